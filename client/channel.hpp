@@ -141,6 +141,20 @@ namespace XuMQ
             _codec->send(_conn, req);
             waitResponse(rid);
         }
+        /// @brief 清空消息队列中待推送的消息 已推送未确认的消息不受影响
+        /// @param qname 消息队列名称
+        /// @return 成功返回true 队列不存在返回false
+        bool purgeQueue(const std::string &qname)
+        {
+            queuePurgeRequest req;
+            std::string rid = UUIDHelper::uuid();
+            req.set_rid(rid);
+            req.set_cid(_cid);
+            req.set_queue_name(qname);
+            _codec->send(_conn, req);
+            basicResponsePtr resp = waitResponse(rid);
+            return resp->ok();
+        }
         /// @brief 添加绑定信息
         /// @param ename 交换机名称
         /// @param qname 消息队列名称
@@ -196,8 +210,8 @@ namespace XuMQ
             waitResponse(rid);
         }
         /// @brief 应答消息
-        /// @param msg_id 消息id
-        void basicAck(const std::string &msg_id)
+        /// @param delivery_tag 推送消息时携带的投递标识
+        void basicAck(uint64_t delivery_tag)
         {
             if (_consumer.get() == nullptr) // 消费者不存在 无法进行确认
             {
@@ -209,7 +223,7 @@ namespace XuMQ
             req.set_rid(rid);
             req.set_cid(_cid);
             req.set_queue_name(_consumer->qname);
-            req.set_msg_id(msg_id);
+            req.set_delivery_tag(delivery_tag);
             _codec->send(_conn, req);
             waitResponse(rid);
         }
@@ -280,7 +294,7 @@ namespace XuMQ
                 error(logger, "推送消息中消费者标识与信道消费者标识不一致!");
                 return;
             }
-            _consumer->callback(resp->consumer_tag(), resp->mutable_properties(), resp->body());
+            _consumer->callback(resp->consumer_tag(), resp->delivery_tag(), resp->mutable_properties(), resp->body());
         }
 
         std::string cid()
@@ -1,10 +1,10 @@
 #include "connection.hpp"
 #include "../common/logger.hpp"
 
-void callBack(XuMQ::Channel::ptr &channel, const std::string &consumer_tag, const XuMQ::BasicProperties *bp, const std::string &body)
+void callBack(XuMQ::Channel::ptr &channel, const std::string &consumer_tag, uint64_t delivery_tag, const XuMQ::BasicProperties *bp, const std::string &body)
 {
     info(XuMQ::logger, "消费者%s 消费的消息是：%s", consumer_tag.c_str(), body.c_str());
-    channel->basicAck(bp->id());
+    channel->basicAck(delivery_tag);
 }
 int main(int argc, char *argv[])
 {
@@ -31,7 +31,7 @@ int main(int argc, char *argv[])
     // 绑定queue2-exchange1 设置binding_key = news.music.#
     channel->queueBind("exchange1", "queue2", "news.music.#");
     // 订阅指定队列消息
-    auto func = std::bind(callBack, channel, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
+    auto func = std::bind(callBack, channel, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4);
     channel->basicConsume("consumer1", argv[1], false, func);
     while (true)
     {
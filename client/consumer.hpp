@@ -16,7 +16,7 @@
 
 namespace XuMQ
 {
-    using ConsumerCallback = std::function<void(const std::string &, const BasicProperties *, const std::string &)>; ///< 消费者回调函数
+    using ConsumerCallback = std::function<void(const std::string &, uint64_t, const BasicProperties *, const std::string &)>; ///< 消费者回调函数 参数为消费者标识、投递标识、消息属性和消息体
     /// @struct Consumer
     /// @brief 消费者对象结构
     struct Consumer
@@ -2,7 +2,7 @@
  * @file helper.hpp
  * @brief 工具类封装
  *
- * 此文件定义了 SqliteHelper StrHelper UUIDHelper FileHelper
+ * 此文件定义了 SqliteHelper StrHelper UUIDHelper FileHelper CRCHelper CompressHelper
  *
  * SqliteHelper 类提供以下功能：
  * - 创建和打开 SQLite 数据库
@@ -19,6 +19,11 @@
  * - 读取和写入文件
  * - 重命名文件
  * - 创建和删除文件及目录
+ * - 列出目录中的文件
+ *
+ * CRCHelper 类提供 CRC32C 校验和计算，CPU 支持时使用硬件指令，否则使用查表法。
+ *
+ * CompressHelper 类封装 zlib 的压缩和解压。
  *
  */
 
@@ -33,12 +38,20 @@
 #include <iomanip>
 #include <atomic>
 #include <sys/stat.h>
+#include <dirent.h>
 #include <fstream>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <cerrno>
+#include <cstdint>
 #include "logger.hpp"
+#include <zlib.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
 
 namespace XuMQ
 {
@@ -125,6 +138,14 @@ namespace XuMQ
         {
             sqlite3_close_v2(_handler);
         }
+        /**
+         * @brief 获取数据库句柄
+         * @return SQLite 数据库句柄，用于准备语句等 exec 不支持的操作
+         */
+        sqlite3 *handle() const
+        {
+            return _handler;
+        }
 
     private:
         std::string _dbfile; ///< 数据库文件路径
@@ -449,8 +470,167 @@ namespace XuMQ
 #endif
             return (system(cmd.c_str()) != -1);
         }
+        /**
+         * @brief 列出目录中的文件
+         * @param pathname 目录路径
+         * @param result 存储文件名的向量 不包含 "." 和 ".."
+         * @return true 读取成功，false 目录打开失败
+         *
+         * 只返回文件名本身，不包含目录前缀，顺序与文件系统返回的顺序一致。
+         */
+        static bool listDirectory(const std::string &pathname, std::vector<std::string> &result)
+        {
+            DIR *dir = opendir(pathname.c_str());
+            if (dir == nullptr)
+                return false;
+            struct dirent *entry;
+            while ((entry = readdir(dir)) != nullptr)
+            {
+                if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+                    continue;
+                result.push_back(entry->d_name);
+            }
+            closedir(dir);
+            return true;
+        }
 
     private:
         std::string _filename; ///< 操作的文件名
     };
+    /**
+     * @class CRCHelper
+     * @brief CRC32C 校验和计算工具类
+     *
+     * x86 平台在运行时检测 SSE4.2, 支持时使用 crc32 指令;
+     * 编译时启用了 CRC 扩展的 ARM64 平台使用 crc32c 指令;
+     * 其余情况使用查表法
+     */
+    class CRCHelper
+    {
+    public:
+        /**
+         * @brief 计算 CRC32C 校验和
+         * @param data 数据地址
+         * @param len 数据长度
+         * @param crc 之前数据的校验和 用于分段计算 第一段传0
+         * @return 校验和
+         */
+        static uint32_t crc32c(const void *data, size_t len, uint32_t crc = 0)
+        {
+            const uint8_t *p = (const uint8_t *)data;
+#if defined(__x86_64__) || defined(__i386__)
+            static const bool hardware = __builtin_cpu_supports("sse4.2");
+            if (hardware)
+                return ~crc32cHardware(~crc, p, len);
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+            return ~crc32cHardware(~crc, p, len);
+#endif
+            return ~crc32cSoftware(~crc, p, len);
+        }
+
+    private:
+#if defined(__x86_64__) || defined(__i386__)
+        __attribute__((target("sse4.2"))) static uint32_t crc32cHardware(uint32_t crc, const uint8_t *p, size_t len)
+        {
+#if defined(__x86_64__)
+            uint64_t crc64 = crc;
+            for (; len >= 8; p += 8, len -= 8)
+            {
+                uint64_t word;
+                memcpy(&word, p, 8);
+                crc64 = _mm_crc32_u64(crc64, word);
+            }
+            crc = (uint32_t)crc64;
+#endif
+            for (; len > 0; p++, len--)
+                crc = _mm_crc32_u8(crc, *p);
+            return crc;
+        }
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+        static uint32_t crc32cHardware(uint32_t crc, const uint8_t *p, size_t len)
+        {
+            for (; len >= 8; p += 8, len -= 8)
+            {
+                uint64_t word;
+                memcpy(&word, p, 8);
+                crc = __crc32cd(crc, word);
+            }
+            for (; len > 0; p++, len--)
+                crc = __crc32cb(crc, *p);
+            return crc;
+        }
+#endif
+        static uint32_t crc32cSoftware(uint32_t crc, const uint8_t *p, size_t len)
+        {
+            static const std::vector<uint32_t> table = []()
+            {
+                std::vector<uint32_t> t(256);
+                for (uint32_t i = 0; i < 256; i++)
+                {
+                    uint32_t c = i;
+                    for (int k = 0; k < 8; k++)
+                        c = (c & 1) ? (c >> 1) ^ 0x82F63B78 : c >> 1; // CRC32C 反射多项式
+                    t[i] = c;
+                }
+                return t;
+            }();
+            for (; len > 0; p++, len--)
+                crc = table[(crc ^ *p) & 0xff] ^ (crc >> 8);
+            return crc;
+        }
+    };
+    /**
+     * @class CompressHelper
+     * @brief zlib 压缩工具类
+     */
+    class CompressHelper
+    {
+    public:
+        /**
+         * @brief 压缩数据
+         * @param data 数据地址
+         * @param len 数据长度
+         * @param out 压缩结果 追加在原有内容之后
+         * @param level 压缩级别 1(最快)~9(最小) 其他值使用zlib默认级别
+         * @return 成功返回true 失败返回false
+         */
+        static bool compress(const char *data, size_t len, std::string &out, int level = Z_DEFAULT_COMPRESSION)
+        {
+            if (level < Z_BEST_SPEED || level > Z_BEST_COMPRESSION)
+                level = Z_DEFAULT_COMPRESSION;
+            size_t old = out.size();
+            uLongf bound = compressBound(len);
+            out.resize(old + bound);
+            int ret = compress2((Bytef *)&out[old], &bound, (const Bytef *)data, len, level);
+            if (ret != Z_OK)
+            {
+                error(logger, "压缩数据失败! %d", ret);
+                out.resize(old);
+                return false;
+            }
+            out.resize(old + bound);
+            return true;
+        }
+        /**
+         * @brief 解压数据
+         * @param data 压缩数据地址
+         * @param len 压缩数据长度
+         * @param raw 解压后的长度 由调用方保存
+         * @param out 解压结果
+         * @return 成功返回true 失败返回false
+         */
+        static bool uncompress(const char *data, size_t len, size_t raw, std::string &out)
+        {
+            out.resize(raw);
+            uLongf size = raw;
+            int ret = ::uncompress((Bytef *)&out[0], &size, (const Bytef *)data, len);
+            if (ret != Z_OK || size != raw)
+            {
+                error(logger, "解压数据失败! %d", ret);
+                out.clear();
+                return false;
+            }
+            return true;
+        }
+    };
 }
@@ -36,11 +36,28 @@ struct BasicPropertiesDefaultTypeInternal {
   };
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 BasicPropertiesDefaultTypeInternal _BasicProperties_default_instance_;
+PROTOBUF_CONSTEXPR Message_Reference::Message_Reference(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.queue_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.seq_)*/uint64_t{0u}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct Message_ReferenceDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR Message_ReferenceDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~Message_ReferenceDefaultTypeInternal() {}
+  union {
+    Message_Reference _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 Message_ReferenceDefaultTypeInternal _Message_Reference_default_instance_;
 PROTOBUF_CONSTEXPR Message_Payload::Message_Payload(
     ::_pbi::ConstantInitialized): _impl_{
-    /*decltype(_impl_.body_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+    /*decltype(_impl_.refs_)*/{}
+  , /*decltype(_impl_.body_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
   , /*decltype(_impl_.valid_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.queue_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
   , /*decltype(_impl_.properties_)*/nullptr
+  , /*decltype(_impl_.seq_)*/uint64_t{0u}
   , /*decltype(_impl_._cached_size_)*/{}} {}
 struct Message_PayloadDefaultTypeInternal {
   PROTOBUF_CONSTEXPR Message_PayloadDefaultTypeInternal()
@@ -54,8 +71,6 @@ PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORIT
 PROTOBUF_CONSTEXPR Message::Message(
     ::_pbi::ConstantInitialized): _impl_{
     /*decltype(_impl_.payload_)*/nullptr
-  , /*decltype(_impl_.offset_)*/0u
-  , /*decltype(_impl_.length_)*/0u
   , /*decltype(_impl_._cached_size_)*/{}} {}
 struct MessageDefaultTypeInternal {
   PROTOBUF_CONSTEXPR MessageDefaultTypeInternal()
@@ -66,8 +81,60 @@ struct MessageDefaultTypeInternal {
   };
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 MessageDefaultTypeInternal _Message_default_instance_;
+PROTOBUF_CONSTEXPR QueueCheckpoint_SegmentInfo::QueueCheckpoint_SegmentInfo(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.inode_)*/uint64_t{0u}
+  , /*decltype(_impl_.total_)*/uint64_t{0u}
+  , /*decltype(_impl_.min_seq_)*/uint64_t{0u}
+  , /*decltype(_impl_.max_seq_)*/uint64_t{0u}
+  , /*decltype(_impl_.id_)*/0u
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct QueueCheckpoint_SegmentInfoDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR QueueCheckpoint_SegmentInfoDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~QueueCheckpoint_SegmentInfoDefaultTypeInternal() {}
+  union {
+    QueueCheckpoint_SegmentInfo _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 QueueCheckpoint_SegmentInfoDefaultTypeInternal _QueueCheckpoint_SegmentInfo_default_instance_;
+PROTOBUF_CONSTEXPR QueueCheckpoint_Entry::QueueCheckpoint_Entry(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.id_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.seq_)*/uint64_t{0u}
+  , /*decltype(_impl_.offset_)*/uint64_t{0u}
+  , /*decltype(_impl_.segment_)*/0u
+  , /*decltype(_impl_.length_)*/0u
+  , /*decltype(_impl_.inner_)*/0u
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct QueueCheckpoint_EntryDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR QueueCheckpoint_EntryDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~QueueCheckpoint_EntryDefaultTypeInternal() {}
+  union {
+    QueueCheckpoint_Entry _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 QueueCheckpoint_EntryDefaultTypeInternal _QueueCheckpoint_Entry_default_instance_;
+PROTOBUF_CONSTEXPR QueueCheckpoint::QueueCheckpoint(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.segments_)*/{}
+  , /*decltype(_impl_.entries_)*/{}
+  , /*decltype(_impl_.tail_)*/uint64_t{0u}
+  , /*decltype(_impl_.seq_)*/uint64_t{0u}
+  , /*decltype(_impl_.active_)*/0u
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct QueueCheckpointDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR QueueCheckpointDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~QueueCheckpointDefaultTypeInternal() {}
+  union {
+    QueueCheckpoint _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 QueueCheckpointDefaultTypeInternal _QueueCheckpoint_default_instance_;
 }  // namespace XuMQ
-static ::_pb::Metadata file_level_metadata_msg_2eproto[3];
+static ::_pb::Metadata file_level_metadata_msg_2eproto[7];
 static const ::_pb::EnumDescriptor* file_level_enum_descriptors_msg_2eproto[2];
 static constexpr ::_pb::ServiceDescriptor const** file_level_service_descriptors_msg_2eproto = nullptr;
 
@@ -82,6 +149,14 @@ const uint32_t TableStruct_msg_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(prot
   PROTOBUF_FIELD_OFFSET(::XuMQ::BasicProperties, _impl_.delivery_mode_),
   PROTOBUF_FIELD_OFFSET(::XuMQ::BasicProperties, _impl_.routing_key_),
   ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::XuMQ::Message_Reference, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::XuMQ::Message_Reference, _impl_.queue_),
+  PROTOBUF_FIELD_OFFSET(::XuMQ::Message_Reference, _impl_.seq_),
+  ~0u,  // no _has_bits_
   PROTOBUF_FIELD_OFFSET(::XuMQ::Message_Payload, _internal_metadata_),
   ~0u,  // no _extensions_
   ~0u,  // no _oneof_case_
@@ -90,6 +165,9 @@ const uint32_t TableStruct_msg_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(prot
   PROTOBUF_FIELD_OFFSET(::XuMQ::Message_Payload, _impl_.properties_),
   PROTOBUF_FIELD_OFFSET(::XuMQ::Message_Payload, _impl_.body_),
   PROTOBUF_FIELD_OFFSET(::XuMQ::Message_Payload, _impl_.valid_),
+  PROTOBUF_FIELD_OFFSET(::XuMQ::Message_Payload, _impl_.seq_),
+  PROTOBUF_FIELD_OFFSET(::XuMQ::Message_Payload, _impl_.queue_),
+  PROTOBUF_FIELD_OFFSET(::XuMQ::Message_Payload, _impl_.refs_),
   ~0u,  // no _has_bits_
   PROTOBUF_FIELD_OFFSET(::XuMQ::Message, _internal_metadata_),
   ~0u,  // no _extensions_
@@ -97,39 +175,90 @@ const uint32_t TableStruct_msg_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(prot
   ~0u,  // no _weak_field_map_
   ~0u,  // no _inlined_string_donated_
   PROTOBUF_FIELD_OFFSET(::XuMQ::Message, _impl_.payload_),
-  PROTOBUF_FIELD_OFFSET(::XuMQ::Message, _impl_.offset_),
-  PROTOBUF_FIELD_OFFSET(::XuMQ::Message, _impl_.length_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::XuMQ::QueueCheckpoint_SegmentInfo, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::XuMQ::QueueCheckpoint_SegmentInfo, _impl_.id_),
+  PROTOBUF_FIELD_OFFSET(::XuMQ::QueueCheckpoint_SegmentInfo, _impl_.inode_),
+  PROTOBUF_FIELD_OFFSET(::XuMQ::QueueCheckpoint_SegmentInfo, _impl_.total_),
+  PROTOBUF_FIELD_OFFSET(::XuMQ::QueueCheckpoint_SegmentInfo, _impl_.min_seq_),
+  PROTOBUF_FIELD_OFFSET(::XuMQ::QueueCheckpoint_SegmentInfo, _impl_.max_seq_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::XuMQ::QueueCheckpoint_Entry, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::XuMQ::QueueCheckpoint_Entry, _impl_.seq_),
+  PROTOBUF_FIELD_OFFSET(::XuMQ::QueueCheckpoint_Entry, _impl_.segment_),
+  PROTOBUF_FIELD_OFFSET(::XuMQ::QueueCheckpoint_Entry, _impl_.offset_),
+  PROTOBUF_FIELD_OFFSET(::XuMQ::QueueCheckpoint_Entry, _impl_.length_),
+  PROTOBUF_FIELD_OFFSET(::XuMQ::QueueCheckpoint_Entry, _impl_.id_),
+  PROTOBUF_FIELD_OFFSET(::XuMQ::QueueCheckpoint_Entry, _impl_.inner_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::XuMQ::QueueCheckpoint, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::XuMQ::QueueCheckpoint, _impl_.active_),
+  PROTOBUF_FIELD_OFFSET(::XuMQ::QueueCheckpoint, _impl_.tail_),
+  PROTOBUF_FIELD_OFFSET(::XuMQ::QueueCheckpoint, _impl_.seq_),
+  PROTOBUF_FIELD_OFFSET(::XuMQ::QueueCheckpoint, _impl_.segments_),
+  PROTOBUF_FIELD_OFFSET(::XuMQ::QueueCheckpoint, _impl_.entries_),
 };
 static const ::_pbi::MigrationSchema schemas[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
   { 0, -1, -1, sizeof(::XuMQ::BasicProperties)},
-  { 9, -1, -1, sizeof(::XuMQ::Message_Payload)},
-  { 18, -1, -1, sizeof(::XuMQ::Message)},
+  { 9, -1, -1, sizeof(::XuMQ::Message_Reference)},
+  { 17, -1, -1, sizeof(::XuMQ::Message_Payload)},
+  { 29, -1, -1, sizeof(::XuMQ::Message)},
+  { 36, -1, -1, sizeof(::XuMQ::QueueCheckpoint_SegmentInfo)},
+  { 47, -1, -1, sizeof(::XuMQ::QueueCheckpoint_Entry)},
+  { 59, -1, -1, sizeof(::XuMQ::QueueCheckpoint)},
 };
 
 static const ::_pb::Message* const file_default_instances[] = {
   &::XuMQ::_BasicProperties_default_instance_._instance,
+  &::XuMQ::_Message_Reference_default_instance_._instance,
   &::XuMQ::_Message_Payload_default_instance_._instance,
   &::XuMQ::_Message_default_instance_._instance,
+  &::XuMQ::_QueueCheckpoint_SegmentInfo_default_instance_._instance,
+  &::XuMQ::_QueueCheckpoint_Entry_default_instance_._instance,
+  &::XuMQ::_QueueCheckpoint_default_instance_._instance,
 };
 
 const char descriptor_table_protodef_msg_2eproto[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) =
   "\n\tmsg.proto\022\004XuMQ\"]\n\017BasicProperties\022\n\n\002"
   "id\030\001 \001(\t\022)\n\rdelivery_mode\030\002 \001(\0162\022.XuMQ.D"
-  "eliveryMode\022\023\n\013routing_key\030\003 \001(\t\"\244\001\n\007Mes"
+  "eliveryMode\022\023\n\013routing_key\030\003 \001(\t\"\361\001\n\007Mes"
   "sage\022&\n\007payload\030\001 \001(\0132\025.XuMQ.Message.Pay"
-  "load\022\016\n\006offset\030\002 \001(\r\022\016\n\006length\030\003 \001(\r\032Q\n\007"
-  "Payload\022)\n\nproperties\030\001 \001(\0132\025.XuMQ.Basic"
-  "Properties\022\014\n\004body\030\002 \001(\t\022\r\n\005valid\030\003 \001(\t*"
-  "A\n\014ExchangeType\022\016\n\nUNKNOWTYPE\020\000\022\n\n\006DIREC"
-  "T\020\001\022\n\n\006FANOUT\020\002\022\t\n\005TOPIC\020\003*:\n\014DeliveryMo"
-  "de\022\016\n\nUNKNOWMODE\020\000\022\r\n\tUNDURABLE\020\001\022\013\n\007DUR"
-  "ABLE\020\002b\006proto3"
+  "load\032\'\n\tReference\022\r\n\005queue\030\001 \001(\t\022\013\n\003seq\030"
+  "\002 \001(\004\032\224\001\n\007Payload\022)\n\nproperties\030\001 \001(\0132\025."
+  "XuMQ.BasicProperties\022\014\n\004body\030\002 \001(\t\022\r\n\005va"
+  "lid\030\003 \001(\t\022\013\n\003seq\030\004 \001(\004\022\r\n\005queue\030\005 \001(\t\022%\n"
+  "\004refs\030\006 \003(\0132\027.XuMQ.Message.Reference\"\334\002\n"
+  "\017QueueCheckpoint\022\016\n\006active\030\001 \001(\r\022\014\n\004tail"
+  "\030\002 \001(\004\022\013\n\003seq\030\003 \001(\004\0223\n\010segments\030\004 \003(\0132!."
+  "XuMQ.QueueCheckpoint.SegmentInfo\022,\n\007entr"
+  "ies\030\005 \003(\0132\033.XuMQ.QueueCheckpoint.Entry\032Y"
+  "\n\013SegmentInfo\022\n\n\002id\030\001 \001(\r\022\r\n\005inode\030\002 \001(\004"
+  "\022\r\n\005total\030\003 \001(\004\022\017\n\007min_seq\030\004 \001(\004\022\017\n\007max_"
+  "seq\030\005 \001(\004\032`\n\005Entry\022\013\n\003seq\030\001 \001(\004\022\017\n\007segme"
+  "nt\030\002 \001(\r\022\016\n\006offset\030\003 \001(\004\022\016\n\006length\030\004 \001(\r"
+  "\022\n\n\002id\030\005 \001(\t\022\r\n\005inner\030\006 \001(\r*A\n\014ExchangeT"
+  "ype\022\016\n\nUNKNOWTYPE\020\000\022\n\n\006DIRECT\020\001\022\n\n\006FANOU"
+  "T\020\002\022\t\n\005TOPIC\020\003*:\n\014DeliveryMode\022\016\n\nUNKNOW"
+  "MODE\020\000\022\r\n\tUNDURABLE\020\001\022\013\n\007DURABLE\020\002b\006prot"
+  "o3"
   ;
 static ::_pbi::once_flag descriptor_table_msg_2eproto_once;
 const ::_pbi::DescriptorTable descriptor_table_msg_2eproto = {
-    false, false, 414, descriptor_table_protodef_msg_2eproto,
+    false, false, 842, descriptor_table_protodef_msg_2eproto,
     "msg.proto",
-    &descriptor_table_msg_2eproto_once, nullptr, 0, 3,
+    &descriptor_table_msg_2eproto_once, nullptr, 0, 7,
     schemas, file_default_instances, TableStruct_msg_2eproto::offsets,
     file_level_metadata_msg_2eproto, file_level_enum_descriptors_msg_2eproto,
     file_level_service_descriptors_msg_2eproto,
@@ -458,6 +587,236 @@ void BasicProperties::InternalSwap(BasicProperties* other) {
 
 // ===================================================================
 
+class Message_Reference::_Internal {
+ public:
+};
+
+Message_Reference::Message_Reference(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:XuMQ.Message.Reference)
+}
+Message_Reference::Message_Reference(const Message_Reference& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  Message_Reference* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.queue_){}
+    , decltype(_impl_.seq_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.queue_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.queue_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_queue().empty()) {
+    _this->_impl_.queue_.Set(from._internal_queue(), 
+      _this->GetArenaForAllocation());
+  }
+  _this->_impl_.seq_ = from._impl_.seq_;
+  // @@protoc_insertion_point(copy_constructor:XuMQ.Message.Reference)
+}
+
+inline void Message_Reference::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.queue_){}
+    , decltype(_impl_.seq_){uint64_t{0u}}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.queue_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.queue_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+Message_Reference::~Message_Reference() {
+  // @@protoc_insertion_point(destructor:XuMQ.Message.Reference)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void Message_Reference::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.queue_.Destroy();
+}
+
+void Message_Reference::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void Message_Reference::Clear() {
+// @@protoc_insertion_point(message_clear_start:XuMQ.Message.Reference)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.queue_.ClearToEmpty();
+  _impl_.seq_ = uint64_t{0u};
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* Message_Reference::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // string queue = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          auto str = _internal_mutable_queue();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "XuMQ.Message.Reference.queue"));
+        } else
+          goto handle_unusual;
+        continue;
+      // uint64 seq = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
+          _impl_.seq_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* Message_Reference::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:XuMQ.Message.Reference)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // string queue = 1;
+  if (!this->_internal_queue().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_queue().data(), static_cast<int>(this->_internal_queue().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "XuMQ.Message.Reference.queue");
+    target = stream->WriteStringMaybeAliased(
+        1, this->_internal_queue(), target);
+  }
+
+  // uint64 seq = 2;
+  if (this->_internal_seq() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(2, this->_internal_seq(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:XuMQ.Message.Reference)
+  return target;
+}
+
+size_t Message_Reference::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:XuMQ.Message.Reference)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // string queue = 1;
+  if (!this->_internal_queue().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_queue());
+  }
+
+  // uint64 seq = 2;
+  if (this->_internal_seq() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_seq());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData Message_Reference::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    Message_Reference::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*Message_Reference::GetClassData() const { return &_class_data_; }
+
+
+void Message_Reference::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<Message_Reference*>(&to_msg);
+  auto& from = static_cast<const Message_Reference&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:XuMQ.Message.Reference)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_queue().empty()) {
+    _this->_internal_set_queue(from._internal_queue());
+  }
+  if (from._internal_seq() != 0) {
+    _this->_internal_set_seq(from._internal_seq());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void Message_Reference::CopyFrom(const Message_Reference& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:XuMQ.Message.Reference)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool Message_Reference::IsInitialized() const {
+  return true;
+}
+
+void Message_Reference::InternalSwap(Message_Reference* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.queue_, lhs_arena,
+      &other->_impl_.queue_, rhs_arena
+  );
+  swap(_impl_.seq_, other->_impl_.seq_);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata Message_Reference::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_msg_2eproto_getter, &descriptor_table_msg_2eproto_once,
+      file_level_metadata_msg_2eproto[1]);
+}
+
+// ===================================================================
+
 class Message_Payload::_Internal {
  public:
   static const ::XuMQ::BasicProperties& properties(const Message_Payload* msg);
@@ -477,9 +836,12 @@ Message_Payload::Message_Payload(const Message_Payload& from)
   : ::PROTOBUF_NAMESPACE_ID::Message() {
   Message_Payload* const _this = this; (void)_this;
   new (&_impl_) Impl_{
-      decltype(_impl_.body_){}
+      decltype(_impl_.refs_){from._impl_.refs_}
+    , decltype(_impl_.body_){}
     , decltype(_impl_.valid_){}
+    , decltype(_impl_.queue_){}
     , decltype(_impl_.properties_){nullptr}
+    , decltype(_impl_.seq_){}
     , /*decltype(_impl_._cached_size_)*/{}};
 
   _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
@@ -499,9 +861,18 @@ Message_Payload::Message_Payload(const Message_Payload& from)
     _this->_impl_.valid_.Set(from._internal_valid(), 
       _this->GetArenaForAllocation());
   }
+  _impl_.queue_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.queue_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_queue().empty()) {
+    _this->_impl_.queue_.Set(from._internal_queue(), 
+      _this->GetArenaForAllocation());
+  }
   if (from._internal_has_properties()) {
     _this->_impl_.properties_ = new ::XuMQ::BasicProperties(*from._impl_.properties_);
   }
+  _this->_impl_.seq_ = from._impl_.seq_;
   // @@protoc_insertion_point(copy_constructor:XuMQ.Message.Payload)
 }
 
@@ -510,9 +881,12 @@ inline void Message_Payload::SharedCtor(
   (void)arena;
   (void)is_message_owned;
   new (&_impl_) Impl_{
-      decltype(_impl_.body_){}
+      decltype(_impl_.refs_){arena}
+    , decltype(_impl_.body_){}
     , decltype(_impl_.valid_){}
+    , decltype(_impl_.queue_){}
     , decltype(_impl_.properties_){nullptr}
+    , decltype(_impl_.seq_){uint64_t{0u}}
     , /*decltype(_impl_._cached_size_)*/{}
   };
   _impl_.body_.InitDefault();
@@ -523,6 +897,10 @@ inline void Message_Payload::SharedCtor(
   #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
     _impl_.valid_.Set("", GetArenaForAllocation());
   #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  _impl_.queue_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.queue_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
 }
 
 Message_Payload::~Message_Payload() {
@@ -536,8 +914,10 @@ Message_Payload::~Message_Payload() {
 
 inline void Message_Payload::SharedDtor() {
   GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.refs_.~RepeatedPtrField();
   _impl_.body_.Destroy();
   _impl_.valid_.Destroy();
+  _impl_.queue_.Destroy();
   if (this != internal_default_instance()) delete _impl_.properties_;
 }
 
@@ -551,12 +931,15 @@ void Message_Payload::Clear() {
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
+  _impl_.refs_.Clear();
   _impl_.body_.ClearToEmpty();
   _impl_.valid_.ClearToEmpty();
+  _impl_.queue_.ClearToEmpty();
   if (GetArenaForAllocation() == nullptr && _impl_.properties_ != nullptr) {
     delete _impl_.properties_;
   }
   _impl_.properties_ = nullptr;
+  _impl_.seq_ = uint64_t{0u};
   _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
 }
 
@@ -594,6 +977,37 @@ const char* Message_Payload::_InternalParse(const char* ptr, ::_pbi::ParseContex
         } else
           goto handle_unusual;
         continue;
+      // uint64 seq = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 32)) {
+          _impl_.seq_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // string queue = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 42)) {
+          auto str = _internal_mutable_queue();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "XuMQ.Message.Payload.queue"));
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated .XuMQ.Message.Reference refs = 6;
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 50)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(_internal_add_refs(), ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<50>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -650,6 +1064,30 @@ uint8_t* Message_Payload::_InternalSerialize(
         3, this->_internal_valid(), target);
   }
 
+  // uint64 seq = 4;
+  if (this->_internal_seq() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(4, this->_internal_seq(), target);
+  }
+
+  // string queue = 5;
+  if (!this->_internal_queue().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_queue().data(), static_cast<int>(this->_internal_queue().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "XuMQ.Message.Payload.queue");
+    target = stream->WriteStringMaybeAliased(
+        5, this->_internal_queue(), target);
+  }
+
+  // repeated .XuMQ.Message.Reference refs = 6;
+  for (unsigned i = 0,
+      n = static_cast<unsigned>(this->_internal_refs_size()); i < n; i++) {
+    const auto& repfield = this->_internal_refs(i);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+        InternalWriteMessage(6, repfield, repfield.GetCachedSize(), target, stream);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
@@ -666,6 +1104,13 @@ size_t Message_Payload::ByteSizeLong() const {
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
+  // repeated .XuMQ.Message.Reference refs = 6;
+  total_size += 1UL * this->_internal_refs_size();
+  for (const auto& msg : this->_impl_.refs_) {
+    total_size +=
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
+  }
+
   // string body = 2;
   if (!this->_internal_body().empty()) {
     total_size += 1 +
@@ -680,6 +1125,13 @@ size_t Message_Payload::ByteSizeLong() const {
         this->_internal_valid());
   }
 
+  // string queue = 5;
+  if (!this->_internal_queue().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_queue());
+  }
+
   // .XuMQ.BasicProperties properties = 1;
   if (this->_internal_has_properties()) {
     total_size += 1 +
@@ -687,6 +1139,11 @@ size_t Message_Payload::ByteSizeLong() const {
         *_impl_.properties_);
   }
 
+  // uint64 seq = 4;
+  if (this->_internal_seq() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_seq());
+  }
+
   return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
 }
 
@@ -705,16 +1162,23 @@ void Message_Payload::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const
   uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
+  _this->_impl_.refs_.MergeFrom(from._impl_.refs_);
   if (!from._internal_body().empty()) {
     _this->_internal_set_body(from._internal_body());
   }
   if (!from._internal_valid().empty()) {
     _this->_internal_set_valid(from._internal_valid());
   }
+  if (!from._internal_queue().empty()) {
+    _this->_internal_set_queue(from._internal_queue());
+  }
   if (from._internal_has_properties()) {
     _this->_internal_mutable_properties()->::XuMQ::BasicProperties::MergeFrom(
         from._internal_properties());
   }
+  if (from._internal_seq() != 0) {
+    _this->_internal_set_seq(from._internal_seq());
+  }
   _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
 }
 
@@ -734,6 +1198,7 @@ void Message_Payload::InternalSwap(Message_Payload* other) {
   auto* lhs_arena = GetArenaForAllocation();
   auto* rhs_arena = other->GetArenaForAllocation();
   _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  _impl_.refs_.InternalSwap(&other->_impl_.refs_);
   ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
       &_impl_.body_, lhs_arena,
       &other->_impl_.body_, rhs_arena
@@ -742,13 +1207,22 @@ void Message_Payload::InternalSwap(Message_Payload* other) {
       &_impl_.valid_, lhs_arena,
       &other->_impl_.valid_, rhs_arena
   );
-  swap(_impl_.properties_, other->_impl_.properties_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.queue_, lhs_arena,
+      &other->_impl_.queue_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(Message_Payload, _impl_.seq_)
+      + sizeof(Message_Payload::_impl_.seq_)
+      - PROTOBUF_FIELD_OFFSET(Message_Payload, _impl_.properties_)>(
+          reinterpret_cast<char*>(&_impl_.properties_),
+          reinterpret_cast<char*>(&other->_impl_.properties_));
 }
 
 ::PROTOBUF_NAMESPACE_ID::Metadata Message_Payload::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_msg_2eproto_getter, &descriptor_table_msg_2eproto_once,
-      file_level_metadata_msg_2eproto[1]);
+      file_level_metadata_msg_2eproto[2]);
 }
 
 // ===================================================================
@@ -773,17 +1247,12 @@ Message::Message(const Message& from)
   Message* const _this = this; (void)_this;
   new (&_impl_) Impl_{
       decltype(_impl_.payload_){nullptr}
-    , decltype(_impl_.offset_){}
-    , decltype(_impl_.length_){}
     , /*decltype(_impl_._cached_size_)*/{}};
 
   _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
   if (from._internal_has_payload()) {
     _this->_impl_.payload_ = new ::XuMQ::Message_Payload(*from._impl_.payload_);
   }
-  ::memcpy(&_impl_.offset_, &from._impl_.offset_,
-    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.length_) -
-    reinterpret_cast<char*>(&_impl_.offset_)) + sizeof(_impl_.length_));
   // @@protoc_insertion_point(copy_constructor:XuMQ.Message)
 }
 
@@ -793,8 +1262,6 @@ inline void Message::SharedCtor(
   (void)is_message_owned;
   new (&_impl_) Impl_{
       decltype(_impl_.payload_){nullptr}
-    , decltype(_impl_.offset_){0u}
-    , decltype(_impl_.length_){0u}
     , /*decltype(_impl_._cached_size_)*/{}
   };
 }
@@ -827,9 +1294,6 @@ void Message::Clear() {
     delete _impl_.payload_;
   }
   _impl_.payload_ = nullptr;
-  ::memset(&_impl_.offset_, 0, static_cast<size_t>(
-      reinterpret_cast<char*>(&_impl_.length_) -
-      reinterpret_cast<char*>(&_impl_.offset_)) + sizeof(_impl_.length_));
   _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
 }
 
@@ -847,22 +1311,541 @@ const char* Message::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx)
         } else
           goto handle_unusual;
         continue;
-      // uint32 offset = 2;
-      case 2:
-        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
-          _impl_.offset_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
-          CHK_(ptr);
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* Message::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:XuMQ.Message)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // .XuMQ.Message.Payload payload = 1;
+  if (this->_internal_has_payload()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(1, _Internal::payload(this),
+        _Internal::payload(this).GetCachedSize(), target, stream);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:XuMQ.Message)
+  return target;
+}
+
+size_t Message::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:XuMQ.Message)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // .XuMQ.Message.Payload payload = 1;
+  if (this->_internal_has_payload()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+        *_impl_.payload_);
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData Message::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    Message::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*Message::GetClassData() const { return &_class_data_; }
+
+
+void Message::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<Message*>(&to_msg);
+  auto& from = static_cast<const Message&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:XuMQ.Message)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (from._internal_has_payload()) {
+    _this->_internal_mutable_payload()->::XuMQ::Message_Payload::MergeFrom(
+        from._internal_payload());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void Message::CopyFrom(const Message& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:XuMQ.Message)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool Message::IsInitialized() const {
+  return true;
+}
+
+void Message::InternalSwap(Message* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  swap(_impl_.payload_, other->_impl_.payload_);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata Message::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_msg_2eproto_getter, &descriptor_table_msg_2eproto_once,
+      file_level_metadata_msg_2eproto[3]);
+}
+
+// ===================================================================
+
+class QueueCheckpoint_SegmentInfo::_Internal {
+ public:
+};
+
+QueueCheckpoint_SegmentInfo::QueueCheckpoint_SegmentInfo(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:XuMQ.QueueCheckpoint.SegmentInfo)
+}
+QueueCheckpoint_SegmentInfo::QueueCheckpoint_SegmentInfo(const QueueCheckpoint_SegmentInfo& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  QueueCheckpoint_SegmentInfo* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.inode_){}
+    , decltype(_impl_.total_){}
+    , decltype(_impl_.min_seq_){}
+    , decltype(_impl_.max_seq_){}
+    , decltype(_impl_.id_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  ::memcpy(&_impl_.inode_, &from._impl_.inode_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.id_) -
+    reinterpret_cast<char*>(&_impl_.inode_)) + sizeof(_impl_.id_));
+  // @@protoc_insertion_point(copy_constructor:XuMQ.QueueCheckpoint.SegmentInfo)
+}
+
+inline void QueueCheckpoint_SegmentInfo::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.inode_){uint64_t{0u}}
+    , decltype(_impl_.total_){uint64_t{0u}}
+    , decltype(_impl_.min_seq_){uint64_t{0u}}
+    , decltype(_impl_.max_seq_){uint64_t{0u}}
+    , decltype(_impl_.id_){0u}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+}
+
+QueueCheckpoint_SegmentInfo::~QueueCheckpoint_SegmentInfo() {
+  // @@protoc_insertion_point(destructor:XuMQ.QueueCheckpoint.SegmentInfo)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void QueueCheckpoint_SegmentInfo::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+}
+
+void QueueCheckpoint_SegmentInfo::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void QueueCheckpoint_SegmentInfo::Clear() {
+// @@protoc_insertion_point(message_clear_start:XuMQ.QueueCheckpoint.SegmentInfo)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  ::memset(&_impl_.inode_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.id_) -
+      reinterpret_cast<char*>(&_impl_.inode_)) + sizeof(_impl_.id_));
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* QueueCheckpoint_SegmentInfo::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // uint32 id = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          _impl_.id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint64 inode = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
+          _impl_.inode_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint64 total = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          _impl_.total_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint64 min_seq = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 32)) {
+          _impl_.min_seq_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint64 max_seq = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 40)) {
+          _impl_.max_seq_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* QueueCheckpoint_SegmentInfo::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:XuMQ.QueueCheckpoint.SegmentInfo)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // uint32 id = 1;
+  if (this->_internal_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(1, this->_internal_id(), target);
+  }
+
+  // uint64 inode = 2;
+  if (this->_internal_inode() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(2, this->_internal_inode(), target);
+  }
+
+  // uint64 total = 3;
+  if (this->_internal_total() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(3, this->_internal_total(), target);
+  }
+
+  // uint64 min_seq = 4;
+  if (this->_internal_min_seq() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(4, this->_internal_min_seq(), target);
+  }
+
+  // uint64 max_seq = 5;
+  if (this->_internal_max_seq() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(5, this->_internal_max_seq(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:XuMQ.QueueCheckpoint.SegmentInfo)
+  return target;
+}
+
+size_t QueueCheckpoint_SegmentInfo::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:XuMQ.QueueCheckpoint.SegmentInfo)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // uint64 inode = 2;
+  if (this->_internal_inode() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_inode());
+  }
+
+  // uint64 total = 3;
+  if (this->_internal_total() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_total());
+  }
+
+  // uint64 min_seq = 4;
+  if (this->_internal_min_seq() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_min_seq());
+  }
+
+  // uint64 max_seq = 5;
+  if (this->_internal_max_seq() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_max_seq());
+  }
+
+  // uint32 id = 1;
+  if (this->_internal_id() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_id());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData QueueCheckpoint_SegmentInfo::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    QueueCheckpoint_SegmentInfo::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*QueueCheckpoint_SegmentInfo::GetClassData() const { return &_class_data_; }
+
+
+void QueueCheckpoint_SegmentInfo::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<QueueCheckpoint_SegmentInfo*>(&to_msg);
+  auto& from = static_cast<const QueueCheckpoint_SegmentInfo&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:XuMQ.QueueCheckpoint.SegmentInfo)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (from._internal_inode() != 0) {
+    _this->_internal_set_inode(from._internal_inode());
+  }
+  if (from._internal_total() != 0) {
+    _this->_internal_set_total(from._internal_total());
+  }
+  if (from._internal_min_seq() != 0) {
+    _this->_internal_set_min_seq(from._internal_min_seq());
+  }
+  if (from._internal_max_seq() != 0) {
+    _this->_internal_set_max_seq(from._internal_max_seq());
+  }
+  if (from._internal_id() != 0) {
+    _this->_internal_set_id(from._internal_id());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void QueueCheckpoint_SegmentInfo::CopyFrom(const QueueCheckpoint_SegmentInfo& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:XuMQ.QueueCheckpoint.SegmentInfo)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool QueueCheckpoint_SegmentInfo::IsInitialized() const {
+  return true;
+}
+
+void QueueCheckpoint_SegmentInfo::InternalSwap(QueueCheckpoint_SegmentInfo* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(QueueCheckpoint_SegmentInfo, _impl_.id_)
+      + sizeof(QueueCheckpoint_SegmentInfo::_impl_.id_)
+      - PROTOBUF_FIELD_OFFSET(QueueCheckpoint_SegmentInfo, _impl_.inode_)>(
+          reinterpret_cast<char*>(&_impl_.inode_),
+          reinterpret_cast<char*>(&other->_impl_.inode_));
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata QueueCheckpoint_SegmentInfo::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_msg_2eproto_getter, &descriptor_table_msg_2eproto_once,
+      file_level_metadata_msg_2eproto[4]);
+}
+
+// ===================================================================
+
+class QueueCheckpoint_Entry::_Internal {
+ public:
+};
+
+QueueCheckpoint_Entry::QueueCheckpoint_Entry(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:XuMQ.QueueCheckpoint.Entry)
+}
+QueueCheckpoint_Entry::QueueCheckpoint_Entry(const QueueCheckpoint_Entry& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  QueueCheckpoint_Entry* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.id_){}
+    , decltype(_impl_.seq_){}
+    , decltype(_impl_.offset_){}
+    , decltype(_impl_.segment_){}
+    , decltype(_impl_.length_){}
+    , decltype(_impl_.inner_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.id_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.id_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_id().empty()) {
+    _this->_impl_.id_.Set(from._internal_id(), 
+      _this->GetArenaForAllocation());
+  }
+  ::memcpy(&_impl_.seq_, &from._impl_.seq_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.inner_) -
+    reinterpret_cast<char*>(&_impl_.seq_)) + sizeof(_impl_.inner_));
+  // @@protoc_insertion_point(copy_constructor:XuMQ.QueueCheckpoint.Entry)
+}
+
+inline void QueueCheckpoint_Entry::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.id_){}
+    , decltype(_impl_.seq_){uint64_t{0u}}
+    , decltype(_impl_.offset_){uint64_t{0u}}
+    , decltype(_impl_.segment_){0u}
+    , decltype(_impl_.length_){0u}
+    , decltype(_impl_.inner_){0u}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.id_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.id_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+QueueCheckpoint_Entry::~QueueCheckpoint_Entry() {
+  // @@protoc_insertion_point(destructor:XuMQ.QueueCheckpoint.Entry)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void QueueCheckpoint_Entry::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.id_.Destroy();
+}
+
+void QueueCheckpoint_Entry::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void QueueCheckpoint_Entry::Clear() {
+// @@protoc_insertion_point(message_clear_start:XuMQ.QueueCheckpoint.Entry)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.id_.ClearToEmpty();
+  ::memset(&_impl_.seq_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.inner_) -
+      reinterpret_cast<char*>(&_impl_.seq_)) + sizeof(_impl_.inner_));
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* QueueCheckpoint_Entry::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // uint64 seq = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          _impl_.seq_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 segment = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
+          _impl_.segment_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
         } else
           goto handle_unusual;
         continue;
-      // uint32 length = 3;
+      // uint64 offset = 3;
       case 3:
         if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          _impl_.offset_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 length = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 32)) {
           _impl_.length_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
           CHK_(ptr);
         } else
           goto handle_unusual;
         continue;
+      // string id = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 42)) {
+          auto str = _internal_mutable_id();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "XuMQ.QueueCheckpoint.Entry.id"));
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 inner = 6;
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 48)) {
+          _impl_.inner_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -886,121 +1869,474 @@ failure:
 #undef CHK_
 }
 
-uint8_t* Message::_InternalSerialize(
+uint8_t* QueueCheckpoint_Entry::_InternalSerialize(
     uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
-  // @@protoc_insertion_point(serialize_to_array_start:XuMQ.Message)
+  // @@protoc_insertion_point(serialize_to_array_start:XuMQ.QueueCheckpoint.Entry)
   uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
-  // .XuMQ.Message.Payload payload = 1;
-  if (this->_internal_has_payload()) {
-    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
-      InternalWriteMessage(1, _Internal::payload(this),
-        _Internal::payload(this).GetCachedSize(), target, stream);
+  // uint64 seq = 1;
+  if (this->_internal_seq() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(1, this->_internal_seq(), target);
+  }
+
+  // uint32 segment = 2;
+  if (this->_internal_segment() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(2, this->_internal_segment(), target);
   }
 
-  // uint32 offset = 2;
+  // uint64 offset = 3;
   if (this->_internal_offset() != 0) {
     target = stream->EnsureSpace(target);
-    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(2, this->_internal_offset(), target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(3, this->_internal_offset(), target);
   }
 
-  // uint32 length = 3;
+  // uint32 length = 4;
   if (this->_internal_length() != 0) {
     target = stream->EnsureSpace(target);
-    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(3, this->_internal_length(), target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(4, this->_internal_length(), target);
+  }
+
+  // string id = 5;
+  if (!this->_internal_id().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_id().data(), static_cast<int>(this->_internal_id().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "XuMQ.QueueCheckpoint.Entry.id");
+    target = stream->WriteStringMaybeAliased(
+        5, this->_internal_id(), target);
+  }
+
+  // uint32 inner = 6;
+  if (this->_internal_inner() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(6, this->_internal_inner(), target);
   }
 
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
   }
-  // @@protoc_insertion_point(serialize_to_array_end:XuMQ.Message)
+  // @@protoc_insertion_point(serialize_to_array_end:XuMQ.QueueCheckpoint.Entry)
   return target;
 }
 
-size_t Message::ByteSizeLong() const {
-// @@protoc_insertion_point(message_byte_size_start:XuMQ.Message)
+size_t QueueCheckpoint_Entry::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:XuMQ.QueueCheckpoint.Entry)
   size_t total_size = 0;
 
   uint32_t cached_has_bits = 0;
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
-  // .XuMQ.Message.Payload payload = 1;
-  if (this->_internal_has_payload()) {
+  // string id = 5;
+  if (!this->_internal_id().empty()) {
     total_size += 1 +
-      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
-        *_impl_.payload_);
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_id());
   }
 
-  // uint32 offset = 2;
+  // uint64 seq = 1;
+  if (this->_internal_seq() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_seq());
+  }
+
+  // uint64 offset = 3;
   if (this->_internal_offset() != 0) {
-    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_offset());
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_offset());
+  }
+
+  // uint32 segment = 2;
+  if (this->_internal_segment() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_segment());
   }
 
-  // uint32 length = 3;
+  // uint32 length = 4;
   if (this->_internal_length() != 0) {
     total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_length());
   }
 
+  // uint32 inner = 6;
+  if (this->_internal_inner() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_inner());
+  }
+
   return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
 }
 
-const ::PROTOBUF_NAMESPACE_ID::Message::ClassData Message::_class_data_ = {
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData QueueCheckpoint_Entry::_class_data_ = {
     ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
-    Message::MergeImpl
+    QueueCheckpoint_Entry::MergeImpl
 };
-const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*Message::GetClassData() const { return &_class_data_; }
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*QueueCheckpoint_Entry::GetClassData() const { return &_class_data_; }
 
 
-void Message::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
-  auto* const _this = static_cast<Message*>(&to_msg);
-  auto& from = static_cast<const Message&>(from_msg);
-  // @@protoc_insertion_point(class_specific_merge_from_start:XuMQ.Message)
+void QueueCheckpoint_Entry::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<QueueCheckpoint_Entry*>(&to_msg);
+  auto& from = static_cast<const QueueCheckpoint_Entry&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:XuMQ.QueueCheckpoint.Entry)
   GOOGLE_DCHECK_NE(&from, _this);
   uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
-  if (from._internal_has_payload()) {
-    _this->_internal_mutable_payload()->::XuMQ::Message_Payload::MergeFrom(
-        from._internal_payload());
+  if (!from._internal_id().empty()) {
+    _this->_internal_set_id(from._internal_id());
+  }
+  if (from._internal_seq() != 0) {
+    _this->_internal_set_seq(from._internal_seq());
   }
   if (from._internal_offset() != 0) {
     _this->_internal_set_offset(from._internal_offset());
   }
+  if (from._internal_segment() != 0) {
+    _this->_internal_set_segment(from._internal_segment());
+  }
   if (from._internal_length() != 0) {
     _this->_internal_set_length(from._internal_length());
   }
+  if (from._internal_inner() != 0) {
+    _this->_internal_set_inner(from._internal_inner());
+  }
   _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
 }
 
-void Message::CopyFrom(const Message& from) {
-// @@protoc_insertion_point(class_specific_copy_from_start:XuMQ.Message)
+void QueueCheckpoint_Entry::CopyFrom(const QueueCheckpoint_Entry& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:XuMQ.QueueCheckpoint.Entry)
   if (&from == this) return;
   Clear();
   MergeFrom(from);
 }
 
-bool Message::IsInitialized() const {
+bool QueueCheckpoint_Entry::IsInitialized() const {
   return true;
 }
 
-void Message::InternalSwap(Message* other) {
+void QueueCheckpoint_Entry::InternalSwap(QueueCheckpoint_Entry* other) {
   using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
   _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.id_, lhs_arena,
+      &other->_impl_.id_, rhs_arena
+  );
   ::PROTOBUF_NAMESPACE_ID::internal::memswap<
-      PROTOBUF_FIELD_OFFSET(Message, _impl_.length_)
-      + sizeof(Message::_impl_.length_)
-      - PROTOBUF_FIELD_OFFSET(Message, _impl_.payload_)>(
-          reinterpret_cast<char*>(&_impl_.payload_),
-          reinterpret_cast<char*>(&other->_impl_.payload_));
+      PROTOBUF_FIELD_OFFSET(QueueCheckpoint_Entry, _impl_.inner_)
+      + sizeof(QueueCheckpoint_Entry::_impl_.inner_)
+      - PROTOBUF_FIELD_OFFSET(QueueCheckpoint_Entry, _impl_.seq_)>(
+          reinterpret_cast<char*>(&_impl_.seq_),
+          reinterpret_cast<char*>(&other->_impl_.seq_));
 }
 
-::PROTOBUF_NAMESPACE_ID::Metadata Message::GetMetadata() const {
+::PROTOBUF_NAMESPACE_ID::Metadata QueueCheckpoint_Entry::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_msg_2eproto_getter, &descriptor_table_msg_2eproto_once,
-      file_level_metadata_msg_2eproto[2]);
+      file_level_metadata_msg_2eproto[5]);
+}
+
+// ===================================================================
+
+class QueueCheckpoint::_Internal {
+ public:
+};
+
+QueueCheckpoint::QueueCheckpoint(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:XuMQ.QueueCheckpoint)
+}
+QueueCheckpoint::QueueCheckpoint(const QueueCheckpoint& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  QueueCheckpoint* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.segments_){from._impl_.segments_}
+    , decltype(_impl_.entries_){from._impl_.entries_}
+    , decltype(_impl_.tail_){}
+    , decltype(_impl_.seq_){}
+    , decltype(_impl_.active_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  ::memcpy(&_impl_.tail_, &from._impl_.tail_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.active_) -
+    reinterpret_cast<char*>(&_impl_.tail_)) + sizeof(_impl_.active_));
+  // @@protoc_insertion_point(copy_constructor:XuMQ.QueueCheckpoint)
+}
+
+inline void QueueCheckpoint::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.segments_){arena}
+    , decltype(_impl_.entries_){arena}
+    , decltype(_impl_.tail_){uint64_t{0u}}
+    , decltype(_impl_.seq_){uint64_t{0u}}
+    , decltype(_impl_.active_){0u}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+}
+
+QueueCheckpoint::~QueueCheckpoint() {
+  // @@protoc_insertion_point(destructor:XuMQ.QueueCheckpoint)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void QueueCheckpoint::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.segments_.~RepeatedPtrField();
+  _impl_.entries_.~RepeatedPtrField();
+}
+
+void QueueCheckpoint::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void QueueCheckpoint::Clear() {
+// @@protoc_insertion_point(message_clear_start:XuMQ.QueueCheckpoint)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.segments_.Clear();
+  _impl_.entries_.Clear();
+  ::memset(&_impl_.tail_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.active_) -
+      reinterpret_cast<char*>(&_impl_.tail_)) + sizeof(_impl_.active_));
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* QueueCheckpoint::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // uint32 active = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          _impl_.active_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint64 tail = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
+          _impl_.tail_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint64 seq = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          _impl_.seq_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated .XuMQ.QueueCheckpoint.SegmentInfo segments = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 34)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(_internal_add_segments(), ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<34>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated .XuMQ.QueueCheckpoint.Entry entries = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 42)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(_internal_add_entries(), ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<42>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* QueueCheckpoint::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:XuMQ.QueueCheckpoint)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // uint32 active = 1;
+  if (this->_internal_active() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(1, this->_internal_active(), target);
+  }
+
+  // uint64 tail = 2;
+  if (this->_internal_tail() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(2, this->_internal_tail(), target);
+  }
+
+  // uint64 seq = 3;
+  if (this->_internal_seq() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(3, this->_internal_seq(), target);
+  }
+
+  // repeated .XuMQ.QueueCheckpoint.SegmentInfo segments = 4;
+  for (unsigned i = 0,
+      n = static_cast<unsigned>(this->_internal_segments_size()); i < n; i++) {
+    const auto& repfield = this->_internal_segments(i);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+        InternalWriteMessage(4, repfield, repfield.GetCachedSize(), target, stream);
+  }
+
+  // repeated .XuMQ.QueueCheckpoint.Entry entries = 5;
+  for (unsigned i = 0,
+      n = static_cast<unsigned>(this->_internal_entries_size()); i < n; i++) {
+    const auto& repfield = this->_internal_entries(i);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+        InternalWriteMessage(5, repfield, repfield.GetCachedSize(), target, stream);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:XuMQ.QueueCheckpoint)
+  return target;
+}
+
+size_t QueueCheckpoint::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:XuMQ.QueueCheckpoint)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // repeated .XuMQ.QueueCheckpoint.SegmentInfo segments = 4;
+  total_size += 1UL * this->_internal_segments_size();
+  for (const auto& msg : this->_impl_.segments_) {
+    total_size +=
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
+  }
+
+  // repeated .XuMQ.QueueCheckpoint.Entry entries = 5;
+  total_size += 1UL * this->_internal_entries_size();
+  for (const auto& msg : this->_impl_.entries_) {
+    total_size +=
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
+  }
+
+  // uint64 tail = 2;
+  if (this->_internal_tail() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_tail());
+  }
+
+  // uint64 seq = 3;
+  if (this->_internal_seq() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_seq());
+  }
+
+  // uint32 active = 1;
+  if (this->_internal_active() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_active());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData QueueCheckpoint::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    QueueCheckpoint::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*QueueCheckpoint::GetClassData() const { return &_class_data_; }
+
+
+void QueueCheckpoint::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<QueueCheckpoint*>(&to_msg);
+  auto& from = static_cast<const QueueCheckpoint&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:XuMQ.QueueCheckpoint)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  _this->_impl_.segments_.MergeFrom(from._impl_.segments_);
+  _this->_impl_.entries_.MergeFrom(from._impl_.entries_);
+  if (from._internal_tail() != 0) {
+    _this->_internal_set_tail(from._internal_tail());
+  }
+  if (from._internal_seq() != 0) {
+    _this->_internal_set_seq(from._internal_seq());
+  }
+  if (from._internal_active() != 0) {
+    _this->_internal_set_active(from._internal_active());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void QueueCheckpoint::CopyFrom(const QueueCheckpoint& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:XuMQ.QueueCheckpoint)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool QueueCheckpoint::IsInitialized() const {
+  return true;
+}
+
+void QueueCheckpoint::InternalSwap(QueueCheckpoint* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  _impl_.segments_.InternalSwap(&other->_impl_.segments_);
+  _impl_.entries_.InternalSwap(&other->_impl_.entries_);
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(QueueCheckpoint, _impl_.active_)
+      + sizeof(QueueCheckpoint::_impl_.active_)
+      - PROTOBUF_FIELD_OFFSET(QueueCheckpoint, _impl_.tail_)>(
+          reinterpret_cast<char*>(&_impl_.tail_),
+          reinterpret_cast<char*>(&other->_impl_.tail_));
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata QueueCheckpoint::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_msg_2eproto_getter, &descriptor_table_msg_2eproto_once,
+      file_level_metadata_msg_2eproto[6]);
 }
 
 // @@protoc_insertion_point(namespace_scope)
@@ -1010,6 +2346,10 @@ template<> PROTOBUF_NOINLINE ::XuMQ::BasicProperties*
 Arena::CreateMaybeMessage< ::XuMQ::BasicProperties >(Arena* arena) {
   return Arena::CreateMessageInternal< ::XuMQ::BasicProperties >(arena);
 }
+template<> PROTOBUF_NOINLINE ::XuMQ::Message_Reference*
+Arena::CreateMaybeMessage< ::XuMQ::Message_Reference >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::XuMQ::Message_Reference >(arena);
+}
 template<> PROTOBUF_NOINLINE ::XuMQ::Message_Payload*
 Arena::CreateMaybeMessage< ::XuMQ::Message_Payload >(Arena* arena) {
   return Arena::CreateMessageInternal< ::XuMQ::Message_Payload >(arena);
@@ -1018,6 +2358,18 @@ template<> PROTOBUF_NOINLINE ::XuMQ::Message*
 Arena::CreateMaybeMessage< ::XuMQ::Message >(Arena* arena) {
   return Arena::CreateMessageInternal< ::XuMQ::Message >(arena);
 }
+template<> PROTOBUF_NOINLINE ::XuMQ::QueueCheckpoint_SegmentInfo*
+Arena::CreateMaybeMessage< ::XuMQ::QueueCheckpoint_SegmentInfo >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::XuMQ::QueueCheckpoint_SegmentInfo >(arena);
+}
+template<> PROTOBUF_NOINLINE ::XuMQ::QueueCheckpoint_Entry*
+Arena::CreateMaybeMessage< ::XuMQ::QueueCheckpoint_Entry >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::XuMQ::QueueCheckpoint_Entry >(arena);
+}
+template<> PROTOBUF_NOINLINE ::XuMQ::QueueCheckpoint*
+Arena::CreateMaybeMessage< ::XuMQ::QueueCheckpoint >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::XuMQ::QueueCheckpoint >(arena);
+}
 PROTOBUF_NAMESPACE_CLOSE
 
 // @@protoc_insertion_point(global_scope)
@@ -55,11 +55,27 @@ extern MessageDefaultTypeInternal _Message_default_instance_;
 class Message_Payload;
 struct Message_PayloadDefaultTypeInternal;
 extern Message_PayloadDefaultTypeInternal _Message_Payload_default_instance_;
+class Message_Reference;
+struct Message_ReferenceDefaultTypeInternal;
+extern Message_ReferenceDefaultTypeInternal _Message_Reference_default_instance_;
+class QueueCheckpoint;
+struct QueueCheckpointDefaultTypeInternal;
+extern QueueCheckpointDefaultTypeInternal _QueueCheckpoint_default_instance_;
+class QueueCheckpoint_Entry;
+struct QueueCheckpoint_EntryDefaultTypeInternal;
+extern QueueCheckpoint_EntryDefaultTypeInternal _QueueCheckpoint_Entry_default_instance_;
+class QueueCheckpoint_SegmentInfo;
+struct QueueCheckpoint_SegmentInfoDefaultTypeInternal;
+extern QueueCheckpoint_SegmentInfoDefaultTypeInternal _QueueCheckpoint_SegmentInfo_default_instance_;
 }  // namespace XuMQ
 PROTOBUF_NAMESPACE_OPEN
 template<> ::XuMQ::BasicProperties* Arena::CreateMaybeMessage<::XuMQ::BasicProperties>(Arena*);
 template<> ::XuMQ::Message* Arena::CreateMaybeMessage<::XuMQ::Message>(Arena*);
 template<> ::XuMQ::Message_Payload* Arena::CreateMaybeMessage<::XuMQ::Message_Payload>(Arena*);
+template<> ::XuMQ::Message_Reference* Arena::CreateMaybeMessage<::XuMQ::Message_Reference>(Arena*);
+template<> ::XuMQ::QueueCheckpoint* Arena::CreateMaybeMessage<::XuMQ::QueueCheckpoint>(Arena*);
+template<> ::XuMQ::QueueCheckpoint_Entry* Arena::CreateMaybeMessage<::XuMQ::QueueCheckpoint_Entry>(Arena*);
+template<> ::XuMQ::QueueCheckpoint_SegmentInfo* Arena::CreateMaybeMessage<::XuMQ::QueueCheckpoint_SegmentInfo>(Arena*);
 PROTOBUF_NAMESPACE_CLOSE
 namespace XuMQ {
 
@@ -298,6 +314,170 @@ class BasicProperties final :
 };
 // -------------------------------------------------------------------
 
+class Message_Reference final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:XuMQ.Message.Reference) */ {
+ public:
+  inline Message_Reference() : Message_Reference(nullptr) {}
+  ~Message_Reference() override;
+  explicit PROTOBUF_CONSTEXPR Message_Reference(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  Message_Reference(const Message_Reference& from);
+  Message_Reference(Message_Reference&& from) noexcept
+    : Message_Reference() {
+    *this = ::std::move(from);
+  }
+
+  inline Message_Reference& operator=(const Message_Reference& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline Message_Reference& operator=(Message_Reference&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const Message_Reference& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const Message_Reference* internal_default_instance() {
+    return reinterpret_cast<const Message_Reference*>(
+               &_Message_Reference_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    1;
+
+  friend void swap(Message_Reference& a, Message_Reference& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(Message_Reference* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(Message_Reference* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  Message_Reference* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<Message_Reference>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const Message_Reference& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const Message_Reference& from) {
+    Message_Reference::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(Message_Reference* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "XuMQ.Message.Reference";
+  }
+  protected:
+  explicit Message_Reference(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kQueueFieldNumber = 1,
+    kSeqFieldNumber = 2,
+  };
+  // string queue = 1;
+  void clear_queue();
+  const std::string& queue() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_queue(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_queue();
+  PROTOBUF_NODISCARD std::string* release_queue();
+  void set_allocated_queue(std::string* queue);
+  private:
+  const std::string& _internal_queue() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_queue(const std::string& value);
+  std::string* _internal_mutable_queue();
+  public:
+
+  // uint64 seq = 2;
+  void clear_seq();
+  uint64_t seq() const;
+  void set_seq(uint64_t value);
+  private:
+  uint64_t _internal_seq() const;
+  void _internal_set_seq(uint64_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:XuMQ.Message.Reference)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr queue_;
+    uint64_t seq_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_msg_2eproto;
+};
+// -------------------------------------------------------------------
+
 class Message_Payload final :
     public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:XuMQ.Message.Payload) */ {
  public:
@@ -346,7 +526,7 @@ class Message_Payload final :
                &_Message_Payload_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    1;
+    2;
 
   friend void swap(Message_Payload& a, Message_Payload& b) {
     a.Swap(&b);
@@ -419,10 +599,31 @@ class Message_Payload final :
   // accessors -------------------------------------------------------
 
   enum : int {
+    kRefsFieldNumber = 6,
     kBodyFieldNumber = 2,
     kValidFieldNumber = 3,
+    kQueueFieldNumber = 5,
     kPropertiesFieldNumber = 1,
+    kSeqFieldNumber = 4,
   };
+  // repeated .XuMQ.Message.Reference refs = 6;
+  int refs_size() const;
+  private:
+  int _internal_refs_size() const;
+  public:
+  void clear_refs();
+  ::XuMQ::Message_Reference* mutable_refs(int index);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::XuMQ::Message_Reference >*
+      mutable_refs();
+  private:
+  const ::XuMQ::Message_Reference& _internal_refs(int index) const;
+  ::XuMQ::Message_Reference* _internal_add_refs();
+  public:
+  const ::XuMQ::Message_Reference& refs(int index) const;
+  ::XuMQ::Message_Reference* add_refs();
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::XuMQ::Message_Reference >&
+      refs() const;
+
   // string body = 2;
   void clear_body();
   const std::string& body() const;
@@ -451,6 +652,20 @@ class Message_Payload final :
   std::string* _internal_mutable_valid();
   public:
 
+  // string queue = 5;
+  void clear_queue();
+  const std::string& queue() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_queue(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_queue();
+  PROTOBUF_NODISCARD std::string* release_queue();
+  void set_allocated_queue(std::string* queue);
+  private:
+  const std::string& _internal_queue() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_queue(const std::string& value);
+  std::string* _internal_mutable_queue();
+  public:
+
   // .XuMQ.BasicProperties properties = 1;
   bool has_properties() const;
   private:
@@ -469,6 +684,15 @@ class Message_Payload final :
       ::XuMQ::BasicProperties* properties);
   ::XuMQ::BasicProperties* unsafe_arena_release_properties();
 
+  // uint64 seq = 4;
+  void clear_seq();
+  uint64_t seq() const;
+  void set_seq(uint64_t value);
+  private:
+  uint64_t _internal_seq() const;
+  void _internal_set_seq(uint64_t value);
+  public:
+
   // @@protoc_insertion_point(class_scope:XuMQ.Message.Payload)
  private:
   class _Internal;
@@ -477,9 +701,12 @@ class Message_Payload final :
   typedef void InternalArenaConstructable_;
   typedef void DestructorSkippable_;
   struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::XuMQ::Message_Reference > refs_;
     ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr body_;
     ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr valid_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr queue_;
     ::XuMQ::BasicProperties* properties_;
+    uint64_t seq_;
     mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
   };
   union { Impl_ _impl_; };
@@ -535,7 +762,7 @@ class Message final :
                &_Message_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    2;
+    3;
 
   friend void swap(Message& a, Message& b) {
     a.Swap(&b);
@@ -605,52 +832,642 @@ class Message final :
 
   // nested types ----------------------------------------------------
 
+  typedef Message_Reference Reference;
   typedef Message_Payload Payload;
 
   // accessors -------------------------------------------------------
 
   enum : int {
-    kPayloadFieldNumber = 1,
-    kOffsetFieldNumber = 2,
-    kLengthFieldNumber = 3,
+    kPayloadFieldNumber = 1,
+  };
+  // .XuMQ.Message.Payload payload = 1;
+  bool has_payload() const;
+  private:
+  bool _internal_has_payload() const;
+  public:
+  void clear_payload();
+  const ::XuMQ::Message_Payload& payload() const;
+  PROTOBUF_NODISCARD ::XuMQ::Message_Payload* release_payload();
+  ::XuMQ::Message_Payload* mutable_payload();
+  void set_allocated_payload(::XuMQ::Message_Payload* payload);
+  private:
+  const ::XuMQ::Message_Payload& _internal_payload() const;
+  ::XuMQ::Message_Payload* _internal_mutable_payload();
+  public:
+  void unsafe_arena_set_allocated_payload(
+      ::XuMQ::Message_Payload* payload);
+  ::XuMQ::Message_Payload* unsafe_arena_release_payload();
+
+  // @@protoc_insertion_point(class_scope:XuMQ.Message)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::XuMQ::Message_Payload* payload_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_msg_2eproto;
+};
+// -------------------------------------------------------------------
+
+class QueueCheckpoint_SegmentInfo final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:XuMQ.QueueCheckpoint.SegmentInfo) */ {
+ public:
+  inline QueueCheckpoint_SegmentInfo() : QueueCheckpoint_SegmentInfo(nullptr) {}
+  ~QueueCheckpoint_SegmentInfo() override;
+  explicit PROTOBUF_CONSTEXPR QueueCheckpoint_SegmentInfo(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  QueueCheckpoint_SegmentInfo(const QueueCheckpoint_SegmentInfo& from);
+  QueueCheckpoint_SegmentInfo(QueueCheckpoint_SegmentInfo&& from) noexcept
+    : QueueCheckpoint_SegmentInfo() {
+    *this = ::std::move(from);
+  }
+
+  inline QueueCheckpoint_SegmentInfo& operator=(const QueueCheckpoint_SegmentInfo& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline QueueCheckpoint_SegmentInfo& operator=(QueueCheckpoint_SegmentInfo&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const QueueCheckpoint_SegmentInfo& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const QueueCheckpoint_SegmentInfo* internal_default_instance() {
+    return reinterpret_cast<const QueueCheckpoint_SegmentInfo*>(
+               &_QueueCheckpoint_SegmentInfo_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    4;
+
+  friend void swap(QueueCheckpoint_SegmentInfo& a, QueueCheckpoint_SegmentInfo& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(QueueCheckpoint_SegmentInfo* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(QueueCheckpoint_SegmentInfo* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  QueueCheckpoint_SegmentInfo* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<QueueCheckpoint_SegmentInfo>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const QueueCheckpoint_SegmentInfo& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const QueueCheckpoint_SegmentInfo& from) {
+    QueueCheckpoint_SegmentInfo::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(QueueCheckpoint_SegmentInfo* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "XuMQ.QueueCheckpoint.SegmentInfo";
+  }
+  protected:
+  explicit QueueCheckpoint_SegmentInfo(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kInodeFieldNumber = 2,
+    kTotalFieldNumber = 3,
+    kMinSeqFieldNumber = 4,
+    kMaxSeqFieldNumber = 5,
+    kIdFieldNumber = 1,
+  };
+  // uint64 inode = 2;
+  void clear_inode();
+  uint64_t inode() const;
+  void set_inode(uint64_t value);
+  private:
+  uint64_t _internal_inode() const;
+  void _internal_set_inode(uint64_t value);
+  public:
+
+  // uint64 total = 3;
+  void clear_total();
+  uint64_t total() const;
+  void set_total(uint64_t value);
+  private:
+  uint64_t _internal_total() const;
+  void _internal_set_total(uint64_t value);
+  public:
+
+  // uint64 min_seq = 4;
+  void clear_min_seq();
+  uint64_t min_seq() const;
+  void set_min_seq(uint64_t value);
+  private:
+  uint64_t _internal_min_seq() const;
+  void _internal_set_min_seq(uint64_t value);
+  public:
+
+  // uint64 max_seq = 5;
+  void clear_max_seq();
+  uint64_t max_seq() const;
+  void set_max_seq(uint64_t value);
+  private:
+  uint64_t _internal_max_seq() const;
+  void _internal_set_max_seq(uint64_t value);
+  public:
+
+  // uint32 id = 1;
+  void clear_id();
+  uint32_t id() const;
+  void set_id(uint32_t value);
+  private:
+  uint32_t _internal_id() const;
+  void _internal_set_id(uint32_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:XuMQ.QueueCheckpoint.SegmentInfo)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    uint64_t inode_;
+    uint64_t total_;
+    uint64_t min_seq_;
+    uint64_t max_seq_;
+    uint32_t id_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_msg_2eproto;
+};
+// -------------------------------------------------------------------
+
+class QueueCheckpoint_Entry final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:XuMQ.QueueCheckpoint.Entry) */ {
+ public:
+  inline QueueCheckpoint_Entry() : QueueCheckpoint_Entry(nullptr) {}
+  ~QueueCheckpoint_Entry() override;
+  explicit PROTOBUF_CONSTEXPR QueueCheckpoint_Entry(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  QueueCheckpoint_Entry(const QueueCheckpoint_Entry& from);
+  QueueCheckpoint_Entry(QueueCheckpoint_Entry&& from) noexcept
+    : QueueCheckpoint_Entry() {
+    *this = ::std::move(from);
+  }
+
+  inline QueueCheckpoint_Entry& operator=(const QueueCheckpoint_Entry& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline QueueCheckpoint_Entry& operator=(QueueCheckpoint_Entry&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const QueueCheckpoint_Entry& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const QueueCheckpoint_Entry* internal_default_instance() {
+    return reinterpret_cast<const QueueCheckpoint_Entry*>(
+               &_QueueCheckpoint_Entry_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    5;
+
+  friend void swap(QueueCheckpoint_Entry& a, QueueCheckpoint_Entry& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(QueueCheckpoint_Entry* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(QueueCheckpoint_Entry* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  QueueCheckpoint_Entry* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<QueueCheckpoint_Entry>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const QueueCheckpoint_Entry& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const QueueCheckpoint_Entry& from) {
+    QueueCheckpoint_Entry::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(QueueCheckpoint_Entry* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "XuMQ.QueueCheckpoint.Entry";
+  }
+  protected:
+  explicit QueueCheckpoint_Entry(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kIdFieldNumber = 5,
+    kSeqFieldNumber = 1,
+    kOffsetFieldNumber = 3,
+    kSegmentFieldNumber = 2,
+    kLengthFieldNumber = 4,
+    kInnerFieldNumber = 6,
+  };
+  // string id = 5;
+  void clear_id();
+  const std::string& id() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_id(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_id();
+  PROTOBUF_NODISCARD std::string* release_id();
+  void set_allocated_id(std::string* id);
+  private:
+  const std::string& _internal_id() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_id(const std::string& value);
+  std::string* _internal_mutable_id();
+  public:
+
+  // uint64 seq = 1;
+  void clear_seq();
+  uint64_t seq() const;
+  void set_seq(uint64_t value);
+  private:
+  uint64_t _internal_seq() const;
+  void _internal_set_seq(uint64_t value);
+  public:
+
+  // uint64 offset = 3;
+  void clear_offset();
+  uint64_t offset() const;
+  void set_offset(uint64_t value);
+  private:
+  uint64_t _internal_offset() const;
+  void _internal_set_offset(uint64_t value);
+  public:
+
+  // uint32 segment = 2;
+  void clear_segment();
+  uint32_t segment() const;
+  void set_segment(uint32_t value);
+  private:
+  uint32_t _internal_segment() const;
+  void _internal_set_segment(uint32_t value);
+  public:
+
+  // uint32 length = 4;
+  void clear_length();
+  uint32_t length() const;
+  void set_length(uint32_t value);
+  private:
+  uint32_t _internal_length() const;
+  void _internal_set_length(uint32_t value);
+  public:
+
+  // uint32 inner = 6;
+  void clear_inner();
+  uint32_t inner() const;
+  void set_inner(uint32_t value);
+  private:
+  uint32_t _internal_inner() const;
+  void _internal_set_inner(uint32_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:XuMQ.QueueCheckpoint.Entry)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr id_;
+    uint64_t seq_;
+    uint64_t offset_;
+    uint32_t segment_;
+    uint32_t length_;
+    uint32_t inner_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_msg_2eproto;
+};
+// -------------------------------------------------------------------
+
+class QueueCheckpoint final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:XuMQ.QueueCheckpoint) */ {
+ public:
+  inline QueueCheckpoint() : QueueCheckpoint(nullptr) {}
+  ~QueueCheckpoint() override;
+  explicit PROTOBUF_CONSTEXPR QueueCheckpoint(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  QueueCheckpoint(const QueueCheckpoint& from);
+  QueueCheckpoint(QueueCheckpoint&& from) noexcept
+    : QueueCheckpoint() {
+    *this = ::std::move(from);
+  }
+
+  inline QueueCheckpoint& operator=(const QueueCheckpoint& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline QueueCheckpoint& operator=(QueueCheckpoint&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const QueueCheckpoint& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const QueueCheckpoint* internal_default_instance() {
+    return reinterpret_cast<const QueueCheckpoint*>(
+               &_QueueCheckpoint_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    6;
+
+  friend void swap(QueueCheckpoint& a, QueueCheckpoint& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(QueueCheckpoint* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(QueueCheckpoint* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  QueueCheckpoint* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<QueueCheckpoint>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const QueueCheckpoint& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const QueueCheckpoint& from) {
+    QueueCheckpoint::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(QueueCheckpoint* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "XuMQ.QueueCheckpoint";
+  }
+  protected:
+  explicit QueueCheckpoint(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  typedef QueueCheckpoint_SegmentInfo SegmentInfo;
+  typedef QueueCheckpoint_Entry Entry;
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kSegmentsFieldNumber = 4,
+    kEntriesFieldNumber = 5,
+    kTailFieldNumber = 2,
+    kSeqFieldNumber = 3,
+    kActiveFieldNumber = 1,
   };
-  // .XuMQ.Message.Payload payload = 1;
-  bool has_payload() const;
+  // repeated .XuMQ.QueueCheckpoint.SegmentInfo segments = 4;
+  int segments_size() const;
   private:
-  bool _internal_has_payload() const;
+  int _internal_segments_size() const;
   public:
-  void clear_payload();
-  const ::XuMQ::Message_Payload& payload() const;
-  PROTOBUF_NODISCARD ::XuMQ::Message_Payload* release_payload();
-  ::XuMQ::Message_Payload* mutable_payload();
-  void set_allocated_payload(::XuMQ::Message_Payload* payload);
+  void clear_segments();
+  ::XuMQ::QueueCheckpoint_SegmentInfo* mutable_segments(int index);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::XuMQ::QueueCheckpoint_SegmentInfo >*
+      mutable_segments();
   private:
-  const ::XuMQ::Message_Payload& _internal_payload() const;
-  ::XuMQ::Message_Payload* _internal_mutable_payload();
+  const ::XuMQ::QueueCheckpoint_SegmentInfo& _internal_segments(int index) const;
+  ::XuMQ::QueueCheckpoint_SegmentInfo* _internal_add_segments();
   public:
-  void unsafe_arena_set_allocated_payload(
-      ::XuMQ::Message_Payload* payload);
-  ::XuMQ::Message_Payload* unsafe_arena_release_payload();
+  const ::XuMQ::QueueCheckpoint_SegmentInfo& segments(int index) const;
+  ::XuMQ::QueueCheckpoint_SegmentInfo* add_segments();
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::XuMQ::QueueCheckpoint_SegmentInfo >&
+      segments() const;
 
-  // uint32 offset = 2;
-  void clear_offset();
-  uint32_t offset() const;
-  void set_offset(uint32_t value);
+  // repeated .XuMQ.QueueCheckpoint.Entry entries = 5;
+  int entries_size() const;
+  private:
+  int _internal_entries_size() const;
+  public:
+  void clear_entries();
+  ::XuMQ::QueueCheckpoint_Entry* mutable_entries(int index);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::XuMQ::QueueCheckpoint_Entry >*
+      mutable_entries();
+  private:
+  const ::XuMQ::QueueCheckpoint_Entry& _internal_entries(int index) const;
+  ::XuMQ::QueueCheckpoint_Entry* _internal_add_entries();
+  public:
+  const ::XuMQ::QueueCheckpoint_Entry& entries(int index) const;
+  ::XuMQ::QueueCheckpoint_Entry* add_entries();
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::XuMQ::QueueCheckpoint_Entry >&
+      entries() const;
+
+  // uint64 tail = 2;
+  void clear_tail();
+  uint64_t tail() const;
+  void set_tail(uint64_t value);
   private:
-  uint32_t _internal_offset() const;
-  void _internal_set_offset(uint32_t value);
+  uint64_t _internal_tail() const;
+  void _internal_set_tail(uint64_t value);
   public:
 
-  // uint32 length = 3;
-  void clear_length();
-  uint32_t length() const;
-  void set_length(uint32_t value);
+  // uint64 seq = 3;
+  void clear_seq();
+  uint64_t seq() const;
+  void set_seq(uint64_t value);
   private:
-  uint32_t _internal_length() const;
-  void _internal_set_length(uint32_t value);
+  uint64_t _internal_seq() const;
+  void _internal_set_seq(uint64_t value);
   public:
 
-  // @@protoc_insertion_point(class_scope:XuMQ.Message)
+  // uint32 active = 1;
+  void clear_active();
+  uint32_t active() const;
+  void set_active(uint32_t value);
+  private:
+  uint32_t _internal_active() const;
+  void _internal_set_active(uint32_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:XuMQ.QueueCheckpoint)
  private:
   class _Internal;
 
@@ -658,9 +1475,11 @@ class Message final :
   typedef void InternalArenaConstructable_;
   typedef void DestructorSkippable_;
   struct Impl_ {
-    ::XuMQ::Message_Payload* payload_;
-    uint32_t offset_;
-    uint32_t length_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::XuMQ::QueueCheckpoint_SegmentInfo > segments_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::XuMQ::QueueCheckpoint_Entry > entries_;
+    uint64_t tail_;
+    uint64_t seq_;
+    uint32_t active_;
     mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
   };
   union { Impl_ _impl_; };
@@ -799,6 +1618,80 @@ inline void BasicProperties::set_allocated_routing_key(std::string* routing_key)
 
 // -------------------------------------------------------------------
 
+// Message_Reference
+
+// string queue = 1;
+inline void Message_Reference::clear_queue() {
+  _impl_.queue_.ClearToEmpty();
+}
+inline const std::string& Message_Reference::queue() const {
+  // @@protoc_insertion_point(field_get:XuMQ.Message.Reference.queue)
+  return _internal_queue();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void Message_Reference::set_queue(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.queue_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:XuMQ.Message.Reference.queue)
+}
+inline std::string* Message_Reference::mutable_queue() {
+  std::string* _s = _internal_mutable_queue();
+  // @@protoc_insertion_point(field_mutable:XuMQ.Message.Reference.queue)
+  return _s;
+}
+inline const std::string& Message_Reference::_internal_queue() const {
+  return _impl_.queue_.Get();
+}
+inline void Message_Reference::_internal_set_queue(const std::string& value) {
+  
+  _impl_.queue_.Set(value, GetArenaForAllocation());
+}
+inline std::string* Message_Reference::_internal_mutable_queue() {
+  
+  return _impl_.queue_.Mutable(GetArenaForAllocation());
+}
+inline std::string* Message_Reference::release_queue() {
+  // @@protoc_insertion_point(field_release:XuMQ.Message.Reference.queue)
+  return _impl_.queue_.Release();
+}
+inline void Message_Reference::set_allocated_queue(std::string* queue) {
+  if (queue != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.queue_.SetAllocated(queue, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.queue_.IsDefault()) {
+    _impl_.queue_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:XuMQ.Message.Reference.queue)
+}
+
+// uint64 seq = 2;
+inline void Message_Reference::clear_seq() {
+  _impl_.seq_ = uint64_t{0u};
+}
+inline uint64_t Message_Reference::_internal_seq() const {
+  return _impl_.seq_;
+}
+inline uint64_t Message_Reference::seq() const {
+  // @@protoc_insertion_point(field_get:XuMQ.Message.Reference.seq)
+  return _internal_seq();
+}
+inline void Message_Reference::_internal_set_seq(uint64_t value) {
+  
+  _impl_.seq_ = value;
+}
+inline void Message_Reference::set_seq(uint64_t value) {
+  _internal_set_seq(value);
+  // @@protoc_insertion_point(field_set:XuMQ.Message.Reference.seq)
+}
+
+// -------------------------------------------------------------------
+
 // Message_Payload
 
 // .XuMQ.BasicProperties properties = 1;
@@ -991,6 +1884,116 @@ inline void Message_Payload::set_allocated_valid(std::string* valid) {
   // @@protoc_insertion_point(field_set_allocated:XuMQ.Message.Payload.valid)
 }
 
+// uint64 seq = 4;
+inline void Message_Payload::clear_seq() {
+  _impl_.seq_ = uint64_t{0u};
+}
+inline uint64_t Message_Payload::_internal_seq() const {
+  return _impl_.seq_;
+}
+inline uint64_t Message_Payload::seq() const {
+  // @@protoc_insertion_point(field_get:XuMQ.Message.Payload.seq)
+  return _internal_seq();
+}
+inline void Message_Payload::_internal_set_seq(uint64_t value) {
+  
+  _impl_.seq_ = value;
+}
+inline void Message_Payload::set_seq(uint64_t value) {
+  _internal_set_seq(value);
+  // @@protoc_insertion_point(field_set:XuMQ.Message.Payload.seq)
+}
+
+// string queue = 5;
+inline void Message_Payload::clear_queue() {
+  _impl_.queue_.ClearToEmpty();
+}
+inline const std::string& Message_Payload::queue() const {
+  // @@protoc_insertion_point(field_get:XuMQ.Message.Payload.queue)
+  return _internal_queue();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void Message_Payload::set_queue(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.queue_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:XuMQ.Message.Payload.queue)
+}
+inline std::string* Message_Payload::mutable_queue() {
+  std::string* _s = _internal_mutable_queue();
+  // @@protoc_insertion_point(field_mutable:XuMQ.Message.Payload.queue)
+  return _s;
+}
+inline const std::string& Message_Payload::_internal_queue() const {
+  return _impl_.queue_.Get();
+}
+inline void Message_Payload::_internal_set_queue(const std::string& value) {
+  
+  _impl_.queue_.Set(value, GetArenaForAllocation());
+}
+inline std::string* Message_Payload::_internal_mutable_queue() {
+  
+  return _impl_.queue_.Mutable(GetArenaForAllocation());
+}
+inline std::string* Message_Payload::release_queue() {
+  // @@protoc_insertion_point(field_release:XuMQ.Message.Payload.queue)
+  return _impl_.queue_.Release();
+}
+inline void Message_Payload::set_allocated_queue(std::string* queue) {
+  if (queue != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.queue_.SetAllocated(queue, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.queue_.IsDefault()) {
+    _impl_.queue_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:XuMQ.Message.Payload.queue)
+}
+
+// repeated .XuMQ.Message.Reference refs = 6;
+inline int Message_Payload::_internal_refs_size() const {
+  return _impl_.refs_.size();
+}
+inline int Message_Payload::refs_size() const {
+  return _internal_refs_size();
+}
+inline void Message_Payload::clear_refs() {
+  _impl_.refs_.Clear();
+}
+inline ::XuMQ::Message_Reference* Message_Payload::mutable_refs(int index) {
+  // @@protoc_insertion_point(field_mutable:XuMQ.Message.Payload.refs)
+  return _impl_.refs_.Mutable(index);
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::XuMQ::Message_Reference >*
+Message_Payload::mutable_refs() {
+  // @@protoc_insertion_point(field_mutable_list:XuMQ.Message.Payload.refs)
+  return &_impl_.refs_;
+}
+inline const ::XuMQ::Message_Reference& Message_Payload::_internal_refs(int index) const {
+  return _impl_.refs_.Get(index);
+}
+inline const ::XuMQ::Message_Reference& Message_Payload::refs(int index) const {
+  // @@protoc_insertion_point(field_get:XuMQ.Message.Payload.refs)
+  return _internal_refs(index);
+}
+inline ::XuMQ::Message_Reference* Message_Payload::_internal_add_refs() {
+  return _impl_.refs_.Add();
+}
+inline ::XuMQ::Message_Reference* Message_Payload::add_refs() {
+  ::XuMQ::Message_Reference* _add = _internal_add_refs();
+  // @@protoc_insertion_point(field_add:XuMQ.Message.Payload.refs)
+  return _add;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::XuMQ::Message_Reference >&
+Message_Payload::refs() const {
+  // @@protoc_insertion_point(field_list:XuMQ.Message.Payload.refs)
+  return _impl_.refs_;
+}
+
 // -------------------------------------------------------------------
 
 // Message
@@ -1085,44 +2088,406 @@ inline void Message::set_allocated_payload(::XuMQ::Message_Payload* payload) {
   // @@protoc_insertion_point(field_set_allocated:XuMQ.Message.payload)
 }
 
-// uint32 offset = 2;
-inline void Message::clear_offset() {
-  _impl_.offset_ = 0u;
+// -------------------------------------------------------------------
+
+// QueueCheckpoint_SegmentInfo
+
+// uint32 id = 1;
+inline void QueueCheckpoint_SegmentInfo::clear_id() {
+  _impl_.id_ = 0u;
+}
+inline uint32_t QueueCheckpoint_SegmentInfo::_internal_id() const {
+  return _impl_.id_;
+}
+inline uint32_t QueueCheckpoint_SegmentInfo::id() const {
+  // @@protoc_insertion_point(field_get:XuMQ.QueueCheckpoint.SegmentInfo.id)
+  return _internal_id();
+}
+inline void QueueCheckpoint_SegmentInfo::_internal_set_id(uint32_t value) {
+  
+  _impl_.id_ = value;
+}
+inline void QueueCheckpoint_SegmentInfo::set_id(uint32_t value) {
+  _internal_set_id(value);
+  // @@protoc_insertion_point(field_set:XuMQ.QueueCheckpoint.SegmentInfo.id)
+}
+
+// uint64 inode = 2;
+inline void QueueCheckpoint_SegmentInfo::clear_inode() {
+  _impl_.inode_ = uint64_t{0u};
+}
+inline uint64_t QueueCheckpoint_SegmentInfo::_internal_inode() const {
+  return _impl_.inode_;
+}
+inline uint64_t QueueCheckpoint_SegmentInfo::inode() const {
+  // @@protoc_insertion_point(field_get:XuMQ.QueueCheckpoint.SegmentInfo.inode)
+  return _internal_inode();
+}
+inline void QueueCheckpoint_SegmentInfo::_internal_set_inode(uint64_t value) {
+  
+  _impl_.inode_ = value;
+}
+inline void QueueCheckpoint_SegmentInfo::set_inode(uint64_t value) {
+  _internal_set_inode(value);
+  // @@protoc_insertion_point(field_set:XuMQ.QueueCheckpoint.SegmentInfo.inode)
+}
+
+// uint64 total = 3;
+inline void QueueCheckpoint_SegmentInfo::clear_total() {
+  _impl_.total_ = uint64_t{0u};
+}
+inline uint64_t QueueCheckpoint_SegmentInfo::_internal_total() const {
+  return _impl_.total_;
+}
+inline uint64_t QueueCheckpoint_SegmentInfo::total() const {
+  // @@protoc_insertion_point(field_get:XuMQ.QueueCheckpoint.SegmentInfo.total)
+  return _internal_total();
+}
+inline void QueueCheckpoint_SegmentInfo::_internal_set_total(uint64_t value) {
+  
+  _impl_.total_ = value;
+}
+inline void QueueCheckpoint_SegmentInfo::set_total(uint64_t value) {
+  _internal_set_total(value);
+  // @@protoc_insertion_point(field_set:XuMQ.QueueCheckpoint.SegmentInfo.total)
+}
+
+// uint64 min_seq = 4;
+inline void QueueCheckpoint_SegmentInfo::clear_min_seq() {
+  _impl_.min_seq_ = uint64_t{0u};
+}
+inline uint64_t QueueCheckpoint_SegmentInfo::_internal_min_seq() const {
+  return _impl_.min_seq_;
+}
+inline uint64_t QueueCheckpoint_SegmentInfo::min_seq() const {
+  // @@protoc_insertion_point(field_get:XuMQ.QueueCheckpoint.SegmentInfo.min_seq)
+  return _internal_min_seq();
+}
+inline void QueueCheckpoint_SegmentInfo::_internal_set_min_seq(uint64_t value) {
+  
+  _impl_.min_seq_ = value;
+}
+inline void QueueCheckpoint_SegmentInfo::set_min_seq(uint64_t value) {
+  _internal_set_min_seq(value);
+  // @@protoc_insertion_point(field_set:XuMQ.QueueCheckpoint.SegmentInfo.min_seq)
+}
+
+// uint64 max_seq = 5;
+inline void QueueCheckpoint_SegmentInfo::clear_max_seq() {
+  _impl_.max_seq_ = uint64_t{0u};
+}
+inline uint64_t QueueCheckpoint_SegmentInfo::_internal_max_seq() const {
+  return _impl_.max_seq_;
+}
+inline uint64_t QueueCheckpoint_SegmentInfo::max_seq() const {
+  // @@protoc_insertion_point(field_get:XuMQ.QueueCheckpoint.SegmentInfo.max_seq)
+  return _internal_max_seq();
+}
+inline void QueueCheckpoint_SegmentInfo::_internal_set_max_seq(uint64_t value) {
+  
+  _impl_.max_seq_ = value;
+}
+inline void QueueCheckpoint_SegmentInfo::set_max_seq(uint64_t value) {
+  _internal_set_max_seq(value);
+  // @@protoc_insertion_point(field_set:XuMQ.QueueCheckpoint.SegmentInfo.max_seq)
+}
+
+// -------------------------------------------------------------------
+
+// QueueCheckpoint_Entry
+
+// uint64 seq = 1;
+inline void QueueCheckpoint_Entry::clear_seq() {
+  _impl_.seq_ = uint64_t{0u};
+}
+inline uint64_t QueueCheckpoint_Entry::_internal_seq() const {
+  return _impl_.seq_;
+}
+inline uint64_t QueueCheckpoint_Entry::seq() const {
+  // @@protoc_insertion_point(field_get:XuMQ.QueueCheckpoint.Entry.seq)
+  return _internal_seq();
+}
+inline void QueueCheckpoint_Entry::_internal_set_seq(uint64_t value) {
+  
+  _impl_.seq_ = value;
+}
+inline void QueueCheckpoint_Entry::set_seq(uint64_t value) {
+  _internal_set_seq(value);
+  // @@protoc_insertion_point(field_set:XuMQ.QueueCheckpoint.Entry.seq)
+}
+
+// uint32 segment = 2;
+inline void QueueCheckpoint_Entry::clear_segment() {
+  _impl_.segment_ = 0u;
+}
+inline uint32_t QueueCheckpoint_Entry::_internal_segment() const {
+  return _impl_.segment_;
+}
+inline uint32_t QueueCheckpoint_Entry::segment() const {
+  // @@protoc_insertion_point(field_get:XuMQ.QueueCheckpoint.Entry.segment)
+  return _internal_segment();
+}
+inline void QueueCheckpoint_Entry::_internal_set_segment(uint32_t value) {
+  
+  _impl_.segment_ = value;
+}
+inline void QueueCheckpoint_Entry::set_segment(uint32_t value) {
+  _internal_set_segment(value);
+  // @@protoc_insertion_point(field_set:XuMQ.QueueCheckpoint.Entry.segment)
+}
+
+// uint64 offset = 3;
+inline void QueueCheckpoint_Entry::clear_offset() {
+  _impl_.offset_ = uint64_t{0u};
 }
-inline uint32_t Message::_internal_offset() const {
+inline uint64_t QueueCheckpoint_Entry::_internal_offset() const {
   return _impl_.offset_;
 }
-inline uint32_t Message::offset() const {
-  // @@protoc_insertion_point(field_get:XuMQ.Message.offset)
+inline uint64_t QueueCheckpoint_Entry::offset() const {
+  // @@protoc_insertion_point(field_get:XuMQ.QueueCheckpoint.Entry.offset)
   return _internal_offset();
 }
-inline void Message::_internal_set_offset(uint32_t value) {
+inline void QueueCheckpoint_Entry::_internal_set_offset(uint64_t value) {
   
   _impl_.offset_ = value;
 }
-inline void Message::set_offset(uint32_t value) {
+inline void QueueCheckpoint_Entry::set_offset(uint64_t value) {
   _internal_set_offset(value);
-  // @@protoc_insertion_point(field_set:XuMQ.Message.offset)
+  // @@protoc_insertion_point(field_set:XuMQ.QueueCheckpoint.Entry.offset)
 }
 
-// uint32 length = 3;
-inline void Message::clear_length() {
+// uint32 length = 4;
+inline void QueueCheckpoint_Entry::clear_length() {
   _impl_.length_ = 0u;
 }
-inline uint32_t Message::_internal_length() const {
+inline uint32_t QueueCheckpoint_Entry::_internal_length() const {
   return _impl_.length_;
 }
-inline uint32_t Message::length() const {
-  // @@protoc_insertion_point(field_get:XuMQ.Message.length)
+inline uint32_t QueueCheckpoint_Entry::length() const {
+  // @@protoc_insertion_point(field_get:XuMQ.QueueCheckpoint.Entry.length)
   return _internal_length();
 }
-inline void Message::_internal_set_length(uint32_t value) {
+inline void QueueCheckpoint_Entry::_internal_set_length(uint32_t value) {
   
   _impl_.length_ = value;
 }
-inline void Message::set_length(uint32_t value) {
+inline void QueueCheckpoint_Entry::set_length(uint32_t value) {
   _internal_set_length(value);
-  // @@protoc_insertion_point(field_set:XuMQ.Message.length)
+  // @@protoc_insertion_point(field_set:XuMQ.QueueCheckpoint.Entry.length)
+}
+
+// string id = 5;
+inline void QueueCheckpoint_Entry::clear_id() {
+  _impl_.id_.ClearToEmpty();
+}
+inline const std::string& QueueCheckpoint_Entry::id() const {
+  // @@protoc_insertion_point(field_get:XuMQ.QueueCheckpoint.Entry.id)
+  return _internal_id();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void QueueCheckpoint_Entry::set_id(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.id_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:XuMQ.QueueCheckpoint.Entry.id)
+}
+inline std::string* QueueCheckpoint_Entry::mutable_id() {
+  std::string* _s = _internal_mutable_id();
+  // @@protoc_insertion_point(field_mutable:XuMQ.QueueCheckpoint.Entry.id)
+  return _s;
+}
+inline const std::string& QueueCheckpoint_Entry::_internal_id() const {
+  return _impl_.id_.Get();
+}
+inline void QueueCheckpoint_Entry::_internal_set_id(const std::string& value) {
+  
+  _impl_.id_.Set(value, GetArenaForAllocation());
+}
+inline std::string* QueueCheckpoint_Entry::_internal_mutable_id() {
+  
+  return _impl_.id_.Mutable(GetArenaForAllocation());
+}
+inline std::string* QueueCheckpoint_Entry::release_id() {
+  // @@protoc_insertion_point(field_release:XuMQ.QueueCheckpoint.Entry.id)
+  return _impl_.id_.Release();
+}
+inline void QueueCheckpoint_Entry::set_allocated_id(std::string* id) {
+  if (id != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.id_.SetAllocated(id, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.id_.IsDefault()) {
+    _impl_.id_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:XuMQ.QueueCheckpoint.Entry.id)
+}
+
+// uint32 inner = 6;
+inline void QueueCheckpoint_Entry::clear_inner() {
+  _impl_.inner_ = 0u;
+}
+inline uint32_t QueueCheckpoint_Entry::_internal_inner() const {
+  return _impl_.inner_;
+}
+inline uint32_t QueueCheckpoint_Entry::inner() const {
+  // @@protoc_insertion_point(field_get:XuMQ.QueueCheckpoint.Entry.inner)
+  return _internal_inner();
+}
+inline void QueueCheckpoint_Entry::_internal_set_inner(uint32_t value) {
+  
+  _impl_.inner_ = value;
+}
+inline void QueueCheckpoint_Entry::set_inner(uint32_t value) {
+  _internal_set_inner(value);
+  // @@protoc_insertion_point(field_set:XuMQ.QueueCheckpoint.Entry.inner)
+}
+
+// -------------------------------------------------------------------
+
+// QueueCheckpoint
+
+// uint32 active = 1;
+inline void QueueCheckpoint::clear_active() {
+  _impl_.active_ = 0u;
+}
+inline uint32_t QueueCheckpoint::_internal_active() const {
+  return _impl_.active_;
+}
+inline uint32_t QueueCheckpoint::active() const {
+  // @@protoc_insertion_point(field_get:XuMQ.QueueCheckpoint.active)
+  return _internal_active();
+}
+inline void QueueCheckpoint::_internal_set_active(uint32_t value) {
+  
+  _impl_.active_ = value;
+}
+inline void QueueCheckpoint::set_active(uint32_t value) {
+  _internal_set_active(value);
+  // @@protoc_insertion_point(field_set:XuMQ.QueueCheckpoint.active)
+}
+
+// uint64 tail = 2;
+inline void QueueCheckpoint::clear_tail() {
+  _impl_.tail_ = uint64_t{0u};
+}
+inline uint64_t QueueCheckpoint::_internal_tail() const {
+  return _impl_.tail_;
+}
+inline uint64_t QueueCheckpoint::tail() const {
+  // @@protoc_insertion_point(field_get:XuMQ.QueueCheckpoint.tail)
+  return _internal_tail();
+}
+inline void QueueCheckpoint::_internal_set_tail(uint64_t value) {
+  
+  _impl_.tail_ = value;
+}
+inline void QueueCheckpoint::set_tail(uint64_t value) {
+  _internal_set_tail(value);
+  // @@protoc_insertion_point(field_set:XuMQ.QueueCheckpoint.tail)
+}
+
+// uint64 seq = 3;
+inline void QueueCheckpoint::clear_seq() {
+  _impl_.seq_ = uint64_t{0u};
+}
+inline uint64_t QueueCheckpoint::_internal_seq() const {
+  return _impl_.seq_;
+}
+inline uint64_t QueueCheckpoint::seq() const {
+  // @@protoc_insertion_point(field_get:XuMQ.QueueCheckpoint.seq)
+  return _internal_seq();
+}
+inline void QueueCheckpoint::_internal_set_seq(uint64_t value) {
+  
+  _impl_.seq_ = value;
+}
+inline void QueueCheckpoint::set_seq(uint64_t value) {
+  _internal_set_seq(value);
+  // @@protoc_insertion_point(field_set:XuMQ.QueueCheckpoint.seq)
+}
+
+// repeated .XuMQ.QueueCheckpoint.SegmentInfo segments = 4;
+inline int QueueCheckpoint::_internal_segments_size() const {
+  return _impl_.segments_.size();
+}
+inline int QueueCheckpoint::segments_size() const {
+  return _internal_segments_size();
+}
+inline void QueueCheckpoint::clear_segments() {
+  _impl_.segments_.Clear();
+}
+inline ::XuMQ::QueueCheckpoint_SegmentInfo* QueueCheckpoint::mutable_segments(int index) {
+  // @@protoc_insertion_point(field_mutable:XuMQ.QueueCheckpoint.segments)
+  return _impl_.segments_.Mutable(index);
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::XuMQ::QueueCheckpoint_SegmentInfo >*
+QueueCheckpoint::mutable_segments() {
+  // @@protoc_insertion_point(field_mutable_list:XuMQ.QueueCheckpoint.segments)
+  return &_impl_.segments_;
+}
+inline const ::XuMQ::QueueCheckpoint_SegmentInfo& QueueCheckpoint::_internal_segments(int index) const {
+  return _impl_.segments_.Get(index);
+}
+inline const ::XuMQ::QueueCheckpoint_SegmentInfo& QueueCheckpoint::segments(int index) const {
+  // @@protoc_insertion_point(field_get:XuMQ.QueueCheckpoint.segments)
+  return _internal_segments(index);
+}
+inline ::XuMQ::QueueCheckpoint_SegmentInfo* QueueCheckpoint::_internal_add_segments() {
+  return _impl_.segments_.Add();
+}
+inline ::XuMQ::QueueCheckpoint_SegmentInfo* QueueCheckpoint::add_segments() {
+  ::XuMQ::QueueCheckpoint_SegmentInfo* _add = _internal_add_segments();
+  // @@protoc_insertion_point(field_add:XuMQ.QueueCheckpoint.segments)
+  return _add;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::XuMQ::QueueCheckpoint_SegmentInfo >&
+QueueCheckpoint::segments() const {
+  // @@protoc_insertion_point(field_list:XuMQ.QueueCheckpoint.segments)
+  return _impl_.segments_;
+}
+
+// repeated .XuMQ.QueueCheckpoint.Entry entries = 5;
+inline int QueueCheckpoint::_internal_entries_size() const {
+  return _impl_.entries_.size();
+}
+inline int QueueCheckpoint::entries_size() const {
+  return _internal_entries_size();
+}
+inline void QueueCheckpoint::clear_entries() {
+  _impl_.entries_.Clear();
+}
+inline ::XuMQ::QueueCheckpoint_Entry* QueueCheckpoint::mutable_entries(int index) {
+  // @@protoc_insertion_point(field_mutable:XuMQ.QueueCheckpoint.entries)
+  return _impl_.entries_.Mutable(index);
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::XuMQ::QueueCheckpoint_Entry >*
+QueueCheckpoint::mutable_entries() {
+  // @@protoc_insertion_point(field_mutable_list:XuMQ.QueueCheckpoint.entries)
+  return &_impl_.entries_;
+}
+inline const ::XuMQ::QueueCheckpoint_Entry& QueueCheckpoint::_internal_entries(int index) const {
+  return _impl_.entries_.Get(index);
+}
+inline const ::XuMQ::QueueCheckpoint_Entry& QueueCheckpoint::entries(int index) const {
+  // @@protoc_insertion_point(field_get:XuMQ.QueueCheckpoint.entries)
+  return _internal_entries(index);
+}
+inline ::XuMQ::QueueCheckpoint_Entry* QueueCheckpoint::_internal_add_entries() {
+  return _impl_.entries_.Add();
+}
+inline ::XuMQ::QueueCheckpoint_Entry* QueueCheckpoint::add_entries() {
+  ::XuMQ::QueueCheckpoint_Entry* _add = _internal_add_entries();
+  // @@protoc_insertion_point(field_add:XuMQ.QueueCheckpoint.entries)
+  return _add;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::XuMQ::QueueCheckpoint_Entry >&
+QueueCheckpoint::entries() const {
+  // @@protoc_insertion_point(field_list:XuMQ.QueueCheckpoint.entries)
+  return _impl_.entries_;
 }
 
 #ifdef __GNUC__
@@ -1132,6 +2497,14 @@ inline void Message::set_length(uint32_t value) {
 
 // -------------------------------------------------------------------
 
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
 
 // @@protoc_insertion_point(namespace_scope)
 
@@ -139,6 +139,21 @@ struct deleteQueueRequestDefaultTypeInternal {
   };
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 deleteQueueRequestDefaultTypeInternal _deleteQueueRequest_default_instance_;
+PROTOBUF_CONSTEXPR queuePurgeRequest::queuePurgeRequest(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.rid_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.cid_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.queue_name_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct queuePurgeRequestDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR queuePurgeRequestDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~queuePurgeRequestDefaultTypeInternal() {}
+  union {
+    queuePurgeRequest _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 queuePurgeRequestDefaultTypeInternal _queuePurgeRequest_default_instance_;
 PROTOBUF_CONSTEXPR queueBindRequest::queueBindRequest(
     ::_pbi::ConstantInitialized): _impl_{
     /*decltype(_impl_.rid_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
@@ -194,7 +209,7 @@ PROTOBUF_CONSTEXPR basicAckRequest::basicAckRequest(
     /*decltype(_impl_.rid_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
   , /*decltype(_impl_.cid_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
   , /*decltype(_impl_.queue_name_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
-  , /*decltype(_impl_.msg_id_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.delivery_tag_)*/uint64_t{0u}
   , /*decltype(_impl_._cached_size_)*/{}} {}
 struct basicAckRequestDefaultTypeInternal {
   PROTOBUF_CONSTEXPR basicAckRequestDefaultTypeInternal()
@@ -244,6 +259,7 @@ PROTOBUF_CONSTEXPR basicConsumeResponse::basicConsumeResponse(
   , /*decltype(_impl_.consumer_tag_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
   , /*decltype(_impl_.body_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
   , /*decltype(_impl_.properties_)*/nullptr
+  , /*decltype(_impl_.delivery_tag_)*/uint64_t{0u}
   , /*decltype(_impl_._cached_size_)*/{}} {}
 struct basicConsumeResponseDefaultTypeInternal {
   PROTOBUF_CONSTEXPR basicConsumeResponseDefaultTypeInternal()
@@ -270,7 +286,7 @@ struct basicResponseDefaultTypeInternal {
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 basicResponseDefaultTypeInternal _basicResponse_default_instance_;
 }  // namespace XuMQ
-static ::_pb::Metadata file_level_metadata_protocol_2eproto[16];
+static ::_pb::Metadata file_level_metadata_protocol_2eproto[17];
 static constexpr ::_pb::EnumDescriptor const** file_level_enum_descriptors_protocol_2eproto = nullptr;
 static constexpr ::_pb::ServiceDescriptor const** file_level_service_descriptors_protocol_2eproto = nullptr;
 
@@ -356,6 +372,15 @@ const uint32_t TableStruct_protocol_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE
   PROTOBUF_FIELD_OFFSET(::XuMQ::deleteQueueRequest, _impl_.cid_),
   PROTOBUF_FIELD_OFFSET(::XuMQ::deleteQueueRequest, _impl_.queue_name_),
   ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::XuMQ::queuePurgeRequest, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::XuMQ::queuePurgeRequest, _impl_.rid_),
+  PROTOBUF_FIELD_OFFSET(::XuMQ::queuePurgeRequest, _impl_.cid_),
+  PROTOBUF_FIELD_OFFSET(::XuMQ::queuePurgeRequest, _impl_.queue_name_),
+  ~0u,  // no _has_bits_
   PROTOBUF_FIELD_OFFSET(::XuMQ::queueBindRequest, _internal_metadata_),
   ~0u,  // no _extensions_
   ~0u,  // no _oneof_case_
@@ -396,7 +421,7 @@ const uint32_t TableStruct_protocol_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE
   PROTOBUF_FIELD_OFFSET(::XuMQ::basicAckRequest, _impl_.rid_),
   PROTOBUF_FIELD_OFFSET(::XuMQ::basicAckRequest, _impl_.cid_),
   PROTOBUF_FIELD_OFFSET(::XuMQ::basicAckRequest, _impl_.queue_name_),
-  PROTOBUF_FIELD_OFFSET(::XuMQ::basicAckRequest, _impl_.msg_id_),
+  PROTOBUF_FIELD_OFFSET(::XuMQ::basicAckRequest, _impl_.delivery_tag_),
   ~0u,  // no _has_bits_
   PROTOBUF_FIELD_OFFSET(::XuMQ::basicConsumeRequest, _internal_metadata_),
   ~0u,  // no _extensions_
@@ -428,6 +453,7 @@ const uint32_t TableStruct_protocol_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE
   PROTOBUF_FIELD_OFFSET(::XuMQ::basicConsumeResponse, _impl_.consumer_tag_),
   PROTOBUF_FIELD_OFFSET(::XuMQ::basicConsumeResponse, _impl_.body_),
   PROTOBUF_FIELD_OFFSET(::XuMQ::basicConsumeResponse, _impl_.properties_),
+  PROTOBUF_FIELD_OFFSET(::XuMQ::basicConsumeResponse, _impl_.delivery_tag_),
   ~0u,  // no _has_bits_
   PROTOBUF_FIELD_OFFSET(::XuMQ::basicResponse, _internal_metadata_),
   ~0u,  // no _extensions_
@@ -447,14 +473,15 @@ static const ::_pbi::MigrationSchema schemas[] PROTOBUF_SECTION_VARIABLE(protode
   { 48, 56, -1, sizeof(::XuMQ::declareQueueRequest_ArgsEntry_DoNotUse)},
   { 58, -1, -1, sizeof(::XuMQ::declareQueueRequest)},
   { 71, -1, -1, sizeof(::XuMQ::deleteQueueRequest)},
-  { 80, -1, -1, sizeof(::XuMQ::queueBindRequest)},
-  { 91, -1, -1, sizeof(::XuMQ::queueUnBindRequest)},
-  { 101, -1, -1, sizeof(::XuMQ::basicPublishRequest)},
-  { 112, -1, -1, sizeof(::XuMQ::basicAckRequest)},
-  { 122, -1, -1, sizeof(::XuMQ::basicConsumeRequest)},
-  { 133, -1, -1, sizeof(::XuMQ::basicCancelRequest)},
-  { 143, -1, -1, sizeof(::XuMQ::basicConsumeResponse)},
-  { 153, -1, -1, sizeof(::XuMQ::basicResponse)},
+  { 80, -1, -1, sizeof(::XuMQ::queuePurgeRequest)},
+  { 89, -1, -1, sizeof(::XuMQ::queueBindRequest)},
+  { 100, -1, -1, sizeof(::XuMQ::queueUnBindRequest)},
+  { 110, -1, -1, sizeof(::XuMQ::basicPublishRequest)},
+  { 121, -1, -1, sizeof(::XuMQ::basicAckRequest)},
+  { 131, -1, -1, sizeof(::XuMQ::basicConsumeRequest)},
+  { 142, -1, -1, sizeof(::XuMQ::basicCancelRequest)},
+  { 152, -1, -1, sizeof(::XuMQ::basicConsumeResponse)},
+  { 163, -1, -1, sizeof(::XuMQ::basicResponse)},
 };
 
 static const ::_pb::Message* const file_default_instances[] = {
@@ -466,6 +493,7 @@ static const ::_pb::Message* const file_default_instances[] = {
   &::XuMQ::_declareQueueRequest_ArgsEntry_DoNotUse_default_instance_._instance,
   &::XuMQ::_declareQueueRequest_default_instance_._instance,
   &::XuMQ::_deleteQueueRequest_default_instance_._instance,
+  &::XuMQ::_queuePurgeRequest_default_instance_._instance,
   &::XuMQ::_queueBindRequest_default_instance_._instance,
   &::XuMQ::_queueUnBindRequest_default_instance_._instance,
   &::XuMQ::_basicPublishRequest_default_instance_._instance,
@@ -495,36 +523,39 @@ const char descriptor_table_protodef_protocol_2eproto[] PROTOBUF_SECTION_VARIABL
   "\0132#.XuMQ.declareQueueRequest.ArgsEntry\032+"
   "\n\tArgsEntry\022\013\n\003key\030\001 \001(\t\022\r\n\005value\030\002 \001(\t:"
   "\0028\001\"B\n\022deleteQueueRequest\022\013\n\003rid\030\001 \001(\t\022\013"
-  "\n\003cid\030\002 \001(\t\022\022\n\nqueue_name\030\003 \001(\t\"l\n\020queue"
-  "BindRequest\022\013\n\003rid\030\001 \001(\t\022\013\n\003cid\030\002 \001(\t\022\025\n"
-  "\rexchange_name\030\003 \001(\t\022\022\n\nqueue_name\030\004 \001(\t"
-  "\022\023\n\013binding_key\030\005 \001(\t\"Y\n\022queueUnBindRequ"
-  "est\022\013\n\003rid\030\001 \001(\t\022\013\n\003cid\030\002 \001(\t\022\025\n\rexchang"
-  "e_name\030\003 \001(\t\022\022\n\nqueue_name\030\004 \001(\t\"\177\n\023basi"
-  "cPublishRequest\022\013\n\003rid\030\001 \001(\t\022\013\n\003cid\030\002 \001("
-  "\t\022\025\n\rexchange_name\030\003 \001(\t\022\014\n\004body\030\004 \001(\t\022)"
-  "\n\nproperties\030\005 \001(\0132\025.XuMQ.BasicPropertie"
-  "s\"O\n\017basicAckRequest\022\013\n\003rid\030\001 \001(\t\022\013\n\003cid"
-  "\030\002 \001(\t\022\022\n\nqueue_name\030\003 \001(\t\022\016\n\006msg_id\030\004 \001"
-  "(\t\"k\n\023basicConsumeRequest\022\013\n\003rid\030\001 \001(\t\022\013"
-  "\n\003cid\030\002 \001(\t\022\024\n\014consumer_tag\030\003 \001(\t\022\022\n\nque"
-  "ue_name\030\004 \001(\t\022\020\n\010auto_ack\030\005 \001(\010\"X\n\022basic"
-  "CancelRequest\022\013\n\003rid\030\001 \001(\t\022\013\n\003cid\030\002 \001(\t\022"
-  "\024\n\014consumer_tag\030\003 \001(\t\022\022\n\nqueue_name\030\004 \001("
-  "\t\"r\n\024basicConsumeResponse\022\013\n\003cid\030\001 \001(\t\022\024"
+  "\n\003cid\030\002 \001(\t\022\022\n\nqueue_name\030\003 \001(\t\"A\n\021queue"
+  "PurgeRequest\022\013\n\003rid\030\001 \001(\t\022\013\n\003cid\030\002 \001(\t\022\022"
+  "\n\nqueue_name\030\003 \001(\t\"l\n\020queueBindRequest\022\013"
+  "\n\003rid\030\001 \001(\t\022\013\n\003cid\030\002 \001(\t\022\025\n\rexchange_nam"
+  "e\030\003 \001(\t\022\022\n\nqueue_name\030\004 \001(\t\022\023\n\013binding_k"
+  "ey\030\005 \001(\t\"Y\n\022queueUnBindRequest\022\013\n\003rid\030\001 "
+  "\001(\t\022\013\n\003cid\030\002 \001(\t\022\025\n\rexchange_name\030\003 \001(\t\022"
+  "\022\n\nqueue_name\030\004 \001(\t\"\177\n\023basicPublishReque"
+  "st\022\013\n\003rid\030\001 \001(\t\022\013\n\003cid\030\002 \001(\t\022\025\n\rexchange"
+  "_name\030\003 \001(\t\022\014\n\004body\030\004 \001(\t\022)\n\nproperties\030"
+  "\005 \001(\0132\025.XuMQ.BasicProperties\"[\n\017basicAck"
+  "Request\022\013\n\003rid\030\001 \001(\t\022\013\n\003cid\030\002 \001(\t\022\022\n\nque"
+  "ue_name\030\003 \001(\t\022\024\n\014delivery_tag\030\005 \001(\004J\004\010\004\020"
+  "\005\"k\n\023basicConsumeRequest\022\013\n\003rid\030\001 \001(\t\022\013\n"
+  "\003cid\030\002 \001(\t\022\024\n\014consumer_tag\030\003 \001(\t\022\022\n\nqueu"
+  "e_name\030\004 \001(\t\022\020\n\010auto_ack\030\005 \001(\010\"X\n\022basicC"
+  "ancelRequest\022\013\n\003rid\030\001 \001(\t\022\013\n\003cid\030\002 \001(\t\022\024"
+  "\n\014consumer_tag\030\003 \001(\t\022\022\n\nqueue_name\030\004 \001(\t"
+  "\"\210\001\n\024basicConsumeResponse\022\013\n\003cid\030\001 \001(\t\022\024"
   "\n\014consumer_tag\030\002 \001(\t\022\014\n\004body\030\003 \001(\t\022)\n\npr"
-  "operties\030\004 \001(\0132\025.XuMQ.BasicProperties\"5\n"
-  "\rbasicResponse\022\013\n\003rid\030\001 \001(\t\022\013\n\003cid\030\002 \001(\t"
-  "\022\n\n\002ok\030\003 \001(\010b\006proto3"
+  "operties\030\004 \001(\0132\025.XuMQ.BasicProperties\022\024\n"
+  "\014delivery_tag\030\005 \001(\004\"5\n\rbasicResponse\022\013\n\003"
+  "rid\030\001 \001(\t\022\013\n\003cid\030\002 \001(\t\022\n\n\002ok\030\003 \001(\010b\006prot"
+  "o3"
   ;
 static const ::_pbi::DescriptorTable* const descriptor_table_protocol_2eproto_deps[1] = {
   &::descriptor_table_msg_2eproto,
 };
 static ::_pbi::once_flag descriptor_table_protocol_2eproto_once;
 const ::_pbi::DescriptorTable descriptor_table_protocol_2eproto = {
-    false, false, 1540, descriptor_table_protodef_protocol_2eproto,
+    false, false, 1642, descriptor_table_protodef_protocol_2eproto,
     "protocol.proto",
-    &descriptor_table_protocol_2eproto_once, descriptor_table_protocol_2eproto_deps, 1, 16,
+    &descriptor_table_protocol_2eproto_once, descriptor_table_protocol_2eproto_deps, 1, 17,
     schemas, file_default_instances, TableStruct_protocol_2eproto::offsets,
     file_level_metadata_protocol_2eproto, file_level_enum_descriptors_protocol_2eproto,
     file_level_service_descriptors_protocol_2eproto,
@@ -2592,6 +2623,309 @@ void deleteQueueRequest::InternalSwap(deleteQueueRequest* other) {
 
 // ===================================================================
 
+class queuePurgeRequest::_Internal {
+ public:
+};
+
+queuePurgeRequest::queuePurgeRequest(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:XuMQ.queuePurgeRequest)
+}
+queuePurgeRequest::queuePurgeRequest(const queuePurgeRequest& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  queuePurgeRequest* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.rid_){}
+    , decltype(_impl_.cid_){}
+    , decltype(_impl_.queue_name_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.rid_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.rid_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_rid().empty()) {
+    _this->_impl_.rid_.Set(from._internal_rid(), 
+      _this->GetArenaForAllocation());
+  }
+  _impl_.cid_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.cid_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_cid().empty()) {
+    _this->_impl_.cid_.Set(from._internal_cid(), 
+      _this->GetArenaForAllocation());
+  }
+  _impl_.queue_name_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.queue_name_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_queue_name().empty()) {
+    _this->_impl_.queue_name_.Set(from._internal_queue_name(), 
+      _this->GetArenaForAllocation());
+  }
+  // @@protoc_insertion_point(copy_constructor:XuMQ.queuePurgeRequest)
+}
+
+inline void queuePurgeRequest::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.rid_){}
+    , decltype(_impl_.cid_){}
+    , decltype(_impl_.queue_name_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.rid_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.rid_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  _impl_.cid_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.cid_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  _impl_.queue_name_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.queue_name_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+queuePurgeRequest::~queuePurgeRequest() {
+  // @@protoc_insertion_point(destructor:XuMQ.queuePurgeRequest)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void queuePurgeRequest::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.rid_.Destroy();
+  _impl_.cid_.Destroy();
+  _impl_.queue_name_.Destroy();
+}
+
+void queuePurgeRequest::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void queuePurgeRequest::Clear() {
+// @@protoc_insertion_point(message_clear_start:XuMQ.queuePurgeRequest)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.rid_.ClearToEmpty();
+  _impl_.cid_.ClearToEmpty();
+  _impl_.queue_name_.ClearToEmpty();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* queuePurgeRequest::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // string rid = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          auto str = _internal_mutable_rid();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "XuMQ.queuePurgeRequest.rid"));
+        } else
+          goto handle_unusual;
+        continue;
+      // string cid = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 18)) {
+          auto str = _internal_mutable_cid();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "XuMQ.queuePurgeRequest.cid"));
+        } else
+          goto handle_unusual;
+        continue;
+      // string queue_name = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 26)) {
+          auto str = _internal_mutable_queue_name();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "XuMQ.queuePurgeRequest.queue_name"));
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* queuePurgeRequest::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:XuMQ.queuePurgeRequest)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // string rid = 1;
+  if (!this->_internal_rid().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_rid().data(), static_cast<int>(this->_internal_rid().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "XuMQ.queuePurgeRequest.rid");
+    target = stream->WriteStringMaybeAliased(
+        1, this->_internal_rid(), target);
+  }
+
+  // string cid = 2;
+  if (!this->_internal_cid().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_cid().data(), static_cast<int>(this->_internal_cid().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "XuMQ.queuePurgeRequest.cid");
+    target = stream->WriteStringMaybeAliased(
+        2, this->_internal_cid(), target);
+  }
+
+  // string queue_name = 3;
+  if (!this->_internal_queue_name().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_queue_name().data(), static_cast<int>(this->_internal_queue_name().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "XuMQ.queuePurgeRequest.queue_name");
+    target = stream->WriteStringMaybeAliased(
+        3, this->_internal_queue_name(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:XuMQ.queuePurgeRequest)
+  return target;
+}
+
+size_t queuePurgeRequest::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:XuMQ.queuePurgeRequest)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // string rid = 1;
+  if (!this->_internal_rid().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_rid());
+  }
+
+  // string cid = 2;
+  if (!this->_internal_cid().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_cid());
+  }
+
+  // string queue_name = 3;
+  if (!this->_internal_queue_name().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_queue_name());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData queuePurgeRequest::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    queuePurgeRequest::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*queuePurgeRequest::GetClassData() const { return &_class_data_; }
+
+
+void queuePurgeRequest::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<queuePurgeRequest*>(&to_msg);
+  auto& from = static_cast<const queuePurgeRequest&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:XuMQ.queuePurgeRequest)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_rid().empty()) {
+    _this->_internal_set_rid(from._internal_rid());
+  }
+  if (!from._internal_cid().empty()) {
+    _this->_internal_set_cid(from._internal_cid());
+  }
+  if (!from._internal_queue_name().empty()) {
+    _this->_internal_set_queue_name(from._internal_queue_name());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void queuePurgeRequest::CopyFrom(const queuePurgeRequest& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:XuMQ.queuePurgeRequest)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool queuePurgeRequest::IsInitialized() const {
+  return true;
+}
+
+void queuePurgeRequest::InternalSwap(queuePurgeRequest* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.rid_, lhs_arena,
+      &other->_impl_.rid_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.cid_, lhs_arena,
+      &other->_impl_.cid_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.queue_name_, lhs_arena,
+      &other->_impl_.queue_name_, rhs_arena
+  );
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata queuePurgeRequest::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_protocol_2eproto_getter, &descriptor_table_protocol_2eproto_once,
+      file_level_metadata_protocol_2eproto[8]);
+}
+
+// ===================================================================
+
 class queueBindRequest::_Internal {
  public:
 };
@@ -2990,7 +3324,7 @@ void queueBindRequest::InternalSwap(queueBindRequest* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata queueBindRequest::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_protocol_2eproto_getter, &descriptor_table_protocol_2eproto_once,
-      file_level_metadata_protocol_2eproto[8]);
+      file_level_metadata_protocol_2eproto[9]);
 }
 
 // ===================================================================
@@ -3343,7 +3677,7 @@ void queueUnBindRequest::InternalSwap(queueUnBindRequest* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata queueUnBindRequest::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_protocol_2eproto_getter, &descriptor_table_protocol_2eproto_once,
-      file_level_metadata_protocol_2eproto[9]);
+      file_level_metadata_protocol_2eproto[10]);
 }
 
 // ===================================================================
@@ -3744,7 +4078,7 @@ void basicPublishRequest::InternalSwap(basicPublishRequest* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata basicPublishRequest::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_protocol_2eproto_getter, &descriptor_table_protocol_2eproto_once,
-      file_level_metadata_protocol_2eproto[10]);
+      file_level_metadata_protocol_2eproto[11]);
 }
 
 // ===================================================================
@@ -3766,7 +4100,7 @@ basicAckRequest::basicAckRequest(const basicAckRequest& from)
       decltype(_impl_.rid_){}
     , decltype(_impl_.cid_){}
     , decltype(_impl_.queue_name_){}
-    , decltype(_impl_.msg_id_){}
+    , decltype(_impl_.delivery_tag_){}
     , /*decltype(_impl_._cached_size_)*/{}};
 
   _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
@@ -3794,14 +4128,7 @@ basicAckRequest::basicAckRequest(const basicAckRequest& from)
     _this->_impl_.queue_name_.Set(from._internal_queue_name(), 
       _this->GetArenaForAllocation());
   }
-  _impl_.msg_id_.InitDefault();
-  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
-    _impl_.msg_id_.Set("", GetArenaForAllocation());
-  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
-  if (!from._internal_msg_id().empty()) {
-    _this->_impl_.msg_id_.Set(from._internal_msg_id(), 
-      _this->GetArenaForAllocation());
-  }
+  _this->_impl_.delivery_tag_ = from._impl_.delivery_tag_;
   // @@protoc_insertion_point(copy_constructor:XuMQ.basicAckRequest)
 }
 
@@ -3813,7 +4140,7 @@ inline void basicAckRequest::SharedCtor(
       decltype(_impl_.rid_){}
     , decltype(_impl_.cid_){}
     , decltype(_impl_.queue_name_){}
-    , decltype(_impl_.msg_id_){}
+    , decltype(_impl_.delivery_tag_){uint64_t{0u}}
     , /*decltype(_impl_._cached_size_)*/{}
   };
   _impl_.rid_.InitDefault();
@@ -3828,10 +4155,6 @@ inline void basicAckRequest::SharedCtor(
   #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
     _impl_.queue_name_.Set("", GetArenaForAllocation());
   #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
-  _impl_.msg_id_.InitDefault();
-  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
-    _impl_.msg_id_.Set("", GetArenaForAllocation());
-  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
 }
 
 basicAckRequest::~basicAckRequest() {
@@ -3848,7 +4171,6 @@ inline void basicAckRequest::SharedDtor() {
   _impl_.rid_.Destroy();
   _impl_.cid_.Destroy();
   _impl_.queue_name_.Destroy();
-  _impl_.msg_id_.Destroy();
 }
 
 void basicAckRequest::SetCachedSize(int size) const {
@@ -3864,7 +4186,7 @@ void basicAckRequest::Clear() {
   _impl_.rid_.ClearToEmpty();
   _impl_.cid_.ClearToEmpty();
   _impl_.queue_name_.ClearToEmpty();
-  _impl_.msg_id_.ClearToEmpty();
+  _impl_.delivery_tag_ = uint64_t{0u};
   _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
 }
 
@@ -3904,13 +4226,11 @@ const char* basicAckRequest::_InternalParse(const char* ptr, ::_pbi::ParseContex
         } else
           goto handle_unusual;
         continue;
-      // string msg_id = 4;
-      case 4:
-        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 34)) {
-          auto str = _internal_mutable_msg_id();
-          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+      // uint64 delivery_tag = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 40)) {
+          _impl_.delivery_tag_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
           CHK_(ptr);
-          CHK_(::_pbi::VerifyUTF8(str, "XuMQ.basicAckRequest.msg_id"));
         } else
           goto handle_unusual;
         continue;
@@ -3973,14 +4293,10 @@ uint8_t* basicAckRequest::_InternalSerialize(
         3, this->_internal_queue_name(), target);
   }
 
-  // string msg_id = 4;
-  if (!this->_internal_msg_id().empty()) {
-    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
-      this->_internal_msg_id().data(), static_cast<int>(this->_internal_msg_id().length()),
-      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
-      "XuMQ.basicAckRequest.msg_id");
-    target = stream->WriteStringMaybeAliased(
-        4, this->_internal_msg_id(), target);
+  // uint64 delivery_tag = 5;
+  if (this->_internal_delivery_tag() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(5, this->_internal_delivery_tag(), target);
   }
 
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
@@ -4020,11 +4336,9 @@ size_t basicAckRequest::ByteSizeLong() const {
         this->_internal_queue_name());
   }
 
-  // string msg_id = 4;
-  if (!this->_internal_msg_id().empty()) {
-    total_size += 1 +
-      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
-        this->_internal_msg_id());
+  // uint64 delivery_tag = 5;
+  if (this->_internal_delivery_tag() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_delivery_tag());
   }
 
   return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
@@ -4054,8 +4368,8 @@ void basicAckRequest::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const
   if (!from._internal_queue_name().empty()) {
     _this->_internal_set_queue_name(from._internal_queue_name());
   }
-  if (!from._internal_msg_id().empty()) {
-    _this->_internal_set_msg_id(from._internal_msg_id());
+  if (from._internal_delivery_tag() != 0) {
+    _this->_internal_set_delivery_tag(from._internal_delivery_tag());
   }
   _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
 }
@@ -4088,16 +4402,13 @@ void basicAckRequest::InternalSwap(basicAckRequest* other) {
       &_impl_.queue_name_, lhs_arena,
       &other->_impl_.queue_name_, rhs_arena
   );
-  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
-      &_impl_.msg_id_, lhs_arena,
-      &other->_impl_.msg_id_, rhs_arena
-  );
+  swap(_impl_.delivery_tag_, other->_impl_.delivery_tag_);
 }
 
 ::PROTOBUF_NAMESPACE_ID::Metadata basicAckRequest::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_protocol_2eproto_getter, &descriptor_table_protocol_2eproto_once,
-      file_level_metadata_protocol_2eproto[11]);
+      file_level_metadata_protocol_2eproto[12]);
 }
 
 // ===================================================================
@@ -4477,7 +4788,7 @@ void basicConsumeRequest::InternalSwap(basicConsumeRequest* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata basicConsumeRequest::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_protocol_2eproto_getter, &descriptor_table_protocol_2eproto_once,
-      file_level_metadata_protocol_2eproto[12]);
+      file_level_metadata_protocol_2eproto[13]);
 }
 
 // ===================================================================
@@ -4830,7 +5141,7 @@ void basicCancelRequest::InternalSwap(basicCancelRequest* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata basicCancelRequest::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_protocol_2eproto_getter, &descriptor_table_protocol_2eproto_once,
-      file_level_metadata_protocol_2eproto[13]);
+      file_level_metadata_protocol_2eproto[14]);
 }
 
 // ===================================================================
@@ -4864,6 +5175,7 @@ basicConsumeResponse::basicConsumeResponse(const basicConsumeResponse& from)
     , decltype(_impl_.consumer_tag_){}
     , decltype(_impl_.body_){}
     , decltype(_impl_.properties_){nullptr}
+    , decltype(_impl_.delivery_tag_){}
     , /*decltype(_impl_._cached_size_)*/{}};
 
   _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
@@ -4894,6 +5206,7 @@ basicConsumeResponse::basicConsumeResponse(const basicConsumeResponse& from)
   if (from._internal_has_properties()) {
     _this->_impl_.properties_ = new ::XuMQ::BasicProperties(*from._impl_.properties_);
   }
+  _this->_impl_.delivery_tag_ = from._impl_.delivery_tag_;
   // @@protoc_insertion_point(copy_constructor:XuMQ.basicConsumeResponse)
 }
 
@@ -4906,6 +5219,7 @@ inline void basicConsumeResponse::SharedCtor(
     , decltype(_impl_.consumer_tag_){}
     , decltype(_impl_.body_){}
     , decltype(_impl_.properties_){nullptr}
+    , decltype(_impl_.delivery_tag_){uint64_t{0u}}
     , /*decltype(_impl_._cached_size_)*/{}
   };
   _impl_.cid_.InitDefault();
@@ -4956,6 +5270,7 @@ void basicConsumeResponse::Clear() {
     delete _impl_.properties_;
   }
   _impl_.properties_ = nullptr;
+  _impl_.delivery_tag_ = uint64_t{0u};
   _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
 }
 
@@ -5003,6 +5318,14 @@ const char* basicConsumeResponse::_InternalParse(const char* ptr, ::_pbi::ParseC
         } else
           goto handle_unusual;
         continue;
+      // uint64 delivery_tag = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 40)) {
+          _impl_.delivery_tag_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -5069,6 +5392,12 @@ uint8_t* basicConsumeResponse::_InternalSerialize(
         _Internal::properties(this).GetCachedSize(), target, stream);
   }
 
+  // uint64 delivery_tag = 5;
+  if (this->_internal_delivery_tag() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(5, this->_internal_delivery_tag(), target);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
@@ -5113,6 +5442,11 @@ size_t basicConsumeResponse::ByteSizeLong() const {
         *_impl_.properties_);
   }
 
+  // uint64 delivery_tag = 5;
+  if (this->_internal_delivery_tag() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_delivery_tag());
+  }
+
   return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
 }
 
@@ -5144,6 +5478,9 @@ void basicConsumeResponse::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, c
     _this->_internal_mutable_properties()->::XuMQ::BasicProperties::MergeFrom(
         from._internal_properties());
   }
+  if (from._internal_delivery_tag() != 0) {
+    _this->_internal_set_delivery_tag(from._internal_delivery_tag());
+  }
   _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
 }
 
@@ -5175,13 +5512,18 @@ void basicConsumeResponse::InternalSwap(basicConsumeResponse* other) {
       &_impl_.body_, lhs_arena,
       &other->_impl_.body_, rhs_arena
   );
-  swap(_impl_.properties_, other->_impl_.properties_);
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(basicConsumeResponse, _impl_.delivery_tag_)
+      + sizeof(basicConsumeResponse::_impl_.delivery_tag_)
+      - PROTOBUF_FIELD_OFFSET(basicConsumeResponse, _impl_.properties_)>(
+          reinterpret_cast<char*>(&_impl_.properties_),
+          reinterpret_cast<char*>(&other->_impl_.properties_));
 }
 
 ::PROTOBUF_NAMESPACE_ID::Metadata basicConsumeResponse::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_protocol_2eproto_getter, &descriptor_table_protocol_2eproto_once,
-      file_level_metadata_protocol_2eproto[14]);
+      file_level_metadata_protocol_2eproto[15]);
 }
 
 // ===================================================================
@@ -5461,7 +5803,7 @@ void basicResponse::InternalSwap(basicResponse* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata basicResponse::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_protocol_2eproto_getter, &descriptor_table_protocol_2eproto_once,
-      file_level_metadata_protocol_2eproto[15]);
+      file_level_metadata_protocol_2eproto[16]);
 }
 
 // @@protoc_insertion_point(namespace_scope)
@@ -5499,6 +5841,10 @@ template<> PROTOBUF_NOINLINE ::XuMQ::deleteQueueRequest*
 Arena::CreateMaybeMessage< ::XuMQ::deleteQueueRequest >(Arena* arena) {
   return Arena::CreateMessageInternal< ::XuMQ::deleteQueueRequest >(arena);
 }
+template<> PROTOBUF_NOINLINE ::XuMQ::queuePurgeRequest*
+Arena::CreateMaybeMessage< ::XuMQ::queuePurgeRequest >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::XuMQ::queuePurgeRequest >(arena);
+}
 template<> PROTOBUF_NOINLINE ::XuMQ::queueBindRequest*
 Arena::CreateMaybeMessage< ::XuMQ::queueBindRequest >(Arena* arena) {
   return Arena::CreateMessageInternal< ::XuMQ::queueBindRequest >(arena);
@@ -94,6 +94,9 @@ extern openChannelRequestDefaultTypeInternal _openChannelRequest_default_instanc
 class queueBindRequest;
 struct queueBindRequestDefaultTypeInternal;
 extern queueBindRequestDefaultTypeInternal _queueBindRequest_default_instance_;
+class queuePurgeRequest;
+struct queuePurgeRequestDefaultTypeInternal;
+extern queuePurgeRequestDefaultTypeInternal _queuePurgeRequest_default_instance_;
 class queueUnBindRequest;
 struct queueUnBindRequestDefaultTypeInternal;
 extern queueUnBindRequestDefaultTypeInternal _queueUnBindRequest_default_instance_;
@@ -114,6 +117,7 @@ template<> ::XuMQ::deleteExchangeRequest* Arena::CreateMaybeMessage<::XuMQ::dele
 template<> ::XuMQ::deleteQueueRequest* Arena::CreateMaybeMessage<::XuMQ::deleteQueueRequest>(Arena*);
 template<> ::XuMQ::openChannelRequest* Arena::CreateMaybeMessage<::XuMQ::openChannelRequest>(Arena*);
 template<> ::XuMQ::queueBindRequest* Arena::CreateMaybeMessage<::XuMQ::queueBindRequest>(Arena*);
+template<> ::XuMQ::queuePurgeRequest* Arena::CreateMaybeMessage<::XuMQ::queuePurgeRequest>(Arena*);
 template<> ::XuMQ::queueUnBindRequest* Arena::CreateMaybeMessage<::XuMQ::queueUnBindRequest>(Arena*);
 PROTOBUF_NAMESPACE_CLOSE
 namespace XuMQ {
@@ -1372,6 +1376,191 @@ class deleteQueueRequest final :
 };
 // -------------------------------------------------------------------
 
+class queuePurgeRequest final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:XuMQ.queuePurgeRequest) */ {
+ public:
+  inline queuePurgeRequest() : queuePurgeRequest(nullptr) {}
+  ~queuePurgeRequest() override;
+  explicit PROTOBUF_CONSTEXPR queuePurgeRequest(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  queuePurgeRequest(const queuePurgeRequest& from);
+  queuePurgeRequest(queuePurgeRequest&& from) noexcept
+    : queuePurgeRequest() {
+    *this = ::std::move(from);
+  }
+
+  inline queuePurgeRequest& operator=(const queuePurgeRequest& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline queuePurgeRequest& operator=(queuePurgeRequest&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const queuePurgeRequest& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const queuePurgeRequest* internal_default_instance() {
+    return reinterpret_cast<const queuePurgeRequest*>(
+               &_queuePurgeRequest_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    8;
+
+  friend void swap(queuePurgeRequest& a, queuePurgeRequest& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(queuePurgeRequest* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(queuePurgeRequest* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  queuePurgeRequest* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<queuePurgeRequest>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const queuePurgeRequest& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const queuePurgeRequest& from) {
+    queuePurgeRequest::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(queuePurgeRequest* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "XuMQ.queuePurgeRequest";
+  }
+  protected:
+  explicit queuePurgeRequest(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kRidFieldNumber = 1,
+    kCidFieldNumber = 2,
+    kQueueNameFieldNumber = 3,
+  };
+  // string rid = 1;
+  void clear_rid();
+  const std::string& rid() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_rid(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_rid();
+  PROTOBUF_NODISCARD std::string* release_rid();
+  void set_allocated_rid(std::string* rid);
+  private:
+  const std::string& _internal_rid() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_rid(const std::string& value);
+  std::string* _internal_mutable_rid();
+  public:
+
+  // string cid = 2;
+  void clear_cid();
+  const std::string& cid() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_cid(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_cid();
+  PROTOBUF_NODISCARD std::string* release_cid();
+  void set_allocated_cid(std::string* cid);
+  private:
+  const std::string& _internal_cid() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_cid(const std::string& value);
+  std::string* _internal_mutable_cid();
+  public:
+
+  // string queue_name = 3;
+  void clear_queue_name();
+  const std::string& queue_name() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_queue_name(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_queue_name();
+  PROTOBUF_NODISCARD std::string* release_queue_name();
+  void set_allocated_queue_name(std::string* queue_name);
+  private:
+  const std::string& _internal_queue_name() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_queue_name(const std::string& value);
+  std::string* _internal_mutable_queue_name();
+  public:
+
+  // @@protoc_insertion_point(class_scope:XuMQ.queuePurgeRequest)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr rid_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr cid_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr queue_name_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_protocol_2eproto;
+};
+// -------------------------------------------------------------------
+
 class queueBindRequest final :
     public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:XuMQ.queueBindRequest) */ {
  public:
@@ -1420,7 +1609,7 @@ class queueBindRequest final :
                &_queueBindRequest_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    8;
+    9;
 
   friend void swap(queueBindRequest& a, queueBindRequest& b) {
     a.Swap(&b);
@@ -1637,7 +1826,7 @@ class queueUnBindRequest final :
                &_queueUnBindRequest_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    9;
+    10;
 
   friend void swap(queueUnBindRequest& a, queueUnBindRequest& b) {
     a.Swap(&b);
@@ -1838,7 +2027,7 @@ class basicPublishRequest final :
                &_basicPublishRequest_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    10;
+    11;
 
   friend void swap(basicPublishRequest& a, basicPublishRequest& b) {
     a.Swap(&b);
@@ -2059,7 +2248,7 @@ class basicAckRequest final :
                &_basicAckRequest_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    11;
+    12;
 
   friend void swap(basicAckRequest& a, basicAckRequest& b) {
     a.Swap(&b);
@@ -2135,7 +2324,7 @@ class basicAckRequest final :
     kRidFieldNumber = 1,
     kCidFieldNumber = 2,
     kQueueNameFieldNumber = 3,
-    kMsgIdFieldNumber = 4,
+    kDeliveryTagFieldNumber = 5,
   };
   // string rid = 1;
   void clear_rid();
@@ -2179,18 +2368,13 @@ class basicAckRequest final :
   std::string* _internal_mutable_queue_name();
   public:
 
-  // string msg_id = 4;
-  void clear_msg_id();
-  const std::string& msg_id() const;
-  template <typename ArgT0 = const std::string&, typename... ArgT>
-  void set_msg_id(ArgT0&& arg0, ArgT... args);
-  std::string* mutable_msg_id();
-  PROTOBUF_NODISCARD std::string* release_msg_id();
-  void set_allocated_msg_id(std::string* msg_id);
+  // uint64 delivery_tag = 5;
+  void clear_delivery_tag();
+  uint64_t delivery_tag() const;
+  void set_delivery_tag(uint64_t value);
   private:
-  const std::string& _internal_msg_id() const;
-  inline PROTOBUF_ALWAYS_INLINE void _internal_set_msg_id(const std::string& value);
-  std::string* _internal_mutable_msg_id();
+  uint64_t _internal_delivery_tag() const;
+  void _internal_set_delivery_tag(uint64_t value);
   public:
 
   // @@protoc_insertion_point(class_scope:XuMQ.basicAckRequest)
@@ -2204,7 +2388,7 @@ class basicAckRequest final :
     ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr rid_;
     ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr cid_;
     ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr queue_name_;
-    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr msg_id_;
+    uint64_t delivery_tag_;
     mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
   };
   union { Impl_ _impl_; };
@@ -2260,7 +2444,7 @@ class basicConsumeRequest final :
                &_basicConsumeRequest_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    12;
+    13;
 
   friend void swap(basicConsumeRequest& a, basicConsumeRequest& b) {
     a.Swap(&b);
@@ -2472,7 +2656,7 @@ class basicCancelRequest final :
                &_basicCancelRequest_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    13;
+    14;
 
   friend void swap(basicCancelRequest& a, basicCancelRequest& b) {
     a.Swap(&b);
@@ -2673,7 +2857,7 @@ class basicConsumeResponse final :
                &_basicConsumeResponse_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    14;
+    15;
 
   friend void swap(basicConsumeResponse& a, basicConsumeResponse& b) {
     a.Swap(&b);
@@ -2750,6 +2934,7 @@ class basicConsumeResponse final :
     kConsumerTagFieldNumber = 2,
     kBodyFieldNumber = 3,
     kPropertiesFieldNumber = 4,
+    kDeliveryTagFieldNumber = 5,
   };
   // string cid = 1;
   void clear_cid();
@@ -2811,6 +2996,15 @@ class basicConsumeResponse final :
       ::XuMQ::BasicProperties* properties);
   ::XuMQ::BasicProperties* unsafe_arena_release_properties();
 
+  // uint64 delivery_tag = 5;
+  void clear_delivery_tag();
+  uint64_t delivery_tag() const;
+  void set_delivery_tag(uint64_t value);
+  private:
+  uint64_t _internal_delivery_tag() const;
+  void _internal_set_delivery_tag(uint64_t value);
+  public:
+
   // @@protoc_insertion_point(class_scope:XuMQ.basicConsumeResponse)
  private:
   class _Internal;
@@ -2823,6 +3017,7 @@ class basicConsumeResponse final :
     ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr consumer_tag_;
     ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr body_;
     ::XuMQ::BasicProperties* properties_;
+    uint64_t delivery_tag_;
     mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
   };
   union { Impl_ _impl_; };
@@ -2878,7 +3073,7 @@ class basicResponse final :
                &_basicResponse_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    15;
+    16;
 
   friend void swap(basicResponse& a, basicResponse& b) {
     a.Swap(&b);
@@ -4023,6 +4218,160 @@ inline void deleteQueueRequest::set_allocated_queue_name(std::string* queue_name
 
 // -------------------------------------------------------------------
 
+// queuePurgeRequest
+
+// string rid = 1;
+inline void queuePurgeRequest::clear_rid() {
+  _impl_.rid_.ClearToEmpty();
+}
+inline const std::string& queuePurgeRequest::rid() const {
+  // @@protoc_insertion_point(field_get:XuMQ.queuePurgeRequest.rid)
+  return _internal_rid();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void queuePurgeRequest::set_rid(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.rid_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:XuMQ.queuePurgeRequest.rid)
+}
+inline std::string* queuePurgeRequest::mutable_rid() {
+  std::string* _s = _internal_mutable_rid();
+  // @@protoc_insertion_point(field_mutable:XuMQ.queuePurgeRequest.rid)
+  return _s;
+}
+inline const std::string& queuePurgeRequest::_internal_rid() const {
+  return _impl_.rid_.Get();
+}
+inline void queuePurgeRequest::_internal_set_rid(const std::string& value) {
+  
+  _impl_.rid_.Set(value, GetArenaForAllocation());
+}
+inline std::string* queuePurgeRequest::_internal_mutable_rid() {
+  
+  return _impl_.rid_.Mutable(GetArenaForAllocation());
+}
+inline std::string* queuePurgeRequest::release_rid() {
+  // @@protoc_insertion_point(field_release:XuMQ.queuePurgeRequest.rid)
+  return _impl_.rid_.Release();
+}
+inline void queuePurgeRequest::set_allocated_rid(std::string* rid) {
+  if (rid != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.rid_.SetAllocated(rid, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.rid_.IsDefault()) {
+    _impl_.rid_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:XuMQ.queuePurgeRequest.rid)
+}
+
+// string cid = 2;
+inline void queuePurgeRequest::clear_cid() {
+  _impl_.cid_.ClearToEmpty();
+}
+inline const std::string& queuePurgeRequest::cid() const {
+  // @@protoc_insertion_point(field_get:XuMQ.queuePurgeRequest.cid)
+  return _internal_cid();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void queuePurgeRequest::set_cid(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.cid_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:XuMQ.queuePurgeRequest.cid)
+}
+inline std::string* queuePurgeRequest::mutable_cid() {
+  std::string* _s = _internal_mutable_cid();
+  // @@protoc_insertion_point(field_mutable:XuMQ.queuePurgeRequest.cid)
+  return _s;
+}
+inline const std::string& queuePurgeRequest::_internal_cid() const {
+  return _impl_.cid_.Get();
+}
+inline void queuePurgeRequest::_internal_set_cid(const std::string& value) {
+  
+  _impl_.cid_.Set(value, GetArenaForAllocation());
+}
+inline std::string* queuePurgeRequest::_internal_mutable_cid() {
+  
+  return _impl_.cid_.Mutable(GetArenaForAllocation());
+}
+inline std::string* queuePurgeRequest::release_cid() {
+  // @@protoc_insertion_point(field_release:XuMQ.queuePurgeRequest.cid)
+  return _impl_.cid_.Release();
+}
+inline void queuePurgeRequest::set_allocated_cid(std::string* cid) {
+  if (cid != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.cid_.SetAllocated(cid, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.cid_.IsDefault()) {
+    _impl_.cid_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:XuMQ.queuePurgeRequest.cid)
+}
+
+// string queue_name = 3;
+inline void queuePurgeRequest::clear_queue_name() {
+  _impl_.queue_name_.ClearToEmpty();
+}
+inline const std::string& queuePurgeRequest::queue_name() const {
+  // @@protoc_insertion_point(field_get:XuMQ.queuePurgeRequest.queue_name)
+  return _internal_queue_name();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void queuePurgeRequest::set_queue_name(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.queue_name_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:XuMQ.queuePurgeRequest.queue_name)
+}
+inline std::string* queuePurgeRequest::mutable_queue_name() {
+  std::string* _s = _internal_mutable_queue_name();
+  // @@protoc_insertion_point(field_mutable:XuMQ.queuePurgeRequest.queue_name)
+  return _s;
+}
+inline const std::string& queuePurgeRequest::_internal_queue_name() const {
+  return _impl_.queue_name_.Get();
+}
+inline void queuePurgeRequest::_internal_set_queue_name(const std::string& value) {
+  
+  _impl_.queue_name_.Set(value, GetArenaForAllocation());
+}
+inline std::string* queuePurgeRequest::_internal_mutable_queue_name() {
+  
+  return _impl_.queue_name_.Mutable(GetArenaForAllocation());
+}
+inline std::string* queuePurgeRequest::release_queue_name() {
+  // @@protoc_insertion_point(field_release:XuMQ.queuePurgeRequest.queue_name)
+  return _impl_.queue_name_.Release();
+}
+inline void queuePurgeRequest::set_allocated_queue_name(std::string* queue_name) {
+  if (queue_name != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.queue_name_.SetAllocated(queue_name, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.queue_name_.IsDefault()) {
+    _impl_.queue_name_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:XuMQ.queuePurgeRequest.queue_name)
+}
+
+// -------------------------------------------------------------------
+
 // queueBindRequest
 
 // string rid = 1;
@@ -4922,54 +5271,24 @@ inline void basicAckRequest::set_allocated_queue_name(std::string* queue_name) {
   // @@protoc_insertion_point(field_set_allocated:XuMQ.basicAckRequest.queue_name)
 }
 
-// string msg_id = 4;
-inline void basicAckRequest::clear_msg_id() {
-  _impl_.msg_id_.ClearToEmpty();
-}
-inline const std::string& basicAckRequest::msg_id() const {
-  // @@protoc_insertion_point(field_get:XuMQ.basicAckRequest.msg_id)
-  return _internal_msg_id();
+// uint64 delivery_tag = 5;
+inline void basicAckRequest::clear_delivery_tag() {
+  _impl_.delivery_tag_ = uint64_t{0u};
 }
-template <typename ArgT0, typename... ArgT>
-inline PROTOBUF_ALWAYS_INLINE
-void basicAckRequest::set_msg_id(ArgT0&& arg0, ArgT... args) {
- 
- _impl_.msg_id_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
-  // @@protoc_insertion_point(field_set:XuMQ.basicAckRequest.msg_id)
-}
-inline std::string* basicAckRequest::mutable_msg_id() {
-  std::string* _s = _internal_mutable_msg_id();
-  // @@protoc_insertion_point(field_mutable:XuMQ.basicAckRequest.msg_id)
-  return _s;
+inline uint64_t basicAckRequest::_internal_delivery_tag() const {
+  return _impl_.delivery_tag_;
 }
-inline const std::string& basicAckRequest::_internal_msg_id() const {
-  return _impl_.msg_id_.Get();
+inline uint64_t basicAckRequest::delivery_tag() const {
+  // @@protoc_insertion_point(field_get:XuMQ.basicAckRequest.delivery_tag)
+  return _internal_delivery_tag();
 }
-inline void basicAckRequest::_internal_set_msg_id(const std::string& value) {
+inline void basicAckRequest::_internal_set_delivery_tag(uint64_t value) {
   
-  _impl_.msg_id_.Set(value, GetArenaForAllocation());
+  _impl_.delivery_tag_ = value;
 }
-inline std::string* basicAckRequest::_internal_mutable_msg_id() {
-  
-  return _impl_.msg_id_.Mutable(GetArenaForAllocation());
-}
-inline std::string* basicAckRequest::release_msg_id() {
-  // @@protoc_insertion_point(field_release:XuMQ.basicAckRequest.msg_id)
-  return _impl_.msg_id_.Release();
-}
-inline void basicAckRequest::set_allocated_msg_id(std::string* msg_id) {
-  if (msg_id != nullptr) {
-    
-  } else {
-    
-  }
-  _impl_.msg_id_.SetAllocated(msg_id, GetArenaForAllocation());
-#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
-  if (_impl_.msg_id_.IsDefault()) {
-    _impl_.msg_id_.Set("", GetArenaForAllocation());
-  }
-#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
-  // @@protoc_insertion_point(field_set_allocated:XuMQ.basicAckRequest.msg_id)
+inline void basicAckRequest::set_delivery_tag(uint64_t value) {
+  _internal_set_delivery_tag(value);
+  // @@protoc_insertion_point(field_set:XuMQ.basicAckRequest.delivery_tag)
 }
 
 // -------------------------------------------------------------------
@@ -5639,6 +5958,26 @@ inline void basicConsumeResponse::set_allocated_properties(::XuMQ::BasicProperti
   // @@protoc_insertion_point(field_set_allocated:XuMQ.basicConsumeResponse.properties)
 }
 
+// uint64 delivery_tag = 5;
+inline void basicConsumeResponse::clear_delivery_tag() {
+  _impl_.delivery_tag_ = uint64_t{0u};
+}
+inline uint64_t basicConsumeResponse::_internal_delivery_tag() const {
+  return _impl_.delivery_tag_;
+}
+inline uint64_t basicConsumeResponse::delivery_tag() const {
+  // @@protoc_insertion_point(field_get:XuMQ.basicConsumeResponse.delivery_tag)
+  return _internal_delivery_tag();
+}
+inline void basicConsumeResponse::_internal_set_delivery_tag(uint64_t value) {
+  
+  _impl_.delivery_tag_ = value;
+}
+inline void basicConsumeResponse::set_delivery_tag(uint64_t value) {
+  _internal_set_delivery_tag(value);
+  // @@protoc_insertion_point(field_set:XuMQ.basicConsumeResponse.delivery_tag)
+}
+
 // -------------------------------------------------------------------
 
 // basicResponse
@@ -5796,6 +6135,8 @@ inline void basicResponse::set_ok(bool value) {
 
 // -------------------------------------------------------------------
 
+// -------------------------------------------------------------------
+
 
 // @@protoc_insertion_point(namespace_scope)
 
@@ -0,0 +1,224 @@
+/**
+ * @file registry.hpp
+ * @brief 分片加锁的并发注册表
+ *
+ * 此文件定义了 Registry 类模板，服务端的各个管理类用它保存 名称->对象 的映射表。
+ *
+ * 注册表按键的哈希值分成若干个分片，每个分片有自己的互斥锁和哈希表，
+ * 落在不同分片上的查找、插入和删除互不等待，发布和确认路径上的查找因此不再争用一把全局锁。
+ * 分片按缓存行对齐，相邻分片的锁不会共享同一个缓存行。
+ *
+ * 需要"检查-创建-插入"整体原子完成的操作(例如声明时同时写数据库)通过 update 在键所在分片的锁内完成。
+ * 遍历、计数和清空逐个分片加锁，看到的不是整张表在同一时刻的快照。
+ * 被删除的对象在释放分片锁之后才析构，析构函数中可以再次访问注册表。
+ *
+ */
+
+#pragma once
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+namespace XuMQ
+{
+    const size_t REGISTRY_SHARDS = 16; ///< 注册表默认的分片数
+
+    /**
+     * @class Registry
+     * @brief 分片加锁的并发映射表
+     * @tparam K 键类型
+     * @tparam V 值类型 通常是对象的共享指针 默认构造的值表示不存在
+     * @tparam Hash 键的哈希函数
+     */
+    template <typename K, typename V, typename Hash = std::hash<K>>
+    class Registry
+    {
+    public:
+        using Map = std::unordered_map<K, V, Hash>; ///< 单个分片中的映射表
+
+        /**
+         * @brief 构造函数
+         * @param shards 分片数 向上取整为2的幂
+         */
+        explicit Registry(size_t shards = REGISTRY_SHARDS) : _bits(0)
+        {
+            while (((size_t)1 << _bits) < shards)
+                _bits++;
+            _shards.reset(new Shard[(size_t)1 << _bits]);
+        }
+        Registry(const Registry &) = delete;
+        Registry &operator=(const Registry &) = delete;
+
+        /**
+         * @brief 查找键对应的值
+         * @return 值的副本 不存在时返回默认构造的值
+         */
+        V find(const K &key) const
+        {
+            const Shard &shard = locate(key);
+            std::unique_lock<std::mutex> lock(shard.mutex);
+            auto it = shard.map.find(key);
+            if (it == shard.map.end())
+                return V();
+            return it->second;
+        }
+        /**
+         * @brief 判断键是否存在
+         */
+        bool exists(const K &key) const
+        {
+            const Shard &shard = locate(key);
+            std::unique_lock<std::mutex> lock(shard.mutex);
+            return shard.map.find(key) != shard.map.end();
+        }
+        /**
+         * @brief 键不存在时插入
+         * @return 插入返回true 键已经存在返回false
+         */
+        bool insert(const K &key, const V &value)
+        {
+            Shard &shard = locate(key);
+            std::unique_lock<std::mutex> lock(shard.mutex);
+            return shard.map.insert(std::make_pair(key, value)).second;
+        }
+        /**
+         * @brief 删除键
+         * @return 被删除的值 不存在时返回默认构造的值 由调用者在锁外析构
+         */
+        V erase(const K &key)
+        {
+            V value = V();
+            Shard &shard = locate(key);
+            std::unique_lock<std::mutex> lock(shard.mutex);
+            auto it = shard.map.find(key);
+            if (it == shard.map.end())
+                return value;
+            value = std::move(it->second);
+            shard.map.erase(it);
+            return value;
+        }
+        /**
+         * @brief 在键所在分片的锁内执行复合操作
+         * @param key 键
+         * @param func 回调函数 参数为键所在分片的映射表 只能访问与key同一分片的条目
+         * @return 回调函数的返回值
+         */
+        template <typename F>
+        auto update(const K &key, F func) -> decltype(func(std::declval<Map &>()))
+        {
+            Shard &shard = locate(key);
+            std::unique_lock<std::mutex> lock(shard.mutex);
+            return func(shard.map);
+        }
+        /**
+         * @brief 逐个分片在锁内执行操作
+         * @param func 回调函数 参数为一个分片的映射表
+         */
+        template <typename F>
+        void updateAll(F func)
+        {
+            for (size_t i = 0; i < count(); i++)
+            {
+                std::unique_lock<std::mutex> lock(_shards[i].mutex);
+                func(_shards[i].map);
+            }
+        }
+        /**
+         * @brief 遍历所有条目 逐个分片加锁
+         * @param func 回调函数 参数为键和值 回调中不能再访问注册表
+         */
+        template <typename F>
+        void each(F func) const
+        {
+            for (size_t i = 0; i < count(); i++)
+            {
+                std::unique_lock<std::mutex> lock(_shards[i].mutex);
+                for (auto &entry : _shards[i].map)
+                    func(entry.first, entry.second);
+            }
+        }
+        /**
+         * @brief 获取所有值的副本 在锁外逐个处理时使用
+         */
+        std::vector<V> values() const
+        {
+            std::vector<V> result;
+            each([&result](const K &, const V &value)
+                 { result.push_back(value); });
+            return result;
+        }
+        /**
+         * @brief 获取所有条目的副本
+         */
+        Map snapshot() const
+        {
+            Map result;
+            each([&result](const K &key, const V &value)
+                 { result.insert(std::make_pair(key, value)); });
+            return result;
+        }
+        /**
+         * @brief 用一张映射表替换全部内容 恢复数据时使用
+         */
+        void assign(const Map &map)
+        {
+            clear();
+            for (auto &entry : map)
+                insert(entry.first, entry.second);
+        }
+        /**
+         * @brief 获取条目数量
+         */
+        size_t size() const
+        {
+            size_t total = 0;
+            for (size_t i = 0; i < count(); i++)
+            {
+                std::unique_lock<std::mutex> lock(_shards[i].mutex);
+                total += _shards[i].map.size();
+            }
+            return total;
+        }
+        /**
+         * @brief 清空所有条目 被删除的值在释放分片锁之后析构
+         */
+        void clear()
+        {
+            for (size_t i = 0; i < count(); i++)
+            {
+                Map removed;
+                {
+                    std::unique_lock<std::mutex> lock(_shards[i].mutex);
+                    removed.swap(_shards[i].map);
+                }
+            }
+        }
+
+    private:
+        /// @brief 分片 独占缓存行
+        struct alignas(64) Shard
+        {
+            mutable std::mutex mutex; ///< 分片锁
+            Map map;                  ///< 分片中的映射表
+        };
+
+        /// @brief 分片数
+        size_t count() const { return (size_t)1 << _bits; }
+        /// @brief 按键的哈希值定位分片 乘法散列后取高位 标准库哈希值低位分布不均时也能打散
+        Shard &locate(const K &key) const
+        {
+            if (_bits == 0)
+                return _shards[0];
+            uint64_t hash = (uint64_t)Hash()(key) * 0x9E3779B97F4A7C15ull;
+            return _shards[hash >> (64 - _bits)];
+        }
+
+    private:
+        unsigned _bits;                  ///< 分片数的对数
+        std::unique_ptr<Shard[]> _shards; ///< 分片数组
+    };
+}
@@ -0,0 +1,185 @@
+/**
+ * @file acklog.hpp
+ * @brief 消息确认日志的实现
+ *
+ * 该文件定义了 XuMQ 命名空间中的 AckLog 类。
+ *
+ * 持久化消息被确认时不再回写数据段中的有效标志，而是向队列目录下的确认日志
+ * 顺序追加一条墓碑记录(消息序号, 8字节)。恢复和垃圾回收时加载墓碑集合，
+ * 跳过已经确认的消息；墓碑对应的记录从数据段中清除之后，日志被清空或重写。
+ */
+
+#pragma once
+#include "../common/logger.hpp"
+#include "../common/helper.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace XuMQ
+{
+    const char *ACKLOG_FILE = "ack.log";                 ///< 确认日志文件名
+    const size_t TOMBSTONE_SIZE = sizeof(uint64_t);      ///< 单条墓碑记录的字节数
+
+    /// @class AckLog
+    /// @brief 消息确认日志 顺序追加已确认消息的序号
+    class AckLog
+    {
+    public:
+        /// @brief 构造函数
+        /// @param filename 确认日志文件名
+        AckLog(const std::string &filename)
+            : _filename(filename), _fd(-1), _tail(0)
+        {
+        }
+        /// @brief 析构函数 关闭文件描述符
+        ~AckLog()
+        {
+            close();
+        }
+        /// @brief 打开确认日志 不存在则创建
+        /// @return 成功返回true 失败返回false
+        /// @note 末尾不足一条记录的残留数据(写入中途崩溃)会被后续追加覆盖
+        bool open()
+        {
+            FileHelper::removeFile(_filename + ".tmp"); // 重写中途退出残留的临时文件
+            _fd = ::open(_filename.c_str(), O_RDWR | O_CREAT, 0644);
+            if (_fd < 0)
+            {
+                error(logger, "%s:确认日志打开失败! %s", _filename.c_str(), strerror(errno));
+                return false;
+            }
+            struct stat st;
+            if (fstat(_fd, &st) < 0)
+            {
+                error(logger, "%s:获取确认日志大小失败! %s", _filename.c_str(), strerror(errno));
+                return false;
+            }
+            _tail = st.st_size - st.st_size % TOMBSTONE_SIZE;
+            return true;
+        }
+        /// @brief 关闭确认日志
+        void close()
+        {
+            if (_fd >= 0)
+                ::close(_fd);
+            _fd = -1;
+        }
+        /// @brief 追加一条墓碑记录
+        /// @param seq 已确认消息的序号
+        /// @return 成功返回true 失败返回false
+        bool append(uint64_t seq)
+        {
+            ssize_t ret;
+            do
+            {
+                ret = ::pwrite(_fd, &seq, TOMBSTONE_SIZE, _tail);
+            } while (ret < 0 && errno == EINTR);
+            if (ret != (ssize_t)TOMBSTONE_SIZE)
+            {
+                error(logger, "%s:确认日志写入失败! %s", _filename.c_str(), strerror(errno));
+                return false;
+            }
+            _tail += TOMBSTONE_SIZE;
+            return true;
+        }
+        /// @brief 加载所有墓碑记录
+        /// @param seqs 存储已确认消息序号的集合
+        /// @return 成功返回true 失败返回false
+        bool load(std::unordered_set<uint64_t> &seqs)
+        {
+            std::vector<uint64_t> buf(_tail / TOMBSTONE_SIZE);
+            size_t done = 0, len = buf.size() * TOMBSTONE_SIZE;
+            while (done < len)
+            {
+                ssize_t ret = ::pread(_fd, (char *)buf.data() + done, len - done, done);
+                if (ret < 0 && errno == EINTR)
+                    continue;
+                if (ret <= 0)
+                {
+                    error(logger, "%s:确认日志读取失败!", _filename.c_str());
+                    return false;
+                }
+                done += ret;
+            }
+            seqs.insert(buf.begin(), buf.end());
+            return true;
+        }
+        /// @brief 清空确认日志 在墓碑对应的消息已经从数据段中清除之后调用
+        /// @return 成功返回true 失败返回false
+        bool reset()
+        {
+            if (::ftruncate(_fd, 0) < 0)
+            {
+                error(logger, "%s:清空确认日志失败! %s", _filename.c_str(), strerror(errno));
+                return false;
+            }
+            _tail = 0;
+            return true;
+        }
+        /// @brief 重写确认日志 只保留仍然需要的墓碑
+        /// @param seqs 需要保留的消息序号
+        /// @return 成功返回true 失败返回false
+        /// @note 先写入临时文件并刷盘 再原子地重命名覆盖原文件
+        bool rewrite(const std::vector<uint64_t> &seqs)
+        {
+            std::string tmpfile = _filename + ".tmp";
+            int fd = ::open(tmpfile.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0)
+            {
+                error(logger, "%s:创建确认日志临时文件失败! %s", tmpfile.c_str(), strerror(errno));
+                return false;
+            }
+            size_t done = 0, len = seqs.size() * TOMBSTONE_SIZE;
+            while (done < len)
+            {
+                ssize_t ret = ::pwrite(fd, (const char *)seqs.data() + done, len - done, done);
+                if (ret < 0 && errno == EINTR)
+                    continue;
+                if (ret < 0)
+                    break;
+                done += ret;
+            }
+            if (done < len || ::fdatasync(fd) < 0 || FileHelper(tmpfile).rename(_filename) == false)
+            {
+                error(logger, "%s:重写确认日志失败! %s", _filename.c_str(), strerror(errno));
+                ::close(fd);
+                FileHelper::removeFile(tmpfile);
+                return false;
+            }
+            close();
+            _fd = fd;
+            _tail = len;
+            return true;
+        }
+        /// @brief 将确认日志刷入磁盘
+        /// @return 成功返回true 失败返回false
+        bool sync()
+        {
+            if (_fd < 0)
+                return true;
+            if (::fdatasync(_fd) < 0)
+            {
+                error(logger, "%s:确认日志刷盘失败! %s", _filename.c_str(), strerror(errno));
+                return false;
+            }
+            return true;
+        }
+        /// @brief 关闭并删除确认日志
+        void remove()
+        {
+            close();
+            FileHelper::removeFile(_filename);
+        }
+        /// @brief 获取墓碑记录数量
+        size_t count() const { return _tail / TOMBSTONE_SIZE; }
+
+    private:
+        std::string _filename; ///< 确认日志文件名
+        int _fd;               ///< 常驻打开的文件描述符
+        size_t _tail;          ///< 尾部偏移
+    };
+}
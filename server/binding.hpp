@@ -13,13 +13,17 @@
 #include "../common/logger.hpp"
 #include "../common/helper.hpp"
 #include "../common/msg.pb.h"
+#include "../common/registry.hpp"
 #include <iostream>
+#include <atomic>
 #include <unordered_map>
 #include <mutex>
 #include <memory>
 
 namespace XuMQ
 {
+    const size_t BINDING_CACHE_LIMIT = 4096; ///< 每个线程为一个管理类缓存的交换机数量上限 达到后整体丢弃
+
     /// @struct Binding
     /// @brief 绑定信息结构体
     struct Binding
@@ -53,6 +57,9 @@ namespace XuMQ
     /// 删除交换机绑定信息时, 需要删除交换机->绑定信息中的数据
     /// 额外需要遍历队列->绑定信息中绑定信息的交换机名称 再进行释放 效率极低
     using BindingMap = std::unordered_map<std::string, MsgQueueBindingMap>;
+    /// @brief 交换机绑定信息的只读快照
+    /// @note 快照创建后不再修改 绑定和解绑时生成新的快照整体替换 持有快照的一方可以不加锁直接遍历
+    using BindingSnapshot = std::shared_ptr<const MsgQueueBindingMap>;
     /// @class BindingMapper
     /// @brief 绑定信息持久化管理类
     class BindingMapper
@@ -194,14 +201,27 @@ namespace XuMQ
     };
     /// @class BindingManager
     /// @brief 绑定信息内存管理类
+    /// @note
+    /// 每个交换机的绑定信息保存在一个槽中 槽中有主副本、最近生成的只读快照和一个原子版本号
+    /// 绑定、解绑只在写锁和槽锁内修改主副本并增加版本号 不复制映射表 连续的多次修改只在下一次读取时生成一次快照
+    /// 每个线程缓存自己读到的槽、版本号和快照 发布消息时版本号未变则直接返回缓存的快照 不加锁
+    /// 版本号变化后读取方在槽锁内取得(必要时生成)新的快照
+    /// 线程缓存在查找未命中时清理已析构的管理类和过多的缓存项 其余在线程退出时释放
     class BindingManager
     {
     public:
         using ptr = std::shared_ptr<BindingManager>; ///< 绑定信息内存管理类指针
         /// @brief 绑定信息数据内存管理类 构造函数 从数据库中恢复数据
         /// @param dbfile 数据库名称
-        BindingManager(const std::string &dbfile) : _mapper(dbfile) {
-            _bindings = _mapper.recovery();
+        BindingManager(const std::string &dbfile)
+            : _mapper(dbfile), _id(nextId()), _alive(std::make_shared<char>(0)), _layout(0)
+        {
+            for (auto &binding : _mapper.recovery())
+            {
+                auto slot = std::make_shared<Slot>();
+                slot->bindings = std::move(binding.second);
+                _slots.insert(binding.first, slot);
+            }
         }
         /// @brief 添加绑定信息
         /// @param ename 交换机名称
@@ -212,10 +232,17 @@ namespace XuMQ
         /// @note 当交换机和消息队列的持久化标志都为true时 绑定信息持久化标志为true才有意义
         bool bind(const std::string &ename, const std::string &qname, const std::string &key, bool durable)
         {
-            // 加锁 构造一个队列信息绑定对象 添加映射关系
+            // 加写锁 构造一个队列信息绑定对象 加入交换机的主副本
             std::unique_lock<std::mutex> lock(_mutex);
-            auto it = _bindings.find(ename);
-            if (it != _bindings.end() && it->second.find(qname) != it->second.end()) // 绑定信息已经存在
+            std::shared_ptr<Slot> slot = _slots.find(ename);
+            if (slot.get() == nullptr)
+            {
+                slot = std::make_shared<Slot>();
+                _slots.insert(ename, slot);
+                _layout.fetch_add(1, std::memory_order_release);
+            }
+            std::unique_lock<std::mutex> slock(slot->mutex);
+            if (slot->bindings.find(qname) != slot->bindings.end()) // 绑定信息已经存在
                 return true;
             Binding::ptr bp = std::make_shared<Binding>(ename, qname, key);
             if (durable)
@@ -224,8 +251,8 @@ namespace XuMQ
                 if (ret == false)
                     return false;
             }
-            auto &qbmap = _bindings[ename];
-            qbmap.insert(std::make_pair(qname, bp));
+            slot->bindings.insert(std::make_pair(qname, bp));
+            slot->version.fetch_add(1, std::memory_order_release);
             return true;
         }
         /// @brief 解除绑定信息
@@ -234,14 +261,15 @@ namespace XuMQ
         void unbind(const std::string &ename, const std::string &qname)
         {
             std::unique_lock<std::mutex> lock(_mutex);
-            auto eit = _bindings.find(ename);
-            if (eit == _bindings.end()) // 没有交换机的绑定信息
+            std::shared_ptr<Slot> slot = _slots.find(ename);
+            if (slot.get() == nullptr)
                 return;
-            auto qit = eit->second.find(qname); // 没有交换机对应队列的绑定信息
-            if (qit == eit->second.end())
+            std::unique_lock<std::mutex> slock(slot->mutex);
+            if (slot->bindings.find(qname) == slot->bindings.end()) // 没有交换机对应队列的绑定信息
                 return;
             _mapper.remove(ename, qname);
-            _bindings[ename].erase(qname);
+            slot->bindings.erase(qname);
+            slot->version.fetch_add(1, std::memory_order_release);
         }
         /// @brief 移除指定交换机的所有绑定信息
         /// @param ename 交换机名称
@@ -249,7 +277,7 @@ namespace XuMQ
         {
             std::unique_lock<std::mutex> lock(_mutex);
             _mapper.removeExchangeBindings(ename);
-            _bindings.erase(ename);
+            retire(_slots.erase(ename));
         }
         /// @brief 移除指定消息队列的所有绑定信息
         /// @param qname 消息队列名称
@@ -257,19 +285,19 @@ namespace XuMQ
         {
             std::unique_lock<std::mutex> lock(_mutex);
             _mapper.removeQueueBindings(qname);
-            for (auto &binding : _bindings) // 遍历所有交换机
-                binding.second.erase(qname);
+            for (auto &slot : _slots.values()) // 遍历所有交换机 只修改包含该队列的槽
+            {
+                std::unique_lock<std::mutex> slock(slot->mutex);
+                if (slot->bindings.erase(qname) > 0)
+                    slot->version.fetch_add(1, std::memory_order_release);
+            }
         }
-        /// @brief 获取指定交换机的绑定信息
+        /// @brief 获取指定交换机的绑定信息 版本号未变时不加锁 不复制
         /// @param ename 交换机名称
-        /// @return 消息队列绑定映射表 @see MsgQueueBindingMap
-        MsgQueueBindingMap getExchangeBindings(const std::string &ename)
+        /// @return 绑定信息的只读快照 没有绑定信息时为空映射表 @see BindingSnapshot
+        BindingSnapshot getExchangeBindings(const std::string &ename)
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            auto eit = _bindings.find(ename);
-            if (eit == _bindings.end())
-                return MsgQueueBindingMap();
-            return eit->second;
+            return select(ename);
         }
 
         /// @brief 获取绑定信息
@@ -278,12 +306,9 @@ namespace XuMQ
         /// @return 绑定信息指针 @see Binding::ptr
         Binding::ptr getBinding(const std::string &ename, const std::string &qname)
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            auto eit = _bindings.find(ename);
-            if (eit == _bindings.end())
-                return Binding::ptr();
-            auto qit = eit->second.find(qname);
-            if (qit == eit->second.end())
+            BindingSnapshot qbmap = select(ename);
+            auto qit = qbmap->find(qname);
+            if (qit == qbmap->end())
                 return Binding::ptr();
             return qit->second;
         }
@@ -293,23 +318,25 @@ namespace XuMQ
         /// @return 存在则返回true 不存在返回false
         bool exists(const std::string &ename, const std::string &qname)
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            auto eit = _bindings.find(ename);
-            if (eit == _bindings.end())
-                return false;
-            auto qit = eit->second.find(qname);
-            if (qit == eit->second.end())
-                return false;
-            return true;
+            return getBinding(ename, qname).get() != nullptr;
+        }
+        /// @brief 获取当前线程缓存的交换机数量
+        size_t cachedCount()
+        {
+            ThreadCache &cache = threadCache();
+            auto it = cache.find(_id);
+            return it == cache.end() ? 0 : it->second.exchanges.size();
         }
         /// @brief 获取绑定信息数量
         /// @return 绑定信息数量
         size_t size()
         {
             size_t total_size = 0;
-            std::unique_lock<std::mutex> lock(_mutex);
-            for (auto &it : _bindings)
-                total_size += it.second.size();
+            for (auto &slot : _slots.values())
+            {
+                std::unique_lock<std::mutex> slock(slot->mutex);
+                total_size += slot->bindings.size();
+            }
             return total_size;
         }
         /// @brief 清除绑定信息
@@ -317,12 +344,149 @@ namespace XuMQ
         {
             std::unique_lock<std::mutex> lock(_mutex);
             _mapper.removeTable();
-            _bindings.clear();
+            for (auto &slot : _slots.snapshot())
+                retire(_slots.erase(slot.first));
+        }
+
+    private:
+        /// @struct Slot
+        /// @brief 一个交换机的绑定信息
+        struct Slot
+        {
+            std::mutex mutex;                   ///< 槽锁 保护主副本和快照
+            MsgQueueBindingMap bindings;        ///< 主副本 只在槽锁内访问
+            BindingSnapshot snapshot;           ///< 最近生成的快照
+            uint64_t built;                     ///< 快照对应的版本号
+            bool removed;                       ///< 槽已从管理类中移除 缓存它的线程需要重新查找
+            std::atomic<uint64_t> version;      ///< 版本号 每次修改主副本后加一
+            Slot() : built(0), removed(false), version(1) {}
+        };
+        /// @struct Cached
+        /// @brief 线程缓存的一个交换机的快照
+        struct Cached
+        {
+            std::shared_ptr<Slot> slot; ///< 交换机的槽 为空表示查找时交换机没有绑定信息
+            uint64_t version;           ///< 槽为空时是管理类的槽布局版本号 否则是槽的版本号
+            BindingSnapshot snapshot;   ///< 缓存的快照
+        };
+        /// @struct ManagerCache
+        /// @brief 线程缓存的一个管理类的快照
+        struct ManagerCache
+        {
+            std::weak_ptr<void> alive;                          ///< 管理类的存活标记 失效表示管理类已析构
+            std::unordered_map<std::string, Cached> exchanges;  ///< 交换机名称->缓存的快照
+        };
+        /// @brief 线程缓存 管理类编号->管理类的缓存
+        using ThreadCache = std::unordered_map<uint64_t, ManagerCache>;
+
+        /// @brief 生成管理类编号 线程缓存按编号区分不同的管理类 已析构的管理类的编号不会被复用
+        static uint64_t nextId()
+        {
+            static std::atomic<uint64_t> id(0);
+            return ++id;
+        }
+        /// @brief 获取共享的空映射表
+        static const BindingSnapshot &empty()
+        {
+            static const BindingSnapshot snapshot = std::make_shared<const MsgQueueBindingMap>();
+            return snapshot;
+        }
+        /// @brief 获取交换机当前的绑定信息快照
+        /// @return 快照 交换机没有绑定信息时返回共享的空映射表
+        BindingSnapshot select(const std::string &ename)
+        {
+            ThreadCache &cache = threadCache();
+            ManagerCache &mcache = cache[_id];
+            auto &cached_map = mcache.exchanges;
+            auto it = cached_map.find(ename);
+            if (it != cached_map.end())
+            {
+                Cached &cached = it->second;
+                if (cached.slot.get() == nullptr)
+                {
+                    if (cached.version == _layout.load(std::memory_order_acquire))
+                        return cached.snapshot;
+                }
+                else
+                {
+                    if (cached.version == cached.slot->version.load(std::memory_order_acquire))
+                        return cached.snapshot;
+                    if (refresh(cached))
+                        return cached.snapshot;
+                    // 槽已被移除 交换机可能不会再被访问 丢弃缓存项 重新绑定过时按未缓存重新查找
+                    cached_map.erase(it);
+                    if (_slots.find(ename).get() == nullptr)
+                        return empty();
+                    it = cached_map.end();
+                }
+            }
+            if (it == cached_map.end())
+            {
+                // 未命中时清理已析构的管理类的缓存 缓存项过多时整体丢弃 避免线程缓存无限增长
+                if (mcache.alive.expired())
+                    mcache.alive = _alive;
+                for (auto mit = cache.begin(); mit != cache.end();)
+                    mit = mit->second.alive.expired() ? cache.erase(mit) : std::next(mit);
+                if (cached_map.size() >= BINDING_CACHE_LIMIT)
+                    cached_map.clear();
+                it = cached_map.insert(std::make_pair(ename, Cached())).first;
+            }
+            // 第一次读取或槽已被移除 先读布局版本号再查找 之后新建的槽会使缓存失效
+            Cached &cached = it->second;
+            cached.version = _layout.load(std::memory_order_acquire);
+            cached.slot = _slots.find(ename);
+            cached.snapshot = empty();
+            if (cached.slot.get() != nullptr && refresh(cached) == false)
+            {
+                cached.slot.reset();
+                cached.snapshot = empty();
+            }
+            return cached.snapshot;
+        }
+        /// @brief 获取当前线程的缓存
+        static ThreadCache &threadCache()
+        {
+            static thread_local ThreadCache cache;
+            return cache;
+        }
+        /// @brief 在槽锁内取得槽的最新快照 主副本在上次生成快照之后被修改过时重新生成
+        /// @param cached 线程缓存的快照
+        /// @return 成功返回true 槽已被移除返回false
+        bool refresh(Cached &cached)
+        {
+            Slot &slot = *cached.slot;
+            std::unique_lock<std::mutex> slock(slot.mutex);
+            if (slot.removed)
+                return false;
+            uint64_t version = slot.version.load(std::memory_order_relaxed);
+            if (slot.built != version)
+            {
+                slot.snapshot = slot.bindings.empty() ? empty() : std::make_shared<const MsgQueueBindingMap>(slot.bindings);
+                slot.built = version;
+            }
+            cached.version = version;
+            cached.snapshot = slot.snapshot;
+            return true;
+        }
+        /// @brief 标记槽已移除 需持有写锁
+        /// @param slot 已从注册表中删除的槽 可以为空
+        void retire(const std::shared_ptr<Slot> &slot)
+        {
+            if (slot.get() == nullptr)
+                return;
+            std::unique_lock<std::mutex> slock(slot->mutex);
+            slot->removed = true;
+            slot->bindings.clear();
+            slot->snapshot.reset();
+            slot->version.fetch_add(1, std::memory_order_release);
         }
 
     private:
-        std::mutex _mutex;     ///< 互斥锁
-        BindingMapper _mapper; ///< 绑定信息持久化管理类
-        BindingMap _bindings;  ///< 绑定映射表
+        std::mutex _mutex;                              ///< 写锁 串行化绑定信息的修改和持久化 读取不加写锁
+        BindingMapper _mapper;                          ///< 绑定信息持久化管理类
+        Registry<std::string, std::shared_ptr<Slot>> _slots; ///< 交换机名称->绑定信息槽
+        uint64_t _id;                                   ///< 管理类编号 @see nextId
+        std::shared_ptr<void> _alive;                   ///< 存活标记 线程缓存持有它的弱引用 析构后缓存可被清理
+        std::atomic<uint64_t> _layout;                  ///< 槽布局版本号 新建槽时加一 使线程缓存的"没有绑定信息"失效
     };
-}
\ No newline at end of file
+}
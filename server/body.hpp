@@ -0,0 +1,544 @@
+/**
+ * @file body.hpp
+ * @brief 共享消息与队列消息引用的定义
+ *
+ * 该文件定义了 XuMQ 命名空间中的 MessageId、PackedMessage 和 MessageRef。
+ *
+ * 一次发布只构造一个只读的紧凑消息记录(PackedMessage)，路由到的所有队列通过侵入式引用计数共享它，
+ * 最后一个引用释放时才被回收。记录是一整块内存: 固定大小的头部(引用计数、投递模式、二进制id、
+ * 驻留的路由键指针)之后紧跟消息体，标准格式的 UUID 以128位二进制保存，其他格式的 id 原样保存在消息体之前。
+ * 路由键在全局的驻留表中只保存一份，同一路由键的消息共享同一个字符串，驻留表按路由键分片加锁。
+ * protobuf 对象只在边界上构造: 写入磁盘和投递给消费者时生成，从磁盘读回时解析后立即转换为紧凑记录。
+ *
+ * 每个队列只保存一个 MessageRef，其中是队列自己的状态: 队列内的消息序号、是否持久化以及记录在磁盘上的位置。
+ * MessageRef 同样使用侵入式引用计数，从固定大小的内存池中分配，内存池为每个线程缓存一批空闲对象，分配和释放通常不加锁。
+ *
+ * 磁盘上的记录由两部分拼接而成: 共享部分(序列化后的消息)和引用部分(只含序号等字段的 Payload)，
+ * protobuf 解析拼接的数据时会合并两部分的字段，因此共享部分每次发布只序列化一次。
+ * 开启压缩的队列中记录位于压缩块内，段号、偏移和长度指向整个块。
+ */
+
+#pragma once
+#include "../common/msg.pb.h"
+#include "../common/registry.hpp"
+#include <atomic>
+#include <algorithm>
+#include <mutex>
+#include <new>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <unordered_map>
+
+namespace XuMQ
+{
+    const char *MSG_VALID = "1";               ///< 消息有效标志
+    const char *MSG_INVALID = "0";             ///< 消息无效标志 仅出现在旧版本数据中
+    const size_t SLAB_CHUNK_BYTES = 64 * 1024; ///< 内存池每次向系统申请的字节数
+    const size_t SLAB_CACHE_BATCH = 64;        ///< 线程缓存与全局空闲链表之间每次交换的对象个数
+
+    /// @class IntrusivePtr
+    /// @brief 侵入式引用计数指针 引用计数保存在对象内部 接口与 std::shared_ptr 的常用部分一致
+    /// @tparam T 对象类型 需提供 retain() 和静态的 release(T *)
+    template <typename T>
+    class IntrusivePtr
+    {
+    public:
+        IntrusivePtr() : _ptr(nullptr) {}
+        /// @brief 接管一个引用计数为1的新对象
+        explicit IntrusivePtr(T *ptr) : _ptr(ptr) {}
+        IntrusivePtr(const IntrusivePtr &other) : _ptr(other._ptr)
+        {
+            if (_ptr != nullptr)
+                _ptr->retain();
+        }
+        IntrusivePtr(IntrusivePtr &&other) noexcept : _ptr(other._ptr) { other._ptr = nullptr; }
+        ~IntrusivePtr() { reset(); }
+        IntrusivePtr &operator=(IntrusivePtr other) noexcept
+        {
+            std::swap(_ptr, other._ptr);
+            return *this;
+        }
+        /// @brief 释放持有的引用
+        void reset()
+        {
+            if (_ptr != nullptr)
+                T::release(_ptr);
+            _ptr = nullptr;
+        }
+        T *get() const { return _ptr; }
+        T *operator->() const { return _ptr; }
+        T &operator*() const { return *_ptr; }
+        bool operator==(const IntrusivePtr &other) const { return _ptr == other._ptr; }
+        bool operator!=(const IntrusivePtr &other) const { return _ptr != other._ptr; }
+        explicit operator bool() const { return _ptr != nullptr; }
+
+    private:
+        T *_ptr; ///< 指向的对象
+    };
+
+    /// @class SlabPool
+    /// @brief 固定大小对象的内存池 按块向系统申请 释放的对象挂回空闲链表复用
+    /// @tparam T 对象类型
+    /// @note
+    /// 每个线程有自己的空闲链表缓存 分配和释放只访问本线程的缓存 不加锁
+    /// 缓存为空时从全局链表一次取回一批 缓存超过两批时归还一批 全局链表的锁每一批对象只争用一次
+    /// 线程退出时缓存全部归还 之后(例如主线程退出后的静态对象析构)直接使用全局链表
+    /// 内存块不归还给系统 池本身有意不析构 保证静态对象析构时仍可释放引用
+    template <typename T>
+    class SlabPool
+    {
+    public:
+        /// @brief 获取该类型的全局内存池
+        static SlabPool &instance()
+        {
+            static SlabPool *pool = new SlabPool();
+            return *pool;
+        }
+        /// @brief 分配一个对象大小的内存
+        void *allocate()
+        {
+            Cache &cache = local();
+            if (cache.closed)
+            {
+                Slot *slot = nullptr;
+                take(slot, 1);
+                return slot;
+            }
+            if (cache.free == nullptr)
+                cache.count = take(cache.free, SLAB_CACHE_BATCH);
+            Slot *slot = cache.free;
+            cache.free = slot->next;
+            cache.count--;
+            return slot;
+        }
+        /// @brief 归还由 allocate 分配的内存
+        void deallocate(void *ptr)
+        {
+            Slot *slot = static_cast<Slot *>(ptr);
+            Cache &cache = local();
+            if (cache.closed)
+            {
+                give(slot, slot, 1);
+                return;
+            }
+            slot->next = cache.free;
+            cache.free = slot;
+            if (++cache.count >= 2 * SLAB_CACHE_BATCH)
+                flush(cache, SLAB_CACHE_BATCH);
+        }
+
+    private:
+        union Slot
+        {
+            Slot *next;                         ///< 空闲时指向下一个空闲位置
+            alignas(T) char storage[sizeof(T)]; ///< 对象存储
+        };
+        /// @brief 线程的空闲链表缓存 平凡析构 线程的其他析构函数中仍可访问
+        struct Cache
+        {
+            Slot *free;      ///< 空闲链表
+            size_t count;    ///< 空闲链表长度
+            bool registered; ///< 是否已登记线程退出时的归还
+            bool closed;     ///< 线程已经退出 直接使用全局链表
+        };
+        /// @brief 线程退出时归还缓存
+        struct Closer
+        {
+            ~Closer()
+            {
+                Cache &cache = local();
+                instance().flush(cache, cache.count);
+                cache.closed = true;
+            }
+        };
+        SlabPool() : _free(nullptr) {}
+        /// @brief 获取本线程的缓存 第一次访问时登记线程退出时的归还
+        static Cache &local()
+        {
+            static thread_local Cache cache = {nullptr, 0, false, false};
+            if (cache.registered == false)
+            {
+                cache.registered = true;
+                static thread_local Closer closer;
+                (void)closer;
+            }
+            return cache;
+        }
+        /// @brief 从全局链表取出一批位置
+        /// @param head 输出参数 取出的链表
+        /// @param count 最多取出的个数
+        /// @return 取出的个数
+        size_t take(Slot *&head, size_t count)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_free == nullptr)
+                grow();
+            head = _free;
+            Slot *tail = _free;
+            size_t taken = 1;
+            while (taken < count && tail->next != nullptr)
+            {
+                tail = tail->next;
+                taken++;
+            }
+            _free = tail->next;
+            tail->next = nullptr;
+            return taken;
+        }
+        /// @brief 将一段链表挂回全局链表
+        void give(Slot *head, Slot *tail, size_t count)
+        {
+            if (count == 0)
+                return;
+            std::unique_lock<std::mutex> lock(_mutex);
+            tail->next = _free;
+            _free = head;
+        }
+        /// @brief 将缓存中的一批位置归还全局链表 链表在锁外拆分
+        void flush(Cache &cache, size_t count)
+        {
+            if (count == 0)
+                return;
+            Slot *head = cache.free;
+            Slot *tail = head;
+            for (size_t i = 1; i < count; i++)
+                tail = tail->next;
+            cache.free = tail->next;
+            cache.count -= count;
+            give(head, tail, count);
+        }
+        /// @brief 申请一个新的内存块 并将其中的位置加入空闲链表
+        void grow()
+        {
+            const size_t slots = std::max<size_t>(1, SLAB_CHUNK_BYTES / sizeof(Slot));
+            Slot *chunk = new Slot[slots];
+            for (size_t i = 0; i < slots; i++)
+                chunk[i].next = i + 1 < slots ? &chunk[i + 1] : _free;
+            _free = chunk;
+        }
+
+    private:
+        std::mutex _mutex; ///< 全局链表的互斥锁
+        Slot *_free;       ///< 全局空闲链表
+    };
+
+    /// @struct MessageId
+    /// @brief 128位的二进制消息id
+    /// @note 标准格式(小写 8-4-4-4-12)的 UUID 与二进制形式一一对应; 其他格式的 id 取128位哈希值作为键
+    struct MessageId
+    {
+        uint64_t hi; ///< 高64位
+        uint64_t lo; ///< 低64位
+
+        bool operator==(const MessageId &other) const { return hi == other.hi && lo == other.lo; }
+        bool operator!=(const MessageId &other) const { return !(*this == other); }
+        /// @brief 将字符串 id 转换为二进制 id
+        /// @param id 消息id
+        /// @return 标准格式的 UUID 返回对应的二进制值 其他格式返回哈希值
+        static MessageId of(const std::string &id)
+        {
+            MessageId key;
+            if (parse(id, key))
+                return key;
+            // FNV-1a 的两个不同初值分别生成高低64位 再混合一次
+            key.hi = 14695981039346656037ULL;
+            key.lo = 0x6c62272e07bb0142ULL;
+            for (unsigned char c : id)
+            {
+                key.hi = (key.hi ^ c) * 1099511628211ULL;
+                key.lo = (key.lo ^ c) * 0x100000001b3ULL + 0x9e3779b97f4a7c15ULL;
+            }
+            key.hi ^= key.lo >> 29;
+            key.lo ^= key.hi >> 31;
+            return key;
+        }
+        /// @brief 解析标准格式的 UUID
+        /// @param id 消息id
+        /// @param key 输出参数 二进制 id
+        /// @return id 是标准格式的 UUID 返回true 否则返回false
+        static bool parse(const std::string &id, MessageId &key)
+        {
+            if (id.size() != 36)
+                return false;
+            uint64_t half[2] = {0, 0};
+            size_t digits = 0;
+            for (size_t i = 0; i < id.size(); i++)
+            {
+                char c = id[i];
+                if (i == 8 || i == 13 || i == 18 || i == 23)
+                {
+                    if (c != '-')
+                        return false;
+                    continue;
+                }
+                uint64_t value;
+                if (c >= '0' && c <= '9')
+                    value = c - '0';
+                else if (c >= 'a' && c <= 'f')
+                    value = c - 'a' + 10;
+                else
+                    return false;
+                half[digits / 16] = half[digits / 16] << 4 | value;
+                digits++;
+            }
+            key.hi = half[0];
+            key.lo = half[1];
+            return true;
+        }
+        /// @brief 转换为标准格式的 UUID 字符串
+        std::string str() const
+        {
+            static const char *digits = "0123456789abcdef";
+            std::string result;
+            result.reserve(36);
+            for (int i = 0; i < 32; i++)
+            {
+                if (i == 8 || i == 12 || i == 16 || i == 20)
+                    result.push_back('-');
+                uint64_t half = i < 16 ? hi : lo;
+                result.push_back(digits[(half >> (60 - (i % 16) * 4)) & 0xf]);
+            }
+            return result;
+        }
+    };
+}
+
+namespace std
+{
+    template <>
+    struct hash<XuMQ::MessageId>
+    {
+        size_t operator()(const XuMQ::MessageId &id) const
+        {
+            return id.hi ^ (id.lo * 0x9e3779b97f4a7c15ULL);
+        }
+    };
+}
+
+namespace XuMQ
+{
+    /// @class InternTable
+    /// @brief 路由键驻留表 相同的路由键只保存一份 按引用计数回收
+    /// @note 按路由键的哈希值分片加锁 不同路由键的消息创建和释放互不等待
+    class InternTable
+    {
+    public:
+        /// @brief 获取全局驻留表
+        static InternTable &instance()
+        {
+            static InternTable *table = new InternTable();
+            return *table;
+        }
+        /// @brief 获取驻留的字符串 引用计数加一
+        /// @param str 字符串
+        /// @return 驻留的字符串 空字符串返回空指针
+        const std::string *acquire(const std::string &str)
+        {
+            if (str.empty())
+                return nullptr;
+            return _strings.update(str, [&str](std::unordered_map<std::string, size_t> &strings)
+                                   {
+                                       auto it = strings.insert(std::make_pair(str, 0)).first;
+                                       it->second++;
+                                       return &it->first; });
+        }
+        /// @brief 释放驻留的字符串 引用计数为0时删除
+        /// @param str 由 acquire 返回的字符串
+        void release(const std::string *str)
+        {
+            if (str == nullptr)
+                return;
+            _strings.update(*str, [str](std::unordered_map<std::string, size_t> &strings)
+                            {
+                                auto it = strings.find(*str);
+                                if (it != strings.end() && --it->second == 0)
+                                    strings.erase(it); });
+        }
+        /// @brief 获取驻留的字符串个数
+        size_t size() { return _strings.size(); }
+
+    private:
+        InternTable() {}
+
+    private:
+        Registry<std::string, size_t> _strings; ///< 驻留的字符串与引用计数
+    };
+
+    /// @class PackedMessage
+    /// @brief 紧凑的只读消息记录 头部与消息体位于同一块内存
+    class PackedMessage
+    {
+    public:
+        /// @brief 构造消息记录
+        /// @param id 消息id
+        /// @param mode 投递模式
+        /// @param routing_key 路由键
+        /// @param body 消息体
+        /// @return 引用计数为1的消息
+        static IntrusivePtr<const PackedMessage> create(const std::string &id, DeliveryMode mode,
+                                                        const std::string &routing_key, std::string_view body)
+        {
+            MessageId key;
+            bool binary = MessageId::parse(id, key);
+            if (binary == false)
+                key = MessageId::of(id);
+            size_t id_len = binary ? 0 : id.size();
+            void *mem = ::operator new(sizeof(PackedMessage) + id_len + body.size());
+            PackedMessage *msg = new (mem) PackedMessage(key, mode, id_len, body.size(), InternTable::instance().acquire(routing_key));
+            char *data = reinterpret_cast<char *>(msg + 1);
+            id.copy(data, id_len);
+            body.copy(data + id_len, body.size());
+            return IntrusivePtr<const PackedMessage>(msg);
+        }
+        /// @brief 获取二进制消息id 用作队列中映射表的键
+        const MessageId &key() const { return _key; }
+        /// @brief 获取消息id
+        std::string id() const { return _id_len == 0 ? _key.str() : std::string(data(), _id_len); }
+        /// @brief 获取消息体
+        std::string_view body() const { return std::string_view(data() + _id_len, _body_len); }
+        /// @brief 获取路由键
+        const std::string &routingKey() const
+        {
+            static const std::string empty;
+            return _routing_key != nullptr ? *_routing_key : empty;
+        }
+        /// @brief 获取投递模式
+        DeliveryMode deliveryMode() const { return static_cast<DeliveryMode>(_mode); }
+        /// @brief 生成消息属性 投递给消费者时使用
+        BasicProperties properties() const
+        {
+            BasicProperties properties;
+            properties.set_id(id());
+            properties.set_delivery_mode(deliveryMode());
+            properties.set_routing_key(routingKey());
+            return properties;
+        }
+        /// @brief 序列化为记录的共享部分
+        std::string serialize() const
+        {
+            Message::Payload payload;
+            *payload.mutable_properties() = properties();
+            payload.set_body(data() + _id_len, _body_len);
+            payload.set_valid(MSG_VALID); // 持久化存储中表示数据有效
+            return payload.SerializeAsString();
+        }
+        /// @brief 消息记录占用的字节数 驻留的路由键不计入
+        size_t footprint() const { return sizeof(PackedMessage) + _id_len + _body_len; }
+        /// @brief 一个队列开始在待推送列表中持有消息体
+        /// @return 第一个持有的队列返回true 扇出的消息体只计入一次内存占用
+        bool pin() const { return _pending.fetch_add(1, std::memory_order_relaxed) == 0; }
+        /// @brief 一个队列不再在待推送列表中持有消息体
+        /// @return 最后一个持有的队列返回true
+        bool unpin() const { return _pending.fetch_sub(1, std::memory_order_relaxed) == 1; }
+        /// @brief 引用计数加一
+        void retain() const { _refs.fetch_add(1, std::memory_order_relaxed); }
+        /// @brief 引用计数减一 减到0时回收
+        static void release(const PackedMessage *msg)
+        {
+            if (msg->_refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                return;
+            msg->~PackedMessage();
+            ::operator delete(const_cast<PackedMessage *>(msg));
+        }
+
+    private:
+        PackedMessage(const MessageId &key, DeliveryMode mode, size_t id_len, size_t body_len, const std::string *routing_key)
+            : _refs(1), _pending(0), _mode(static_cast<uint8_t>(mode)), _id_len(id_len), _body_len(body_len), _key(key), _routing_key(routing_key)
+        {
+        }
+        ~PackedMessage() { InternTable::instance().release(_routing_key); }
+        const char *data() const { return reinterpret_cast<const char *>(this + 1); }
+
+    private:
+        mutable std::atomic<uint32_t> _refs;    ///< 引用计数
+        mutable std::atomic<uint32_t> _pending; ///< 在待推送列表中持有消息体的队列数
+        uint8_t _mode;                          ///< 投递模式
+        uint32_t _id_len;                       ///< 原样保存的id长度 标准格式的 UUID 为0
+        uint32_t _body_len;                     ///< 消息体长度
+        MessageId _key;                         ///< 二进制消息id
+        const std::string *_routing_key;        ///< 驻留的路由键 空路由键为空指针
+    };
+
+    using MessagePtr = IntrusivePtr<const PackedMessage>; ///< 共享的只读消息 扇出到多个队列时只有一份
+
+    /// @struct MessageRef
+    /// @brief 队列中的一条消息 共享的消息加上队列自己的状态
+    struct MessageRef
+    {
+        using ptr = IntrusivePtr<MessageRef>;
+        MessagePtr msg;   ///< 共享的消息
+        uint64_t seq;     ///< 队列内单调递增的消息序号 确认日志以此标识消息
+        uint64_t offset;  ///< 记录在段内的偏移
+        uint32_t segment; ///< 记录所在段号
+        uint32_t length;  ///< 记录长度
+        uint32_t inner;   ///< 记录在压缩块中的偏移 0表示独立的记录 @see RecordBlock
+        bool durable;     ///< 是否在该队列中持久化
+
+        /// @brief 从内存池中构造队列消息
+        /// @param msg 共享的消息
+        /// @param seq 队列内的消息序号
+        /// @param durable 是否持久化
+        static ptr create(const MessagePtr &msg = MessagePtr(), uint64_t seq = 0, bool durable = false)
+        {
+            return ptr(new (SlabPool<MessageRef>::instance().allocate()) MessageRef(msg, seq, durable));
+        }
+        /// @brief 获取消息id
+        std::string id() const { return msg->id(); }
+        /// @brief 获取二进制消息id
+        const MessageId &key() const { return msg->key(); }
+        /// @brief 估算消息在内存中占用的字节数 消息未读回时为0
+        size_t footprint() const
+        {
+            if (msg.get() == nullptr)
+                return 0;
+            return sizeof(MessageRef) + msg->footprint();
+        }
+        /// @brief 引用计数加一
+        void retain() { _refs.fetch_add(1, std::memory_order_relaxed); }
+        /// @brief 引用计数减一 减到0时归还内存池
+        static void release(MessageRef *ref)
+        {
+            if (ref->_refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                return;
+            ref->~MessageRef();
+            SlabPool<MessageRef>::instance().deallocate(ref);
+        }
+        /// @brief 生成记录的引用部分 拼接在共享部分之后
+        /// @param seq 队列内的消息序号
+        /// @return 序列化后的引用部分
+        static std::string reference(uint64_t seq)
+        {
+            Message::Payload payload;
+            payload.set_seq(seq);
+            return payload.SerializeAsString();
+        }
+        /// @brief 解析一条记录 分离共享部分和引用部分
+        /// @param data 记录数据
+        /// @param len 记录长度
+        /// @param refs 输出参数 记录中的引用部分(序号 队列标识 扇出引用 有效标志)
+        /// @return 共享的消息 解析失败返回空指针
+        static MessagePtr parse(const char *data, size_t len, Message::Payload &refs)
+        {
+            Message::Payload payload;
+            if (payload.ParseFromArray(data, len) == false)
+                return MessagePtr();
+            refs.set_seq(payload.seq());
+            refs.set_queue(payload.queue());
+            refs.set_valid(payload.valid());
+            refs.mutable_refs()->Swap(payload.mutable_refs());
+            const BasicProperties &properties = payload.properties();
+            return PackedMessage::create(properties.id(), properties.delivery_mode(), properties.routing_key(), payload.body());
+        }
+
+    private:
+        MessageRef(const MessagePtr &smsg, uint64_t sseq, bool sdurable)
+            : msg(smsg), seq(sseq), offset(0), segment(0), length(0), inner(0), durable(sdurable), _refs(1)
+        {
+        }
+
+    private:
+        std::atomic<uint32_t> _refs; ///< 引用计数
+    };
+}
@@ -41,13 +41,22 @@ namespace XuMQ
         /// @brief Server类的构造函数
         /// @param port 服务器监听的端口号
         /// @param basedir 基础目录，用于存储元数据等文件
-        Server(int port, const std::string &basedir) : _server(&_baseloop, muduo::net::InetAddress("0.0.0.0", port),
+        /// @param datadirs 消息数据目录列表，通常位于不同的磁盘，为空时消息数据也存放在基础目录下
+        /// @param placement 新队列选择数据目录的方式
+        /// @param policy 虚拟机默认持久化策略，队列声明参数可以覆盖
+        /// @param recovery_threads 恢复历史消息的线程数，0表示使用CPU核心数
+        /// @param storage 持久化消息的存储方式
+        Server(int port, const std::string &basedir, const std::vector<std::string> &datadirs = std::vector<std::string>(),
+               PlacementPolicy placement = PlacementPolicy::HASH, const DurabilityPolicy &policy = DurabilityPolicy(),
+               size_t recovery_threads = 0, StorageMode storage = StorageMode::PER_QUEUE) : _server(&_baseloop, muduo::net::InetAddress("0.0.0.0", port),
                                                                "Server", muduo::net::TcpServer::kReusePort),
                                                        _dispatcher(std::bind(&Server::onUnknowMessage, this,
                                                                              std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)),
                                                        _codec(std::make_shared<ProtobufCodec>(std::bind(&ProtobufDispatcher::onProtobufMessage, &_dispatcher,
                                                                                                         std::placeholders::_1, std::placeholders::_2, std::placeholders::_3))),
-                                                       _virtual_host(std::make_shared<VirtualHost>(HOSTNAME, basedir, basedir + DBFILE)),
+                                                       _virtual_host(std::make_shared<VirtualHost>(HOSTNAME, datadirs.empty() ? std::vector<std::string>{basedir} : datadirs,
+                                                                                                   basedir + DBFILE, policy, recovery_threads,
+                                                                                                   storage, placement)),
                                                        _consumer_manager(std::make_shared<ConsumerManager>()),
                                                        _connection_manager(std::make_shared<ConnectionManager>()),
                                                        _threadpool(std::make_shared<threadpool>())
@@ -70,6 +79,8 @@ namespace XuMQ
                                                                                      std::placeholders::_2, std::placeholders::_3));
             _dispatcher.registerMessageCallback<XuMQ::deleteQueueRequest>(std::bind(&Server::onDeleteQueue, this, std::placeholders::_1,
                                                                                     std::placeholders::_2, std::placeholders::_3));
+            _dispatcher.registerMessageCallback<XuMQ::queuePurgeRequest>(std::bind(&Server::onPurgeQueue, this, std::placeholders::_1,
+                                                                                   std::placeholders::_2, std::placeholders::_3));
             _dispatcher.registerMessageCallback<XuMQ::queueBindRequest>(std::bind(&Server::onQueueBind, this, std::placeholders::_1,
                                                                                   std::placeholders::_2, std::placeholders::_3));
             _dispatcher.registerMessageCallback<XuMQ::queueUnBindRequest>(std::bind(&Server::onQueueUnBind, this, std::placeholders::_1,
@@ -227,6 +238,29 @@ namespace XuMQ
             }
             return cp->deleteQueue(message);
         }
+        /**
+         * @brief 处理清空队列的请求
+         * @param conn 客户端连接
+         * @param message 清空队列请求消息
+         * @param timestamp 消息时间戳
+         */
+        void onPurgeQueue(const muduo::net::TcpConnectionPtr &conn, const queuePurgeRequestPtr message, muduo::Timestamp)
+        {
+            Connection::ptr mconn = _connection_manager->getConnection(conn);
+            if (mconn.get() == nullptr)
+            {
+                error(logger, "清空队列时 没有找到连接对应的Connection对象!");
+                conn->shutdown();
+                return;
+            }
+            Channel::ptr cp = mconn->getChannel(message->cid());
+            if (cp.get() == nullptr)
+            {
+                error(logger, "清空队列时 没有找到信道!");
+                return;
+            }
+            return cp->purgeQueue(message);
+        }
         /**
          * @brief 处理队列绑定的请求
          * @param conn 客户端连接
@@ -0,0 +1,441 @@
+/**
+ * @file btree.hpp
+ * @brief B+树存储引擎的实现
+ *
+ * 该文件定义了 XuMQ 命名空间中的 BTreeDatabase 类和 BTreeStore 类。
+ *
+ * 虚拟机内所有选择 btree 引擎的队列共用第一个数据目录下的 messages.db，
+ * 消息保存在以 (队列名称, 消息序号) 为主键的 B+树表中(SQLite WITHOUT ROWID 表):
+ * 确认直接删除对应的键，没有确认日志，也不需要压缩回收空间；
+ * 重启时按主键顺序读出队列剩余的消息即可，不需要扫描日志或重放确认。
+ * 适合消费者多、确认乱序的队列，顺序读写为主的队列使用默认的文件引擎更快。
+ *
+ * 写入和删除累积在同一个事务中，按持久化策略提交，每次提交刷盘一次(WAL 模式, synchronous=FULL)，
+ * 所有队列并发的写入合并到同一次提交中。不主动刷盘的队列也会定时提交，避免事务无限增长。
+ */
+
+#pragma once
+#include "../common/logger.hpp"
+#include "../common/helper.hpp"
+#include "../common/msg.pb.h"
+#include "store.hpp"
+#include "body.hpp"
+#include <string>
+#include <list>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <functional>
+
+namespace XuMQ
+{
+    const char *BTREE_FILE = "messages.db"; ///< B+树存储的数据库文件名 位于第一个数据目录下
+
+    /// @class BTreeDatabase
+    /// @brief 虚拟机内所有 btree 队列共用的数据库 首次使用时打开
+    class BTreeDatabase
+    {
+    public:
+        using ptr = std::shared_ptr<BTreeDatabase>;
+        /// @brief 构造函数 不打开数据库
+        /// @param dbfile 数据库文件名
+        BTreeDatabase(const std::string &dbfile)
+            : _dbfile(dbfile), _sql(dbfile), _opened(false), _put(nullptr), _erase(nullptr), _get(nullptr),
+              _scan(nullptr), _drop(nullptr), _in_txn(false), _written(0), _committed(0),
+              _aborted_from(0), _aborted_to(0), _commit_count(0)
+        {
+        }
+        /// @brief 析构函数 提交尚未提交的事务并关闭数据库
+        ~BTreeDatabase()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_opened == false)
+                return;
+            commitLocked();
+            for (sqlite3_stmt *stmt : {_put, _erase, _get, _scan, _drop})
+                sqlite3_finalize(stmt);
+            _sql.close();
+        }
+        /// @brief 写入一条消息
+        /// @param qname 队列名称
+        /// @param seq 消息序号
+        /// @param record 序列化后的消息
+        /// @param ticket 输出参数 写入序号 提交到该序号后消息才落盘 @see commit
+        /// @return 成功返回true 失败返回false
+        bool put(const std::string &qname, uint64_t seq, const std::string &record, uint64_t &ticket)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (begin() == false)
+                return false;
+            sqlite3_bind_text(_put, 1, qname.data(), qname.size(), SQLITE_STATIC);
+            sqlite3_bind_int64(_put, 2, seq);
+            sqlite3_bind_blob(_put, 3, record.data(), record.size(), SQLITE_STATIC);
+            if (step(_put) == false)
+                return rollback();
+            ticket = ++_written;
+            return true;
+        }
+        /// @brief 删除一条消息
+        /// @param qname 队列名称
+        /// @param seq 消息序号
+        /// @param ticket 输出参数 写入序号
+        /// @return 成功返回true 失败返回false
+        bool erase(const std::string &qname, uint64_t seq, uint64_t &ticket)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (begin() == false)
+                return false;
+            sqlite3_bind_text(_erase, 1, qname.data(), qname.size(), SQLITE_STATIC);
+            sqlite3_bind_int64(_erase, 2, seq);
+            if (step(_erase) == false)
+                return rollback();
+            ticket = ++_written;
+            return true;
+        }
+        /// @brief 读取一条消息
+        /// @param qname 队列名称
+        /// @param seq 消息序号
+        /// @param record 存储读取内容的字符串
+        /// @return 成功返回true 不存在或失败返回false
+        bool get(const std::string &qname, uint64_t seq, std::string &record)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (open() == false)
+                return false;
+            sqlite3_bind_text(_get, 1, qname.data(), qname.size(), SQLITE_STATIC);
+            sqlite3_bind_int64(_get, 2, seq);
+            bool found = sqlite3_step(_get) == SQLITE_ROW;
+            if (found)
+                record.assign((const char *)sqlite3_column_blob(_get, 0), sqlite3_column_bytes(_get, 0));
+            sqlite3_reset(_get);
+            return found;
+        }
+        /// @brief 按序号顺序遍历队列的所有消息
+        /// @param qname 队列名称
+        /// @param cb 回调函数 参数为消息序号、消息数据和长度
+        /// @return 成功返回true 失败返回false
+        bool scan(const std::string &qname, const std::function<void(uint64_t, const char *, size_t)> &cb)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (open() == false)
+                return false;
+            sqlite3_bind_text(_scan, 1, qname.data(), qname.size(), SQLITE_STATIC);
+            int ret;
+            while ((ret = sqlite3_step(_scan)) == SQLITE_ROW)
+                cb(sqlite3_column_int64(_scan, 0), (const char *)sqlite3_column_blob(_scan, 1), sqlite3_column_bytes(_scan, 1));
+            sqlite3_reset(_scan);
+            if (ret != SQLITE_DONE)
+            {
+                error(logger, "%s:遍历队列 %s 的消息失败: %s", _dbfile.c_str(), qname.c_str(), sqlite3_errmsg(_sql.handle()));
+                return false;
+            }
+            return true;
+        }
+        /// @brief 删除队列的所有消息并立即提交
+        /// @param qname 队列名称
+        /// @return 成功返回true 失败返回false
+        bool drop(const std::string &qname)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (begin() == false)
+                return false;
+            sqlite3_bind_text(_drop, 1, qname.data(), qname.size(), SQLITE_STATIC);
+            if (step(_drop) == false)
+                return rollback();
+            ++_written;
+            return commitLocked();
+        }
+        /// @brief 提交事务 直到指定的写入序号
+        /// @param ticket 写入序号 已经提交过时直接返回 并发的调用者合并到同一次提交中
+        /// @return 成功返回true 失败或写入已随事务回滚返回false
+        bool commit(uint64_t ticket)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (ticket > _aborted_from && ticket <= _aborted_to)
+                return false;
+            if (_committed >= ticket)
+                return true;
+            return commitLocked();
+        }
+        /// @brief 获取实际执行的提交次数
+        size_t commitCount()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            return _commit_count;
+        }
+
+    private:
+        /// @brief 打开数据库 创建消息表并准备语句 已经打开时直接返回
+        /// @return 成功返回true 失败返回false
+        bool open()
+        {
+            if (_opened)
+                return true;
+            std::string dir = FileHelper::parentDirectory(_dbfile);
+            if (FileHelper(dir).exists() == false)
+                FileHelper::createDirectory(dir);
+            if (_sql.open(SQLITE_OPEN_NOMUTEX) == false)
+                return false;
+            if (_sql.exec("PRAGMA journal_mode=WAL;", nullptr, nullptr) == false ||
+                _sql.exec("PRAGMA synchronous=FULL;", nullptr, nullptr) == false ||
+                _sql.exec("create table if not exists messages(queue text not null, seq integer not null, "
+                          "body blob not null, primary key(queue, seq)) without rowid;",
+                          nullptr, nullptr) == false)
+            {
+                _sql.close();
+                return false;
+            }
+            if (prepare("insert or replace into messages values(?, ?, ?);", &_put) == false ||
+                prepare("delete from messages where queue=? and seq=?;", &_erase) == false ||
+                prepare("select body from messages where queue=? and seq=?;", &_get) == false ||
+                prepare("select seq, body from messages where queue=? order by seq;", &_scan) == false ||
+                prepare("delete from messages where queue=?;", &_drop) == false)
+            {
+                for (sqlite3_stmt *stmt : {_put, _erase, _get, _scan, _drop})
+                    sqlite3_finalize(stmt);
+                _sql.close();
+                return false;
+            }
+            _opened = true;
+            return true;
+        }
+        /// @brief 准备一条语句
+        bool prepare(const char *sql, sqlite3_stmt **stmt)
+        {
+            if (sqlite3_prepare_v2(_sql.handle(), sql, -1, stmt, nullptr) != SQLITE_OK)
+            {
+                error(logger, "%s--准备语句失败: %s", sql, sqlite3_errmsg(_sql.handle()));
+                *stmt = nullptr;
+                return false;
+            }
+            return true;
+        }
+        /// @brief 执行一条已绑定参数的写语句并重置
+        bool step(sqlite3_stmt *stmt)
+        {
+            int ret = sqlite3_step(stmt);
+            sqlite3_reset(stmt);
+            if (ret != SQLITE_DONE)
+            {
+                error(logger, "%s:写入消息失败: %s", _dbfile.c_str(), sqlite3_errmsg(_sql.handle()));
+                return false;
+            }
+            return true;
+        }
+        /// @brief 打开数据库并开始事务 事务已经开始时直接返回
+        bool begin()
+        {
+            if (open() == false)
+                return false;
+            if (_in_txn)
+                return true;
+            if (_sql.exec("begin;", nullptr, nullptr) == false)
+                return false;
+            _in_txn = true;
+            return true;
+        }
+        /// @brief 写语句失败后回滚当前事务 调用时持有互斥锁
+        /// @return 始终返回false
+        /// @note 事务由所有队列共用 回滚后本事务内其他队列的写入也一并丢弃 它们提交时返回false
+        bool rollback()
+        {
+            // 部分错误(磁盘已满、IO错误等)下 sqlite 已经自动回滚了事务
+            if (_in_txn && sqlite3_get_autocommit(_sql.handle()) == 0)
+                _sql.exec("rollback;", nullptr, nullptr);
+            if (_in_txn)
+            {
+                _aborted_from = _committed;
+                _aborted_to = _written;
+                error(logger, "%s:事务已回滚, %zu 次写入没有落盘", _dbfile.c_str(), (size_t)(_written - _committed));
+            }
+            _in_txn = false;
+            return false;
+        }
+        /// @brief 提交当前事务 调用时持有互斥锁
+        bool commitLocked()
+        {
+            if (_in_txn == false)
+            {
+                _committed = _written;
+                return true;
+            }
+            if (_sql.exec("commit;", nullptr, nullptr) == false)
+                return rollback();
+            _in_txn = false;
+            _committed = _written;
+            _commit_count++;
+            return true;
+        }
+
+    private:
+        std::mutex _mutex;      ///< 互斥锁 所有访问串行执行
+        std::string _dbfile;    ///< 数据库文件名
+        SqliteHelper _sql;      ///< 数据库操作句柄
+        bool _opened;           ///< 是否已经打开
+        sqlite3_stmt *_put;     ///< 写入消息的语句
+        sqlite3_stmt *_erase;   ///< 删除消息的语句
+        sqlite3_stmt *_get;     ///< 读取消息的语句
+        sqlite3_stmt *_scan;    ///< 遍历队列消息的语句
+        sqlite3_stmt *_drop;    ///< 删除队列所有消息的语句
+        bool _in_txn;           ///< 是否有未提交的事务
+        uint64_t _written;      ///< 已写入的序号
+        uint64_t _committed;    ///< 已提交的序号
+        uint64_t _aborted_from; ///< 最近一次回滚丢弃的写入序号 区间起点(不含)
+        uint64_t _aborted_to;   ///< 最近一次回滚丢弃的写入序号 区间终点(含)
+        size_t _commit_count;   ///< 实际执行的提交次数
+    };
+
+    /// @class BTreeStore
+    /// @brief B+树存储引擎 每个队列的消息是共用数据库中的一段主键区间
+    class BTreeStore : public MessageStore
+    {
+    public:
+        using ptr = std::shared_ptr<BTreeStore>;
+        /// @brief 构造函数
+        /// @param db 虚拟机共用的数据库
+        /// @param qname 队列名称
+        /// @param policy 持久化策略 决定何时提交事务
+        BTreeStore(const BTreeDatabase::ptr &db, const std::string &qname, const DurabilityPolicy &policy = DurabilityPolicy())
+            : _db(db), _qname(qname), _policy(policy), _count(0), _ticket(0), _pending(0),
+              _last_sync(std::chrono::steady_clock::now())
+        {
+        }
+        bool insert(const MessageRef::ptr &ref, const std::string &record) override
+        {
+            uint64_t ticket;
+            if (_db->put(_qname, ref->seq, record, ticket) == false)
+                return false;
+            ref->segment = 0;
+            ref->offset = 0;
+            ref->length = record.size();
+            ref->inner = 0;
+            _count++;
+            _ticket = ticket;
+            _pending++;
+            return true;
+        }
+        /// @brief 删除消息对应的键
+        /// @note 长度为0说明消息没有写入数据库(写入失败或事务已回滚) 没有可删除的键
+        bool remove(const MessageRef::ptr &ref) override
+        {
+            uint64_t ticket;
+            if (ref->length == 0)
+            {
+                warn(logger, "%s:消息 %s 没有写入存储, 无需删除", _qname.c_str(), std::to_string(ref->seq).c_str());
+                return false;
+            }
+            if (_db->erase(_qname, ref->seq, ticket) == false)
+                return false;
+            if (_count > 0)
+                _count--;
+            _ticket = ticket;
+            return true;
+        }
+        /// @brief 按序号顺序读出队列剩余的消息
+        std::list<MessageRef::ptr> recovery(uint64_t &seq) override
+        {
+            std::list<MessageRef::ptr> result;
+            seq = 0;
+            _db->scan(_qname, [&](uint64_t key, const char *data, size_t len)
+                      {
+                Message::Payload refs;
+                auto ref = MessageRef::create(MessageRef::parse(data, len, refs), key, true);
+                if (ref->msg.get() == nullptr)
+                {
+                    warn(logger, "%s:消息 %s 解析失败, 已忽略", _qname.c_str(), std::to_string(key).c_str());
+                    return;
+                }
+                ref->length = len;
+                seq = key;
+                result.push_back(ref); });
+            _count = result.size();
+            info(logger, "%s:从B+树存储恢复 %zu 条消息", _qname.c_str(), result.size());
+            return result;
+        }
+        bool read(const std::vector<MessageRef::ptr> &refs) override
+        {
+            for (auto &ref : refs)
+            {
+                std::string record;
+                Message::Payload parsed;
+                if (_db->get(_qname, ref->seq, record) == false ||
+                    (ref->msg = MessageRef::parse(record.data(), record.size(), parsed)).get() == nullptr)
+                {
+                    error(logger, "%s:读取消息 %s 失败!", _qname.c_str(), std::to_string(ref->seq).c_str());
+                    return false;
+                }
+            }
+            return true;
+        }
+        /// @brief 按持久化策略提交事务
+        bool commit() override
+        {
+            switch (_policy.mode)
+            {
+            case SyncMode::NONE:
+            case SyncMode::INTERVAL:
+                return true;
+            case SyncMode::BATCH:
+                if (_pending < _policy.batch)
+                    return true;
+                break;
+            case SyncMode::CONFIRM:
+                break;
+            }
+            return sync();
+        }
+        /// @brief 定时提交事务 不主动刷盘的队列按默认间隔提交
+        bool flush() override
+        {
+            size_t interval = _policy.interval_ms > 0 ? _policy.interval_ms : FSYNC_INTERVAL_DEFAULT;
+            if (std::chrono::steady_clock::now() - lastSync() < std::chrono::milliseconds(interval))
+                return true;
+            return sync();
+        }
+        /// @brief 提交事务 直到本队列最近一次写入
+        bool sync() override
+        {
+            {
+                std::unique_lock<std::mutex> lock(_sync_mutex);
+                _last_sync = std::chrono::steady_clock::now();
+            }
+            _pending = 0;
+            return _db->commit(_ticket);
+        }
+        /// @brief 事务必须定时提交 始终需要后台线程
+        bool needFlusher() const override { return true; }
+        /// @brief 删除队列的所有消息
+        void clear() override
+        {
+            _db->drop(_qname);
+            _count = 0;
+        }
+        /// @brief 删除队列的所有消息 代价与消息数成正比 但只是一次主键区间删除
+        bool purge() override
+        {
+            if (_db->drop(_qname) == false)
+                return false;
+            _count = 0;
+            return true;
+        }
+        size_t totalCount() override { return _count; }
+
+    private:
+        /// @brief 获取上一次提交的时间
+        std::chrono::steady_clock::time_point lastSync()
+        {
+            std::unique_lock<std::mutex> lock(_sync_mutex);
+            return _last_sync;
+        }
+
+    private:
+        BTreeDatabase::ptr _db;                           ///< 虚拟机共用的数据库
+        std::string _qname;                               ///< 队列名称
+        DurabilityPolicy _policy;                         ///< 持久化策略
+        size_t _count;                                    ///< 存活消息数
+        std::atomic<uint64_t> _ticket;                    ///< 最近一次写入的序号
+        std::atomic<size_t> _pending;                     ///< 上次提交后写入的消息数
+        std::mutex _sync_mutex;                           ///< 提交时间锁
+        std::chrono::steady_clock::time_point _last_sync; ///< 上一次提交的时间
+    };
+}
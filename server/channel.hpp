@@ -22,7 +22,10 @@
 #include "../common/msg.pb.h"
 #include "../common/protocol.pb.h"
 #include "../common/threadpool.hpp"
+#include "../common/registry.hpp"
 #include <google/protobuf/map.h>
+#include <algorithm>
+#include <vector>
 #include "consumer.hpp"
 #include "host.hpp"
 #include "route.hpp"
@@ -36,12 +39,25 @@ namespace XuMQ
     using deleteExchangeRequestPtr = std::shared_ptr<deleteExchangeRequest>;   ///< 删除交换机请求
     using declareQueueRequestPtr = std::shared_ptr<declareQueueRequest>;       ///< 声明队列请求
     using deleteQueueRequestPtr = std::shared_ptr<deleteQueueRequest>;         ///< 删除队列请求
+    using queuePurgeRequestPtr = std::shared_ptr<queuePurgeRequest>;           ///< 清空队列请求
     using queueBindRequestPtr = std::shared_ptr<queueBindRequest>;             ///< 绑定请求
     using queueUnBindRequestPtr = std::shared_ptr<queueUnBindRequest>;         ///< 解除绑定请求
     using basicPublishRequestPtr = std::shared_ptr<basicPublishRequest>;       ///< 消息发布请求
     using basicAckRequestPtr = std::shared_ptr<basicAckRequest>;               ///< 消息应答请求
     using basicCancelRequestPtr = std::shared_ptr<basicCancelRequest>;         ///< 取消订阅请求
     using basicConsumeRequestPtr = std::shared_ptr<basicConsumeRequest>;       ///< 取消订阅请求
+
+    const size_t CHANNEL_UNACKED_LIMIT = 65536; ///< 信道中已推送未确认消息数的默认上限 达到上限后新的投递退回队列
+
+    /// @struct Unacked
+    /// @brief 信道中一条已推送未确认的消息
+    struct Unacked
+    {
+        uint64_t tag = 0;   ///< 队列内的投递标识 0表示空位
+        uint32_t queue = 0; ///< 队列名称在信道队列名称表中的下标
+
+        explicit operator bool() const { return tag != 0; }
+    };
     /// @class Channel
     /// @brief 信道类
     class Channel
@@ -55,14 +71,23 @@ namespace XuMQ
         /// @param codec 协议处理句柄
         /// @param conn muduo连接管理句柄
         /// @param pool 线程池管理句柄
+        /// @param unacked_limit 已推送未确认消息数的上限
         Channel(const std::string &id, const VirtualHost::ptr &host, const ConsumerManager::ptr &cmp,
-                const ProtobufCodecPtr &codec, const muduo::net::TcpConnectionPtr &conn, const threadpool::ptr &pool)
-            : _cid(id), _conn(conn), _codec(codec), _cmp(cmp), _host(host), _pool(pool) {}
-        /// @brief 析构函数
+                const ProtobufCodecPtr &codec, const muduo::net::TcpConnectionPtr &conn, const threadpool::ptr &pool,
+                size_t unacked_limit = CHANNEL_UNACKED_LIMIT)
+            : _cid(id), _unacked_limit(unacked_limit), _conn(conn), _codec(codec), _cmp(cmp), _host(host), _pool(pool) {}
+        /// @brief 析构函数 未确认的消息放回各自队列的队头 再为每条退回的消息添加一次推送任务
         ~Channel()
         {
             if (_consumer.get() != nullptr)
                 _cmp->remove(_consumer->tag, _consumer->qname);
+            std::vector<size_t> requeued(_queues.size(), 0);
+            _unacked.each([&](uint64_t, const Unacked &entry)
+                          {
+                              if (_host->basicRequeue(_queues[entry.queue], entry.tag))
+                                  requeued[entry.queue]++; });
+            for (size_t i = 0; i < _queues.size(); i++)
+                dispatch(_queues[i], requeued[i]);
         }
         /// @brief 声明交换机请求处理函数
         /// @param req 声明交换机请求
@@ -99,6 +124,13 @@ namespace XuMQ
             _host->deleteQueue(req->queue_name());
             basicRespFunc(true, req->rid(), req->cid());
         }
+        /// @brief 清空队列请求处理函数
+        /// @param req 清空队列请求
+        void purgeQueue(const queuePurgeRequestPtr &req)
+        {
+            bool ret = _host->purgeQueue(req->queue_name());
+            basicRespFunc(ret, req->rid(), req->cid());
+        }
         /// @brief 队列绑定请求处理函数
         /// @param req 队列绑定请求
         void queueBind(const queueBindRequestPtr &req)
@@ -120,9 +152,12 @@ namespace XuMQ
             // 获取交换机
             Exchange::ptr ep = _host->selectExchange(req->exchange_name());
             if (ep.get() == nullptr)
+            {
                 basicRespFunc(false, req->rid(), req->cid());
-            // 获取指定交换机的绑定信息
-            MsgQueueBindingMap mqbm = _host->exchangeBindings(req->exchange_name());
+                return;
+            }
+            // 获取指定交换机的绑定信息快照 不加锁 不复制
+            BindingSnapshot mqbm = _host->exchangeBindings(req->exchange_name());
             BasicProperties *properties = nullptr;
             std::string routing_key;
 
@@ -131,26 +166,44 @@ namespace XuMQ
                 properties = req->mutable_properties();
                 routing_key = properties->routing_key();
             }
-            for (auto &binding : mqbm)
+            // 交换路由 找到对应的队列
+            std::vector<std::string> qnames;
+            for (auto &binding : *mqbm)
             {
-                // 交换路由 找到对应的队列
                 if (Router::route(ep->type, routing_key, binding.second->binding_key))
-                {
-                    // 将消息添加到队列中
-                    _host->basicPublish(binding.first, properties, req->body());
-                    // 向线程池中添加一个消息消费任务(向指定队列的订阅者推送消息)
-                    auto task = std::bind(&Channel::consume, this, binding.first);
-                    _pool->push(task);
-                }
-                basicRespFunc(true, req->rid(), req->cid());
+                    qnames.push_back(binding.first);
             }
+            // 将消息添加到所有队列中 各队列共享同一个消息对象
+            _host->basicPublish(qnames, properties, req->body());
+            // 向线程池中添加消息消费任务(向指定队列的订阅者推送消息)
+            for (auto &qname : qnames)
+                dispatch(qname);
+            basicRespFunc(true, req->rid(), req->cid());
         }
         /// @brief 确认消息请求处理函数
         /// @param req 确认消息请求
+        /// @note 因达到未确认上限而退回过消息的队列 在确认腾出位置后重新推送
         void basicAck(const basicAckRequestPtr &req)
         {
-            _host->basicAck(req->queue_name(), req->msg_id());
-            basicRespFunc(true, req->rid(), req->cid());
+            Unacked entry;
+            std::string qname;
+            std::vector<std::string> resumed;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                if (_unacked.take(req->delivery_tag(), entry) == false)
+                {
+                    warn(logger, "确认消息失败, 信道 %s 中没有投递标识 %llu", _cid.c_str(), (unsigned long long)req->delivery_tag());
+                    basicRespFunc(false, req->rid(), req->cid());
+                    return;
+                }
+                qname = _queues[entry.queue];
+                if (_throttled.empty() == false && _unacked.size() < _unacked_limit)
+                    resumed.swap(_throttled);
+            }
+            bool ret = _host->basicAck(qname, entry.tag);
+            basicRespFunc(ret, req->rid(), req->cid());
+            for (auto &name : resumed)
+                dispatch(name);
         }
         /// @brief 订阅消息请求处理函数
         /// @param req 订阅消息请求
@@ -159,9 +212,13 @@ namespace XuMQ
             // 判断队列是否存在
             bool ret = _host->existsQueue(req->queue_name());
             if (ret == false)
+            {
                 basicRespFunc(false, req->rid(), req->cid());
+                return;
+            }
             // 创建队列消费者
-            auto cb = std::bind(&Channel::callback, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
+            auto cb = std::bind(&Channel::callback, this, std::placeholders::_1, std::placeholders::_2,
+                                std::placeholders::_3, std::placeholders::_4, std::placeholders::_5);
             // 创建消费者之后 信道的角色就是消费者
             _consumer = _cmp->create(req->consumer_tag(), req->queue_name(), req->auto_ack(), cb);
             if(_consumer==nullptr)
@@ -173,6 +230,9 @@ namespace XuMQ
                 info(logger,"消费者创建成功！");
             }
             basicRespFunc(true, req->rid(), req->cid());
+            // 没有消费者期间退回或积压的消息 在有了消费者之后推送 一次最多推送未确认消息的上限条
+            if (_consumer.get() != nullptr)
+                dispatch(req->queue_name(), std::min(_host->availableCount(req->queue_name()), _unacked_limit));
         }
         /// @brief 取消订阅请求处理函数
         /// @param req 取消订阅请求
@@ -195,36 +255,73 @@ namespace XuMQ
             resp.set_ok(ok);
             _codec->send(_conn, resp);
         }
+        /// @brief 向线程池中添加推送任务 每个任务向队列的订阅者推送一条消息
+        /// @param qname 队列名称
+        /// @param count 任务个数
+        /// @note 任务只持有虚拟机和消费者管理句柄 不引用信道 信道关闭后仍可执行
+        void dispatch(const std::string &qname, size_t count = 1)
+        {
+            for (size_t i = 0; i < count; i++)
+                _pool->push(std::bind(&Channel::consume, _host, _cmp, qname));
+        }
         /// @brief 消费调用函数
+        /// @param host 虚拟机
+        /// @param cmp 消费者管理句柄
         /// @param qname 队列名称
-        void consume(const std::string &qname)
+        /// @note 没有消费者时消息退回队头 不再添加任务 等有消费者订阅时再推送 @see basicConsume
+        static void consume(const VirtualHost::ptr &host, const ConsumerManager::ptr &cmp, const std::string &qname)
         {
-            MessagePtr mp = _host->basicConsume(qname);
+            uint64_t tag;
+            MessagePtr mp = host->basicConsume(qname, tag);
             if (mp.get() == nullptr)
             {
                 error(logger, "消费任务失败, 指定队列中没有消息: %s", qname.c_str());
                 return;
             }
-            Consumer::ptr cp = _cmp->choose(qname);
+            Consumer::ptr cp = cmp->choose(qname);
             if (cp.get() == nullptr)
             {
                 error(logger, "消费任务失败, 指定队列中没有消费者: %s", qname.c_str());
+                host->basicRequeue(qname, tag);
                 return;
             }
-            cp->callback(cp->tag, mp->mutable_payload()->mutable_properties(), mp->payload().body());
             if (cp->auto_ack == true)
-                _host->basicAck(qname, mp->payload().properties().id());
+            {
+                host->basicAck(qname, tag);
+                tag = 0;
+            }
+            // 投递时才生成消息属性和消息体
+            BasicProperties properties = mp->properties();
+            cp->callback(cp->tag, qname, tag, &properties, std::string(mp->body()));
         }
-        /// @brief 消费者回调函数
+        /// @brief 消费者回调函数 为需要确认的消息分配信道内的投递标识
+        /// @note 未确认的消息达到上限时不推送 消息退回队头 等到确认腾出位置后再推送
         /// @param tag 消费者标识
+        /// @param qname 队列名称
+        /// @param queue_tag 队列内的投递标识 自动确认的消息为0
         /// @param bp 消息属性
         /// @param body 消息主体
-        void callback(const std::string &tag, const BasicProperties *bp, const std::string &body)
+        void callback(const std::string &tag, const std::string &qname, uint64_t queue_tag,
+                      const BasicProperties *bp, const std::string &body)
         {
             basicConsumeResponse resp;
             resp.set_cid(_cid);
             resp.set_body(body);
             resp.set_consumer_tag(tag);
+            if (queue_tag != 0)
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                if (_unacked.size() >= _unacked_limit)
+                {
+                    if (std::find(_throttled.begin(), _throttled.end(), qname) == _throttled.end())
+                        _throttled.push_back(qname);
+                    lock.unlock();
+                    debug(logger, "信道 %s 未确认的消息达到上限 %zu, 消息退回队列 %s", _cid.c_str(), _unacked_limit, qname.c_str());
+                    _host->basicRequeue(qname, queue_tag);
+                    return;
+                }
+                resp.set_delivery_tag(_unacked.push(Unacked{queue_tag, queueIndex(qname)}));
+            }
             if (bp)
             {
                 resp.mutable_properties()->set_id(bp->id());
@@ -233,10 +330,27 @@ namespace XuMQ
             }
             _codec->send(_conn, resp);
         }
+        /// @brief 获取队列名称在信道队列名称表中的下标 需持有信道锁
+        /// @note 一个信道通常只从一两个队列接收消息 顺序查找即可
+        uint32_t queueIndex(const std::string &qname)
+        {
+            for (size_t i = 0; i < _queues.size(); i++)
+            {
+                if (_queues[i] == qname)
+                    return i;
+            }
+            _queues.push_back(qname);
+            return _queues.size() - 1;
+        }
 
     private:
         std::string _cid;                   ///< 信道id
         Consumer::ptr _consumer;            ///< 消费者对象
+        std::mutex _mutex;                  ///< 保护待确认窗口和队列名称表
+        DeliveryWindow<Unacked> _unacked;   ///< 待确认窗口 以信道内的投递标识为键
+        std::vector<std::string> _queues;   ///< 信道接收过消息的队列名称 待确认窗口中以下标引用
+        std::vector<std::string> _throttled; ///< 因达到未确认上限而退回过消息的队列
+        size_t _unacked_limit;              ///< 未确认消息数的上限
         muduo::net::TcpConnectionPtr _conn; ///< muduo连接管理句柄
         ProtobufCodecPtr _codec;            ///< 协议处理句柄
         ConsumerManager::ptr _cmp;          ///< 消费者管理句柄
@@ -263,19 +377,18 @@ namespace XuMQ
         bool openChannel(const std::string &id, const VirtualHost::ptr &host, const ConsumerManager::ptr &cmp,
                          const ProtobufCodecPtr &codec, const muduo::net::TcpConnectionPtr &conn, const threadpool::ptr &pool)
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            auto it = _channels.find(id);
-            if (it != _channels.end())
-                return false;
-            auto channel = std::make_shared<Channel>(id, host, cmp, codec, conn, pool);
-            _channels.insert(std::make_pair(id, channel));
-            return true;
+            return _channels.update(id, [&](std::unordered_map<std::string, Channel::ptr> &channels)
+                                    {
+                                        if (channels.find(id) != channels.end())
+                                            return false;
+                                        channels.insert(std::make_pair(id, std::make_shared<Channel>(id, host, cmp, codec, conn, pool)));
+                                        return true; });
         }
         /// @brief 关闭信道
         /// @param id 信道id
+        /// @note 信道在释放分片锁之后析构 析构时退回未确认的消息
         void closeChannel(const std::string &id)
         {
-            std::unique_lock<std::mutex> lock(_mutex);
             _channels.erase(id);
         }
         /// @brief 获取信道句柄
@@ -283,15 +396,10 @@ namespace XuMQ
         /// @return 信道管理句柄
         Channel::ptr getChannel(const std::string &id)
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            auto it = _channels.find(id);
-            if (it == _channels.end())
-                return Channel::ptr();
-            return it->second;
+            return _channels.find(id);
         }
 
     private:
-        std::mutex _mutex; ///< 互斥锁
-        std::unordered_map<std::string, Channel::ptr> _channels; ///< 信道id到信道管理句柄的映射表
+        Registry<std::string, Channel::ptr> _channels; ///< 信道id到信道管理句柄的映射表 按信道id分片加锁
     };
-}
\ No newline at end of file
+}
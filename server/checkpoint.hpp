@@ -0,0 +1,114 @@
+/**
+ * @file checkpoint.hpp
+ * @brief 队列索引检查点的实现
+ *
+ * 该文件定义了 XuMQ 命名空间中的 Checkpoint 类。
+ *
+ * 检查点保存某一时刻队列中所有存活持久化消息的位置(序号, 段号, 偏移, 长度, 消息id)、
+ * 各个段的统计信息和当时的日志位置(活跃段号, 尾部偏移)。重启时按检查点直接读取存活消息，
+ * 只扫描检查点之后追加的数据，不再读取已确认的数据，也不重写数据段。
+ *
+ * 文件格式: sizeof(size_t)字节长度|QueueCheckpoint序列化数据，
+ * 先写入临时文件并刷盘，再原子地重命名覆盖原文件。
+ */
+
+#pragma once
+#include "../common/logger.hpp"
+#include "../common/helper.hpp"
+#include "../common/msg.pb.h"
+#include <iostream>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace XuMQ
+{
+    const char *CHECKPOINT_FILE = "checkpoint";          ///< 检查点文件名
+    const size_t CHECKPOINT_INTERVAL_MS = 5000;          ///< 定时写入检查点的周期(毫秒)
+
+    /// @class Checkpoint
+    /// @brief 队列索引检查点文件
+    class Checkpoint
+    {
+    public:
+        /// @brief 构造函数
+        /// @param filename 检查点文件名
+        Checkpoint(const std::string &filename)
+            : _filename(filename)
+        {
+        }
+        /// @brief 写入检查点
+        /// @param checkpoint 检查点数据
+        /// @return 成功返回true 失败返回false
+        /// @note 调用者需保证检查点引用的数据已经落盘
+        bool save(const QueueCheckpoint &checkpoint)
+        {
+            std::string body = checkpoint.SerializeAsString();
+            size_t len = body.size();
+            body.insert(0, (const char *)&len, sizeof(len));
+            std::string tmpfile = _filename + ".tmp";
+            int fd = ::open(tmpfile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0)
+            {
+                error(logger, "%s:创建检查点临时文件失败! %s", tmpfile.c_str(), strerror(errno));
+                return false;
+            }
+            size_t done = 0;
+            while (done < body.size())
+            {
+                ssize_t ret = ::write(fd, body.data() + done, body.size() - done);
+                if (ret < 0 && errno == EINTR)
+                    continue;
+                if (ret < 0)
+                    break;
+                done += ret;
+            }
+            bool ret = done == body.size() && ::fdatasync(fd) == 0;
+            ::close(fd);
+            if (ret == false || FileHelper(tmpfile).rename(_filename) == false)
+            {
+                error(logger, "%s:写入检查点失败! %s", _filename.c_str(), strerror(errno));
+                FileHelper::removeFile(tmpfile);
+                return false;
+            }
+            return true;
+        }
+        /// @brief 读取检查点
+        /// @param checkpoint 存储检查点数据
+        /// @return 成功返回true 文件不存在或已损坏返回false
+        bool load(QueueCheckpoint &checkpoint)
+        {
+            FileHelper::removeFile(_filename + ".tmp"); // 写入中途退出残留的临时文件
+            FileHelper helper(_filename);
+            if (helper.exists() == false)
+                return false;
+            std::string body;
+            if (helper.read(body) == false)
+                return false;
+            size_t len;
+            if (body.size() < sizeof(len))
+                return false;
+            memcpy(&len, body.data(), sizeof(len));
+            if (body.size() - sizeof(len) != len)
+            {
+                warn(logger, "%s:检查点文件长度不一致, 已忽略", _filename.c_str());
+                return false;
+            }
+            if (checkpoint.ParseFromArray(body.data() + sizeof(len), len) == false)
+            {
+                warn(logger, "%s:检查点文件解析失败, 已忽略", _filename.c_str());
+                return false;
+            }
+            return true;
+        }
+        /// @brief 删除检查点
+        void remove()
+        {
+            FileHelper::removeFile(_filename);
+            FileHelper::removeFile(_filename + ".tmp");
+        }
+
+    private:
+        std::string _filename; ///< 检查点文件名
+    };
+}
@@ -99,18 +99,15 @@ namespace XuMQ
                            const ProtobufCodecPtr &codec, const muduo::net::TcpConnectionPtr &conn,
                            const threadpool::ptr &pool)
         {
-            std::unique_lock lock(_mutex);
-            auto it = _conns.find(conn);
-            if (it != _conns.end())
-                return;
-            Connection::ptr self_conn = std::make_shared<Connection>(host, cmp, codec, conn, pool);
-            _conns.insert(std::make_pair(conn, self_conn));
+            _conns.update(conn, [&](std::unordered_map<muduo::net::TcpConnectionPtr, Connection::ptr> &conns)
+                          {
+                              if (conns.find(conn) == conns.end())
+                                  conns.insert(std::make_pair(conn, std::make_shared<Connection>(host, cmp, codec, conn, pool))); });
         }
         /// @brief 删除一个连接
         /// @param conn muduo连接管理句柄
         void deleteConnection(const muduo::net::TcpConnectionPtr &conn)
         {
-            std::unique_lock lock(_mutex);
             _conns.erase(conn);
         }
         /// @brief 获取一个连接
@@ -118,15 +115,10 @@ namespace XuMQ
         /// @return 连接句柄
         Connection::ptr getConnection(const muduo::net::TcpConnectionPtr &conn)
         {
-            std::unique_lock lock(_mutex);
-            auto it = _conns.find(conn);
-            if (it == _conns.end())
-                return Connection::ptr();
-            return it->second;
+            return _conns.find(conn);
         }
 
     private:
-        std::mutex _mutex;                                                        ///< 互斥锁
-        std::unordered_map<muduo::net::TcpConnectionPtr, Connection::ptr> _conns; ///< 一个从muduo连接管理句柄到连接管理句柄的映射表
+        Registry<muduo::net::TcpConnectionPtr, Connection::ptr> _conns; ///< 一个从muduo连接管理句柄到连接管理句柄的映射表 按连接分片加锁
     };
-}
\ No newline at end of file
+}
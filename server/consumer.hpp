@@ -12,6 +12,7 @@
 #include "../common/logger.hpp"
 #include "../common/helper.hpp"
 #include "../common/msg.pb.h"    
+#include "../common/registry.hpp"
 #include <iostream>
 #include <unordered_map>
 #include <vector>
@@ -21,7 +22,8 @@
 
 namespace XuMQ
 {
-    using ConsumerCallback = std::function<void(const std::string&, const BasicProperties *, const std::string&)>; ///< 消费者回调函数
+    /// @brief 消费者回调函数 参数依次为消费者标识、队列名称、队列内的投递标识(自动确认时为0)、消息属性和消息主体
+    using ConsumerCallback = std::function<void(const std::string &, const std::string &, uint64_t, const BasicProperties *, const std::string &)>;
     /// @struct Consumer
     /// @brief 消费者对象结构
     struct Consumer
@@ -156,23 +158,16 @@ namespace XuMQ
         /// @param name 队列名称
         void initQueueConsumer(const std::string &name)
         {
-            // 加锁
-            std::unique_lock<std::mutex> lock(_mutex);
-            // 判断重复
-            auto it = _qconsumers.find(name);
-            if (it != _qconsumers.end())
-            {
-                return;
-            }
-            // 新增
-            auto qconsumers = std::make_shared<QueueConsumer>(name);
-            _qconsumers.insert(std::make_pair(name, qconsumers));
+            // 判断重复 不存在时新增
+            _qconsumers.update(name, [&](QueueConsumerMap &qconsumers)
+                               {
+                                   if (qconsumers.find(name) == qconsumers.end())
+                                       qconsumers.insert(std::make_pair(name, std::make_shared<QueueConsumer>(name))); });
         }
         /// @brief 销毁消费者队列
         /// @param name 队列名称
         void destroyQueueConsumer(const std::string &name)
         {
-            std::unique_lock<std::mutex> lock(_mutex);
             _qconsumers.erase(name);
         }
         /// @brief 向指定队列新增消费者
@@ -183,18 +178,10 @@ namespace XuMQ
         /// @return 消费者指针
         Consumer::ptr create(const std::string &ctag, const std::string &queue_name, bool ack, const ConsumerCallback &cb)
         {
-            QueueConsumer::ptr qcp;
-            {
-                std::unique_lock<std::mutex> lock(_mutex);
-                // 获取队列的消费者管理单元
-                auto it = _qconsumers.find(queue_name);
-                if (it == _qconsumers.end())
-                {
-                    warn(logger, "没有找到指定队列! 队列名称: %s", queue_name.c_str());
-                    return Consumer::ptr();
-                }
-                qcp = it->second;
-            }
+            // 获取队列的消费者管理单元
+            QueueConsumer::ptr qcp = select(queue_name);
+            if (qcp.get() == nullptr)
+                return Consumer::ptr();
             // 完成新建
             return qcp->create(ctag, queue_name, ack, cb);
         }
@@ -203,18 +190,9 @@ namespace XuMQ
         /// @param queue_name 队列名称
         void remove(const std::string &ctag, const std::string &queue_name)
         {
-            QueueConsumer::ptr qcp;
-            {
-                std::unique_lock<std::mutex> lock(_mutex);
-                // 获取队列的消费者管理单元
-                auto it = _qconsumers.find(queue_name);
-                if (it == _qconsumers.end())
-                {
-                    warn(logger, "没有找到指定队列! 队列名称: %s", queue_name.c_str());
-                    return;
-                }
-                qcp = it->second;
-            }
+            QueueConsumer::ptr qcp = select(queue_name);
+            if (qcp.get() == nullptr)
+                return;
             qcp->remove(ctag);
         }
         /// @brief 获取指定队列的消费者
@@ -222,18 +200,9 @@ namespace XuMQ
         /// @return 消费者指针
         Consumer::ptr choose(const std::string &queue_name)
         {
-            QueueConsumer::ptr qcp;
-            {
-                std::unique_lock<std::mutex> lock(_mutex);
-                // 获取队列的消费者管理单元
-                auto it = _qconsumers.find(queue_name);
-                if (it == _qconsumers.end())
-                {
-                    warn(logger, "没有找到指定队列! 队列名称: %s", queue_name.c_str());
-                    return Consumer::ptr();
-                }
-                qcp = it->second;
-            }
+            QueueConsumer::ptr qcp = select(queue_name);
+            if (qcp.get() == nullptr)
+                return Consumer::ptr();
             return qcp->choose();
         }
 
@@ -242,18 +211,9 @@ namespace XuMQ
         /// @return 为空返回true 不为空返回false
         bool empty(const std::string &queue_name)
         {
-            QueueConsumer::ptr qcp;
-            {
-                std::unique_lock<std::mutex> lock(_mutex);
-                // 获取队列的消费者管理单元
-                auto it = _qconsumers.find(queue_name);
-                if (it == _qconsumers.end())
-                {
-                    warn(logger, "没有找到指定队列! 队列名称: %s", queue_name.c_str());
-                    return true;
-                }
-                qcp = it->second;
-            }
+            QueueConsumer::ptr qcp = select(queue_name);
+            if (qcp.get() == nullptr)
+                return true;
             return qcp->empty();
         }
         /// @brief 判断队列中的消费者是否存在
@@ -262,30 +222,32 @@ namespace XuMQ
         /// @return 存在返回true 不存在返回false
         bool exists(const std::string &ctag, const std::string &queue_name)
         {
-            QueueConsumer::ptr qcp;
-            {
-                std::unique_lock<std::mutex> lock(_mutex);
-                // 获取队列的消费者管理单元
-                auto it = _qconsumers.find(queue_name);
-                if (it == _qconsumers.end())
-                {
-                    warn(logger, "没有找到指定队列! 队列名称: %s", queue_name.c_str());
-                    return false;
-                }
-                qcp = it->second;
-            }
+            QueueConsumer::ptr qcp = select(queue_name);
+            if (qcp.get() == nullptr)
+                return false;
             return qcp->exists(ctag);
         }
         /// @brief 清理
         void clear()
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            QueueConsumer::ptr qcp;
             _qconsumers.clear();
         }
 
     private:
-        std::mutex _mutex;
-        std::unordered_map<std::string, QueueConsumer::ptr> _qconsumers;
+        using QueueConsumerMap = std::unordered_map<std::string, QueueConsumer::ptr>; ///< 队列名称->消费者管理单元
+
+        /// @brief 获取队列的消费者管理单元
+        /// @param queue_name 队列名称
+        /// @return 消费者管理单元 队列不存在时返回空指针
+        QueueConsumer::ptr select(const std::string &queue_name)
+        {
+            QueueConsumer::ptr qcp = _qconsumers.find(queue_name);
+            if (qcp.get() == nullptr)
+                warn(logger, "没有找到指定队列! 队列名称: %s", queue_name.c_str());
+            return qcp;
+        }
+
+    private:
+        Registry<std::string, QueueConsumer::ptr> _qconsumers; ///< 各队列的消费者管理单元 按队列名称分片加锁
     };
-}
\ No newline at end of file
+}
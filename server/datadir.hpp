@@ -0,0 +1,140 @@
+/**
+ * @file datadir.hpp
+ * @brief 消息数据目录的定义
+ *
+ * 该文件定义了 XuMQ 命名空间中的 DataDirectories 类，负责将队列的消息数据分布到多个数据目录(通常位于不同的磁盘)。
+ *
+ * 每个队列的数据整体存放在其中一个目录下的 "目录/队列名称/" 中，不跨目录拆分;
+ * 新队列按放置策略选择目录，已有数据的队列(包括旧版本的 "目录/队列名称.mqd" 数据文件)无论放置策略如何都留在原来的目录，
+ * 因此调整目录列表的顺序或增加目录后，重启仍能恢复所有队列。
+ * 共享日志固定位于第一个目录下。
+ */
+
+#pragma once
+#include "../common/logger.hpp"
+#include "../common/helper.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <memory>
+#include <sys/statvfs.h>
+
+namespace XuMQ
+{
+    const char *DATAFILE_SUBFIX = ".mqd";    ///< 旧版本数据文件后缀名
+    const char *TMPFILE_SUBFIX = ".mqd.tmp"; ///< 旧版本临时文件后缀名
+
+    /// @brief 新队列选择数据目录的方式
+    enum class PlacementPolicy
+    {
+        HASH,      ///< 按队列名称的哈希值选择 同名队列总是落在同一个目录
+        LEAST_USED ///< 选择可用空间最多的目录 可用空间相同时选择放置队列最少的目录
+    };
+
+    /// @class DataDirectories
+    /// @brief 管理多个数据目录 为每个队列确定数据所在的目录
+    class DataDirectories
+    {
+    public:
+        using ptr = std::shared_ptr<DataDirectories>;
+        /// @brief 构造函数 末尾没有分隔符的目录会补上'/'
+        /// @param dirs 数据目录列表 不能为空
+        /// @param policy 新队列的放置策略
+        DataDirectories(const std::vector<std::string> &dirs, PlacementPolicy policy = PlacementPolicy::HASH)
+            : _dirs(dirs), _policy(policy)
+        {
+            if (_dirs.empty())
+            {
+                fatal(logger, "至少需要一个数据目录!");
+                abort();
+            }
+            for (auto &dir : _dirs)
+            {
+                if (dir.back() != '/' && dir.back() != '\\')
+                    dir.push_back('/');
+            }
+        }
+        /// @brief 确定队列数据所在的目录
+        /// @param qname 队列名称
+        /// @return 数据目录 末尾带分隔符
+        /// @note 先在所有目录中查找已有的队列数据 找不到时按放置策略选择 结果在释放前保持不变
+        std::string locate(const std::string &qname)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            auto it = _placed.find(qname);
+            if (it != _placed.end())
+                return _dirs[it->second];
+            size_t index = _dirs.size();
+            for (size_t i = 0; i < _dirs.size(); i++)
+            {
+                if (FileHelper(_dirs[i] + qname).exists() || FileHelper(_dirs[i] + qname + DATAFILE_SUBFIX).exists())
+                {
+                    index = i;
+                    break;
+                }
+            }
+            if (index == _dirs.size())
+                index = _policy == PlacementPolicy::HASH ? hashIndex(qname) : leastUsedIndex();
+            _placed.insert(std::make_pair(qname, index));
+            return _dirs[index];
+        }
+        /// @brief 队列删除后释放其放置记录 同名队列重新声明时重新选择目录
+        /// @param qname 队列名称
+        void release(const std::string &qname)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _placed.erase(qname);
+        }
+        /// @brief 获取第一个数据目录 共享日志位于该目录下
+        const std::string &primary() const { return _dirs.front(); }
+        /// @brief 获取所有数据目录
+        const std::vector<std::string> &dirs() const { return _dirs; }
+
+    private:
+        /// @brief 按队列名称的哈希值选择目录
+        /// @note 使用 CRC32C 而不是 std::hash 保证不同构建的代理放置结果一致
+        size_t hashIndex(const std::string &qname) const
+        {
+            return CRCHelper::crc32c(qname.data(), qname.size()) % _dirs.size();
+        }
+        /// @brief 选择可用空间最多的目录 获取不到可用空间的目录视为0
+        size_t leastUsedIndex() const
+        {
+            std::vector<size_t> counts(_dirs.size(), 0);
+            for (auto &placed : _placed)
+                counts[placed.second]++;
+            size_t best = 0;
+            unsigned long long best_avail = 0;
+            for (size_t i = 0; i < _dirs.size(); i++)
+            {
+                unsigned long long avail = available(_dirs[i]);
+                if (i == 0 || avail > best_avail || (avail == best_avail && counts[i] < counts[best]))
+                {
+                    best = i;
+                    best_avail = avail;
+                }
+            }
+            return best;
+        }
+        /// @brief 获取目录所在文件系统的可用字节数 目录不存在时先创建
+        static unsigned long long available(const std::string &dir)
+        {
+            if (FileHelper(dir).exists() == false)
+                FileHelper::createDirectory(dir);
+            struct statvfs st;
+            if (::statvfs(dir.c_str(), &st) < 0)
+            {
+                warn(logger, "%s:获取数据目录的可用空间失败! %s", dir.c_str(), strerror(errno));
+                return 0;
+            }
+            return (unsigned long long)st.f_bavail * st.f_frsize;
+        }
+
+    private:
+        std::mutex _mutex;                               ///< 互斥锁
+        std::vector<std::string> _dirs;                  ///< 数据目录列表
+        PlacementPolicy _policy;                         ///< 新队列的放置策略
+        std::unordered_map<std::string, size_t> _placed; ///< 队列名称与数据目录下标的映射
+    };
+}
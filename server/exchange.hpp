@@ -10,6 +10,7 @@
 #include "../common/logger.hpp"
 #include "../common/helper.hpp"
 #include "../common/msg.pb.h"
+#include "../common/registry.hpp"
 #include <iostream>
 #include <unordered_map>
 #include <mutex>
@@ -198,7 +199,7 @@ namespace XuMQ
         ExchangeManager(const std::string &dbfile)
             : _mapper(dbfile)
         {
-            _exchanges = _mapper.recovery();
+            _exchanges.assign(_mapper.recovery());
         }
         /// @brief 声明交换机
         /// @param name 交换机名称
@@ -213,58 +214,46 @@ namespace XuMQ
                              bool auto_delete,
                              const google::protobuf::Map<std::string, std::string> &args)
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            auto it = _exchanges.find(name);
-            if (it != _exchanges.end())
-                return true;
-            auto exp = std::make_shared<Exchange>(name, type, durable, auto_delete, args);
-            if (durable)
-            {
-                bool ret = _mapper.insert(exp);
-                if (ret == false)
-                    return false;
-            }
-            _exchanges.insert(std::make_pair(name, exp));
-            return true;
+            return _exchanges.update(name, [&](ExchangeMap &exchanges)
+                                     {
+                                         if (exchanges.find(name) != exchanges.end())
+                                             return true;
+                                         auto exp = std::make_shared<Exchange>(name, type, durable, auto_delete, args);
+                                         if (durable && _mapper.insert(exp) == false)
+                                             return false;
+                                         exchanges.insert(std::make_pair(name, exp));
+                                         return true; });
         }
         /// @brief 删除交换机
         /// @param name 交换机名称
         void deleteExchange(const std::string &name)
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            auto it = _exchanges.find(name);
-            if (it == _exchanges.end())
-                return;
-            _exchanges.erase(name);
-            if (it->second->durable == true)
-                _mapper.remove(name);
+            _exchanges.update(name, [&](ExchangeMap &exchanges)
+                              {
+                                  auto it = exchanges.find(name);
+                                  if (it == exchanges.end())
+                                      return;
+                                  if (it->second->durable == true)
+                                      _mapper.remove(name);
+                                  exchanges.erase(it); });
         }
         /// @brief 获取指定交换机
         /// @param name 交换机名称
         /// @return 交换机对象指针
         Exchange::ptr selectExchange(const std::string &name)
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            auto it = _exchanges.find(name);
-            if (it == _exchanges.end())
-                return Exchange::ptr();
-            return it->second;
+            return _exchanges.find(name);
         }
         /// @brief 判断交换机是否存在
         /// @param name 交换机名称
         /// @return true表示交换机存在 flase表示交换机不存在
         bool exists(const std::string &name)
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            auto it = _exchanges.find(name);
-            if (it == _exchanges.end())
-                return false;
-            return true;
+            return _exchanges.exists(name);
         }
         /// @brief 清除所有交换机数据
         void clear()
         {
-            std::unique_lock<std::mutex> lock(_mutex);
             _mapper.removeTable();
             _exchanges.clear();
         }
@@ -272,13 +261,11 @@ namespace XuMQ
         /// @return 交换机数量
         size_t size()
         {
-            std::unique_lock<std::mutex> lock(_mutex);
             return _exchanges.size();
         }
 
     private:
-        std::mutex _mutex;      ///< 互斥锁
-        ExchangeMapper _mapper; ///< 持久化交换机管理类
-        ExchangeMap _exchanges; ///< 全部交换机信息
+        ExchangeMapper _mapper;                          ///< 持久化交换机管理类
+        Registry<std::string, Exchange::ptr> _exchanges; ///< 全部交换机信息 按名称分片加锁
     };
-}
\ No newline at end of file
+}
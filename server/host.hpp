@@ -27,17 +27,46 @@ namespace XuMQ
         /// @param hname 虚拟机名称
         /// @param basedir 基础目录
         /// @param dbfile 数据库目录
-        VirtualHost(const std::string hname, const std::string &basedir, const std::string &dbfile)
+        /// @param policy 虚拟机默认持久化策略 队列声明参数可以覆盖
+        /// @param recovery_threads 恢复历史消息的线程数 0表示使用CPU核心数
+        /// @param storage 持久化消息的存储方式 共享日志适合扇出和大量小队列的场景
+        /// @note 所有队列恢复完成后构造函数才返回 服务器在此之后才开始监听
+        VirtualHost(const std::string hname, const std::string &basedir, const std::string &dbfile,
+                    const DurabilityPolicy &policy = DurabilityPolicy(), size_t recovery_threads = 0,
+                    StorageMode storage = StorageMode::PER_QUEUE)
+            : VirtualHost(hname, std::vector<std::string>{basedir}, dbfile, policy, recovery_threads, storage)
+        {
+        }
+        /// @brief 虚拟机构造函数 消息数据分布在多个数据目录中 恢复历史消息
+        /// @param hname 虚拟机名称
+        /// @param datadirs 数据目录列表 每个队列的数据位于其中一个目录 恢复时在所有目录中查找
+        /// @param dbfile 数据库目录
+        /// @param policy 虚拟机默认持久化策略 队列声明参数可以覆盖
+        /// @param recovery_threads 恢复历史消息的线程数 0表示使用CPU核心数
+        /// @param storage 持久化消息的存储方式 共享日志位于第一个数据目录下
+        /// @param placement 新队列选择数据目录的方式
+        VirtualHost(const std::string hname, const std::vector<std::string> &datadirs, const std::string &dbfile,
+                    const DurabilityPolicy &policy = DurabilityPolicy(), size_t recovery_threads = 0,
+                    StorageMode storage = StorageMode::PER_QUEUE, PlacementPolicy placement = PlacementPolicy::HASH)
             : _emp(std::make_shared<ExchangeManager>(dbfile)),
               _mqmp(std::make_shared<MsgQueueManager>(dbfile)),
               _bmp(std::make_shared<BindingManager>(dbfile)),
-              _mmp(std::make_shared<MessageManager>(basedir))
+              _mmp(std::make_shared<MessageManager>(datadirs, policy, storage, placement))
 
         {
-            // 获取所有队列信息 通过队列信息恢复历史消息
+            // 获取所有队列信息 通过队列信息并行恢复历史消息
             QueueMap qm = _mqmp->allQueue();
+            std::vector<std::pair<std::string, QueueArgs>> queues;
             for (auto &q : qm)
-                _mmp->initQueueMessage(q.first);
+                queues.push_back(std::make_pair(q.first, q.second->args));
+            _mmp->recoverQueueMessages(queues, recovery_threads);
+        }
+
+        /// @brief 设置内存高水位 所有队列待推送消息的内存占用超过后换出到磁盘
+        /// @param bytes 字节数 0表示不限制
+        void setMemoryWatermark(size_t bytes)
+        {
+            _mmp->setMemoryWatermark(bytes);
         }
 
         /// @brief 声明交换机
@@ -79,7 +108,7 @@ namespace XuMQ
         {
             // 初始化队列消息句柄
             // 消息对立创建
-            _mmp->initQueueMessage(qname);
+            _mmp->initQueueMessage(qname, qargs);
             return _mqmp->declareQueue(qname, qdurable, qexclusive, qauto_delete, qargs);
         }
         /// @brief 删除消息队列
@@ -92,6 +121,20 @@ namespace XuMQ
             _bmp->removeMsgQueueBindings(name);
             return _mqmp->deleteQueue(name);
         }
+        /// @brief 清空消息队列中待推送的消息 队列、绑定信息和消费者保持不变
+        /// @param name 消息队列名称
+        /// @return 成功返回true 队列不存在返回false
+        bool purgeQueue(const std::string &name)
+        {
+            if (_mqmp->exists(name) == false)
+            {
+                error(logger, "清空队列失败, 队列 %s 不存在", name.c_str());
+                return false;
+            }
+            size_t count = _mmp->purgeQueueMessage(name);
+            info(logger, "队列 %s 已清空, 丢弃 %zu 条消息", name.c_str(), count);
+            return true;
+        }
 
         /// @brief 添加绑定信息
         /// @param ename 交换机名称
@@ -124,8 +167,8 @@ namespace XuMQ
         }
         /// @brief 获取交换机绑定信息
         /// @param ename 交换机名称
-        /// @return 消息队列绑定映射表 @see MsgQueueBindingMap
-        MsgQueueBindingMap exchangeBindings(const std::string &ename)
+        /// @return 绑定信息的只读快照 @see BindingSnapshot
+        BindingSnapshot exchangeBindings(const std::string &ename)
         {
             return _bmp->getExchangeBindings(ename);
         }
@@ -152,19 +195,58 @@ namespace XuMQ
             }
             return _mmp->insert(qname, bp, body, mqp->durable);
         }
+        /// @brief 向多个队列插入同一条消息 消息只构造一次 持久化消息体在共享日志模式下只写入一次
+        /// @param qnames 消息队列名称
+        /// @param bp 消息属性
+        /// @param body 消息主体
+        /// @return 全部插入成功返回true 失败返回false
+        bool basicPublish(const std::vector<std::string> &qnames, BasicProperties *bp, const std::string &body)
+        {
+            std::vector<std::pair<std::string, bool>> queues;
+            for (auto &qname : qnames)
+            {
+                MsgQueue::ptr mqp = _mqmp->selectQueue(qname);
+                if (mqp.get() == nullptr)
+                {
+                    error(logger, "发布消息失败, 队列 %s 不存在", qname.c_str());
+                    continue;
+                }
+                queues.push_back(std::make_pair(qname, mqp->durable));
+            }
+            if (queues.empty())
+                return qnames.empty();
+            return _mmp->insert(queues, bp, body) && queues.size() == qnames.size();
+        }
         /// @brief 获取队头消息
         /// @param qname 消息队列名称
+        /// @param tag 输出参数 队列内的投递标识 确认和退回消息时使用
         /// @return 消息指针
-        MessagePtr basicConsume(const std::string &qname)
+        MessagePtr basicConsume(const std::string &qname, uint64_t &tag)
         {
-            return _mmp->front(qname);
+            return _mmp->front(qname, tag);
         }
         /// @brief 应答消息
         /// @param qname 消息队列名称
-        /// @param msg_id 消息id
-        void basicAck(const std::string &qname, const std::string &msg_id)
+        /// @param tag 队列内的投递标识
+        /// @return 成功返回true 失败返回false
+        bool basicAck(const std::string &qname, uint64_t tag)
         {
-            _mmp->ack(qname, msg_id);
+            return _mmp->ack(qname, tag);
+        }
+        /// @brief 将已推送未确认的消息放回队头
+        /// @param qname 消息队列名称
+        /// @param tag 队列内的投递标识
+        /// @return 成功返回true 失败返回false
+        bool basicRequeue(const std::string &qname, uint64_t tag)
+        {
+            return _mmp->requeue(qname, tag);
+        }
+        /// @brief 获取队列中等待推送的消息数量
+        /// @param qname 消息队列名称
+        /// @return 等待推送的消息数量
+        size_t availableCount(const std::string &qname)
+        {
+            return _mmp->availableCount(qname);
         }
 
         /// @brief 获取指定交换机句柄
@@ -233,12 +315,10 @@ namespace XuMQ
                                 const std::string &basedir,
                                 const std::string &dbfile)
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            auto it = _vhosts.find(hname);
-            if(it!=_vhosts.end())
-                return true;
-            auto host = std::make_shared<VirtualHost>(hname, basedir, dbfile);
-            _vhosts.insert(std::make_pair(hname, host));
+            _vhosts.update(hname, [&](std::unordered_map<std::string, VirtualHost::ptr> &vhosts)
+                           {
+                               if (vhosts.find(hname) == vhosts.end())
+                                   vhosts.insert(std::make_pair(hname, std::make_shared<VirtualHost>(hname, basedir, dbfile))); });
             return true;
         }
 
@@ -246,10 +326,6 @@ namespace XuMQ
         /// @param hname 虚拟机名称
         void deleteVirtualHost(const std::string &hname)
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            auto it = _vhosts.find(hname);
-            if(it == _vhosts.end())
-                return;
             _vhosts.erase(hname);
         }
 
@@ -258,11 +334,7 @@ namespace XuMQ
         /// @return 成功获取虚拟机句柄 失败返回空指针
         VirtualHost::ptr selectVirtualHost(const std::string &hname)
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            auto it = _vhosts.find(hname);
-            if(it == _vhosts.end())
-                return VirtualHost::ptr();
-            return it->second;
+            return _vhosts.find(hname);
         }
 
         /// @brief 判断虚拟机是否存在
@@ -270,17 +342,12 @@ namespace XuMQ
         /// @return 存在返回true 失败返回false
         bool exists(const std::string &hname)
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            auto it = _vhosts.find(hname);
-            if(it == _vhosts.end())
-                return false;
-            return true;
+            return _vhosts.exists(hname);
         }
 
         /// @brief 清除所有虚拟机数据
         void clear()
         {
-            std::unique_lock<std::mutex> lock(_mutex);
             _vhosts.clear();
         }
 
@@ -288,11 +355,9 @@ namespace XuMQ
         /// @return 交换机个数
         size_t size()
         {
-            std::unique_lock<std::mutex> lock(_mutex);
             return _vhosts.size();
         }
     private:
-        std::mutex _mutex;                                         ///< 互斥锁
-        std::unordered_map<std::string, VirtualHost::ptr> _vhosts; ///< 虚拟机名称到虚拟机管理句柄的映射表
+        Registry<std::string, VirtualHost::ptr> _vhosts; ///< 虚拟机名称到虚拟机管理句柄的映射表 按名称分片加锁
     };
-}
\ No newline at end of file
+}
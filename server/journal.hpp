@@ -0,0 +1,298 @@
+/**
+ * @file journal.hpp
+ * @brief 虚拟机共享日志的实现
+ *
+ * 该文件定义了 XuMQ 命名空间中的 Journal 类。
+ *
+ * 共享日志模式下，一个虚拟机中所有队列的持久化消息顺序追加到同一个分段日志
+ * ("基础目录/.journal/")中，每个队列只在内存中保存指向共享日志的索引(段号, 偏移, 长度)。
+ * 扇出到多个持久化队列的发布因此是对同一个文件的顺序写，并发的刷盘请求合并为一次 fdatasync。
+ *
+ * 每条记录的引用部分列出引用它的所有队列的标识和序号 @see MessageRef
+ * 扇出到多个持久化队列的消息只写入一条记录，记录在每个引用它的队列中各算一条存活记录。
+ * 队列标识在队列目录创建时随机生成，队列删除后重新声明会得到新的标识，旧记录不会被误恢复。
+ *
+ * 共享日志按段记录所有队列存活消息的总数，已封存的段存活数归零时直接删除；
+ * 启动时扫描一次整个日志，按队列标识分组，各队列恢复时领取属于自己的记录。
+ */
+
+#pragma once
+#include "../common/logger.hpp"
+#include "../common/helper.hpp"
+#include "../common/msg.pb.h"
+#include "segment.hpp"
+#include "body.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+
+namespace XuMQ
+{
+    const char *JOURNAL_DIR = ".journal/"; ///< 共享日志目录名 位于基础目录下
+
+    /// @class Journal
+    /// @brief 虚拟机内所有队列共享的顺序追加日志
+    class Journal
+    {
+    public:
+        using ptr = std::shared_ptr<Journal>;
+        /// @brief 构造函数
+        /// @param dirname 共享日志目录
+        /// @param max_size 段文件滚动大小
+        /// @param options 段文件的写入方式
+        Journal(const std::string &dirname, size_t max_size = SEGMENT_MAX_SIZE, const SegmentOptions &options = SegmentOptions())
+            : _log(dirname, max_size, options), _written(0), _synced(0), _syncing(false), _sync_count(0)
+        {
+        }
+        /// @brief 打开共享日志 扫描所有段 按队列标识分组暂存记录
+        /// @return 成功返回true 失败返回false
+        /// @note 暂存的记录在被队列领取或丢弃之前都算作存活 所在的段不会被删除
+        bool open()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_log.open() == false)
+            {
+                error(logger, " %s :打开共享日志失败!", _log.dirname().c_str());
+                return false;
+            }
+            size_t count = 0;
+            for (auto &segment : _log.segments())
+            {
+                SegmentReader reader(segment);
+                if (reader.open() == false)
+                    return false;
+                RecordHeader header;
+                const char *body;
+                size_t offset;
+                while (reader.next(header, body, offset))
+                {
+                    Message::Payload refs;
+                    MessagePtr msg = MessageRef::parse(body, header.length, refs);
+                    if (msg.get() == nullptr)
+                        continue;
+                    if (refs.refs_size() == 0) // 只属于一个队列的记录
+                    {
+                        Message::Reference *reference = refs.add_refs();
+                        reference->set_queue(refs.queue());
+                        reference->set_seq(refs.seq());
+                    }
+                    for (auto &reference : refs.refs())
+                    {
+                        auto ref = MessageRef::create(msg, reference.seq(), true);
+                        ref->segment = segment->id();
+                        ref->offset = offset;
+                        ref->length = header.length;
+                        _pending[reference.queue()].push_back(ref);
+                        _live[segment->id()]++;
+                        count++;
+                    }
+                }
+                if (reader.truncated() && segment->truncate(reader.position()) == true)
+                    info(logger, " %s :已截断到 %zu 字节", segment->filename().c_str(), reader.position());
+                retire(segment->id());
+            }
+            info(logger, " %s :共享日志中有 %zu 条记录, 属于 %zu 个队列", _log.dirname().c_str(), count, _pending.size());
+            return true;
+        }
+        /// @brief 追加一条记录
+        /// @param body 记录数据 共享部分加上列出队列标识和序号的引用部分
+        /// @param seq 消息在队列内的序号
+        /// @param segment 输出参数 记录所在段号
+        /// @param offset 输出参数 数据在段内的偏移
+        /// @param ticket 输出参数 写入序号 刷盘到该序号之后记录才落盘 @see syncTo
+        /// @param refs 引用这条记录的队列数
+        /// @return 成功返回true 失败返回false
+        bool append(const std::string &body, uint64_t seq, uint32_t &segment, size_t &offset, uint64_t &ticket, size_t refs = 1)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            Segment::ptr previous = _log.active();
+            if (_log.append(body, seq, segment, offset) == false)
+            {
+                error(logger, " %s :共享日志写入失败!", _log.dirname().c_str());
+                return false;
+            }
+            // 活跃段滚动后 原活跃段中的消息可能已经全部确认
+            if (previous.get() != nullptr && segment != previous->id())
+                retire(previous->id());
+            _live[segment] += refs;
+            std::unique_lock<std::mutex> slock(_sync_mutex);
+            Segment::ptr active = _log.active();
+            if (_dirty.empty() || _dirty.back() != active)
+                _dirty.push_back(active);
+            ticket = ++_written;
+            return true;
+        }
+        /// @brief 领取属于指定队列的记录 包括已确认的记录 由队列在恢复时过滤
+        /// @param tag 队列标识
+        /// @return 按日志顺序排列的记录
+        /// @note 扇出记录在各个队列中的引用共享同一个消息对象
+        std::vector<MessageRef::ptr> take(const std::string &tag)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            std::vector<MessageRef::ptr> result;
+            auto it = _pending.find(tag);
+            if (it == _pending.end())
+                return result;
+            result.swap(it->second);
+            _pending.erase(it);
+            return result;
+        }
+        /// @brief 释放段中的存活记录 已封存的段存活数归零时删除
+        /// @param segment 段号
+        /// @param count 释放的记录数
+        void release(uint32_t segment, size_t count = 1)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            auto it = _live.find(segment);
+            if (it == _live.end())
+                return;
+            it->second -= std::min(it->second, count);
+            retire(segment);
+        }
+        /// @brief 丢弃没有被任何队列领取的记录 在所有队列恢复完成后调用
+        /// @note 这些记录属于已经删除的队列
+        void discardPending()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            size_t count = 0;
+            std::vector<uint32_t> segments;
+            for (auto &queue : _pending)
+            {
+                for (auto &ref : queue.second)
+                {
+                    auto it = _live.find(ref->segment);
+                    if (it != _live.end() && it->second > 0)
+                        it->second--;
+                    segments.push_back(ref->segment);
+                    count++;
+                }
+            }
+            _pending.clear();
+            for (uint32_t segment : segments)
+                retire(segment);
+            if (count > 0)
+                info(logger, " %s :丢弃已删除队列的 %zu 条记录", _log.dirname().c_str(), count);
+        }
+        /// @brief 组提交 等待刷盘进度达到目标
+        /// @param ticket 目标写入序号 @see append
+        /// @return 成功返回true 失败返回false
+        /// @note 多个队列同时请求刷盘时只有一个线程执行 fdatasync 覆盖开始刷盘时所有已写入的记录
+        bool syncTo(uint64_t ticket)
+        {
+            std::unique_lock<std::mutex> lock(_sync_mutex);
+            while (_synced < ticket)
+            {
+                if (_syncing)
+                {
+                    _sync_cv.wait(lock);
+                    continue;
+                }
+                _syncing = true;
+                uint64_t goal = _written;
+                std::vector<Segment::ptr> dirty;
+                dirty.swap(_dirty);
+                lock.unlock();
+                bool ret = true;
+                for (auto &segment : dirty)
+                    ret = segment->sync() && ret;
+                lock.lock();
+                _syncing = false;
+                _sync_count++;
+                if (ret == false)
+                {
+                    // 刷盘失败 重新登记这些段 下次重试
+                    _dirty.insert(_dirty.begin(), dirty.begin(), dirty.end());
+                    _sync_cv.notify_all();
+                    return false;
+                }
+                _synced = goal;
+                _sync_cv.notify_all();
+            }
+            return true;
+        }
+        /// @brief 立即将所有已写入的记录刷盘
+        /// @return 成功返回true 失败返回false
+        bool sync()
+        {
+            uint64_t ticket;
+            {
+                std::unique_lock<std::mutex> lock(_sync_mutex);
+                ticket = _written;
+            }
+            return syncTo(ticket);
+        }
+        /// @brief 读取指定段中的数据
+        /// @param segment 段号
+        /// @param offset 段内偏移
+        /// @param len 读取长度
+        /// @param body 存储读取内容的字符串
+        /// @return 成功返回true 失败返回false
+        /// @note 只持有互斥锁查找段 读取时不持有 存活记录所在的段不会被删除
+        bool read(uint32_t segment, size_t offset, size_t len, std::string &body)
+        {
+            Segment::ptr sp;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                sp = _log.select(segment);
+            }
+            if (sp.get() == nullptr)
+                return false;
+            body.resize(len);
+            return sp->read(&body[0], offset, len);
+        }
+        /// @brief 判断段是否存在
+        /// @param segment 段号
+        bool contains(uint32_t segment)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            return _log.contains(segment);
+        }
+        /// @brief 获取段的数量
+        size_t segmentCount()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            return _log.segments().size();
+        }
+        /// @brief 获取实际执行的刷盘次数
+        size_t syncCount()
+        {
+            std::unique_lock<std::mutex> lock(_sync_mutex);
+            return _sync_count;
+        }
+        /// @brief 获取共享日志目录
+        const std::string &dirname() const { return _log.dirname(); }
+
+    private:
+        /// @brief 删除存活记录数归零的已封存段 需持有互斥锁
+        /// @param segment 段号
+        void retire(uint32_t segment)
+        {
+            auto it = _live.find(segment);
+            if (it != _live.end() && it->second > 0)
+                return;
+            Segment::ptr active = _log.active();
+            if (active.get() != nullptr && active->id() == segment)
+                return;
+            if (_log.contains(segment) && _log.removeSegment(segment) == false)
+                return;
+            _live.erase(segment);
+        }
+
+    private:
+        std::mutex _mutex;                                                                  ///< 日志和统计的互斥锁
+        SegmentLog _log;                                                                    ///< 分段日志
+        std::map<uint32_t, size_t> _live;                                                   ///< 段号到存活记录数的映射表
+        std::unordered_map<std::string, std::vector<MessageRef::ptr>> _pending;            ///< 尚未被队列领取的记录
+        std::mutex _sync_mutex;                                                             ///< 刷盘状态锁
+        std::condition_variable _sync_cv;                                                   ///< 等待刷盘完成的条件变量
+        std::vector<Segment::ptr> _dirty;                                                   ///< 尚未刷盘的段
+        uint64_t _written;                                                                  ///< 已写入的记录序号
+        uint64_t _synced;                                                                   ///< 已刷盘的记录序号
+        bool _syncing;                                                                      ///< 是否有线程正在刷盘
+        size_t _sync_count;                                                                 ///< 实际执行的刷盘次数
+    };
+}
@@ -10,39 +10,146 @@
  * - 插入、删除消息
  * - 对无效消息进行垃圾回收
  *
- * 使用文件存储消息队列数据，通过指定的目录和文件名进行管理。
+ * 每个队列的数据存放在 "基础目录/队列名称/" 下的分段日志中 @see SegmentLog
+ * 旧版本的单个 "队列名称.mqd" 文件会在首次打开时迁移为第一个段。
+ *
+ * 持久化消息何时刷盘由持久化策略决定 @see DurabilityPolicy
+ * 同一个队列上并发的发布共享一次 fdatasync (组提交)。
+ *
+ * 消息确认只向确认日志追加消息序号，不再改写数据段 @see AckLog
+ *
+ * 已确认消息占用的空间按段回收: 每个段记录存活消息数，已封存的段存活数归零时直接删除，
+ * 先进先出的队列因此几乎不需要额外的磁盘读写；长期存活且稀疏的段由后台线程复制压缩，
+ * 复制过程不持有队列锁，只在最后替换段文件、更新消息位置时短暂加锁。
+ *
+ * 后台线程定期为每个队列写入索引检查点，重启时只扫描检查点之后追加的数据 @see Checkpoint
+ *
+ * 开启压缩的队列先将记录攒在内存中的压缩块里，块写满、按持久化策略需要刷盘或停留超过
+ * COMPRESS_LINGER_MS 时整体压缩写出 @see RecordBlock 加载、读回和压缩数据段时透明地解压。
+ *
+ * 一次发布路由到的所有队列共享同一个只读的紧凑消息记录，队列中只保存引用和队列自己的状态，
+ * 待确认消息按投递标识、持久化消息按序号索引 @see PackedMessage MessageRef DeliveryWindow
+ * 惰性队列(x-queue-mode=lazy)中的持久化消息只保留引用，投递前再从数据段读回。
+ *
+ * 每个队列统计待推送消息占用的内存，所有队列的总和超过高水位时，从占用最多的队列开始
+ * 换出最早的消息: 持久化消息直接丢弃内存中的消息体，非持久化消息写入队列的换出日志 @see MessageMapper::spill
+ *
+ * 共享日志模式下，虚拟机内所有队列的持久化消息追加到同一个日志中 @see Journal
+ * 队列目录下只保留确认日志和队列标识，不再压缩数据段，也不写检查点。
+ *
+ * 推送消息队列只通过存储引擎接口访问持久化存储，MessageMapper 是默认的文件存储引擎，
+ * 队列可以在声明时通过 x-store 选择其他引擎 @see MessageStore
+ *
+ * 消息数据可以分布在多个数据目录(磁盘)中，每个队列整体位于其中一个目录下 @see DataDirectories
+ *
+ * 推送消息队列的两端分开加锁: 发布端在存储锁内写入存储后，短暂持有队尾锁把消息追加到入队列表；
+ * 消费端持有队头锁从出队列表取消息，出队列表取空时才短暂持有队尾锁把整个入队列表交换过来。
+ * 非惰性队列的投递不需要存储锁，同一个队列的发布和消费可以在不同的线程上并行。
+ * 需要同时持有多把锁时按 队头锁 -> 存储锁 -> 队尾锁 的顺序加锁。
  */
 
 #pragma once
 #include "../common/logger.hpp"
 #include "../common/helper.hpp"
 #include "../common/msg.pb.h"
+#include "../common/registry.hpp"
+#include "segment.hpp"
+#include "acklog.hpp"
+#include "checkpoint.hpp"
+#include "journal.hpp"
+#include "body.hpp"
+#include "pending.hpp"
+#include "store.hpp"
+#include "ring.hpp"
+#include "btree.hpp"
+#include "datadir.hpp"
 #include <iostream>
 #include <unordered_map>
+#include <unordered_set>
+#include <map>
+#include <atomic>
+#include <algorithm>
 #include <mutex>
 #include <memory>
 #include <list>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#include <google/protobuf/map.h>
 
 namespace XuMQ
 {
-    const char *DATAFILE_SUBFIX = ".mqd";              ///< 数据文件后缀名
-    const char *TMPFILE_SUBFIX = ".mqd.tmp";           ///< 临时文件后缀名
-    const char *MSG_VALID = "1";                       ///< 消息有效标志
-    const char *MSG_INVALID = "0";                     ///< 消息无效标志
-    using MessagePtr = std::shared_ptr<XuMQ::Message>; ///< proto生成的Message类型指针
+
+    const size_t FLUSHER_TICK_MS = 10;                       ///< 后台刷盘线程的检查周期(毫秒)
+    const size_t COMPACTOR_TICK_MS = 100;                    ///< 后台压缩线程的检查周期(毫秒)
+    const size_t COMPACT_RATE_DEFAULT = 32 * 1024 * 1024;    ///< 默认压缩速率上限(字节/秒)
+    const size_t COMPACT_BATCH_BYTES = 1024 * 1024;          ///< 压缩时每批读取的字节数 每批加锁检查一次存活状态
+    const size_t COMPACT_MIN_RECORDS = 2000;                 ///< 活跃段至少有这么多条记录才会被封存压缩
+    const size_t COMPACT_LIVE_PERCENT = 50;                  ///< 存活记录占比低于该百分比的段需要压缩
+    const size_t ACKLOG_COMPACT_MIN = 4096;                  ///< 确认日志至少有这么多条墓碑才考虑重写
+    const char *ARG_QUEUE_MODE = "x-queue-mode";             ///< 队列参数: 队列模式 default|lazy
+    const size_t LAZY_READAHEAD = 16;                        ///< 惰性队列投递前一次读回的消息条数
+    const size_t LAZY_READ_GAP = 64 * 1024;                  ///< 惰性队列读回时 相邻记录间隔不超过该字节数则合并为一次读取
+    const char *QUEUE_ID_FILE = "queue.id";                  ///< 队列标识文件名 共享日志模式下区分同名队列的不同实例
+    const size_t COMPRESS_BLOCK_SIZE = 64 * 1024;            ///< 压缩块中的记录累计到该字节数后写出
+    const size_t COMPRESS_LINGER_MS = 100;                   ///< 压缩块中的记录在内存中停留的最长时间(毫秒) 由后台线程写出
+    const char *SPILL_DIR = "spill/";                        ///< 换出的非持久化消息所在目录 位于队列目录下 重启时删除
+    const double MEMORY_LOW_WATERMARK = 0.8;                 ///< 超过内存高水位后换出消息 直到占用低于高水位的该比例
+
+    /// @struct SegmentStat
+    /// @brief 单个数据段的记录统计 用于选择压缩对象和判断墓碑是否仍然需要
+    struct SegmentStat
+    {
+        size_t total;     ///< 段中的记录总数
+        size_t live;      ///< 段中尚未确认的记录数
+        uint64_t min_seq; ///< 段中记录的最小序号
+        uint64_t max_seq; ///< 段中记录的最大序号
+        /// @brief 构造函数
+        SegmentStat() : total(0), live(0), min_seq(UINT64_MAX), max_seq(0) {}
+    };
+
+    /// @struct LoadedSet
+    /// @brief 恢复时已加载的消息 用于去除垃圾回收或迁移中途崩溃留下的重复记录
+    /// @note 消息id是应用填写的元数据 可能重复或为空 只有旧版本没有序号的记录按消息id去重
+    struct LoadedSet
+    {
+        std::unordered_set<uint64_t> seqs; ///< 已加载消息的序号
+        std::unordered_set<MessageId> ids; ///< 已加载的无序号消息的id
+        /// @brief 记录一条消息
+        /// @return 第一次出现返回true 重复返回false
+        bool insert(const MessageRef::ptr &ref)
+        {
+            if (ref->seq != 0)
+                return seqs.insert(ref->seq).second;
+            return ids.insert(ref->key()).second;
+        }
+    };
+
+    /// @brief 持久化消息的存储方式
+    enum class StorageMode
+    {
+        PER_QUEUE,     ///< 每个队列使用独立的分段日志
+        SHARED_JOURNAL ///< 虚拟机内所有队列共享一个顺序追加的日志 @see Journal
+    };
+
     /// @class MessageMapper
-    /// @brief 处理消息队列的文件存储和管理类
-    class MessageMapper
+    /// @brief 处理消息队列的文件存储和管理类 默认的存储引擎
+    class MessageMapper : public MessageStore
     {
     public:
         /// @brief 构造函数 创建必要的目录和数据文件
         /// @param basedir 基础目录
         /// @param qname 队列名称
-        MessageMapper(std::string &basedir, const std::string &qname)
-            : _qname(qname)
+        /// @param policy 持久化策略
+        /// @param journal 共享日志 为空时使用队列独立的分段日志
+        MessageMapper(std::string &basedir, const std::string &qname, const DurabilityPolicy &policy = DurabilityPolicy(),
+                      const Journal::ptr &journal = Journal::ptr())
+            : _qname(qname), _log(queueDirectory(basedir, qname), SEGMENT_MAX_SIZE, policy.segmentOptions()), _journal(journal), _acklog(_log.dirname() + ACKLOG_FILE),
+              _checkpoint(_log.dirname() + CHECKPOINT_FILE), _spill(_log.dirname() + SPILL_DIR), _policy(policy), _written(0),
+              _synced(0), _journal_written(0),
+              _ack_dirty(false), _syncing(false), _sync_count(0), _last_sync(std::chrono::steady_clock::now())
         {
-            if (basedir.back() != '/' && basedir.back() != '\\')
-                basedir.push_back('/');
             _datafile = basedir + qname + DATAFILE_SUBFIX;
             _tmpfile = basedir + qname + TMPFILE_SUBFIX;
 
@@ -57,300 +164,1657 @@ namespace XuMQ
             }
             createMsgFile();
         }
-        /// @brief 创建消息文件
+        /// @brief 创建消息文件 打开队列的分段日志
         /// @return 成功返回true 失败返回false
+        /// @note 旧版本的单个数据文件会被直接重命名为第一个段 记录格式不变
         bool createMsgFile()
         {
-            if (FileHelper(_datafile).exists() == false)
+            if (FileHelper(_datafile).exists() == true && FileHelper(_log.dirname()).exists() == false)
             {
-                bool ret = FileHelper::createFile(_datafile);
-                if (ret == false)
+                FileHelper::createDirectory(_log.dirname());
+                if (FileHelper(_datafile).rename(_log.segmentName(0)) == false)
                 {
-                    error(logger, " %s :创建队列数据文件失败!", _datafile.c_str());
+                    error(logger, " %s :旧版本队列数据文件迁移失败!", _datafile.c_str());
                     return false;
                 }
+                info(logger, " %s :旧版本队列数据文件已迁移到 %s", _datafile.c_str(), _log.dirname().c_str());
+            }
+            FileHelper::removeFile(_tmpfile);
+            // 上次运行换出的非持久化消息不再恢复
+            if (FileHelper(_spill.dirname()).exists() && _spill.open())
+                _spill.removeAll();
+            if (_journal.get() != nullptr)
+                return createJournalFile();
+            if (_log.open() == false)
+            {
+                error(logger, " %s :打开队列数据段失败!", _log.dirname().c_str());
+                return false;
+            }
+            if (FileHelper(_log.dirname() + QUEUE_ID_FILE).exists())
+                warn(logger, " %s :队列曾使用共享日志模式, 共享日志中的消息不会被恢复", _log.dirname().c_str());
+            if (_acklog.open() == false)
+            {
+                error(logger, " %s :打开队列确认日志失败!", _log.dirname().c_str());
+                return false;
             }
             return true;
         }
-        /// @brief 移除消息文件 包括移除数据文件和临时文件
+        /// @brief 移除消息文件 包括所有段文件、确认日志、检查点和旧版本的数据文件
+        /// @note
+        /// 共享日志模式下释放队列在共享日志中的存活记录 并删除队列标识
+        /// 后台线程可能正在锁外刷盘 等它结束后再关闭文件 待刷盘的记录随文件一起丢弃
         void removeMsgFile()
         {
+            std::unique_lock<std::mutex> lock(_sync_mutex);
+            while (_syncing)
+                _sync_cv.wait(lock);
+            _dirty.clear();
+            _ack_dirty = false;
+            if (_journal.get() != nullptr)
+            {
+                for (auto &stat : _stats)
+                    _journal->release(stat.first, stat.second.live);
+                FileHelper::removeFile(_log.dirname() + QUEUE_ID_FILE);
+            }
+            // 清空段统计 删除之后才结束的压缩不会再被当作成功
+            _stats.clear();
+            _checkpoint.remove();
+            _acklog.remove();
+            _spill.removeAll();
+            _spill_live.clear();
+            _block.clear();
+            _block_refs.clear();
+            _log.removeAll();
             FileHelper::removeFile(_datafile);
             FileHelper::removeFile(_tmpfile);
         }
-        /// @brief 插入消息 将消息添加到数据文件中
-        /// @param msg 消息指针
+        /// @brief 删除存储的所有数据 @see removeMsgFile
+        void clear() override
+        {
+            removeMsgFile();
+        }
+        /// @brief 删除所有段文件和确认日志后重新打开空的段日志
+        /// @return 成功返回true 失败返回false
+        /// @note 共享日志模式下生成新的队列标识 旧标识下的记录不再属于本队列 下次恢复时随已删除的队列一起丢弃
+        bool purge() override
+        {
+            removeMsgFile();
+            return createMsgFile();
+        }
+        /// @brief 插入消息 将消息追加到活跃段中
+        /// @param ref 队列中的消息 写入后更新其存储位置
+        /// @param record 序列化后的共享消息 同一次发布的所有队列共用
         /// @return 插入成功返回true 失败返回false
-        bool insert(const MessagePtr &msg)
+        bool insert(const MessageRef::ptr &ref, const std::string &record) override
         {
-            return insert(_datafile, msg);
+            if (_journal.get() != nullptr)
+                return insertJournal(ref, record);
+            std::string body = record + MessageRef::reference(ref->seq);
+            if (_policy.codec != Codec::NONE)
+            {
+                // 攒入压缩块 写出之前存储位置为空
+                if (_block.empty())
+                    _block_since = std::chrono::steady_clock::now();
+                ref->inner = _block.add(body);
+                _block_refs.push_back(ref);
+                return true;
+            }
+            Segment::ptr previous = _log.active();
+            uint32_t segment;
+            size_t offset;
+            if (_log.append(body, ref->seq, segment, offset) == false)
+            {
+                error(logger, " %s :队列数据写入失败!", _log.dirname().c_str());
+                return false;
+            }
+            // 活跃段滚动后 原活跃段中的消息可能已经全部确认
+            if (previous.get() != nullptr && segment != previous->id())
+                retire(previous->id());
+            // 更新消息的存储位置
+            ref->segment = segment;
+            ref->offset = offset;
+            ref->length = body.size();
+            account(segment, ref->seq);
+            // 登记尚未刷盘的段 供组提交使用
+            {
+                std::unique_lock<std::mutex> lock(_sync_mutex);
+                Segment::ptr active = _log.active();
+                if (_dirty.empty() || _dirty.back() != active)
+                    _dirty.push_back(active);
+                _written++;
+            }
+            return true;
         }
-        /// @brief 移除消息 将消息中的有效标记置为false 更新到数据文件中
-        /// @param msg 消息指针
-        /// @return 移除成功返回true 失败返回false
-        bool remove(MessagePtr &msg)
+        /// @brief 压缩并写出压缩块 没有攒下的记录时直接返回
+        /// @param flushed 输出参数 写出的消息 存储位置已更新
+        /// @return 成功返回true 失败返回false 失败时保留压缩块 下次重试
+        bool flushBlock(std::vector<MessageRef::ptr> &flushed) override
+        {
+            if (_block.empty())
+                return true;
+            std::string body;
+            if (_block.encode(_policy.codec, _policy.level, body) == false)
+            {
+                error(logger, " %s :压缩队列数据失败!", _log.dirname().c_str());
+                return false;
+            }
+            Segment::ptr previous = _log.active();
+            uint32_t segment;
+            size_t offset;
+            if (_log.append(body, _block_refs.front()->seq, _policy.codec, segment, offset) == false)
+            {
+                error(logger, " %s :队列数据写入失败!", _log.dirname().c_str());
+                return false;
+            }
+            if (previous.get() != nullptr && segment != previous->id())
+                retire(previous->id());
+            for (auto &ref : _block_refs)
+            {
+                ref->segment = segment;
+                ref->offset = offset;
+                ref->length = body.size();
+                account(segment, ref->seq);
+            }
+            {
+                std::unique_lock<std::mutex> lock(_sync_mutex);
+                Segment::ptr active = _log.active();
+                if (_dirty.empty() || _dirty.back() != active)
+                    _dirty.push_back(active);
+                _written += _block_refs.size();
+            }
+            flushed.swap(_block_refs);
+            _block_refs.clear();
+            _block.clear();
+            return true;
+        }
+        /// @brief 压缩块是否需要立即写出 块已写满或按定量刷盘策略即将刷盘
+        bool blockDue() override
+        {
+            if (_block.empty())
+                return false;
+            if (_block.size() >= COMPRESS_BLOCK_SIZE)
+                return true;
+            std::unique_lock<std::mutex> lock(_sync_mutex);
+            return _policy.mode == SyncMode::BATCH && _written + _block_refs.size() - _synced >= _policy.batch;
+        }
+        /// @brief 压缩块中的记录是否停留过久
+        bool blockExpired() const override
+        {
+            return _block.empty() == false &&
+                   std::chrono::steady_clock::now() - _block_since >= std::chrono::milliseconds(COMPRESS_LINGER_MS);
+        }
+        /// @brief 发布确认前是否需要先写出压缩块
+        /// @note 在释放队列锁之后写出 并发发布的记录因此合并到同一个块中
+        bool flushOnCommit() const override
+        {
+            return _journal.get() == nullptr && _policy.codec != Codec::NONE && _policy.mode == SyncMode::CONFIRM;
+        }
+        /// @brief 按持久化策略提交已写入的消息
+        /// @return 成功返回true 刷盘失败返回false
+        /// @note 调用时不能持有队列的互斥锁, 否则并发的发布无法合并到同一次刷盘中
+        bool commit() override
+        {
+            std::unique_lock<std::mutex> lock(_sync_mutex);
+            switch (_policy.mode)
+            {
+            case SyncMode::NONE:
+            case SyncMode::INTERVAL:
+                return true;
+            case SyncMode::BATCH:
+                if (_written - _synced < _policy.batch)
+                    return true;
+                break;
+            case SyncMode::CONFIRM:
+                break;
+            }
+            return syncTo(lock, _written);
+        }
+        /// @brief 定时刷盘 由后台线程周期性调用
+        /// @return 成功返回true 刷盘失败返回false
+        bool flush() override
+        {
+            std::unique_lock<std::mutex> lock(_sync_mutex);
+            if (_policy.mode == SyncMode::NONE || _policy.interval_ms == 0 || _written == _synced)
+                return true;
+            if (_policy.mode != SyncMode::INTERVAL && _policy.mode != SyncMode::BATCH)
+                return true;
+            auto elapsed = std::chrono::steady_clock::now() - _last_sync;
+            if (elapsed < std::chrono::milliseconds(_policy.interval_ms))
+                return true;
+            return syncTo(lock, _written);
+        }
+        /// @brief 立即将所有已写入的消息刷盘
+        /// @return 成功返回true 失败返回false
+        bool sync() override
+        {
+            std::unique_lock<std::mutex> lock(_sync_mutex);
+            return syncTo(lock, _written);
+        }
+        /// @brief 增量压缩一个数据段 没有需要压缩的段时整理确认日志
+        /// @param mutex 队列锁
+        /// @param msgs 存活的持久化消息 只在持有队列锁时访问
+        /// @param rate 压缩速率上限(字节/秒) 0表示不限速
+        /// @return 压缩了一个段返回true 没有需要压缩的段或压缩失败返回false
+        /// @note
+        /// 读取和复制记录时不持有队列锁 发布和消费不受影响
+        /// 复制期间被确认的记录也可能被复制 它们的墓碑按序号标识 对新位置同样有效
+        /// 压缩块中只要有一条消息存活就整体复制 块内偏移不变
+        bool compact(std::mutex &mutex, const std::unordered_map<uint64_t, MessageRef::ptr> &msgs, size_t rate) override
+        {
+            uint32_t segment;
+            Segment::ptr src, dst;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (compactionCandidate(segment) == false)
+                {
+                    compactAckLog();
+                    return false;
+                }
+                if (beginCompaction(segment, src, dst) == false)
+                    return false;
+            }
+            /// 段中的一条记录
+            struct Record
+            {
+                std::vector<uint64_t> seqs; ///< 消息序号 压缩块中有多条消息
+                RecordHeader header; ///< 记录头 复制时保留入队时间和序号
+                const char *body;  ///< 序列化后的消息 指向原段的映射区域
+                size_t offset;     ///< 在原段中的偏移
+                size_t new_offset; ///< 在临时段中的偏移
+                bool live;         ///< 是否存活
+            };
+            std::vector<Record> moved;
+            SegmentReader reader(src);
+            if (reader.open() == false)
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                abortCompaction(dst);
+                return false;
+            }
+            auto start = std::chrono::steady_clock::now();
+            size_t copied = 0;
+            bool more = true;
+            while (more)
+            {
+                // 读取一批记录 残缺的尾部记录不再复制
+                std::vector<Record> batch;
+                size_t batch_bytes = 0;
+                while (batch_bytes < COMPACT_BATCH_BYTES)
+                {
+                    Record record;
+                    if (reader.next(record.header, record.body, record.offset) == false)
+                    {
+                        more = false;
+                        break;
+                    }
+                    auto parse = [&record](uint32_t, const char *data, size_t len)
+                    {
+                        Message::Payload payload;
+                        payload.ParseFromArray(data, len);
+                        record.seqs.push_back(payload.seq());
+                        return payload.seq();
+                    };
+                    std::string raw;
+                    if (record.header.codec() != Codec::NONE) // 压缩块整体复制 只要有一条消息存活
+                    {
+                        if (RecordBlock::decode(record.body, record.header.length, raw) == false ||
+                            RecordBlock::each(raw, parse) == false)
+                            warn(logger, " %s :偏移 %zu 处的压缩块损坏", src->filename().c_str(), record.offset);
+                    }
+                    else
+                    {
+                        uint64_t seq = parse(0, record.body, record.header.length);
+                        if (record.header.version < FORMAT_V2) // 旧版本的记录重写为 v2 格式
+                            record.header = RecordHeader(seq, record.header.length);
+                    }
+                    // 存活的消息按序号查找 没有序号的旧版本记录(重启整理失败时残留)无法判断 放弃本次压缩
+                    if (std::find(record.seqs.begin(), record.seqs.end(), 0) != record.seqs.end())
+                    {
+                        warn(logger, " %s :偏移 %zu 处的记录没有消息序号, 放弃压缩", src->filename().c_str(), record.offset);
+                        std::unique_lock<std::mutex> lock(mutex);
+                        abortCompaction(dst);
+                        return false;
+                    }
+                    batch_bytes += RECORD_HEADER_SIZE + record.header.length;
+                    batch.push_back(std::move(record));
+                }
+                // 短暂加锁 检查这一批记录是否存活
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    for (auto &record : batch)
+                    {
+                        record.live = false;
+                        for (auto &seq : record.seqs)
+                        {
+                            auto it = msgs.find(seq);
+                            if (it != msgs.end() && it->second->segment == segment &&
+                                it->second->offset == record.offset)
+                                record.live = true;
+                        }
+                    }
+                }
+                // 复制存活的记录
+                for (auto &record : batch)
+                {
+                    if (record.live == false)
+                        continue;
+                    if (dst->append(record.header, record.body, record.new_offset) == false)
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        abortCompaction(dst);
+                        return false;
+                    }
+                    moved.push_back(std::move(record));
+                }
+                // 限速
+                copied += batch_bytes;
+                if (rate > 0)
+                    std::this_thread::sleep_until(start + std::chrono::microseconds(copied * 1000000 / rate));
+            }
+            if (dst->sync() == false)
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                abortCompaction(dst);
+                return false;
+            }
+            // 加锁替换段文件 更新仍然存活的消息的存储位置
+            std::unique_lock<std::mutex> lock(mutex);
+            std::vector<std::pair<MessageRef::ptr, size_t>> updates;
+            size_t total = 0;
+            for (auto &record : moved)
+            {
+                total += record.seqs.size();
+                for (auto &seq : record.seqs)
+                {
+                    auto it = msgs.find(seq);
+                    if (it == msgs.end() || it->second->segment != segment ||
+                        it->second->offset != record.offset)
+                        continue;
+                    updates.push_back(std::make_pair(it->second, record.new_offset));
+                }
+            }
+            if (finishCompaction(dst, total, updates.size()) == false)
+                return false;
+            for (auto &update : updates)
+                update.first->offset = update.second;
+            compactAckLog();
+            return true;
+        }
+        /// @brief 生成检查点数据 需在队列锁内调用 保证与内存中的消息一致
+        /// @param msgs 存活的持久化消息
+        /// @param seq 最近分配的消息序号
+        /// @param checkpoint 存储检查点数据
+        /// @note 共享日志模式下和队列已删除时没有检查点
+        void snapshot(const std::unordered_map<uint64_t, MessageRef::ptr> &msgs, uint64_t seq, QueueCheckpoint &checkpoint) override
+        {
+            Segment::ptr active = _log.active();
+            if (_journal.get() != nullptr || active.get() == nullptr)
+                return;
+            checkpoint.set_active(active->id());
+            checkpoint.set_tail(active->size());
+            checkpoint.set_seq(seq);
+            for (auto &stat : _stats)
+            {
+                if (_log.contains(stat.first) == false)
+                    continue;
+                QueueCheckpoint::SegmentInfo *info = checkpoint.add_segments();
+                info->set_id(stat.first);
+                info->set_inode(_log.select(stat.first)->inode());
+                info->set_total(stat.second.total);
+                info->set_min_seq(stat.second.min_seq);
+                info->set_max_seq(stat.second.max_seq);
+            }
+            for (auto &msg : msgs)
+            {
+                if (msg.second->length == 0) // 尚未写出的压缩块中的消息
+                    continue;
+                QueueCheckpoint::Entry *entry = checkpoint.add_entries();
+                entry->set_seq(msg.second->seq);
+                entry->set_segment(msg.second->segment);
+                entry->set_offset(msg.second->offset);
+                entry->set_length(msg.second->length);
+                if (msg.second->msg.get() != nullptr) // 惰性队列中未读回的消息不记录id 加载时只校验序号
+                    entry->set_id(msg.second->id());
+                entry->set_inner(msg.second->inner);
+            }
+        }
+        /// @brief 写入检查点 不需要持有队列锁
+        /// @param checkpoint 检查点数据 @see snapshot
+        /// @return 成功返回true 失败返回false
+        /// @note 先将检查点引用的数据和确认日志刷盘 写入失败时删除旧的检查点 重启时完整扫描
+        bool writeCheckpoint(const QueueCheckpoint &checkpoint) override
         {
-            // 将msg中的有效标志为设置为'0'(false)
-            msg->mutable_payload()->set_valid(MSG_INVALID);
-            // 对msg进行序列化
-            std::string body = msg->payload().SerializeAsString();
-            if (body.size() != msg->length())
+            if (_journal.get() != nullptr)
+                return sync();
+            if (sync() == false || _checkpoint.save(checkpoint) == false)
             {
-                error(logger, "不能修改文件中的数据信息, 新生成的数据与原数据长度不一致!");
+                error(logger, " %s :写入检查点失败!", _log.dirname().c_str());
+                _checkpoint.remove();
                 return false;
             }
-            // 将序列化的消息 写入到数据中的指定位置(覆盖原有的数据)
-            FileHelper helper(_datafile);
-            bool ret = helper.write(body.c_str(), msg->offset(), body.size());
+            return true;
+        }
+        /// @brief 恢复存活的持久化消息
+        /// @param seq 输出参数 已分配过的最大消息序号
+        /// @return 按序号排列的存活消息
+        /// @note 检查点有效时只扫描检查点之后追加的数据 否则完整加载并整理所有数据段
+        std::list<MessageRef::ptr> recovery(uint64_t &seq) override
+        {
+            std::list<MessageRef::ptr> result;
+            if (_journal.get() != nullptr)
+                return recoverJournal(seq);
+            if (loadCheckpoint(result, seq) == true)
+                return result;
+            result.clear();
+            _checkpoint.remove();
+            result = garbageCollection();
+            seq = 0;
+            for (auto &ref : result)
+                seq = std::max<uint64_t>(seq, ref->seq);
+            return result;
+        }
+        /// @brief 获取数据段中的记录总数 包括已确认但尚未回收的记录
+        size_t totalCount() override
+        {
+            size_t total = 0;
+            for (auto &stat : _stats)
+                total += stat.second.total;
+            return total;
+        }
+        /// @brief 是否需要后台线程定时刷盘
+        bool needFlusher() const override
+        {
+            return _policy.interval_ms > 0 &&
+                   (_policy.mode == SyncMode::INTERVAL || _policy.mode == SyncMode::BATCH);
+        }
+        /// @brief 获取实际执行的刷盘次数
+        size_t syncCount() override
+        {
+            std::unique_lock<std::mutex> lock(_sync_mutex);
+            return _sync_count;
+        }
+        /// @brief 登记已经写入共享日志的消息 供统计和组提交使用
+        /// @param ref 队列中的消息 存储位置已设置
+        /// @param ticket 共享日志的写入序号 @see Journal::append
+        void attach(const MessageRef::ptr &ref, uint64_t ticket) override
+        {
+            account(ref->segment, ref->seq);
+            std::unique_lock<std::mutex> lock(_sync_mutex);
+            _journal_written = ticket;
+            _written++;
+        }
+        /// @brief 获取共享日志中的队列标识
+        std::string tag() const override { return _tag; }
+        /// @brief 是否将消息写入虚拟机的共享日志
+        bool journaled() const override { return _journal.get() != nullptr; }
+        /// @brief 从磁盘读回消息 惰性队列在投递前调用
+        /// @param refs 需要读回的消息 读取后设置其中共享的消息
+        /// @return 全部读取成功返回true 失败返回false
+        /// @note 同一个段中间隔很小的记录合并为一次读取
+        bool read(const std::vector<MessageRef::ptr> &refs) override
+        {
+            size_t i = 0;
+            while (i < refs.size())
+            {
+                // 找出可以合并读取的一段记录 同一个压缩块中的消息只读取一次
+                size_t j = i + 1;
+                uint64_t begin = refs[i]->offset, end = begin + refs[i]->length;
+                while (j < refs.size() && refs[j]->durable == refs[i]->durable && refs[j]->segment == refs[i]->segment &&
+                       (refs[j]->offset == refs[j - 1]->offset ||
+                        (refs[j]->offset >= end && refs[j]->offset - end <= LAZY_READ_GAP)))
+                {
+                    end = std::max<uint64_t>(end, refs[j]->offset + refs[j]->length);
+                    j++;
+                }
+                // 非持久化消息从换出日志读回
+                std::string data;
+                bool ret;
+                if (refs[i]->durable == false)
+                    ret = _spill.read(refs[i]->segment, begin, end - begin, data);
+                else if (_journal.get() != nullptr)
+                    ret = _journal->read(refs[i]->segment, begin, end - begin, data);
+                else
+                    ret = _log.read(refs[i]->segment, begin, end - begin, data);
+                if (ret == false)
+                {
+                    error(logger, " %s :读取消息失败!", _log.dirname().c_str());
+                    return false;
+                }
+                std::string block;
+                uint64_t block_offset = 0;
+                for (; i < j; i++)
+                {
+                    const char *body = data.data() + (refs[i]->offset - begin);
+                    size_t len = refs[i]->length;
+                    if (refs[i]->inner > 0)
+                    {
+                        if ((block.empty() || block_offset != refs[i]->offset) && RecordBlock::decode(body, len, block) == false)
+                        {
+                            error(logger, " %s :解压消息失败!", _log.dirname().c_str());
+                            return false;
+                        }
+                        block_offset = refs[i]->offset;
+                        if (RecordBlock::entry(block, refs[i]->inner, body, len) == false)
+                        {
+                            error(logger, " %s :解析消息失败!", _log.dirname().c_str());
+                            return false;
+                        }
+                    }
+                    Message::Payload parsed;
+                    refs[i]->msg = MessageRef::parse(body, len, parsed);
+                    if (refs[i]->msg.get() == nullptr)
+                    {
+                        error(logger, " %s :解析消息失败!", _log.dirname().c_str());
+                        return false;
+                    }
+                    if (refs[i]->durable == false)
+                        unspill(refs[i]->segment);
+                }
+            }
+            return true;
+        }
+        /// @brief 将非持久化消息写入换出日志 释放内存中的消息体
+        /// @param ref 非持久化消息 写入后更新其存储位置并清空消息
+        /// @return 成功返回true 失败返回false
+        /// @note 换出日志不刷盘 读回后记录即失效 段中的记录全部读回后删除该段
+        bool spill(const MessageRef::ptr &ref) override
+        {
+            if (_spill.active().get() == nullptr && _spill.open() == false)
+            {
+                error(logger, " %s :打开换出日志失败!", _spill.dirname().c_str());
+                return false;
+            }
+            std::string record = ref->msg->serialize();
+            uint32_t segment;
+            size_t offset;
+            if (_spill.append(record, ref->seq, segment, offset) == false)
+            {
+                error(logger, " %s :写入换出日志失败!", _spill.dirname().c_str());
+                return false;
+            }
+            ref->segment = segment;
+            ref->offset = offset;
+            ref->length = record.size();
+            ref->inner = 0;
+            ref->msg.reset();
+            _spill_live[segment]++;
+            return true;
+        }
+        /// @brief 移除消息 向确认日志追加消息序号 数据段保持不变
+        /// @param ref 队列中的消息
+        /// @return 移除成功返回true 失败返回false
+        bool remove(const MessageRef::ptr &ref) override
+        {
+            bool ret = _acklog.append(ref->seq);
             if (ret == false)
             {
-                error(logger, " %s :队列数据文件写入失败!", _datafile.c_str());
+                error(logger, " %s :确认日志写入失败!", _log.dirname().c_str());
                 return false;
             }
+            // 尚未写出的压缩块中的消息还没有计入任何段
+            auto it = ref->length > 0 ? _stats.find(ref->segment) : _stats.end();
+            if (it != _stats.end() && it->second.live > 0)
+                it->second.live--;
+            if (_journal.get() != nullptr)
+                _journal->release(ref->segment);
+            else if (it != _stats.end())
+                retire(ref->segment);
+            std::unique_lock<std::mutex> lock(_sync_mutex);
+            _ack_dirty = true;
             return true;
         }
-        /// @brief 垃圾回收 加载所有有效消息 存储到临时文件后更新数据文件
+        /// @brief 垃圾回收 加载所有有效消息 写入新的段后删除旧的段
         /// @return 有效消息列表
-        std::list<MessagePtr> garbageCollection()
+        std::list<MessageRef::ptr> garbageCollection()
         {
-            std::list<MessagePtr> result;
-            // 加载文件中所有的有效数据 存储格式 4字节长度|数据|4字节长度|数据...
+            std::list<MessageRef::ptr> result;
+            // 加载所有段中的有效数据 存储格式 长度|数据|长度|数据...
             bool ret = load(result);
             if (ret == false)
             {
                 error(logger, "加载有效数据失败!");
                 return result;
             }
-            // 有效数据进行序列化存储到临时文件中
-            FileHelper::createFile(_tmpfile);
-            for (auto &msg : result)
+            // 有效数据写入新的段 旧的段在全部写入成功后再删除
+            std::vector<Segment::ptr> olds = _log.segments();
+            _stats.clear();
+            ret = _log.roll();
+            if (ret == false)
+            {
+                error(logger, " %s :创建新的数据段失败!", _log.dirname().c_str());
+                return result;
+            }
+            for (auto &ref : result)
             {
-                ret = insert(_tmpfile, msg);
+                ret = insert(ref, ref->msg->serialize());
                 if (ret == false)
                 {
-                    error(logger, " %s :临时文件写入消息数据失败!", _tmpfile);
+                    error(logger, " %s :新的数据段写入消息数据失败!", _log.dirname().c_str());
                     return result;
                 }
             }
-            // 删除原文件
-            ret = FileHelper::removeFile(_datafile);
-            if (ret == false)
-            {
-                error(logger, " %s :删除原文件失败!", _datafile);
+            std::vector<MessageRef::ptr> flushed;
+            if (flushBlock(flushed) == false)
                 return result;
-            }
-
-            // 修改临时文件名为原文件名称
-            ret = FileHelper(_tmpfile).rename(_datafile);
-            if (ret == false)
+            // 有效数据落盘之后才能删除旧的段
+            if (_policy.mode != SyncMode::NONE && sync() == false)
             {
-                error(logger, " %s :修改临时文件名称失败!", _tmpfile.c_str());
+                error(logger, " %s :新的数据段刷盘失败!", _log.dirname().c_str());
                 return result;
             }
+            // 删除旧的段
+            for (auto &segment : olds)
+                _log.removeSegment(segment->id());
+            // 已确认的消息都已清除 墓碑不再需要 必须在旧的段删除之后清空
+            _acklog.reset();
             // 返回新的有效数据
             return result;
         }
 
     private:
-        /// @brief 插入消息到指定文件 负责数据文件和临时文件的写入工作
-        /// @param filename 文件名
-        /// @param msg 文件指针
+        /// @brief 统计一条新写入的存活记录
+        /// @param segment 段号
+        /// @param seq 消息序号
+        void account(uint32_t segment, uint64_t seq)
+        {
+            SegmentStat &stat = _stats[segment];
+            stat.total++;
+            stat.live++;
+            stat.min_seq = std::min<uint64_t>(stat.min_seq, seq);
+            stat.max_seq = std::max<uint64_t>(stat.max_seq, seq);
+        }
+        /// @brief 删除存活消息数归零的已封存段
+        /// @param segment 段号
+        /// @note 活跃段和正在压缩的段不会被删除 它们分别在滚动和压缩结束时再次检查
+        void retire(uint32_t segment)
+        {
+            auto it = _stats.find(segment);
+            if (it == _stats.end() || it->second.live > 0)
+                return;
+            Segment::ptr active = _log.active();
+            if (active.get() != nullptr && active->id() == segment)
+                return;
+            if (_compacting.get() != nullptr && _compacting->id() == segment)
+                return;
+            if (_log.removeSegment(segment) == false)
+                return;
+            _stats.erase(it);
+        }
+        /// @brief 选择一个需要压缩的段
+        /// @param segment 输出参数 段号
+        /// @return 找到返回true 否则返回false
+        /// @note
+        /// 存活消息数归零的段在确认时已被直接删除 这里只处理长期存活且稀疏的段
+        /// 优先选择存活比例过低的已封存段; 活跃段累计足够多的记录且存活比例过低时先滚动封存
+        bool compactionCandidate(uint32_t &segment)
+        {
+            // 共享日志中的段由所有队列共用 只按存活数整段删除
+            if (_journal.get() != nullptr || _compacting.get() != nullptr)
+                return false;
+            Segment::ptr active = _log.active();
+            for (auto &stat : _stats)
+            {
+                if (active.get() != nullptr && stat.first == active->id())
+                    continue;
+                // 旧版本格式的段无论存活比例都需要重写
+                if (stat.second.live * 100 < stat.second.total * COMPACT_LIVE_PERCENT ||
+                    _log.select(stat.first)->version() < FORMAT_V2)
+                {
+                    segment = stat.first;
+                    return true;
+                }
+            }
+            if (active.get() == nullptr)
+                return false;
+            auto it = _stats.find(active->id());
+            if (it == _stats.end() || it->second.total <= COMPACT_MIN_RECORDS ||
+                it->second.live * 100 >= it->second.total * COMPACT_LIVE_PERCENT)
+                return false;
+            if (_log.roll() == false)
+                return false;
+            segment = it->first;
+            if (it->second.live == 0)
+            {
+                retire(segment);
+                return false;
+            }
+            return true;
+        }
+        /// @brief 开始压缩指定段
+        /// @param segment 段号
+        /// @param src 输出参数 被压缩的段 压缩期间只读
+        /// @param dst 输出参数 接收存活记录的临时段
         /// @return 成功返回true 失败返回false
-        bool insert(const std::string &filename, const MessagePtr &msg)
+        bool beginCompaction(uint32_t segment, Segment::ptr &src, Segment::ptr &dst)
         {
-            // 新增数据添加在文件末尾
-            // 消息序列化
-            std::string body = msg->payload().SerializeAsString();
-            // 获取文件长度
+            if (_log.contains(segment) == false)
+                return false;
+            src = _log.select(segment);
+            dst = _log.createTemp(segment);
+            if (dst.get() == nullptr)
+                return false;
+            _compacting = src;
+            return true;
+        }
+        /// @brief 完成压缩 用临时段原子地替换原段
+        /// @param dst 已刷盘的临时段
+        /// @param total 临时段中的记录数
+        /// @param live 临时段中仍然存活的记录数
+        /// @return 成功返回true 失败返回false 失败时临时段被删除
+        /// @note 压缩期间原段的消息全部被确认时 直接删除原段
+        bool finishCompaction(const Segment::ptr &dst, size_t total, size_t live)
+        {
+            Segment::ptr src = _compacting;
+            _compacting.reset();
+            // 压缩期间队列被清空 同一个段号可能已经属于新的段
+            if (src.get() == nullptr || _log.contains(dst->id()) == false || _log.select(dst->id()) != src)
+            {
+                dst->remove();
+                return false;
+            }
+            auto it = _stats.find(dst->id());
+            if (it != _stats.end() && it->second.live == 0)
+            {
+                dst->remove();
+                retire(dst->id());
+                return true;
+            }
+            if (_log.contains(dst->id()) == false || _log.replace(dst) == false)
+            {
+                dst->remove();
+                return false;
+            }
+            SegmentStat &stat = _stats[dst->id()];
+            stat.total = total;
+            stat.live = live;
+            return true;
+        }
+        /// @brief 放弃压缩 删除临时段
+        /// @param dst 临时段
+        void abortCompaction(const Segment::ptr &dst)
+        {
+            _compacting.reset();
+            dst->remove();
+            retire(dst->id());
+        }
+        /// @brief 压缩确认日志
+        /// @note
+        /// 数据段中已没有已确认的记录时直接清空确认日志
+        /// 否则在墓碑数量远多于已确认记录时 只保留落在现存段序号范围内的墓碑
+        void compactAckLog()
+        {
+            if (_acklog.count() == 0)
+                return;
+            if (_journal.get() != nullptr)
+            {
+                // 共享日志中已删除的段里不再有本队列的记录
+                for (auto it = _stats.begin(); it != _stats.end();)
+                {
+                    if (it->second.live == 0 && _journal->contains(it->first) == false)
+                        it = _stats.erase(it);
+                    else
+                        ++it;
+                }
+            }
+            size_t acked = 0;
+            for (auto &stat : _stats)
+                acked += stat.second.total - stat.second.live;
+            if (acked == 0)
+            {
+                _acklog.reset();
+                return;
+            }
+            if (_acklog.count() < ACKLOG_COMPACT_MIN || _acklog.count() < acked * 2)
+                return;
+            std::unordered_set<uint64_t> seqs;
+            if (_acklog.load(seqs) == false)
+                return;
+            std::vector<uint64_t> keep;
+            for (uint64_t seq : seqs)
+            {
+                for (auto &stat : _stats)
+                {
+                    if (seq >= stat.second.min_seq && seq <= stat.second.max_seq)
+                    {
+                        keep.push_back(seq);
+                        break;
+                    }
+                }
+            }
+            _acklog.rewrite(keep);
+        }
+        /// @brief 组提交 等待刷盘进度达到目标
+        /// @param lock 已持有的刷盘状态锁
+        /// @param target 目标写入序号
+        /// @return 成功返回true 失败返回false
+        /// @note
+        /// 同一时刻只有一个线程(领导者)执行刷盘, 它会覆盖开始刷盘时所有已写入的记录
+        /// 其余线程等待该次刷盘完成, 若仍未覆盖自己的记录再竞争下一次
+        bool syncTo(std::unique_lock<std::mutex> &lock, uint64_t target)
+        {
+            while (_synced < target)
+            {
+                if (_syncing)
+                {
+                    _sync_cv.wait(lock);
+                    continue;
+                }
+                _syncing = true;
+                uint64_t goal = _written;
+                uint64_t journal_goal = _journal_written;
+                std::vector<Segment::ptr> dirty;
+                dirty.swap(_dirty);
+                bool ack_dirty = _ack_dirty;
+                _ack_dirty = false;
+                lock.unlock();
+                bool ret = true;
+                for (auto &segment : dirty)
+                    ret = segment->sync() && ret;
+                if (_journal.get() != nullptr)
+                    ret = _journal->syncTo(journal_goal) && ret;
+                if (ack_dirty)
+                    ret = _acklog.sync() && ret;
+                lock.lock();
+                _syncing = false;
+                _last_sync = std::chrono::steady_clock::now();
+                _sync_count++;
+                if (ret == false)
+                {
+                    // 刷盘失败 重新登记这些段 下次重试
+                    _dirty.insert(_dirty.begin(), dirty.begin(), dirty.end());
+                    _ack_dirty = _ack_dirty || ack_dirty;
+                    _sync_cv.notify_all();
+                    return false;
+                }
+                _synced = goal;
+                _sync_cv.notify_all();
+            }
+            return true;
+        }
+        /// @brief 生成队列的段目录 同时规范化基础目录
+        /// @param basedir 基础目录 末尾没有分隔符时会补上'/'
+        /// @param qname 队列名称
+        /// @return 段目录
+        static std::string queueDirectory(std::string &basedir, const std::string &qname)
+        {
+            if (basedir.back() != '/' && basedir.back() != '\\')
+                basedir.push_back('/');
+            return basedir + qname + "/";
+        }
+        /// @brief 从指定偏移开始读取段中的所有记录
+        /// @param segment 段
+        /// @param offset 起始偏移
+        /// @param result 存储读取到的消息 包括已确认的消息 旧版本中被标记为无效的消息除外
+        /// @return 成功返回true 读取失败返回false
+        /// @note
+        /// 段文件被映射到内存中 记录在映射区域中原地解析
+        /// 段尾不完整或校验失败的记录(写入中途崩溃)被截断 之后的追加不会跟在残留数据后面
+        bool scan(const Segment::ptr &segment, size_t offset, std::vector<MessageRef::ptr> &result)
+        {
+            SegmentReader reader(segment, offset);
+            if (reader.open() == false)
+                return false;
+            RecordHeader header;
+            const char *msg_body;
+            while (reader.next(header, msg_body, offset))
+            {
+                auto parse = [&](uint32_t inner, const char *data, size_t len)
+                {
+                    Message::Payload refs;
+                    auto ref = MessageRef::create(MessageRef::parse(data, len, refs), 0, true);
+                    if (ref->msg.get() == nullptr || refs.valid() == MSG_INVALID) // 旧版本中被标记为无效的消息
+                        return;
+                    ref->seq = refs.seq();
+                    ref->segment = segment->id();
+                    ref->offset = offset;
+                    ref->length = header.length;
+                    ref->inner = inner;
+                    result.push_back(ref);
+                };
+                if (header.codec() == Codec::NONE)
+                {
+                    parse(0, msg_body, header.length);
+                    continue;
+                }
+                // 压缩块 解压后逐条解析
+                std::string raw;
+                if (RecordBlock::decode(msg_body, header.length, raw) == false ||
+                    RecordBlock::each(raw, parse) == false)
+                    warn(logger, " %s :偏移 %zu 处的压缩块损坏", segment->filename().c_str(), offset);
+            }
+            if (reader.truncated() && segment->truncate(reader.position()) == true)
+                info(logger, " %s :已截断到 %zu 字节", segment->filename().c_str(), reader.position());
+            return true;
+        }
+        /// @brief 加载有效消息 按段号顺序读取所有消息并存为有效的消息对象
+        /// @param result 存储有效消息的列表
+        /// @return 成功返回true 失败返回false
+        /// @note
+        /// 垃圾回收中途崩溃时新旧段中可能存在同一条消息 按消息序号去重
+        /// 旧版本数据没有消息序号 按消息id去重 加载时在已有的最大序号之后依次分配
+        bool load(std::list<MessageRef::ptr> &result)
+        {
+            std::unordered_set<uint64_t> acked;
+            if (_acklog.load(acked) == false)
+            {
+                error(logger, " %s :读取确认日志失败!", _log.dirname().c_str());
+                return false;
+            }
+            LoadedSet loaded;
+            std::vector<MessageRef::ptr> unsequenced;
+            uint64_t max_seq = 0;
+            for (auto &segment : _log.segments())
+            {
+                std::vector<MessageRef::ptr> refs;
+                if (scan(segment, 0, refs) == false)
+                    return false;
+                for (auto &ref : refs)
+                {
+                    if (acked.count(ref->seq) > 0) // 已确认的消息
+                        continue;
+                    if (loaded.insert(ref) == false)
+                        continue;
+                    if (ref->seq == 0)
+                        unsequenced.push_back(ref);
+                    max_seq = std::max<uint64_t>(max_seq, ref->seq);
+                    result.push_back(ref); // 有效消息保存
+                }
+            }
+            for (auto &ref : unsequenced)
+                ref->seq = ++max_seq;
+            return true;
+        }
+        /// @brief 按检查点恢复存活消息 只扫描检查点之后追加的数据
+        /// @param result 存储有效消息的列表 按序号排列
+        /// @param seq 输出参数 已分配过的最大消息序号
+        /// @return 成功返回true 检查点不存在或与数据段不一致返回false
+        /// @note
+        /// 检查点之后被删除的段中已没有存活消息 直接跳过
+        /// 检查点之后被压缩替换的段(inode编号改变)中消息位置已失效 需要完整加载
+        bool loadCheckpoint(std::list<MessageRef::ptr> &result, uint64_t &seq)
+        {
+            QueueCheckpoint checkpoint;
+            if (_checkpoint.load(checkpoint) == false)
+                return false;
+            std::unordered_set<uint64_t> acked;
+            if (_acklog.load(acked) == false)
+            {
+                error(logger, " %s :读取确认日志失败!", _log.dirname().c_str());
+                return false;
+            }
+            seq = checkpoint.seq();
+            for (uint64_t acked_seq : acked)
+                seq = std::max<uint64_t>(seq, acked_seq);
+            // 校验段信息
+            std::map<uint32_t, Segment::ptr> segments;
+            for (auto &segment : _log.segments())
+                segments.insert(std::make_pair(segment->id(), segment));
+            _stats.clear();
+            for (auto &info : checkpoint.segments())
+            {
+                auto it = segments.find(info.id());
+                if (it == segments.end())
+                    continue;
+                if (it->second->inode() != info.inode())
+                {
+                    warn(logger, " %s :检查点之后数据段已被替换, 需要完整加载", it->second->filename().c_str());
+                    return false;
+                }
+                SegmentStat &stat = _stats[info.id()];
+                stat.total = info.total();
+                stat.min_seq = info.min_seq();
+                stat.max_seq = info.max_seq();
+            }
+            for (auto &segment : segments)
+            {
+                if (segment.first < checkpoint.active() && _stats.count(segment.first) == 0 && segment.second->size() > 0)
+                {
+                    warn(logger, " %s :数据段不在检查点中, 需要完整加载", segment.second->filename().c_str());
+                    return false;
+                }
+            }
+            // 按段号和偏移的顺序读取检查点中的存活消息 每个段只映射一次
+            std::vector<const QueueCheckpoint::Entry *> entries;
+            for (auto &entry : checkpoint.entries())
+            {
+                if (segments.count(entry.segment()) > 0 && acked.count(entry.seq()) == 0)
+                    entries.push_back(&entry);
+            }
+            std::sort(entries.begin(), entries.end(), [](const QueueCheckpoint::Entry *a, const QueueCheckpoint::Entry *b)
+                      { return a->segment() != b->segment() ? a->segment() < b->segment() : a->offset() < b->offset(); });
+            std::vector<MessageRef::ptr> refs;
+            LoadedSet loaded;
+            std::unique_ptr<SegmentReader> reader;
+            uint32_t mapped = 0;
+            std::string block; // 最近解压的压缩块 同一个块中的消息在检查点中相邻
+            const char *block_body = nullptr;
+            for (auto *entryp : entries)
+            {
+                const QueueCheckpoint::Entry &entry = *entryp;
+                auto it = segments.find(entry.segment());
+                if (reader.get() == nullptr || mapped != entry.segment())
+                {
+                    mapped = entry.segment();
+                    reader.reset(new SegmentReader(it->second));
+                    block_body = nullptr;
+                    if (reader->open() == false)
+                        return false;
+                }
+                const char *msg_body;
+                if (reader->at(entry.offset(), entry.length(), msg_body) == false)
+                {
+                    warn(logger, " %s :检查点中的消息超出数据段范围, 需要完整加载", it->second->filename().c_str());
+                    return false;
+                }
+                size_t msg_len = entry.length();
+                if (entry.inner() > 0)
+                {
+                    const char *record_body = msg_body;
+                    if (record_body != block_body && RecordBlock::decode(record_body, entry.length(), block) == false)
+                    {
+                        warn(logger, " %s :检查点中的压缩块损坏, 需要完整加载", it->second->filename().c_str());
+                        return false;
+                    }
+                    block_body = record_body;
+                    if (RecordBlock::entry(block, entry.inner(), msg_body, msg_len) == false)
+                    {
+                        warn(logger, " %s :检查点中的消息超出压缩块范围, 需要完整加载", it->second->filename().c_str());
+                        return false;
+                    }
+                }
+                Message::Payload parsed;
+                auto ref = MessageRef::create(MessageRef::parse(msg_body, msg_len, parsed), entry.seq(), true);
+                if (ref->msg.get() == nullptr || parsed.seq() != entry.seq() ||
+                    (entry.id().empty() == false && ref->key() != MessageId::of(entry.id())))
+                {
+                    warn(logger, " %s :检查点与数据段内容不一致, 需要完整加载", it->second->filename().c_str());
+                    return false;
+                }
+                ref->segment = entry.segment();
+                ref->offset = entry.offset();
+                ref->length = entry.length();
+                ref->inner = entry.inner();
+                loaded.insert(ref);
+                refs.push_back(ref);
+            }
+            // 扫描检查点之后追加的数据
+            for (auto &segment : segments)
+            {
+                if (segment.first < checkpoint.active())
+                    continue;
+                size_t offset = 0;
+                if (segment.first == checkpoint.active())
+                {
+                    if (segment.second->size() < checkpoint.tail())
+                    {
+                        warn(logger, " %s :活跃段短于检查点记录的位置, 需要完整加载", segment.second->filename().c_str());
+                        return false;
+                    }
+                    offset = checkpoint.tail();
+                }
+                std::vector<MessageRef::ptr> tail;
+                if (scan(segment.second, offset, tail) == false)
+                    return false;
+                for (auto &ref : tail)
+                {
+                    SegmentStat &stat = _stats[segment.first];
+                    stat.total++;
+                    stat.min_seq = std::min<uint64_t>(stat.min_seq, ref->seq);
+                    stat.max_seq = std::max<uint64_t>(stat.max_seq, ref->seq);
+                    seq = std::max<uint64_t>(seq, ref->seq);
+                    if (acked.count(ref->seq) > 0)
+                        continue;
+                    if (loaded.insert(ref) == false)
+                        continue;
+                    refs.push_back(ref);
+                }
+            }
+            // 统计存活消息 删除已经没有存活消息的段
+            std::sort(refs.begin(), refs.end(), [](const MessageRef::ptr &a, const MessageRef::ptr &b)
+                      { return a->seq < b->seq; });
+            for (auto &ref : refs)
+                _stats[ref->segment].live++;
+            std::vector<uint32_t> empties;
+            for (auto &stat : _stats)
+            {
+                if (stat.second.live == 0)
+                    empties.push_back(stat.first);
+            }
+            for (uint32_t segment : empties)
+                retire(segment);
+            result.assign(refs.begin(), refs.end());
+            info(logger, " %s :按检查点恢复 %zu 条消息", _log.dirname().c_str(), result.size());
+            return true;
+        }
+        /// @brief 共享日志模式下创建队列目录 读取或生成队列标识
+        /// @return 成功返回true 失败返回false
+        /// @note 队列标识在写入任何记录之前刷盘 否则崩溃后共享日志中的记录无法找回
+        bool createJournalFile()
+        {
+            if (FileHelper(_log.dirname()).exists() == false && FileHelper::createDirectory(_log.dirname()) == false)
+            {
+                error(logger, " %s :创建队列目录失败!", _log.dirname().c_str());
+                return false;
+            }
+            std::string filename = _log.dirname() + QUEUE_ID_FILE;
             FileHelper helper(filename);
-            size_t fsize = helper.size();
-            // 先写入4字节数据长度
-            size_t message_size = body.size();
-            bool ret = helper.write((char *)&message_size, fsize, sizeof(size_t));
-            if (ret == false)
+            if (helper.exists() == false || helper.read(_tag) == false || _tag.empty())
+            {
+                _tag = UUIDHelper::uuid();
+                int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+                bool ret = fd >= 0 && ::write(fd, _tag.data(), _tag.size()) == (ssize_t)_tag.size() && ::fdatasync(fd) == 0;
+                if (fd >= 0)
+                    ::close(fd);
+                if (ret == false)
+                {
+                    error(logger, "%s:写入队列标识失败! %s", filename.c_str(), strerror(errno));
+                    return false;
+                }
+            }
+            if (_acklog.open() == false)
             {
-                error(logger, " %s :队列数据文件写入长度失败!", filename.c_str());
+                error(logger, " %s :打开队列确认日志失败!", _log.dirname().c_str());
                 return false;
             }
-
-            // 写入数据到指定位置
-            ret = helper.write(body.c_str(), fsize + sizeof(size_t), body.size());
-            if (ret == false)
+            return true;
+        }
+        /// @brief 将消息追加到共享日志
+        /// @param ref 队列中的消息 写入后更新其存储位置
+        /// @param record 序列化后的共享消息
+        /// @return 插入成功返回true 失败返回false
+        bool insertJournal(const MessageRef::ptr &ref, const std::string &record)
+        {
+            Message::Payload refs;
+            Message::Reference *reference = refs.add_refs();
+            reference->set_queue(_tag);
+            reference->set_seq(ref->seq);
+            std::string body = record + refs.SerializeAsString();
+            uint32_t segment;
+            size_t offset;
+            uint64_t ticket;
+            if (_journal->append(body, ref->seq, segment, offset, ticket) == false)
+            {
+                error(logger, " %s :共享日志写入失败!", _log.dirname().c_str());
+                return false;
+            }
+            ref->segment = segment;
+            ref->offset = offset;
+            ref->length = body.size();
+            attach(ref, ticket);
+            return true;
+        }
+        /// @brief 共享日志模式下恢复存活消息
+        /// @param seq 输出参数 已分配过的最大消息序号
+        /// @return 按序号排列的存活消息
+        /// @note 队列目录中残留的独立分段日志(切换存储方式之前的数据)被迁移到共享日志后删除
+        std::list<MessageRef::ptr> recoverJournal(uint64_t &seq)
+        {
+            std::list<MessageRef::ptr> result;
+            std::unordered_set<uint64_t> acked;
+            if (_acklog.load(acked) == false)
+            {
+                error(logger, " %s :读取确认日志失败!", _log.dirname().c_str());
+                return result;
+            }
+            seq = 0;
+            for (uint64_t acked_seq : acked)
+                seq = std::max<uint64_t>(seq, acked_seq);
+            _stats.clear();
+            LoadedSet loaded;
+            for (auto &ref : _journal->take(_tag))
+            {
+                seq = std::max<uint64_t>(seq, ref->seq);
+                account(ref->segment, ref->seq);
+                if (acked.count(ref->seq) > 0 || loaded.insert(ref) == false)
+                {
+                    _stats[ref->segment].live--;
+                    _journal->release(ref->segment);
+                    continue;
+                }
+                result.push_back(ref);
+            }
+            std::vector<std::string> files;
+            FileHelper::listDirectory(_log.dirname(), files);
+            bool segmented = std::any_of(files.begin(), files.end(), [](const std::string &file)
+                                         { return file.size() > strlen(SEGMENT_SUBFIX) &&
+                                                  file.compare(file.size() - strlen(SEGMENT_SUBFIX), std::string::npos, SEGMENT_SUBFIX) == 0; });
+            if (segmented)
+            {
+                std::list<MessageRef::ptr> legacy;
+                if (_log.open() == false || load(legacy) == false)
+                {
+                    error(logger, " %s :读取队列数据段失败!", _log.dirname().c_str());
+                    return result;
+                }
+                for (auto &ref : legacy)
+                {
+                    if (loaded.insert(ref) == false)
+                        continue;
+                    if (insertJournal(ref, ref->msg->serialize()) == false)
+                        return result;
+                    seq = std::max<uint64_t>(seq, ref->seq);
+                    result.push_back(ref);
+                }
+                // 迁移的消息落盘之后才能删除原来的段
+                if (sync() == false)
+                    return result;
+                _log.removeAll();
+                info(logger, " %s :队列数据段中的 %zu 条消息已迁移到共享日志", _log.dirname().c_str(), legacy.size());
+            }
+            result.sort([](const MessageRef::ptr &a, const MessageRef::ptr &b)
+                        { return a->seq < b->seq; });
+            info(logger, " %s :从共享日志恢复 %zu 条消息", _log.dirname().c_str(), result.size());
+            return result;
+        }
+
+    private:
+        /// @brief 换出日志中的一条记录已读回 段中没有待读回的记录且不是活跃段时删除
+        /// @param segment 段号
+        void unspill(uint32_t segment)
+        {
+            auto it = _spill_live.find(segment);
+            if (it == _spill_live.end() || --it->second > 0)
+                return;
+            Segment::ptr active = _spill.active();
+            if (active.get() != nullptr && active->id() == segment)
+                return;
+            if (_spill.removeSegment(segment))
+                _spill_live.erase(it);
+        }
+
+    private:
+        std::string _qname;                                ///< 队列名称
+        SegmentLog _log;                                   ///< 分段日志
+        Journal::ptr _journal;                             ///< 共享日志 为空时使用分段日志
+        std::string _tag;                                  ///< 共享日志中的队列标识
+        std::string _datafile;                             ///< 旧版本数据文件
+        std::string _tmpfile;                              ///< 旧版本临时文件
+        std::map<uint32_t, SegmentStat> _stats;            ///< 段号到段记录统计的映射表
+        Segment::ptr _compacting;                          ///< 正在压缩的段
+        AckLog _acklog;                                    ///< 确认日志
+        Checkpoint _checkpoint;                            ///< 索引检查点
+        RecordBlock _block;                                ///< 尚未写出的压缩块
+        std::vector<MessageRef::ptr> _block_refs;          ///< 压缩块中的消息
+        std::chrono::steady_clock::time_point _block_since; ///< 压缩块中第一条记录加入的时间
+        SegmentLog _spill;                                 ///< 换出日志 保存被换出内存的非持久化消息
+        std::map<uint32_t, size_t> _spill_live;            ///< 换出日志段号到待读回记录数的映射表
+        DurabilityPolicy _policy;                          ///< 持久化策略
+        std::mutex _sync_mutex;                            ///< 刷盘状态锁
+        std::condition_variable _sync_cv;                  ///< 等待刷盘完成的条件变量
+        std::vector<Segment::ptr> _dirty;                  ///< 尚未刷盘的段
+        uint64_t _written;                                 ///< 已写入的记录序号
+        uint64_t _synced;                                  ///< 已刷盘的记录序号
+        uint64_t _journal_written;                         ///< 最近一条记录在共享日志中的写入序号
+        bool _ack_dirty;                                   ///< 确认日志是否有未刷盘的记录
+        bool _syncing;                                     ///< 是否有线程正在刷盘
+        size_t _sync_count;                                ///< 实际执行的刷盘次数
+        std::chrono::steady_clock::time_point _last_sync;  ///< 上一次刷盘的时间
+    };
+
+    /// @struct Delivery
+    /// @brief 一次投递 消息和确认时使用的投递标识
+    struct Delivery
+    {
+        uint64_t tag;   ///< 投递标识
+        MessagePtr msg; ///< 消息
+    };
+
+    /// @class QueueMessage
+    /// @brief 推送消息队列管理
+    class QueueMessage
+    {
+    public:
+        using ptr = std::shared_ptr<QueueMessage>;
+        /// @brief 推送消息队列构造函数
+        /// @param qname 队列名称
+        /// @param store 存储引擎
+        /// @param lazy 是否为惰性队列 持久化消息只保留引用 投递前从磁盘读回
+        /// @param usage 所有队列共用的内存占用计数 为空时只统计本队列
+        QueueMessage(const std::string &qname, const MessageStore::ptr &store, bool lazy = false,
+                     const std::shared_ptr<std::atomic<size_t>> &usage = std::shared_ptr<std::atomic<size_t>>())
+            : _qname(qname), _seq(0), _changed(false), _recovered(false), _lazy(lazy),
+              _bytes(0), _usage(usage), _store(store), _waitack_msgs(deliveryBase())
+        {
+        }
+        /// @brief 恢复历史消息
+        void recovery()
+        {
+            {
+                std::unique_lock<std::mutex> hlock(_head_mutex);
+                std::unique_lock<std::mutex> lock(_mutex);
+                std::unique_lock<std::mutex> tlock(_tail_mutex);
+                for (auto &ref : _store->recovery(_seq))
+                {
+                    _incoming.push_back(ref);
+                    _durable_msgs.insert(std::make_pair(ref->seq, ref));
+                    if (_lazy)
+                        ref->msg.reset();
+                    else
+                        charge(ref);
+                }
+                _changed = true;
+                _recovered = true;
+            }
+            // 恢复完成后立即写入检查点 下次重启时需要扫描的数据更少
+            checkpoint();
+        }
+        /// @brief 插入推送消息队列
+        /// @param msg 共享的消息
+        /// @param durable 是否在该队列中持久化
+        /// @param record 序列化后的共享消息 只在持久化时使用
+        /// @return 成功返回true 失败返回false
+        bool insert(const MessagePtr &msg, bool durable, const std::string &record)
+        {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                auto ref = MessageRef::create(msg, ++_seq, durable);
+                // 判断消息是否需要持久化
+                if (durable)
+                {
+                    // 持久化存储
+                    bool ret = _store->insert(ref, record);
+                    if (ret == false)
+                    {
+                        error(logger, " %s :持久化存储消息失败!", _qname.c_str());
+                        return false;
+                    }
+                    _durable_msgs.insert(std::make_pair(ref->seq, ref));
+                    _changed = true;
+                }
+                // 内存管理 惰性队列中已经写出的持久化消息只保留引用
+                if (_lazy && durable && ref->length > 0)
+                    ref->msg.reset();
+                else
+                    charge(ref);
+                enqueue(ref);
+                if (durable && _store->blockDue())
+                    flushBlock();
+            }
+            if (durable && _store->flushOnCommit())
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                if (flushBlock() == false)
+                    return false;
+            }
+            // 释放队列锁之后再按策略刷盘 让并发的发布合并到同一次刷盘中
+            if (durable && _store->commit() == false)
             {
-                error(logger, " %s :队列数据文件写入内容失败!", filename.c_str());
+                error(logger, " %s :持久化消息刷盘失败!", _qname.c_str());
                 return false;
             }
-            // 更新msg中的存储信息
-            msg->set_offset(fsize + sizeof(size_t));
-            msg->set_length(body.size());
             return true;
         }
-        /// @brief 加载有效消息 从数据文件中读取所有消息并存为有效的消息对象
-        /// @param result 存储有效消息的列表
+        /// @brief 将一条消息持久化到多个队列 共享日志中只写入一条记录
+        /// @param qmps 持久化的目标队列
+        /// @param msg 共享的消息
+        /// @param record 序列化后的共享消息
+        /// @param journal 共享日志
         /// @return 成功返回true 失败返回false
-        bool load(std::list<MessagePtr> &result)
+        /// @note
+        /// 按地址顺序对所有目标队列的存储锁加锁 分配序号、写入记录、加入队列在同一个临界区内完成
+        /// 每个队列中消息的顺序与序号一致; 记录中的引用部分列出每个队列的标识和序号
+        static bool insert(const std::vector<ptr> &qmps, const MessagePtr &msg, const std::string &record, Journal &journal)
         {
-            FileHelper helper(_datafile);
-            size_t offset = 0, msg_size;
-            size_t fsize = helper.size();
-            bool ret;
-            while (offset < fsize)
+            std::vector<ptr> targets(qmps);
+            std::sort(targets.begin(), targets.end());
+            targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
             {
-                ret = helper.read((char *)&msg_size, offset, sizeof(size_t));
-                if (ret == false)
+                std::vector<std::unique_lock<std::mutex>> locks;
+                for (auto &qmp : targets)
+                    locks.emplace_back(qmp->_mutex);
+                Message::Payload refs;
+                std::vector<MessageRef::ptr> entries;
+                for (auto &qmp : targets)
                 {
-                    error(logger, " %s :读取消息长度失败!", _datafile);
-                    return false;
+                    entries.push_back(MessageRef::create(msg, ++qmp->_seq, true));
+                    Message::Reference *reference = refs.add_refs();
+                    reference->set_queue(qmp->_store->tag());
+                    reference->set_seq(entries.back()->seq);
                 }
-                offset += sizeof(size_t);
-                std::string msg_body(msg_size, '\0');
-                ret = helper.read(&msg_body[0], offset, msg_size);
-                if (ret == false)
+                std::string body = record + refs.SerializeAsString();
+                uint32_t segment;
+                size_t offset;
+                uint64_t ticket;
+                // 扇出记录对应多个序号 记录头中的序号不使用
+                if (journal.append(body, 0, segment, offset, ticket, targets.size()) == false)
                 {
-                    error(logger, " %s :读取消息数据失败!", _datafile);
+                    error(logger, "共享日志写入消息失败!");
                     return false;
                 }
-                offset += msg_size;
-                MessagePtr msgp = std::make_shared<Message>();
-                msgp->mutable_payload()->ParseFromString(msg_body);
-                if (msgp->payload().valid() == MSG_INVALID) // 无效消息则处理下一个
-                    continue;
-                result.push_back(msgp); // 有效消息保存
+                for (size_t i = 0; i < targets.size(); i++)
+                {
+                    MessageRef::ptr &ref = entries[i];
+                    ref->segment = segment;
+                    ref->offset = offset;
+                    ref->length = body.size();
+                    targets[i]->_store->attach(ref, ticket);
+                    targets[i]->_durable_msgs.insert(std::make_pair(ref->seq, ref));
+                    targets[i]->_changed = true;
+                    if (targets[i]->_lazy)
+                        ref->msg.reset();
+                    else
+                        targets[i]->charge(ref);
+                    targets[i]->enqueue(ref);
+                }
             }
-            return true;
+            bool ret = true;
+            for (auto &qmp : targets)
+            {
+                if (qmp->_store->commit() == false)
+                {
+                    error(logger, " %s :持久化消息刷盘失败!", qmp->_qname.c_str());
+                    ret = false;
+                }
+            }
+            return ret;
         }
-
-    private:
-        std::string _qname;    ///< 队列名称
-        std::string _datafile; ///< 数据文件
-        std::string _tmpfile;  ///< 临时文件
-    };
-
-    /// @class QueueMessage
-    /// @brief 推送消息队列管理
-    class QueueMessage
-    {
-    public:
-        using ptr = std::shared_ptr<QueueMessage>;
-        /// @brief 推送消息队列构造函数 恢复历史消息
-        /// @param basedir 基础目录
-        /// @param qname 队列名称
-        QueueMessage(std::string &basedir, const std::string &qname)
-            : _mapper(basedir, qname), _qname(qname), _valid_count(0), _total_count(0)
+        /// @brief 定时刷盘 由消息管理类的后台线程调用
+        void flush()
         {
+            _store->flush();
         }
-        /// @brief 恢复历史消息
-        void recovery()
+        /// @brief 写出停留过久的压缩块 由消息管理类的后台线程调用
+        void expireBlock()
         {
             std::unique_lock<std::mutex> lock(_mutex);
-            _msgs = _mapper.garbageCollection();
-            for (auto &msg : _msgs)
-                _durable_msgs.insert(std::make_pair(msg->payload().properties().id(), msg));
-            _valid_count = _total_count = _msgs.size();
+            if (_store->blockExpired())
+                flushBlock();
         }
-        /// @brief 插入推送消息队列
-        /// @param bp 消息属性
-        /// @param body 消息内容主体
-        /// @param delivery_mode 持久化标志
-        /// @return 成功返回true 失败返回false
-        bool insert(const BasicProperties *bp, const std::string &body, bool queue_id_durable)
+        /// @brief 写入索引检查点 由消息管理类的后台线程调用
+        /// @return 成功或没有变化返回true 失败返回false
+        /// @note 只在生成检查点数据时持有队列锁 刷盘和写文件时不持有
+        bool checkpoint()
         {
-            // 构造消息对象
-            MessagePtr msg = std::make_shared<Message>();
-            msg->mutable_payload()->set_body(body);
-            if (bp != nullptr)
+            QueueCheckpoint checkpoint;
             {
-                DeliveryMode mode = queue_id_durable ? bp->delivery_mode() : DeliveryMode::UNDURABLE;
-                msg->mutable_payload()->mutable_properties()->set_id(bp->id());
-                msg->mutable_payload()->mutable_properties()->set_delivery_mode(mode);
-                msg->mutable_payload()->mutable_properties()->set_routing_key(bp->routing_key());
+                std::unique_lock<std::mutex> lock(_mutex);
+                if (_changed == false)
+                    return true;
+                flushBlock();
+                _store->snapshot(_durable_msgs, _seq, checkpoint);
+                _changed = false;
             }
-            else
+            if (_store->writeCheckpoint(checkpoint) == false)
             {
-                DeliveryMode mode = queue_id_durable ? DeliveryMode::DURABLE : DeliveryMode::UNDURABLE;
-                msg->mutable_payload()->mutable_properties()->set_id(UUIDHelper::uuid());
-                msg->mutable_payload()->mutable_properties()->set_delivery_mode(mode);
-                msg->mutable_payload()->mutable_properties()->set_routing_key("");
+                std::unique_lock<std::mutex> lock(_mutex);
+                _changed = true;
+                return false;
             }
-            std::unique_lock<std::mutex> lock(_mutex);
-            // 判断消息是否需要持久化
-            if (msg->payload().properties().delivery_mode() == DeliveryMode::DURABLE)
+            return true;
+        }
+        /// @brief 增量压缩一个数据段 由消息管理类的后台线程调用
+        /// @param rate 压缩速率上限(字节/秒) 0表示不限速
+        /// @return 改变了消息的存储位置返回true 否则返回false
+        /// @note 只在检查存活状态和更新消息位置时持有队列锁 @see MessageStore::compact
+        bool compact(size_t rate)
+        {
             {
-                msg->mutable_payload()->set_valid(MSG_VALID); // 持久化存储中表示数据有效
-                // 持久化存储
-                bool ret = _mapper.insert(msg);
-                if (ret == false)
-                {
-                    error(logger, " %s :持久化存储消息失败!", body.c_str());
+                std::unique_lock<std::mutex> lock(_mutex);
+                if (_recovered == false)
                     return false;
-                }
-                _valid_count++;
-                _total_count++;
-                _durable_msgs.insert(std::make_pair(msg->payload().properties().id(), msg));
             }
-            // 内存管理
-            _msgs.push_back(msg);
+            if (_store->compact(_mutex, _durable_msgs, rate) == false)
+                return false;
+            std::unique_lock<std::mutex> lock(_mutex);
+            _changed = true;
             return true;
         }
+        /// @brief 是否需要后台线程定时刷盘
+        bool needFlusher() const
+        {
+            return _store->needFlusher();
+        }
+        /// @brief 是否将持久化消息写入虚拟机的共享日志
+        bool journaled() const
+        {
+            return _store->journaled();
+        }
         /// @brief 获取队头消息
         /// @return 消息指针
         MessagePtr front()
         {
-            if (_msgs.size() == 0)
+            uint64_t tag;
+            return front(tag);
+        }
+        /// @brief 获取队头消息
+        /// @param tag 输出参数 投递标识 确认和退回消息时使用
+        /// @return 消息指针
+        /// @note 非惰性队列只持有队头锁 与发布端并行
+        MessagePtr front(uint64_t &tag)
+        {
+            std::unique_lock<std::mutex> hlock(_head_mutex);
+            std::unique_lock<std::mutex> lock(_mutex, std::defer_lock);
+            if (_lazy)
+                lock.lock();
+            if (refill() == false)
+                return MessagePtr();
+            // 惰性队列 读回队头开始的一批消息
+            if (_msgs.front()->msg.get() == nullptr && pageIn(lock) == false)
                 return MessagePtr();
-            std::unique_lock<std::mutex> lock(_mutex);
             // 获取队头消息 从msgs取出数据
-            MessagePtr msg = _msgs.front();
+            MessageRef::ptr ref = _msgs.front();
             _msgs.pop_front();
-            // 将消息对象插入待确认映射表 等到收到确认ack后删除
-            _waitack_msgs.insert(std::make_pair(msg->payload().properties().id(), msg));
+            discharge(ref);
+            // 将消息对象放入待确认窗口 等到收到确认ack后删除
+            tag = _waitack_msgs.push(ref);
+            MessagePtr msg = ref->msg;
+            if (_lazy && ref->durable)
+            {
+                ref->msg.reset(); // 确认时只需要投递标识 退回后从磁盘读回 非持久化消息只在内存中 保留
+                if (ref->length == 0) // 还在压缩块中 先写出 退回后才能按存储位置读回
+                    flushBlock();
+            }
             return msg;
         }
+        /// @brief 批量获取队头消息 只加一次锁
+        /// @param count 最多获取的条数
+        /// @param deliveries 输出参数 获取到的消息和投递标识追加在末尾
+        /// @return 实际获取的条数
+        size_t front(size_t count, std::vector<Delivery> &deliveries)
+        {
+            std::unique_lock<std::mutex> hlock(_head_mutex);
+            std::unique_lock<std::mutex> lock(_mutex, std::defer_lock);
+            if (_lazy)
+                lock.lock();
+            std::vector<MessageRef::ptr> refs;
+            while (refs.size() < count && refill())
+            {
+                // 惰性队列 读回队头开始的一批消息
+                if (_msgs.front()->msg.get() == nullptr && pageIn(lock) == false)
+                    break;
+                _msgs.pop_front(std::min(count - refs.size(), LAZY_READAHEAD), refs);
+            }
+            bool unflushed = false;
+            for (auto &ref : refs)
+            {
+                discharge(ref);
+                deliveries.push_back(Delivery{_waitack_msgs.push(ref), ref->msg});
+                if (_lazy && ref->durable)
+                {
+                    unflushed = unflushed || ref->length == 0;
+                    ref->msg.reset();
+                }
+            }
+            if (unflushed)
+                flushBlock();
+            return refs.size();
+        }
+        /// @brief 将已推送未确认的消息放回队头 下次最先推送
+        /// @param tag 投递标识
+        /// @return 成功返回true 消息不在待确认窗口中返回false
+        /// @note 放回的消息再次推送时分配新的投递标识
+        bool requeue(uint64_t tag)
+        {
+            std::unique_lock<std::mutex> hlock(_head_mutex);
+            std::unique_lock<std::mutex> lock(_mutex, std::defer_lock);
+            if (_lazy)
+                lock.lock();
+            MessageRef::ptr *slot = _waitack_msgs.find(tag);
+            if (slot == nullptr)
+            {
+                warn(logger, " %s :没有找到要退回的消息! 投递标识: %llu", _qname.c_str(), (unsigned long long)tag);
+                return false;
+            }
+            if ((*slot)->msg.get() == nullptr && (*slot)->durable == false) // 惰性队列中已释放的非持久化消息无法再读回
+            {
+                warn(logger, " %s :非持久化消息已释放, 无法退回! 投递标识: %llu", _qname.c_str(), (unsigned long long)tag);
+                return false;
+            }
+            MessageRef::ptr ref;
+            _waitack_msgs.take(tag, ref);
+            _msgs.push_front(ref);
+            charge(ref);
+            return true;
+        }
         /// @brief 移除接收到确认ack的消息
-        /// @param msg_id 消息id
-        /// @return 成功返回true 失败返回false
-        bool remove(const std::string &msg_id)
+        /// @param tag 投递标识
+        /// @return 成功返回true 消息不在待确认窗口中返回false
+        /// @note 先在队头锁内从待确认窗口取出 只有持久化消息才再持有存储锁
+        bool remove(uint64_t tag)
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            // 从待确认映射表中查找消息
-            auto it = _waitack_msgs.find(msg_id);
-            if (it == _waitack_msgs.end())
+            // 从待确认窗口中取出消息
+            MessageRef::ptr ref;
             {
-                warn(logger, "没有找到要删除的消息! 消息id: %s", msg_id.c_str());
-                return true;
+                std::unique_lock<std::mutex> hlock(_head_mutex);
+                if (_waitack_msgs.take(tag, ref) == false)
+                {
+                    warn(logger, " %s :没有找到要删除的消息! 投递标识: %llu", _qname.c_str(), (unsigned long long)tag);
+                    return false;
+                }
             }
             // 查看持久化模式
-            if (it->second->payload().properties().delivery_mode() == DeliveryMode::DURABLE)
+            if (ref->durable)
             {
-                // 删除持久化信息
-                _mapper.remove(it->second);
-                _durable_msgs.erase(msg_id);
-                _valid_count--;
-                garbageCollection();
+                std::unique_lock<std::mutex> lock(_mutex);
+                // 删除持久化信息 占用的空间由后台线程压缩回收 还在压缩块中的消息先写出
+                if (ref->length == 0)
+                    flushBlock();
+                _store->remove(ref);
+                _durable_msgs.erase(ref->seq);
+                _changed = true;
             }
-            // 删除内存中的信息
-            _waitack_msgs.erase(msg_id);
             return true;
         }
         /// @brief 获取可获取消息数量
         /// @return 可获取消息数量
         size_t availableCount()
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            return _msgs.size();
+            std::unique_lock<std::mutex> hlock(_head_mutex);
+            std::unique_lock<std::mutex> tlock(_tail_mutex);
+            return _msgs.size() + _incoming.size();
         }
         /// @brief 获取总消息数量
         /// @return 总消息数量
         size_t totalCount()
         {
             std::unique_lock<std::mutex> lock(_mutex);
-            return _total_count;
+            return _store->totalCount();
         }
         /// @brief 获取待确认消息数量
         /// @return 待确认消息数量
         size_t waitAckCount()
         {
-            std::unique_lock<std::mutex> lock(_mutex);
+            std::unique_lock<std::mutex> hlock(_head_mutex);
             return _waitack_msgs.size();
         }
         /// @brief 获取持久化消息数量
@@ -360,61 +1824,233 @@ namespace XuMQ
             std::unique_lock<std::mutex> lock(_mutex);
             return _durable_msgs.size();
         }
+        /// @brief 获取存储引擎实际执行的刷盘次数
+        /// @return 刷盘次数
+        size_t syncCount()
+        {
+            return _store->syncCount();
+        }
         /// @brief 清空数据
         void clear()
         {
+            std::unique_lock<std::mutex> hlock(_head_mutex);
             std::unique_lock<std::mutex> lock(_mutex);
-            _mapper.removeMsgFile();
+            std::unique_lock<std::mutex> tlock(_tail_mutex);
+            _store->clear();
+            for (PendingList *list : {&_msgs, &_incoming})
+                for (auto &ref : *list)
+                    release(ref);
             _msgs.clear();
+            _incoming.clear();
             _durable_msgs.clear();
             _waitack_msgs.clear();
-            _valid_count = 0;
-            _total_count = 0;
+            _changed = false;
+            _bytes = 0;
+        }
+        /// @brief 清空待推送的消息 待确认的消息保留 等待消费者确认
+        /// @return 被丢弃的消息数量
+        /// @note 持有队列锁时只交换内存中的结构并让存储丢弃所有数据 再重新写入待确认的持久化消息
+        ///       代价与待确认的消息数有关 与队列深度无关 被丢弃的消息在释放队列锁之后析构
+        size_t purge()
+        {
+            PendingList msgs, incoming;
+            std::unordered_map<uint64_t, MessageRef::ptr> durable_msgs;
+            {
+                std::unique_lock<std::mutex> hlock(_head_mutex);
+                std::unique_lock<std::mutex> lock(_mutex);
+                std::unique_lock<std::mutex> tlock(_tail_mutex);
+                std::vector<MessageRef::ptr> keep, unread;
+                _waitack_msgs.each([&](uint64_t, const MessageRef::ptr &ref)
+                                   {
+                                       if (ref->durable == false)
+                                           return;
+                                       keep.push_back(ref);
+                                       if (ref->msg.get() == nullptr)
+                                           unread.push_back(ref); });
+                if (_store->read(unread) == false || _store->purge() == false)
+                {
+                    error(logger, " %s :清空队列存储失败!", _qname.c_str());
+                    return 0;
+                }
+                msgs.swap(_msgs);
+                incoming.swap(_incoming);
+                durable_msgs.swap(_durable_msgs);
+                // 按序号重新写入 存储中的记录保持序号递增
+                std::sort(keep.begin(), keep.end(), [](const MessageRef::ptr &a, const MessageRef::ptr &b)
+                          { return a->seq < b->seq; });
+                for (auto &ref : keep)
+                {
+                    if (_store->insert(ref, ref->msg->serialize()) == false)
+                        error(logger, " %s :重新写入待确认消息失败! 消息id: %s", _qname.c_str(), ref->id().c_str());
+                    _durable_msgs.insert(std::make_pair(ref->seq, ref));
+                }
+                flushBlock();
+                _bytes = 0;
+                _changed = true;
+            }
+            // 被丢弃的消息在释放队列锁之后从全局内存占用中扣除
+            for (PendingList *list : {&msgs, &incoming})
+                for (auto &ref : *list)
+                    release(ref);
+            if (_store->sync() == false)
+                error(logger, " %s :清空队列后刷盘失败!", _qname.c_str());
+            return msgs.size() + incoming.size();
+        }
+        /// @brief 获取待推送消息占用的内存
+        /// @return 字节数
+        size_t memoryUsage()
+        {
+            return _bytes;
+        }
+        /// @brief 从最早的消息开始换出内存中的消息体
+        /// @param bytes 需要释放的字节数
+        /// @return 全局内存占用实际减少的字节数 仍被其他队列持有的消息体不计入
+        /// @note 队头的一批消息即将投递 不换出; 持久化消息直接丢弃消息体 非持久化消息写入换出日志
+        size_t pageOut(size_t bytes)
+        {
+            std::unique_lock<std::mutex> hlock(_head_mutex);
+            std::unique_lock<std::mutex> lock(_mutex);
+            std::unique_lock<std::mutex> tlock(_tail_mutex);
+            size_t freed = 0, skipped = 0;
+            bool spilled = true;
+            for (PendingList *list : {&_msgs, &_incoming})
+            {
+                for (auto it = list->begin(); it != list->end() && freed < bytes && spilled; ++it)
+                {
+                    const MessageRef::ptr &ref = *it;
+                    if (skipped++ < LAZY_READAHEAD || ref->msg.get() == nullptr)
+                        continue;
+                    if (ref->durable && ref->length == 0) // 还在压缩块中 没有磁盘上的副本
+                        continue;
+                    size_t size = discharge(ref);
+                    if (ref->durable)
+                        ref->msg.reset();
+                    else if ((spilled = _store->spill(ref)) == false)
+                    {
+                        charge(ref);
+                        break;
+                    }
+                    freed += size;
+                }
+            }
+            return freed;
         }
 
     private:
-        /// @brief 垃圾回收条件检测
-        /// @return 消息总量大于2000 且 有效消息占比小于50% 返回true 否则返回false
-        bool garbageCollectionCheck()
+        /// @brief 分配待确认窗口的第一个投递标识
+        /// @note 每个队列对象占用独立的 2^40 个标识 删除后重新声明的同名队列不会接受旧的投递标识
+        static uint64_t deliveryBase()
+        {
+            static std::atomic<uint64_t> epoch(0);
+            return (++epoch << 40) + 1;
+        }
+        /// @brief 将消息追加到入队列表 需持有存储锁 保证入队顺序与序号一致
+        void enqueue(const MessageRef::ptr &ref)
+        {
+            std::unique_lock<std::mutex> tlock(_tail_mutex);
+            _incoming.push_back(ref);
+        }
+        /// @brief 出队列表取空时把入队列表整体交换过来 需持有队头锁
+        /// @return 有待推送的消息返回true 否则返回false
+        bool refill()
         {
-            if (_total_count > 2000 && _valid_count * 10 / _total_count < 5)
+            if (_msgs.empty() == false)
                 return true;
-            return false;
+            std::unique_lock<std::mutex> tlock(_tail_mutex);
+            _msgs.swap(_incoming);
+            return _msgs.empty() == false;
         }
-        /// @brief 垃圾回收
-        void garbageCollection()
+        /// @brief 读回队头开始尚未读回的消息 需持有队头锁
+        /// @param lock 存储锁 非惰性队列的消息被换出时才在这里加锁
+        /// @return 成功返回true 失败返回false
+        bool pageIn(std::unique_lock<std::mutex> &lock)
         {
-            // 垃圾回收 获取有效消息信息链表
-            if (garbageCollectionCheck() == false)
-                return;
-            // 更新消息的实际存储位置
-            std::list<MessagePtr> msgs = _mapper.garbageCollection();
-            for (auto &msg : msgs)
+            if (lock.owns_lock() == false)
+                lock.lock();
+            return page();
+        }
+        /// @brief 从磁盘读回队头开始尚未读回的消息 需持有队头锁和存储锁
+        /// @return 成功返回true 失败返回false
+        bool page()
+        {
+            std::vector<MessageRef::ptr> refs;
+            for (auto it = _msgs.begin(); it != _msgs.end() && refs.size() < LAZY_READAHEAD; ++it)
             {
-                auto it = _durable_msgs.find(msg->payload().properties().id());
-                if (it == _durable_msgs.end())
-                {
-                    _msgs.push_back(msg);
-                    _durable_msgs.insert(std::make_pair(msg->payload().properties().id(), msg));
-                    info(logger, "垃圾回收后 有一条消息在内存尚未被管理 已插入待推送消息列表");
+                if ((*it)->msg.get() == nullptr)
+                    refs.push_back(*it);
+            }
+            bool ret = _store->read(refs);
+            for (auto &ref : refs)
+                charge(ref);
+            return ret;
+        }
+        /// @brief 写出压缩块 惰性队列随后释放块中消息的内存 需持有存储锁
+        /// @return 成功返回true 失败返回false
+        bool flushBlock()
+        {
+            std::vector<MessageRef::ptr> flushed;
+            bool ret = _store->flushBlock(flushed);
+            if (ret == false)
+                error(logger, " %s :写出压缩块失败!", _qname.c_str());
+            if (_lazy == false)
+                return ret;
+            for (auto &ref : flushed)
+            {
+                if (ref->msg.get() == nullptr)
                     continue;
-                }
-                it->second->set_offset(msg->offset());
-                it->second->set_length(msg->length());
+                discharge(ref);
+                ref->msg.reset();
             }
-            // 更新有效消息数量 总持久化消息数量
-            _valid_count = _total_count = msgs.size();
+            return ret;
+        }
+        /// @brief 统计加入待推送列表的消息占用的内存
+        /// @note 扇出到多个队列的消息体只在第一个持有它的队列计入全局占用
+        void charge(const MessageRef::ptr &ref)
+        {
+            if (ref->msg.get() == nullptr)
+                return;
+            _bytes += ref->footprint();
+            size_t size = sizeof(MessageRef) + (ref->msg->pin() ? ref->msg->footprint() : 0);
+            if (_usage.get() != nullptr)
+                *_usage += size;
+        }
+        /// @brief 扣除离开待推送列表的消息占用的内存
+        /// @return 全局占用减少的字节数 消息体仍被其他队列持有时不计入
+        size_t discharge(const MessageRef::ptr &ref)
+        {
+            if (ref->msg.get() == nullptr)
+                return 0;
+            _bytes -= ref->footprint();
+            return release(ref);
+        }
+        /// @brief 从全局占用中扣除一条消息 不改变队列自己的统计
+        /// @return 全局占用减少的字节数
+        size_t release(const MessageRef::ptr &ref)
+        {
+            if (ref->msg.get() == nullptr)
+                return 0;
+            size_t size = sizeof(MessageRef) + (ref->msg->unpin() ? ref->msg->footprint() : 0);
+            if (_usage.get() != nullptr)
+                *_usage -= size;
+            return size;
         }
 
     private:
-        std::mutex _mutex;                                         ///< 互斥锁
+        std::mutex _head_mutex;                                    ///< 队头锁 保护出队列表和待确认窗口
+        std::mutex _mutex;                                         ///< 存储锁 保护存储引擎、序号和持久化消息映射表
+        std::mutex _tail_mutex;                                    ///< 队尾锁 保护入队列表
         std::string _qname;                                        ///< 队列名称
-        size_t _valid_count;                                       ///< 有效消息数量
-        size_t _total_count;                                       ///< 总消息数量
-        MessageMapper _mapper;                                     ///< 消息队列持久化管理类
-        std::list<MessagePtr> _msgs;                               ///< 待推送消息列表
-        std::unordered_map<std::string, MessagePtr> _durable_msgs; ///< 持久化消息映射表
-        std::unordered_map<std::string, MessagePtr> _waitack_msgs; ///< 待确认消息映射表
+        uint64_t _seq;                                             ///< 最近分配的消息序号
+        bool _changed;                                             ///< 上次写入检查点之后持久化消息是否有变化
+        bool _recovered;                                           ///< 历史消息是否已经恢复 恢复之前后台线程不能压缩
+        bool _lazy;                                                ///< 是否为惰性队列
+        std::atomic<size_t> _bytes;                                ///< 待推送消息占用的内存
+        std::shared_ptr<std::atomic<size_t>> _usage;               ///< 所有队列共用的内存占用计数
+        MessageStore::ptr _store;                                  ///< 存储引擎
+        PendingList _msgs;                                         ///< 出队列表 较早的待推送消息
+        PendingList _incoming;                                     ///< 入队列表 较新的待推送消息
+        std::unordered_map<uint64_t, MessageRef::ptr> _durable_msgs; ///< 持久化消息映射表 以消息序号为键
+        DeliveryWindow<MessageRef::ptr> _waitack_msgs;              ///< 待确认消息窗口 以投递标识为键
     };
 
     /// @brief 消息管理类
@@ -424,37 +2060,159 @@ namespace XuMQ
         using ptr = std::shared_ptr<MessageManager>; ///< 消息管理类指针
         /// @brief 构造函数
         /// @param basedir 基础目录
-        /// @param qname 消息队列名称
-        MessageManager(const std::string &basedir) : _basedir(basedir) {}
+        /// @param policy 默认持久化策略 可由队列参数覆盖
+        /// @param mode 存储方式 共享日志模式下在构造时扫描整个共享日志
+        MessageManager(const std::string &basedir, const DurabilityPolicy &policy = DurabilityPolicy(),
+                       StorageMode mode = StorageMode::PER_QUEUE)
+            : MessageManager(std::vector<std::string>{basedir}, policy, mode)
+        {
+        }
+        /// @brief 构造函数 消息数据分布在多个数据目录中
+        /// @param datadirs 数据目录列表 共享日志位于第一个目录下
+        /// @param policy 默认持久化策略 可由队列参数覆盖
+        /// @param mode 存储方式 共享日志模式下在构造时扫描整个共享日志
+        /// @param placement 新队列选择数据目录的方式
+        MessageManager(const std::vector<std::string> &datadirs, const DurabilityPolicy &policy = DurabilityPolicy(),
+                       StorageMode mode = StorageMode::PER_QUEUE, PlacementPolicy placement = PlacementPolicy::HASH)
+            : _datadirs(datadirs, placement), _policy(policy), _btree(std::make_shared<BTreeDatabase>(_datadirs.primary() + BTREE_FILE)),
+              _compact_rate(COMPACT_RATE_DEFAULT),
+              _usage(std::make_shared<std::atomic<size_t>>(0)), _watermark(0), _reclaim(false), _flusher_stop(false)
+        {
+            if (mode != StorageMode::SHARED_JOURNAL)
+                return;
+            _journal = std::make_shared<Journal>(_datadirs.primary() + JOURNAL_DIR, SEGMENT_MAX_SIZE, _policy.segmentOptions());
+            if (_journal->open() == false)
+            {
+                fatal(logger, "打开共享日志失败!");
+                abort();
+            }
+        }
+        /// @brief 析构函数 停止后台刷盘线程和压缩线程
+        ~MessageManager()
+        {
+            {
+                std::unique_lock<std::mutex> lock(_flusher_mutex);
+                _flusher_stop = true;
+            }
+            _flusher_cv.notify_all();
+            if (_flusher.joinable())
+                _flusher.join();
+            if (_compactor.joinable())
+                _compactor.join();
+            // 退出前为所有队列写入检查点 下次启动时无需扫描
+            for (auto &qmp : _queue_msgs.values())
+                qmp->checkpoint();
+        }
+        /// @brief 设置后台压缩的速率上限
+        /// @param rate 字节/秒 0表示不限速
+        void setCompactionRate(size_t rate)
+        {
+            _compact_rate = rate;
+        }
+        /// @brief 设置内存高水位 所有队列待推送消息的内存占用超过后换出消息
+        /// @param bytes 字节数 0表示不限制
+        void setMemoryWatermark(size_t bytes)
+        {
+            _watermark = bytes;
+        }
+        /// @brief 获取所有队列待推送消息占用的内存
+        /// @return 字节数
+        size_t memoryUsage()
+        {
+            return *_usage;
+        }
         /// @brief 初始化推送消息队列管理类
         /// @param qname 消息队列名称
-        void initQueueMessage(const std::string &qname)
+        /// @param qargs 队列声明参数 用于覆盖默认持久化策略
+        void initQueueMessage(const std::string &qname, const QueueArgs &qargs = QueueArgs())
         {
             QueueMessage::ptr qmp;
+            bool created = _queue_msgs.update(qname, [&](std::unordered_map<std::string, QueueMessage::ptr> &queue_msgs)
+                                              {
+                                                  if (queue_msgs.find(qname) != queue_msgs.end())
+                                                      return false;
+                                                  bool lazy = false;
+                                                  auto mode = qargs.find(ARG_QUEUE_MODE);
+                                                  if (mode != qargs.end() && mode->second == "lazy")
+                                                      lazy = true;
+                                                  else if (mode != qargs.end() && mode->second != "default")
+                                                      warn(logger, "未知的队列模式: %s", mode->second.c_str());
+                                                  qmp = std::make_shared<QueueMessage>(qname, createStore(qname, qargs), lazy, _usage);
+                                                  queue_msgs.insert(std::make_pair(qname, qmp));
+                                                  return true; });
+            if (created == false)
+                return;
             {
                 std::unique_lock<std::mutex> lock(_mutex);
-                auto it = _queue_msgs.find(qname);
-                if (it != _queue_msgs.end())
-                    return;
-                qmp = std::make_shared<QueueMessage>(_basedir, qname);
-                _queue_msgs.insert(std::make_pair(qname, qmp));
+                if (qmp->needFlusher() && _flusher.joinable() == false)
+                    _flusher = std::thread(&MessageManager::flusherEntry, this);
+                if (_compactor.joinable() == false)
+                    _compactor = std::thread(&MessageManager::compactorEntry, this);
             }
             qmp->recovery();
         }
+        /// @brief 并行恢复多个队列的历史消息 全部恢复完成后返回
+        /// @param queues 队列名称和声明参数
+        /// @param threads 恢复线程数 0表示使用CPU核心数
+        /// @note 共享日志中没有被这些队列领取的记录属于已删除的队列 恢复完成后丢弃
+        void recoverQueueMessages(const std::vector<std::pair<std::string, QueueArgs>> &queues, size_t threads = 0)
+        {
+            if (queues.empty())
+            {
+                if (_journal.get() != nullptr)
+                    _journal->discardPending();
+                return;
+            }
+            if (threads == 0)
+                threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+            threads = std::min(threads, queues.size());
+            info(logger, "开始恢复 %zu 个队列, 恢复线程数 %zu", queues.size(), threads);
+            auto start = std::chrono::steady_clock::now();
+            std::atomic<size_t> next(0), done(0);
+            auto worker = [&]()
+            {
+                size_t i;
+                while ((i = next++) < queues.size())
+                {
+                    auto begin = std::chrono::steady_clock::now();
+                    initQueueMessage(queues[i].first, queues[i].second);
+                    auto cost = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+                    info(logger, "队列 %s 恢复完成, %zu 条消息, 耗时 %lld ms (%zu/%zu)", queues[i].first.c_str(),
+                         durableCount(queues[i].first), (long long)cost.count(), ++done, queues.size());
+                }
+            };
+            std::vector<std::thread> workers;
+            for (size_t i = 0; i < threads; i++)
+                workers.emplace_back(worker);
+            for (auto &thread : workers)
+                thread.join();
+            if (_journal.get() != nullptr)
+                _journal->discardPending();
+            auto cost = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            info(logger, "%zu 个队列全部恢复完成, 耗时 %lld ms", queues.size(), (long long)cost.count());
+        }
         /// @brief 销毁推送消息队列管理类
         /// @param qname
         void destroyQueueMessage(const std::string &qname)
         {
-            QueueMessage::ptr qmp;
+            QueueMessage::ptr qmp = _queue_msgs.erase(qname);
+            if (qmp.get() == nullptr)
+                return;
+            qmp->clear();
+            _datadirs.release(qname);
+        }
+        /// @brief 清空指定队列中待推送的消息
+        /// @param qname 消息队列名称
+        /// @return 被丢弃的消息数量 队列不存在返回0
+        size_t purgeQueueMessage(const std::string &qname)
+        {
+            QueueMessage::ptr qmp = _queue_msgs.find(qname);
+            if (qmp.get() == nullptr)
             {
-                std::unique_lock<std::mutex> lock(_mutex);
-                auto it = _queue_msgs.find(qname);
-                if (it == _queue_msgs.end())
-                    return;
-                qmp = it->second;
-                _queue_msgs.erase(qname);
+                error(logger, "清空队列失败, 没有找到 %s 队列", qname.c_str());
+                return 0;
             }
-            qmp->clear();
+            return qmp->purge();
         }
         /// @brief 向指定队列插入新消息
         /// @param qname 消息队列名称
@@ -464,70 +2222,132 @@ namespace XuMQ
         /// @return 插入成功返回true 失败返回false
         bool insert(const std::string &qname, BasicProperties *bp, const std::string &body, bool mode)
         {
-            QueueMessage::ptr qmp;
+            return insert(std::vector<std::pair<std::string, bool>>{std::make_pair(qname, mode)}, bp, body);
+        }
+        /// @brief 向多个队列插入同一条消息 消息只构造一次 由所有队列共享
+        /// @param queues 消息队列名称和队列的持久化标志
+        /// @param bp 消息属性
+        /// @param body 消息主体
+        /// @return 全部插入成功返回true 否则返回false
+        /// @note 共享日志模式下所有持久化队列只写入一条记录 否则每个队列写入各自的记录 共享部分只序列化一次
+        bool insert(const std::vector<std::pair<std::string, bool>> &queues, BasicProperties *bp, const std::string &body)
+        {
+            // 构造共享的紧凑消息记录
+            MessagePtr msg = PackedMessage::create(bp != nullptr ? bp->id() : UUIDHelper::uuid(),
+                                                   bp != nullptr ? bp->delivery_mode() : DeliveryMode::DURABLE,
+                                                   bp != nullptr ? bp->routing_key() : "", body);
+            bool durable = msg->deliveryMode() == DeliveryMode::DURABLE;
+            std::vector<std::pair<QueueMessage::ptr, bool>> targets;
+            for (auto &queue : queues)
             {
-                std::unique_lock<std::mutex> lock(_mutex);
-                auto it = _queue_msgs.find(qname);
-                if (it == _queue_msgs.end())
+                QueueMessage::ptr qmp = _queue_msgs.find(queue.first);
+                if (qmp.get() == nullptr)
                 {
-                    error(logger, "插入消息失败, 没有找到 %s 队列", qname.c_str());
-                    return false;
+                    error(logger, "插入消息失败, 没有找到 %s 队列", queue.first.c_str());
+                    continue;
                 }
-                qmp = it->second;
+                targets.push_back(std::make_pair(qmp, durable && queue.second));
+            }
+            if (targets.empty())
+                return false;
+            std::string record;
+            std::vector<QueueMessage::ptr> shared;
+            for (auto &target : targets)
+            {
+                if (target.second && record.empty())
+                    record = msg->serialize();
+                if (target.second && target.first->journaled())
+                    shared.push_back(target.first);
             }
-            return qmp->insert(bp, body, mode);
+            bool ret = targets.size() == queues.size();
+            if (shared.empty() == false)
+                ret = QueueMessage::insert(shared, msg, record, *_journal) && ret;
+            for (auto &target : targets)
+            {
+                if (target.second && target.first->journaled())
+                    continue;
+                ret = target.first->insert(msg, target.second, record) && ret;
+            }
+            // 换出由后台线程完成 发布线程不等待磁盘写入
+            if (_watermark > 0 && *_usage > _watermark && _reclaim.exchange(true) == false)
+                _flusher_cv.notify_all();
+            return ret;
         }
         /// @brief 获取队头消息
         /// @param qname 消息队列名称
         /// @return 消息指针
         MessagePtr front(const std::string &qname)
         {
-            QueueMessage::ptr qmp;
+            uint64_t tag;
+            return front(qname, tag);
+        }
+        /// @brief 获取队头消息
+        /// @param qname 消息队列名称
+        /// @param tag 输出参数 投递标识 确认和退回消息时使用
+        /// @return 消息指针
+        MessagePtr front(const std::string &qname, uint64_t &tag)
+        {
+            QueueMessage::ptr qmp = _queue_msgs.find(qname);
+            if (qmp.get() == nullptr)
             {
-                std::unique_lock<std::mutex> lock(_mutex);
-                auto it = _queue_msgs.find(qname);
-                if (it == _queue_msgs.end())
-                {
-                    error(logger, "获取队头消息失败, 没有找到 %s 队列", qname.c_str());
-                    return MessagePtr();
-                }
-                qmp = it->second;
+                error(logger, "获取队头消息失败, 没有找到 %s 队列", qname.c_str());
+                return MessagePtr();
+            }
+            return qmp->front(tag);
+        }
+        /// @brief 批量获取队头消息
+        /// @param qname 消息队列名称
+        /// @param count 最多获取的条数
+        /// @param deliveries 输出参数 获取到的消息和投递标识追加在末尾
+        /// @return 实际获取的条数
+        size_t front(const std::string &qname, size_t count, std::vector<Delivery> &deliveries)
+        {
+            QueueMessage::ptr qmp = _queue_msgs.find(qname);
+            if (qmp.get() == nullptr)
+            {
+                error(logger, "获取队头消息失败, 没有找到 %s 队列", qname.c_str());
+                return 0;
+            }
+            return qmp->front(count, deliveries);
+        }
+        /// @brief 将已推送未确认的消息放回队头
+        /// @param qname 消息队列名称
+        /// @param tag 投递标识
+        /// @return 成功返回true 失败返回false
+        bool requeue(const std::string &qname, uint64_t tag)
+        {
+            QueueMessage::ptr qmp = _queue_msgs.find(qname);
+            if (qmp.get() == nullptr)
+            {
+                error(logger, "退回消息失败, 没有找到 %s 队列", qname.c_str());
+                return false;
             }
-            return qmp->front();
+            return qmp->requeue(tag);
         }
         /// @brief 应答消息
         /// @param qname 消息队列名称
-        /// @param msg_id 消息id
-        void ack(const std::string &qname, const std::string &msg_id)
+        /// @param tag 投递标识
+        /// @return 成功返回true 失败返回false
+        bool ack(const std::string &qname, uint64_t tag)
         {
-            QueueMessage::ptr qmp;
+            QueueMessage::ptr qmp = _queue_msgs.find(qname);
+            if (qmp.get() == nullptr)
             {
-                std::unique_lock<std::mutex> lock(_mutex);
-                auto it = _queue_msgs.find(qname);
-                if (it == _queue_msgs.end())
-                {
-                    error(logger, "确认消息失败, 没有找到 %s 队列", qname.c_str());
-                    return;
-                }
-                qmp = it->second;
+                error(logger, "确认消息失败, 没有找到 %s 队列", qname.c_str());
+                return false;
             }
-            qmp->remove(msg_id);
+            return qmp->remove(tag);
         }
 
         /// @brief 获取可获取消息数量
         /// @return 可获取消息数量
         size_t availableCount(const std::string &qname)
         {
-            QueueMessage::ptr qmp;
+            QueueMessage::ptr qmp = _queue_msgs.find(qname);
+            if (qmp.get() == nullptr)
             {
-                std::unique_lock<std::mutex> lock(_mutex);
-                auto it = _queue_msgs.find(qname);
-                if (it == _queue_msgs.end())
-                {
-                    error(logger, "获取可获取消息数量失败, 没有找到 %s 队列", qname.c_str());
-                    return 0;
-                }
-                qmp = it->second;
+                error(logger, "获取可获取消息数量失败, 没有找到 %s 队列", qname.c_str());
+                return 0;
             }
             return qmp->availableCount();
         }
@@ -535,16 +2355,11 @@ namespace XuMQ
         /// @return 总消息数量
         size_t totalCount(const std::string &qname)
         {
-            QueueMessage::ptr qmp;
+            QueueMessage::ptr qmp = _queue_msgs.find(qname);
+            if (qmp.get() == nullptr)
             {
-                std::unique_lock<std::mutex> lock(_mutex);
-                auto it = _queue_msgs.find(qname);
-                if (it == _queue_msgs.end())
-                {
-                    error(logger, "获取总消息数量失败, 没有找到 %s 队列", qname.c_str());
-                    return 0;
-                }
-                qmp = it->second;
+                error(logger, "获取总消息数量失败, 没有找到 %s 队列", qname.c_str());
+                return 0;
             }
             return qmp->totalCount();
         }
@@ -552,16 +2367,11 @@ namespace XuMQ
         /// @return 待确认消息数量
         size_t waitAckCount(const std::string &qname)
         {
-            QueueMessage::ptr qmp;
+            QueueMessage::ptr qmp = _queue_msgs.find(qname);
+            if (qmp.get() == nullptr)
             {
-                std::unique_lock<std::mutex> lock(_mutex);
-                auto it = _queue_msgs.find(qname);
-                if (it == _queue_msgs.end())
-                {
-                    error(logger, "获取待确认消息数量失败, 没有找到 %s 队列", qname.c_str());
-                    return 0;
-                }
-                qmp = it->second;
+                error(logger, "获取待确认消息数量失败, 没有找到 %s 队列", qname.c_str());
+                return 0;
             }
             return qmp->waitAckCount();
         }
@@ -569,32 +2379,153 @@ namespace XuMQ
         /// @return 持久化消息数量
         size_t durableCount(const std::string &qname)
         {
-            QueueMessage::ptr qmp;
+            QueueMessage::ptr qmp = _queue_msgs.find(qname);
+            if (qmp.get() == nullptr)
             {
-                std::unique_lock<std::mutex> lock(_mutex);
-                auto it = _queue_msgs.find(qname);
-                if (it == _queue_msgs.end())
-                {
-                    error(logger, "获取持久化消息数量失败, 没有找到 %s 队列", qname.c_str());
-                    return 0;
-                }
-                qmp = it->second;
+                error(logger, "获取持久化消息数量失败, 没有找到 %s 队列", qname.c_str());
+                return 0;
             }
             return qmp->durableCount();
         }
+        /// @brief 获取队列实际执行的刷盘次数 用于观察组提交的效果
+        /// @return 刷盘次数
+        size_t syncCount(const std::string &qname)
+        {
+            QueueMessage::ptr qmp = _queue_msgs.find(qname);
+            if (qmp.get() == nullptr)
+            {
+                error(logger, "获取刷盘次数失败, 没有找到 %s 队列", qname.c_str());
+                return 0;
+            }
+            return qmp->syncCount();
+        }
         /// @brief 清空
         void clear()
         {
-            QueueMessage::ptr qmp;
-            for (auto &qmsg : _queue_msgs)
+            for (auto &qmp : _queue_msgs.values())
+                qmp->clear();
+        }
+
+    private:
+        /// @brief 按队列参数创建存储引擎
+        /// @param qname 消息队列名称
+        /// @param qargs 队列声明参数 @see ARG_STORE ARG_RING_SIZE
+        /// @return 存储引擎 没有指定时使用虚拟机默认的引擎 参数不合法时使用文件存储
+        MessageStore::ptr createStore(const std::string &qname, const QueueArgs &qargs)
+        {
+            DurabilityPolicy policy = _policy.override(qargs);
+            if (policy.store == "memory")
+                return std::make_shared<MemoryStore>();
+            if (policy.store == "btree")
+                return std::make_shared<BTreeStore>(_btree, qname, policy);
+            std::string basedir = _datadirs.locate(qname);
+            if (policy.store == "ring")
+            {
+                size_t capacity = RING_SIZE_DEFAULT;
+                auto size = qargs.find(ARG_RING_SIZE);
+                if (size != qargs.end() && strtoull(size->second.c_str(), nullptr, 10) > 0)
+                    capacity = strtoull(size->second.c_str(), nullptr, 10);
+                return std::make_shared<RingStore>(basedir, qname, policy, capacity);
+            }
+            if (policy.store != "file")
+                warn(logger, "未知的存储引擎: %s", policy.store.c_str());
+            return std::make_shared<MessageMapper>(basedir, qname, policy, _journal);
+        }
+        /// @brief 内存占用超过高水位时 从占用最多的队列开始换出消息 直到低于低水位
+        /// @note 由后台压缩线程调用 发布时超过高水位只唤醒后台线程
+        void reclaim()
+        {
+            if (_reclaim.exchange(false) == false)
+                return;
+            size_t low = _watermark * MEMORY_LOW_WATERMARK;
+            size_t usage = *_usage;
+            if (usage <= low)
+                return;
+            std::vector<std::pair<size_t, QueueMessage::ptr>> qmps;
+            for (auto &qmp : _queue_msgs.values())
+                qmps.push_back(std::make_pair(qmp->memoryUsage(), qmp));
+            std::sort(qmps.begin(), qmps.end(), [](const std::pair<size_t, QueueMessage::ptr> &a, const std::pair<size_t, QueueMessage::ptr> &b)
+                      { return a.first > b.first; });
+            size_t freed = 0;
+            for (auto &qmp : qmps)
+            {
+                if (freed >= usage - low)
+                    break;
+                freed += qmp.second->pageOut(usage - low - freed);
+            }
+            info(logger, "内存占用 %zu 字节超过高水位 %zu 字节, 已换出 %zu 字节", usage, (size_t)_watermark, freed);
+        }
+        /// @brief 后台刷盘线程入口 周期性检查定时刷盘的队列
+        void flusherEntry()
+        {
+            std::unique_lock<std::mutex> lock(_flusher_mutex);
+            while (_flusher_stop == false)
+            {
+                _flusher_cv.wait_for(lock, std::chrono::milliseconds(FLUSHER_TICK_MS));
+                if (_flusher_stop)
+                    break;
+                std::vector<QueueMessage::ptr> qmps = _queue_msgs.values();
+                lock.unlock();
+                for (auto &qmp : qmps)
+                    qmp->flush();
+                lock.lock();
+            }
+        }
+        /// @brief 后台压缩线程入口 每个周期为每个队列压缩至多一个数据段 并定期写入检查点
+        /// @note 内存占用超过高水位时被提前唤醒 换出消息后等到周期结束再压缩
+        void compactorEntry()
+        {
+            auto last_checkpoint = std::chrono::steady_clock::now();
+            auto last_compact = last_checkpoint;
+            std::unique_lock<std::mutex> lock(_flusher_mutex);
+            while (_flusher_stop == false)
             {
-                qmsg.second->clear();
+                _flusher_cv.wait_for(lock, std::chrono::milliseconds(COMPACTOR_TICK_MS), [this]()
+                                     { return _flusher_stop || _reclaim; });
+                if (_flusher_stop)
+                    break;
+                std::vector<QueueMessage::ptr> qmps = _queue_msgs.values();
+                lock.unlock();
+                reclaim();
+                auto now = std::chrono::steady_clock::now();
+                if (now - last_compact < std::chrono::milliseconds(COMPACTOR_TICK_MS))
+                {
+                    lock.lock();
+                    continue;
+                }
+                last_compact = now;
+                bool due = now - last_checkpoint >= std::chrono::milliseconds(CHECKPOINT_INTERVAL_MS);
+                if (due)
+                    last_checkpoint = now;
+                for (auto &qmp : qmps)
+                {
+                    if (_flusher_stop)
+                        break;
+                    reclaim(); // 压缩耗时较长 每个队列之间检查一次高水位
+                    qmp->expireBlock();
+                    // 压缩改变了消息位置 立即写入检查点 避免重启时完整加载
+                    if (qmp->compact(_compact_rate) || due)
+                        qmp->checkpoint();
+                }
+                lock.lock();
             }
         }
 
     private:
-        std::mutex _mutex;                                              ///< 互斥锁
-        std::string _basedir;                                           ///< 基础目录
-        std::unordered_map<std::string, QueueMessage::ptr> _queue_msgs; ///< 消息队列
+        std::mutex _mutex;                                              ///< 保护后台线程的启动
+        DataDirectories _datadirs;                                      ///< 数据目录
+        DurabilityPolicy _policy;                                       ///< 默认持久化策略
+        Registry<std::string, QueueMessage::ptr> _queue_msgs;           ///< 消息队列 按队列名称分片加锁
+        BTreeDatabase::ptr _btree;                                      ///< 选择 btree 引擎的队列共用的数据库 首次使用时打开
+        Journal::ptr _journal;                                          ///< 共享日志 为空时每个队列使用独立的分段日志
+        std::atomic<size_t> _compact_rate;                              ///< 后台压缩的速率上限(字节/秒)
+        std::shared_ptr<std::atomic<size_t>> _usage;                    ///< 所有队列待推送消息占用的内存
+        std::atomic<size_t> _watermark;                                 ///< 内存高水位 0表示不限制
+        std::atomic<bool> _reclaim;                                     ///< 内存占用超过了高水位 等待后台线程换出
+        std::mutex _flusher_mutex;                                      ///< 后台线程状态锁
+        std::condition_variable _flusher_cv;                            ///< 唤醒后台线程的条件变量
+        std::atomic<bool> _flusher_stop;                                ///< 后台线程停止标志
+        std::thread _flusher;                                           ///< 后台刷盘线程
+        std::thread _compactor;                                         ///< 后台压缩线程
     };
 }
\ No newline at end of file
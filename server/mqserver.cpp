@@ -1,8 +1,45 @@
 #include "../server/broker.hpp"
 
-int main()
+/// 用法: mqserver [选项...] [数据目录...] 指定多个数据目录时队列按名称分布到各个目录
+/// 选项:
+///   --storage=queue|journal     持久化消息的存储方式 每个队列独立的分段日志(默认)或共享日志
+///   --placement=hash|least-used 新队列选择数据目录的方式 默认按名称哈希
+///   --recovery-threads=N        启动时恢复历史消息的线程数 默认使用CPU核心数
+///   --x-...=值                  虚拟机默认持久化策略 与队列声明参数同名 如 --x-durability=batch --x-fsync-batch=64
+int main(int argc, char *argv[])
 {
-    XuMQ::Server server(8888, "./data/");
+    std::vector<std::string> datadirs;
+    XuMQ::QueueArgs args;
+    XuMQ::PlacementPolicy placement = XuMQ::PlacementPolicy::HASH;
+    XuMQ::StorageMode storage = XuMQ::StorageMode::PER_QUEUE;
+    size_t recovery_threads = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg.compare(0, 2, "--") != 0)
+        {
+            datadirs.push_back(arg);
+            continue;
+        }
+        size_t pos = arg.find('=');
+        std::string key = arg.substr(2, pos == std::string::npos ? std::string::npos : pos - 2);
+        std::string value = pos == std::string::npos ? "" : arg.substr(pos + 1);
+        if (key == "storage" && (value == "queue" || value == "journal"))
+            storage = value == "journal" ? XuMQ::StorageMode::SHARED_JOURNAL : XuMQ::StorageMode::PER_QUEUE;
+        else if (key == "placement" && (value == "hash" || value == "least-used"))
+            placement = value == "least-used" ? XuMQ::PlacementPolicy::LEAST_USED : XuMQ::PlacementPolicy::HASH;
+        else if (key == "recovery-threads" && value.empty() == false && value.find_first_not_of("0123456789") == std::string::npos)
+            recovery_threads = std::stoul(value);
+        else if (key.compare(0, 2, "x-") == 0 && value.empty() == false)
+            args[key] = value;
+        else
+        {
+            error(XuMQ::logger, "无法识别的参数 %s", arg.c_str());
+            return 1;
+        }
+    }
+    XuMQ::Server server(8888, "./data/", datadirs, placement, XuMQ::DurabilityPolicy().override(args),
+                        recovery_threads, storage);
     server.start();
     return 0;
-}
\ No newline at end of file
+}
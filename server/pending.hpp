@@ -0,0 +1,300 @@
+/**
+ * @file pending.hpp
+ * @brief 待推送消息列表的定义
+ *
+ * 该文件定义了 XuMQ 命名空间中的 PendingList 类，用于保存队列中等待推送的消息。
+ *
+ * 列表由定长的块首尾相连组成，每块连续存放 PENDING_CHUNK_SLOTS 个消息引用(每个引用只有一个指针)，
+ * 入队和出队只在块内移动下标，块用完时才从内存池取下一块或归还当前块，
+ * 因此入队出队不再逐条分配释放内存，顺序扫描时访问的是连续的内存。
+ * 队头和队尾都可以在常数时间内插入，被退回的消息可以直接放回队头。
+ *
+ * 同时定义了 DeliveryWindow 类，按单调递增的投递标识保存已推送未确认的消息。
+ * 投递标识连续分配，窗口是以最早未确认的标识为起点的数组，确认时按下标直接定位，
+ * 起点处的消息确认后窗口向前滑动; 长时间不确认的消息会让窗口停留在原处，其后已确认的位置只占一个空槽。
+ * 窗口变长而其中大部分位置已确认时，队头零散的未确认条目被移入一张稀疏的有序表，数组从之后的位置重新开始，
+ * 因此一条始终不确认的消息不会让窗口随后续投递无限增长。
+ */
+
+#pragma once
+#include "body.hpp"
+#include <vector>
+#include <deque>
+#include <map>
+
+namespace XuMQ
+{
+    const size_t PENDING_CHUNK_SLOTS = 256;        ///< 待推送消息列表每块存放的消息个数
+    const size_t DELIVERY_WINDOW_SPARSE_MIN = 1024; ///< 待确认窗口超过该长度且占用不足一半时 队头零散的条目移入稀疏表
+
+    /// @class PendingList
+    /// @brief 分块的待推送消息列表 先进先出 支持放回队头和批量出队
+    /// @note 不是线程安全的 由队列锁保护
+    class PendingList
+    {
+    private:
+        /// @brief 存放消息引用的块
+        struct Chunk
+        {
+            Chunk *prev; ///< 前一块
+            Chunk *next; ///< 后一块
+            alignas(MessageRef::ptr) char slots[PENDING_CHUNK_SLOTS * sizeof(MessageRef::ptr)]; ///< 消息引用
+
+            MessageRef::ptr *at(size_t index) { return reinterpret_cast<MessageRef::ptr *>(slots) + index; }
+        };
+
+    public:
+        /// @class iterator
+        /// @brief 从队头到队尾的只读迭代器
+        class iterator
+        {
+        public:
+            iterator(Chunk *chunk, size_t index) : _chunk(chunk), _index(index) {}
+            const MessageRef::ptr &operator*() const { return *_chunk->at(_index); }
+            const MessageRef::ptr *operator->() const { return _chunk->at(_index); }
+            iterator &operator++()
+            {
+                if (++_index == PENDING_CHUNK_SLOTS && _chunk->next != nullptr)
+                {
+                    _chunk = _chunk->next;
+                    _index = 0;
+                }
+                return *this;
+            }
+            bool operator==(const iterator &other) const { return _chunk == other._chunk && _index == other._index; }
+            bool operator!=(const iterator &other) const { return !(*this == other); }
+
+        private:
+            Chunk *_chunk; ///< 所在的块
+            size_t _index; ///< 块内下标
+        };
+
+        PendingList() : _head(nullptr), _tail(nullptr), _begin(0), _end(0), _size(0) {}
+        PendingList(const PendingList &) = delete;
+        PendingList &operator=(const PendingList &) = delete;
+        ~PendingList() { clear(); }
+
+        /// @brief 在队尾追加消息
+        void push_back(const MessageRef::ptr &ref)
+        {
+            if (_tail == nullptr)
+            {
+                _head = _tail = allocate();
+                _begin = _end = 0;
+            }
+            else if (_end == PENDING_CHUNK_SLOTS)
+            {
+                Chunk *chunk = allocate();
+                chunk->prev = _tail;
+                _tail->next = chunk;
+                _tail = chunk;
+                _end = 0;
+            }
+            new (_tail->at(_end++)) MessageRef::ptr(ref);
+            _size++;
+        }
+        /// @brief 将消息放回队头
+        void push_front(const MessageRef::ptr &ref)
+        {
+            if (_head == nullptr)
+            {
+                _head = _tail = allocate();
+                _begin = _end = PENDING_CHUNK_SLOTS;
+            }
+            else if (_begin == 0)
+            {
+                Chunk *chunk = allocate();
+                chunk->next = _head;
+                _head->prev = chunk;
+                _head = chunk;
+                _begin = PENDING_CHUNK_SLOTS;
+            }
+            new (_head->at(--_begin)) MessageRef::ptr(ref);
+            _size++;
+        }
+        /// @brief 获取队头消息 列表不能为空
+        const MessageRef::ptr &front() const { return *_head->at(_begin); }
+        /// @brief 移除队头消息 列表不能为空
+        void pop_front()
+        {
+            _head->at(_begin++)->~IntrusivePtr();
+            if (--_size == 0)
+            {
+                release(_head);
+                _head = _tail = nullptr;
+                _begin = _end = 0;
+            }
+            else if (_begin == PENDING_CHUNK_SLOTS)
+            {
+                Chunk *chunk = _head;
+                _head = _head->next;
+                _head->prev = nullptr;
+                release(chunk);
+                _begin = 0;
+            }
+        }
+        /// @brief 从队头批量取出消息
+        /// @param count 最多取出的条数
+        /// @param result 输出参数 取出的消息追加在末尾
+        /// @return 实际取出的条数
+        size_t pop_front(size_t count, std::vector<MessageRef::ptr> &result)
+        {
+            size_t n = std::min(count, _size);
+            for (size_t i = 0; i < n; i++)
+            {
+                result.push_back(std::move(*_head->at(_begin)));
+                pop_front();
+            }
+            return n;
+        }
+        /// @brief 获取消息条数
+        size_t size() const { return _size; }
+        /// @brief 是否为空
+        bool empty() const { return _size == 0; }
+        /// @brief 清空列表 块归还内存池
+        void clear()
+        {
+            while (_size > 0)
+                pop_front();
+        }
+        /// @brief 与另一个列表交换内容 常数时间
+        void swap(PendingList &other)
+        {
+            std::swap(_head, other._head);
+            std::swap(_tail, other._tail);
+            std::swap(_begin, other._begin);
+            std::swap(_end, other._end);
+            std::swap(_size, other._size);
+        }
+        iterator begin() const { return iterator(_head, _begin); }
+        iterator end() const { return iterator(_tail, _end); }
+
+    private:
+        /// @brief 从内存池取一块
+        static Chunk *allocate()
+        {
+            Chunk *chunk = static_cast<Chunk *>(SlabPool<Chunk>::instance().allocate());
+            chunk->prev = chunk->next = nullptr;
+            return chunk;
+        }
+        /// @brief 将块归还内存池 块中的消息已经析构
+        static void release(Chunk *chunk)
+        {
+            SlabPool<Chunk>::instance().deallocate(chunk);
+        }
+
+    private:
+        Chunk *_head;  ///< 队头所在的块
+        Chunk *_tail;  ///< 队尾所在的块
+        size_t _begin; ///< 队头在首块中的下标
+        size_t _end;   ///< 队尾之后在末块中的下标
+        size_t _size;  ///< 消息条数
+    };
+
+    /// @class DeliveryWindow
+    /// @brief 按投递标识索引的待确认窗口
+    /// @tparam T 窗口中保存的条目 默认构造的条目表示空位 转换为bool判断是否有效
+    /// @note 不是线程安全的 由使用者加锁保护
+    template <typename T>
+    class DeliveryWindow
+    {
+    public:
+        /// @brief 构造函数
+        /// @param base 第一个投递标识 必须大于0
+        explicit DeliveryWindow(uint64_t base = 1) : _base(base), _next(base), _count(0) {}
+        /// @brief 分配新的投递标识并保存条目
+        /// @return 投递标识
+        uint64_t push(const T &entry)
+        {
+            _slots.push_back(entry);
+            _count++;
+            return _next++;
+        }
+        /// @brief 查找投递标识对应的条目
+        /// @return 条目指针 不在窗口中或已经移除时返回空指针
+        T *find(uint64_t tag)
+        {
+            if (tag < _base)
+            {
+                auto it = _sparse.find(tag);
+                return it == _sparse.end() ? nullptr : &it->second;
+            }
+            if (tag >= _next)
+                return nullptr;
+            T &entry = _slots[tag - _base];
+            return entry ? &entry : nullptr;
+        }
+        /// @brief 移除投递标识对应的条目
+        /// @param tag 投递标识
+        /// @param entry 输出参数 被移除的条目
+        /// @return 找到返回true 否则返回false
+        bool take(uint64_t tag, T &entry)
+        {
+            if (tag < _base)
+            {
+                auto it = _sparse.find(tag);
+                if (it == _sparse.end())
+                    return false;
+                entry = std::move(it->second);
+                _sparse.erase(it);
+                _count--;
+                return true;
+            }
+            T *slot = find(tag);
+            if (slot == nullptr)
+                return false;
+            entry = std::move(*slot);
+            *slot = T();
+            _count--;
+            while (_slots.empty() == false && !_slots.front())
+            {
+                _slots.pop_front();
+                _base++;
+            }
+            // 数组中大部分位置已确认 队头的条目移入稀疏表 每个位置只会被移出一次
+            if (_slots.size() >= DELIVERY_WINDOW_SPARSE_MIN && (_count - _sparse.size()) * 2 < _slots.size())
+            {
+                while (_slots.empty() == false && (_count - _sparse.size()) * 2 < _slots.size())
+                {
+                    if (_slots.front())
+                        _sparse.emplace_hint(_sparse.end(), _base, std::move(_slots.front()));
+                    _slots.pop_front();
+                    _base++;
+                }
+            }
+            return true;
+        }
+        /// @brief 遍历窗口中的有效条目 按投递标识从小到大
+        /// @param func 回调函数 参数为投递标识和条目
+        template <typename F>
+        void each(F func) const
+        {
+            for (auto &entry : _sparse)
+                func(entry.first, entry.second);
+            for (size_t i = 0; i < _slots.size(); i++)
+            {
+                if (_slots[i])
+                    func(_base + i, _slots[i]);
+            }
+        }
+        /// @brief 清空窗口 已分配的投递标识不会再次使用
+        void clear()
+        {
+            _slots.clear();
+            _sparse.clear();
+            _base = _next;
+            _count = 0;
+        }
+        /// @brief 有效条目个数
+        size_t size() const { return _count; }
+        /// @brief 窗口占用的槽位数 包括数组中的空位和稀疏表中的条目
+        size_t capacity() const { return _slots.size() + _sparse.size(); }
+
+    private:
+        std::deque<T> _slots;           ///< 从_base开始的条目
+        std::map<uint64_t, T> _sparse;  ///< 标识小于_base的零散条目
+        uint64_t _base;                 ///< 数组第一个槽位的投递标识
+        uint64_t _next;                 ///< 下一个分配的投递标识
+        size_t _count;                  ///< 有效条目个数
+    };
+}
@@ -13,6 +13,7 @@
 #include "../common/logger.hpp"
 #include "../common/helper.hpp"
 #include "../common/msg.pb.h"
+#include "../common/registry.hpp"
 #include <iostream>
 #include <unordered_map>
 #include <mutex>
@@ -199,7 +200,7 @@ namespace XuMQ
         MsgQueueManager(const std::string &dbfile)
             : _mapper(dbfile)
         {
-            _queues = _mapper.recovery();
+            _queues.assign(_mapper.recovery());
         }
         /// @brief 声明消息队列
         /// @param qname 消息队列名称
@@ -214,80 +215,65 @@ namespace XuMQ
                           bool qauto_delete,
                           const google::protobuf::Map<std::string, std::string> &qargs)
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            auto it = _queues.find(qname);
-            if (it != _queues.end())
-                return true;
-            auto mqp = std::make_shared<MsgQueue>(qname, qdurable, qexclusive, qauto_delete, qargs);
-            if (qdurable)
-            {
-                bool ret = _mapper.insert(mqp);
-                if (ret == false)
-                    return false;
-            }
-            _queues.insert(std::make_pair(qname, mqp));
-            return true;
+            return _queues.update(qname, [&](QueueMap &queues)
+                                  {
+                                      if (queues.find(qname) != queues.end())
+                                          return true;
+                                      auto mqp = std::make_shared<MsgQueue>(qname, qdurable, qexclusive, qauto_delete, qargs);
+                                      if (qdurable && _mapper.insert(mqp) == false)
+                                          return false;
+                                      queues.insert(std::make_pair(qname, mqp));
+                                      return true; });
         }
         /// @brief 删除消息队列
         /// @param name 消息队列名称
         void deleteQueue(const std::string &name)
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            auto it = _queues.find(name);
-            if (it == _queues.end())
-                return;
-            _queues.erase(name);
-            if (it->second->durable == true)
-                _mapper.remove(name);
+            _queues.update(name, [&](QueueMap &queues)
+                           {
+                               auto it = queues.find(name);
+                               if (it == queues.end())
+                                   return;
+                               if (it->second->durable == true)
+                                   _mapper.remove(name);
+                               queues.erase(it); });
         }
         /// @brief 获取指定消息队列
         /// @param name 消息队列名称
         /// @return 消息队列对象指针
         MsgQueue::ptr selectQueue(const std::string &name)
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            auto it = _queues.find(name);
-            if (it == _queues.end())
-                return MsgQueue::ptr();
-            return it->second;
+            return _queues.find(name);
         }
         /// @brief 获取所有队列
-        /// @return 消息队列映射表
+        /// @return 消息队列映射表的副本
         /// @see QueueMap
-        QueueMap &allQueue()
+        QueueMap allQueue()
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            return _queues;
+            return _queues.snapshot();
         }
         /// @brief 判断消息队列是否存在
         /// @param name 消息队列名称
         /// @return 存在则返回true 不存在返回false
         bool exists(const std::string &name)
         {
-            std::unique_lock<std::mutex> lock(_mutex);
-            auto it = _queues.find(name);
-            if (it == _queues.end())
-                return false;
-            return true;
+            return _queues.exists(name);
         }
         /// @brief 获取消息队列数量
         /// @return 消息队列数量
         size_t size()
         {
-            std::unique_lock<std::mutex> lock(_mutex);
             return _queues.size();
         }
         /// @brief 清除消息队列
         void clear()
         {
-            std::unique_lock<std::mutex> lock(_mutex);
             _mapper.removeTable();
             _queues.clear();
         }
 
     private:
-        std::mutex _mutex;      ///< 互斥锁
-        MsgQueueMapper _mapper; ///< 持久化消息队列管理类
-        QueueMap _queues;       ///< 全部消息队列信息
+        MsgQueueMapper _mapper;                       ///< 持久化消息队列管理类
+        Registry<std::string, MsgQueue::ptr> _queues; ///< 全部消息队列信息 按名称分片加锁
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,471 @@
+/**
+ * @file ring.hpp
+ * @brief 环形文件存储引擎的实现
+ *
+ * 该文件定义了 XuMQ 命名空间中的 RingStore 类。
+ *
+ * 每个队列的数据存放在 "基础目录/队列名称/ring.mqr" 中，文件大小在创建时固定:
+ * 一页文件头之后是 x-ring-size 字节的环形数据区，整个文件映射到内存中原地读写。
+ * 消息按入队顺序追加在环的头部，记录格式与分段日志相同 @see RecordHeader
+ * 确认只在记录头的保留字段中打上标记，尾部连续的已确认记录随即回收，不需要确认日志，也不需要压缩。
+ * 环中剩余空间放不下新的记录时发布失败。
+ *
+ * 位置用单调递增的逻辑偏移表示，对容量取模得到在数据区中的位置。记录按8字节对齐，
+ * 数据区末尾放不下一条记录时写入序号为0的填充记录，连记录头也放不下时直接从数据区开头继续。
+ * 文件头只保存尾部位置，重启时从尾部开始扫描，校验和有效且序号递增的记录构成环的内容。
+ */
+
+#pragma once
+#include "../common/logger.hpp"
+#include "../common/helper.hpp"
+#include "../common/msg.pb.h"
+#include "segment.hpp"
+#include "store.hpp"
+#include "body.hpp"
+#include <string>
+#include <vector>
+#include <list>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <sys/mman.h>
+
+namespace XuMQ
+{
+    const char *RING_FILE = "ring.mqr";                ///< 环形文件名 位于队列目录下
+    const char *ARG_RING_SIZE = "x-ring-size";          ///< 队列参数: 环形数据区的字节数 只在创建时生效
+    const size_t RING_SIZE_DEFAULT = 64 * 1024 * 1024; ///< 默认环形数据区的字节数
+    const uint32_t RING_MAGIC = 0x474e5251;             ///< 环形文件头魔数 "QRNG"
+    const size_t RING_HEADER_SIZE = 4096;               ///< 文件头占用的字节数 数据区从这里开始
+    const size_t RING_ALIGN = 8;                        ///< 记录的对齐字节数
+    const uint16_t RING_ACKED = 1;                      ///< 记录头保留字段中的已确认标记 不参与校验
+
+    /// @struct RingHeader
+    /// @brief 环形文件头
+    struct RingHeader
+    {
+        uint32_t magic;    ///< 魔数 @see RING_MAGIC
+        uint32_t version;  ///< 格式版本
+        uint64_t capacity; ///< 数据区的字节数
+        uint64_t tail;     ///< 最早一条未回收记录的逻辑偏移
+    };
+
+    /// @class RingStore
+    /// @brief 固定大小的内存映射环形文件存储引擎
+    class RingStore : public MessageStore
+    {
+    public:
+        using ptr = std::shared_ptr<RingStore>;
+        /// @brief 构造函数 打开或创建环形文件
+        /// @param basedir 基础目录 末尾没有分隔符时会补上'/'
+        /// @param qname 队列名称
+        /// @param policy 持久化策略 不使用其中的压缩方式
+        /// @param capacity 新建时数据区的字节数 已存在的文件沿用原大小
+        RingStore(std::string &basedir, const std::string &qname, const DurabilityPolicy &policy = DurabilityPolicy(),
+                  size_t capacity = RING_SIZE_DEFAULT)
+            : _policy(policy), _fd(-1), _map(nullptr), _header(nullptr), _size(0), _capacity(0), _head(0), _count(0),
+              _written(0), _synced(0), _sync_count(0), _last_sync(std::chrono::steady_clock::now())
+        {
+            if (basedir.back() != '/' && basedir.back() != '\\')
+                basedir.push_back('/');
+            _dirname = basedir + qname + "/";
+            _filename = _dirname + RING_FILE;
+            if (open(capacity) == false)
+                close();
+        }
+        /// @brief 析构函数 解除映射并关闭文件
+        ~RingStore()
+        {
+            close();
+        }
+        /// @brief 在环的头部追加一条记录
+        /// @param ref 队列中的消息 写入后更新其存储位置
+        /// @param record 序列化后的共享消息
+        /// @return 成功返回true 环已满或文件没有打开返回false
+        bool insert(const MessageRef::ptr &ref, const std::string &record) override
+        {
+            if (_map == nullptr)
+            {
+                error(logger, "%s:环形文件没有打开!", _filename.c_str());
+                return false;
+            }
+            std::string body = record + MessageRef::reference(ref->seq);
+            size_t need = align(RECORD_HEADER_SIZE + body.size());
+            size_t room = _capacity - _head % _capacity;
+            size_t skip = room < need ? room : 0;
+            if (_head + skip + need - _header->tail > _capacity)
+            {
+                error(logger, "%s:环形文件已满!", _filename.c_str());
+                return false;
+            }
+            if (skip >= RECORD_HEADER_SIZE)
+            {
+                RecordHeader pad(0, 0);
+                pad.crc = pad.checksum(nullptr);
+                pad.reserved = RING_ACKED;
+                memcpy(at(_head), &pad, RECORD_HEADER_SIZE);
+            }
+            uint64_t pos = _head + skip;
+            RecordHeader header(ref->seq, body.size(), RecordHeader::now());
+            header.crc = header.checksum(body.data());
+            memcpy(at(pos) + RECORD_HEADER_SIZE, body.data(), body.size());
+            memcpy(at(pos), &header, RECORD_HEADER_SIZE);
+            _head = pos + need;
+            erase();
+            ref->segment = 0;
+            ref->offset = pos + RECORD_HEADER_SIZE;
+            ref->length = body.size();
+            ref->inner = 0;
+            _count++;
+            _written++;
+            return true;
+        }
+        /// @brief 在记录头中打上已确认标记 回收尾部连续的已确认记录
+        /// @param ref 队列中的消息
+        /// @return 成功返回true 失败返回false
+        bool remove(const MessageRef::ptr &ref) override
+        {
+            if (_map == nullptr || ref->length == 0)
+                return false;
+            RecordHeader *header = (RecordHeader *)at(ref->offset - RECORD_HEADER_SIZE);
+            header->reserved = RING_ACKED;
+            advance();
+            return true;
+        }
+        /// @brief 从尾部开始扫描环形文件 恢复存活的消息
+        /// @param seq 输出参数 已分配过的最大消息序号
+        /// @return 按序号排列的存活消息
+        /// @note 遇到校验失败、越界或序号没有递增的记录时停止 它们是写入中途崩溃的残留或上一圈的旧数据
+        std::list<MessageRef::ptr> recovery(uint64_t &seq) override
+        {
+            std::list<MessageRef::ptr> result;
+            seq = 0;
+            if (_map == nullptr)
+                return result;
+            uint64_t tail = _header->tail, pos = tail;
+            _count = 0;
+            while (pos - tail < _capacity)
+            {
+                size_t room = _capacity - pos % _capacity;
+                if (room < RECORD_HEADER_SIZE)
+                {
+                    pos += room;
+                    continue;
+                }
+                RecordHeader header;
+                memcpy(&header, at(pos), RECORD_HEADER_SIZE);
+                if (header.seq == 0) // 填充记录
+                {
+                    if (header.length != 0 || valid(header, nullptr) == false)
+                        break;
+                    pos += room;
+                    continue;
+                }
+                size_t need = align(RECORD_HEADER_SIZE + header.length);
+                if (need > room || pos + need - tail > _capacity || header.seq <= seq)
+                    break;
+                const char *body = at(pos) + RECORD_HEADER_SIZE;
+                if (valid(header, body) == false)
+                    break;
+                seq = header.seq;
+                _count++;
+                if (header.reserved != RING_ACKED)
+                {
+                    Message::Payload refs;
+                    auto ref = MessageRef::create(MessageRef::parse(body, header.length, refs), header.seq, true);
+                    if (ref->msg.get() != nullptr)
+                    {
+                        ref->offset = pos + RECORD_HEADER_SIZE;
+                        ref->length = header.length;
+                        result.push_back(ref);
+                    }
+                }
+                pos += need;
+            }
+            _head = pos;
+            erase();
+            advance();
+            info(logger, "%s:从环形文件恢复 %zu 条消息", _filename.c_str(), result.size());
+            return result;
+        }
+        /// @brief 从映射区域读回消息
+        /// @param refs 需要读回的消息 读取后设置其中共享的消息
+        /// @return 全部读取成功返回true 失败返回false
+        bool read(const std::vector<MessageRef::ptr> &refs) override
+        {
+            for (auto &ref : refs)
+            {
+                if (_map == nullptr || ref->length == 0)
+                {
+                    error(logger, "%s:读取消息失败!", _filename.c_str());
+                    return false;
+                }
+                Message::Payload parsed;
+                ref->msg = MessageRef::parse(at(ref->offset), ref->length, parsed);
+                if (ref->msg.get() == nullptr)
+                {
+                    error(logger, "%s:解析消息失败!", _filename.c_str());
+                    return false;
+                }
+            }
+            return true;
+        }
+        /// @brief 按持久化策略提交已写入的消息
+        /// @return 成功返回true 刷盘失败返回false
+        bool commit() override
+        {
+            std::unique_lock<std::mutex> lock(_sync_mutex);
+            uint64_t target = _written;
+            switch (_policy.mode)
+            {
+            case SyncMode::NONE:
+            case SyncMode::INTERVAL:
+                return true;
+            case SyncMode::BATCH:
+                if (target - _synced < _policy.batch)
+                    return true;
+                break;
+            case SyncMode::CONFIRM:
+                break;
+            }
+            return syncTo(target);
+        }
+        /// @brief 定时刷盘 由后台线程周期性调用
+        /// @return 成功返回true 刷盘失败返回false
+        bool flush() override
+        {
+            std::unique_lock<std::mutex> lock(_sync_mutex);
+            if (_policy.mode == SyncMode::NONE || _policy.interval_ms == 0 || _written == _synced)
+                return true;
+            if (_policy.mode != SyncMode::INTERVAL && _policy.mode != SyncMode::BATCH)
+                return true;
+            if (std::chrono::steady_clock::now() - _last_sync < std::chrono::milliseconds(_policy.interval_ms))
+                return true;
+            return syncTo(_written);
+        }
+        /// @brief 立即将映射区域刷盘 包括已确认标记和尾部位置
+        /// @return 成功返回true 失败返回false
+        bool sync() override
+        {
+            std::unique_lock<std::mutex> lock(_sync_mutex);
+            return msync();
+        }
+        /// @brief 是否需要后台线程定时刷盘
+        bool needFlusher() const override
+        {
+            return _policy.interval_ms > 0 &&
+                   (_policy.mode == SyncMode::INTERVAL || _policy.mode == SyncMode::BATCH);
+        }
+        /// @brief 删除环形文件和队列目录
+        void clear() override
+        {
+            std::unique_lock<std::mutex> lock(_sync_mutex);
+            close();
+            FileHelper::removeFile(_filename);
+            ::rmdir(_dirname.c_str());
+            _head = 0;
+            _count = 0;
+        }
+        /// @brief 将尾部移到头部 一次回收环中的所有记录
+        /// @return 成功返回true 失败返回false
+        bool purge() override
+        {
+            if (_map == nullptr)
+                return false;
+            _header->tail = _head;
+            _count = 0;
+            return sync();
+        }
+        /// @brief 获取环中的记录数 包括已确认但尚未回收的记录
+        size_t totalCount() override { return _count; }
+        /// @brief 获取数据区的字节数
+        size_t capacity() const { return _capacity; }
+        /// @brief 获取实际执行的刷盘次数
+        size_t syncCount() override
+        {
+            std::unique_lock<std::mutex> lock(_sync_mutex);
+            return _sync_count;
+        }
+
+    private:
+        /// @brief 打开环形文件 不存在则按指定容量创建
+        /// @param capacity 数据区的字节数
+        /// @return 成功返回true 失败返回false
+        bool open(size_t capacity)
+        {
+            if (FileHelper(_dirname).exists() == false && FileHelper::createDirectory(_dirname) == false)
+            {
+                error(logger, "%s:创建队列目录失败!", _dirname.c_str());
+                return false;
+            }
+            _fd = ::open(_filename.c_str(), O_RDWR | O_CREAT, 0644);
+            if (_fd < 0)
+            {
+                error(logger, "%s:环形文件打开失败! %s", _filename.c_str(), strerror(errno));
+                return false;
+            }
+            struct stat st;
+            if (fstat(_fd, &st) < 0)
+            {
+                error(logger, "%s:获取环形文件大小失败! %s", _filename.c_str(), strerror(errno));
+                return false;
+            }
+            bool created = st.st_size == 0;
+            if (created)
+            {
+                capacity = std::max(capacity / RING_ALIGN * RING_ALIGN, RING_HEADER_SIZE);
+                if (::ftruncate(_fd, RING_HEADER_SIZE + capacity) < 0)
+                {
+                    error(logger, "%s:分配环形文件失败! %s", _filename.c_str(), strerror(errno));
+                    return false;
+                }
+                // 预分配磁盘块 避免写入映射时才分配空间
+                if (_policy.preallocate && ::fallocate(_fd, 0, 0, RING_HEADER_SIZE + capacity) < 0)
+                    warn(logger, "%s:环形文件预分配失败! %s", _filename.c_str(), strerror(errno));
+                _size = RING_HEADER_SIZE + capacity;
+            }
+            else if ((size_t)st.st_size <= RING_HEADER_SIZE)
+            {
+                error(logger, "%s:环形文件损坏!", _filename.c_str());
+                return false;
+            }
+            else
+                _size = st.st_size;
+            void *map = ::mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+            if (map == MAP_FAILED)
+            {
+                error(logger, "%s:映射环形文件失败! %s", _filename.c_str(), strerror(errno));
+                return false;
+            }
+            _map = (char *)map;
+            _header = (RingHeader *)_map;
+            if (created)
+            {
+                _header->magic = RING_MAGIC;
+                _header->version = FORMAT_V2;
+                _header->capacity = capacity;
+                _header->tail = 0;
+                if (::msync(_map, RING_HEADER_SIZE, MS_SYNC) < 0)
+                {
+                    error(logger, "%s:写入环形文件头失败! %s", _filename.c_str(), strerror(errno));
+                    return false;
+                }
+            }
+            else if (_header->magic != RING_MAGIC || _header->capacity + RING_HEADER_SIZE != _size ||
+                     _header->capacity % RING_ALIGN != 0)
+            {
+                error(logger, "%s:环形文件头损坏!", _filename.c_str());
+                return false;
+            }
+            else if (_header->capacity != capacity)
+                info(logger, "%s:环形文件已存在, 沿用原来的大小 %zu 字节", _filename.c_str(), (size_t)_header->capacity);
+            _capacity = _header->capacity;
+            _head = _header->tail;
+            return true;
+        }
+        /// @brief 解除映射并关闭文件
+        void close()
+        {
+            if (_map != nullptr)
+                ::munmap(_map, _size);
+            if (_fd >= 0)
+                ::close(_fd);
+            _map = nullptr;
+            _header = nullptr;
+            _fd = -1;
+        }
+        /// @brief 回收尾部连续的已确认记录和填充记录
+        void advance()
+        {
+            uint64_t tail = _header->tail;
+            while (tail < _head)
+            {
+                size_t room = _capacity - tail % _capacity;
+                if (room < RECORD_HEADER_SIZE)
+                {
+                    tail += room;
+                    continue;
+                }
+                const RecordHeader *header = (const RecordHeader *)at(tail);
+                if (header->reserved != RING_ACKED)
+                    break;
+                if (header->seq == 0)
+                {
+                    tail += room;
+                    continue;
+                }
+                tail += align(RECORD_HEADER_SIZE + header->length);
+                _count--;
+            }
+            _header->tail = tail;
+        }
+        /// @brief 抹掉头部位置上一圈残留的记录头 重启扫描时在这里停止
+        void erase()
+        {
+            size_t room = _capacity - _head % _capacity;
+            uint64_t next = room < RECORD_HEADER_SIZE ? _head + room : _head;
+            if (next + RECORD_HEADER_SIZE - _header->tail <= _capacity)
+                memset(at(next), 0, RECORD_HEADER_SIZE);
+        }
+        /// @brief 刷盘到指定的写入序号 需持有刷盘状态锁
+        /// @param target 目标写入序号
+        /// @return 成功返回true 失败返回false
+        /// @note 持锁刷盘 等待锁的线程拿到锁时往往已经被上一次刷盘覆盖
+        bool syncTo(uint64_t target)
+        {
+            if (_synced >= target)
+                return true;
+            uint64_t goal = _written;
+            if (msync() == false)
+                return false;
+            _synced = std::max(_synced, goal);
+            return true;
+        }
+        /// @brief 将整个映射区域刷盘 需持有刷盘状态锁
+        /// @return 成功返回true 失败返回false
+        bool msync()
+        {
+            if (_map == nullptr)
+                return false;
+            bool ret = ::msync(_map, _size, MS_SYNC) == 0;
+            _last_sync = std::chrono::steady_clock::now();
+            _sync_count++;
+            if (ret == false)
+                error(logger, "%s:环形文件刷盘失败! %s", _filename.c_str(), strerror(errno));
+            return ret;
+        }
+        /// @brief 获取逻辑偏移在映射区域中的地址
+        /// @param pos 逻辑偏移
+        char *at(uint64_t pos) const { return _map + RING_HEADER_SIZE + pos % _capacity; }
+        /// @brief 校验记录 已确认标记不参与校验
+        /// @param header 记录头
+        /// @param body 记录数据
+        static bool valid(const RecordHeader &header, const char *body)
+        {
+            if (header.magic != RECORD_MAGIC || header.version != FORMAT_V2)
+                return false;
+            RecordHeader copy = header;
+            copy.reserved = 0;
+            return copy.checksum(body) == header.crc;
+        }
+        /// @brief 按记录的对齐字节数向上取整
+        static size_t align(size_t len) { return (len + RING_ALIGN - 1) / RING_ALIGN * RING_ALIGN; }
+
+    private:
+        std::string _dirname;                             ///< 队列目录
+        std::string _filename;                            ///< 环形文件名
+        DurabilityPolicy _policy;                         ///< 持久化策略
+        int _fd;                                          ///< 文件描述符
+        char *_map;                                       ///< 整个文件的映射区域
+        RingHeader *_header;                              ///< 文件头 位于映射区域开头
+        size_t _size;                                     ///< 文件大小
+        size_t _capacity;                                 ///< 数据区的字节数
+        uint64_t _head;                                   ///< 下一条记录的逻辑偏移
+        size_t _count;                                    ///< 尾部和头部之间的记录数
+        std::mutex _sync_mutex;                           ///< 刷盘状态锁
+        std::atomic<uint64_t> _written;                   ///< 已写入的记录序号
+        uint64_t _synced;                                 ///< 已刷盘的记录序号
+        size_t _sync_count;                               ///< 实际执行的刷盘次数
+        std::chrono::steady_clock::time_point _last_sync; ///< 上一次刷盘的时间
+    };
+}
@@ -0,0 +1,1099 @@
+/**
+ * @file segment.hpp
+ * @brief 分段追加日志的实现
+ *
+ * 该文件定义了 XuMQ 命名空间中的 Segment 类、SegmentReader 类和 SegmentLog 类，
+ * 作为消息队列持久化的底层存储引擎。
+ *
+ * 每个队列的数据存放在独立的目录中，由若干个段文件组成：
+ * - 段文件名为10位十进制的段号加 ".mqd" 后缀，段号单调递增
+ * - 只有最新的段(活跃段)接收追加写入，写满后滚动到新的段
+ * - 所有段的文件描述符常驻打开，尾部偏移在内存中维护，追加时一次 pwritev 完成
+ *
+ * 段文件格式(v2): 段头(魔数, 格式版本, 创建时间) 之后是若干条记录，
+ * 每条记录为 记录头(魔数, 格式版本, 标志, CRC32C, 32位长度, 入队时间, 64位序号)|数据，
+ * 校验和覆盖记录头(校验和字段置0)和数据，恢复时遇到校验失败的记录视为写入中途崩溃的残留。
+ *
+ * 旧版本(v1)的段没有段头，记录格式为 sizeof(size_t)字节长度|数据。v1 的段只读:
+ * 打开时活跃段若为 v1 则滚动到新的 v2 段，已封存的 v1 段由压缩重写为 v2。
+ *
+ * 已封存的段可以被压缩: 存活记录先写入 "段文件名.tmp"，完成后原子地重命名覆盖原段，段号不变。
+ * 段文件被删除或覆盖后，文件描述符在最后一个引用释放时才关闭，正在进行的读取和刷盘不受影响。
+ *
+ * 恢复和压缩通过 SegmentReader 顺序读取: 段文件被映射到内存中，记录在映射区域中原地遍历和解析。
+ *
+ * 开启压缩时，连续的多条记录打包为一个压缩块写成一条记录，记录头的标志位低4位为压缩方式 @see RecordBlock
+ *
+ * 段文件可以在创建时用 fallocate 预分配到滚动大小，追加写入不再改变文件大小; 滚动时释放封存段未用的空间。
+ * 也可以绕过页缓存(O_DIRECT)追加: 记录紧密地暂存在对齐的缓冲区中，刷盘、封存或暂存过多时按整块写出，
+ * 未写满的最后一块保留在缓冲区中，下次写出时连同新的记录一起覆盖写入; 暂存的数据直接从缓冲区读取。 @see SegmentOptions
+ * 预分配和对齐都会在段尾留下全零的数据，读取时全零的记录头视为数据的结尾，打开段时据此找回真正的尾部偏移。
+ */
+
+#pragma once
+#include "../common/logger.hpp"
+#include "../common/helper.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+
+namespace XuMQ
+{
+    const char *SEGMENT_SUBFIX = ".mqd";                 ///< 段文件后缀名
+    const char *SEGMENT_TMP_SUBFIX = ".tmp";             ///< 压缩中的段文件追加的后缀名
+    const size_t SEGMENT_MAX_SIZE = 64 * 1024 * 1024;    ///< 段文件默认滚动大小
+    const uint32_t SEGMENT_MAGIC = 0x5347514d;           ///< 段头魔数 "MQGS"
+    const uint32_t RECORD_MAGIC = 0x4443514d;            ///< 记录头魔数 "MQCD"
+    const uint32_t FORMAT_V1 = 1;                        ///< 旧版本格式 无段头 记录只有长度前缀
+    const uint32_t FORMAT_V2 = 2;                        ///< 当前格式 带段头和校验和
+    const size_t RECORD_HEADER_V1_SIZE = sizeof(size_t); ///< v1 记录长度前缀的字节数
+    const uint8_t RECORD_CODEC_MASK = 0x0f;              ///< 记录头标志位中表示压缩方式的位
+    const uint8_t RECORD_FLAG_PADDING = 0x10;            ///< 记录头标志位: 填充记录 读取时跳过 只出现在旧的 O_DIRECT 写入的段中
+    const size_t DIRECT_IO_ALIGN = 4096;                 ///< O_DIRECT 写入的偏移、长度和缓冲区按该字节数对齐
+    const size_t DIRECT_IO_STAGE_SIZE = 1024 * 1024;     ///< O_DIRECT 暂存的数据超过该字节数时先整块写出
+
+    /// @brief 压缩块的压缩方式 保存在记录头标志位的低4位
+    enum class Codec : uint8_t
+    {
+        NONE = 0, ///< 不压缩 每条消息一条记录
+        ZLIB = 1  ///< zlib
+    };
+
+    /// @struct SegmentHeader
+    /// @brief v2 段文件头
+    struct SegmentHeader
+    {
+        uint32_t magic;   ///< 魔数 @see SEGMENT_MAGIC
+        uint32_t version; ///< 格式版本
+        uint64_t created; ///< 创建时间(毫秒)
+    };
+
+    /// @struct RecordHeader
+    /// @brief v2 记录头 字段按自然对齐排列 共32字节
+    struct RecordHeader
+    {
+        uint32_t magic;     ///< 魔数 @see RECORD_MAGIC
+        uint8_t version;    ///< 格式版本
+        uint8_t flags;      ///< 标志位 低4位为压缩方式 @see Codec
+        uint16_t reserved;  ///< 保留
+        uint32_t crc;       ///< CRC32C 覆盖记录头(本字段置0)和数据
+        uint32_t length;    ///< 数据长度
+        uint64_t timestamp; ///< 入队时间(毫秒)
+        uint64_t seq;       ///< 消息序号
+        /// @brief 构造函数
+        /// @param seq_ 消息序号
+        /// @param length_ 数据长度
+        /// @param timestamp_ 入队时间(毫秒)
+        /// @param flags_ 标志位
+        RecordHeader(uint64_t seq_ = 0, uint32_t length_ = 0, uint64_t timestamp_ = 0, uint8_t flags_ = 0)
+            : magic(RECORD_MAGIC), version(FORMAT_V2), flags(flags_), reserved(0), crc(0),
+              length(length_), timestamp(timestamp_), seq(seq_)
+        {
+        }
+        /// @brief 计算记录的校验和
+        /// @param body 记录数据 长度为length
+        /// @return 校验和
+        uint32_t checksum(const char *body) const
+        {
+            RecordHeader header = *this;
+            header.crc = 0;
+            uint32_t crc = CRCHelper::crc32c(&header, sizeof(header));
+            return CRCHelper::crc32c(body, length, crc);
+        }
+        /// @brief 获取记录的压缩方式 不为NONE时记录是一个压缩块
+        Codec codec() const { return (Codec)(flags & RECORD_CODEC_MASK); }
+        /// @brief 获取当前时间(毫秒)
+        static uint64_t now()
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        }
+    };
+    static_assert(sizeof(SegmentHeader) == 16, "段头必须为16字节");
+    static_assert(sizeof(RecordHeader) == 32, "记录头必须为32字节");
+    const size_t SEGMENT_HEADER_SIZE = sizeof(SegmentHeader); ///< 段头的字节数
+    const size_t RECORD_HEADER_SIZE = sizeof(RecordHeader);   ///< 记录头的字节数
+
+    /// @struct SegmentOptions
+    /// @brief 段文件的写入方式
+    struct SegmentOptions
+    {
+        size_t preallocate; ///< 新建段文件时预分配的字节数 0表示不预分配
+        bool direct;        ///< 是否绕过页缓存(O_DIRECT)追加写入
+
+        /// @brief 构造函数 默认不预分配 写入经过页缓存
+        SegmentOptions(size_t spreallocate = 0, bool sdirect = false)
+            : preallocate(spreallocate), direct(sdirect)
+        {
+        }
+    };
+
+    /// @class RecordBlock
+    /// @brief 压缩块 将连续的多条记录打包后整体压缩 写成一条记录
+    /// @note
+    /// 解压后的格式为 条目数(4字节)|长度(4字节)|记录|长度|记录...
+    /// 块内的记录以长度前缀在解压数据中的偏移标识 该偏移不会为0
+    /// 写入段中的数据为 解压后长度(4字节)|压缩方式(1字节)|压缩数据
+    class RecordBlock
+    {
+    public:
+        /// @brief 构造函数
+        RecordBlock() : _raw(sizeof(uint32_t), '\0'), _count(0) {}
+        /// @brief 加入一条记录
+        /// @param record 记录数据
+        /// @return 记录在块内的偏移
+        uint32_t add(const std::string &record)
+        {
+            uint32_t inner = _raw.size();
+            uint32_t len = record.size();
+            _raw.append((const char *)&len, sizeof(len));
+            _raw.append(record);
+            _count++;
+            return inner;
+        }
+        /// @brief 压缩块中的所有记录
+        /// @param codec 压缩方式
+        /// @param level 压缩级别
+        /// @param body 输出参数 写入段中的数据
+        /// @return 成功返回true 失败返回false
+        bool encode(Codec codec, int level, std::string &body)
+        {
+            if (codec != Codec::ZLIB)
+                return false;
+            memcpy(&_raw[0], &_count, sizeof(_count));
+            uint32_t raw = _raw.size();
+            body.assign((const char *)&raw, sizeof(raw));
+            body.push_back((char)codec);
+            return CompressHelper::compress(_raw.data(), _raw.size(), body, level);
+        }
+        /// @brief 清空块
+        void clear()
+        {
+            _raw.assign(sizeof(uint32_t), '\0');
+            _count = 0;
+        }
+        /// @brief 是否没有记录
+        bool empty() const { return _count == 0; }
+        /// @brief 获取解压后的字节数
+        size_t size() const { return _raw.size(); }
+        /// @brief 解压段中的块数据
+        /// @param body 段中的块数据
+        /// @param len 块数据长度
+        /// @param raw 输出参数 解压后的数据
+        /// @return 成功返回true 失败返回false
+        /// @note 压缩方式保存在块数据中 只读取消息数据、没有记录头时也能解压
+        static bool decode(const char *body, size_t len, std::string &raw)
+        {
+            uint32_t size;
+            if (len < sizeof(size) + 1)
+                return false;
+            memcpy(&size, body, sizeof(size));
+            if (size < sizeof(uint32_t) || (Codec)body[sizeof(size)] != Codec::ZLIB)
+                return false;
+            return CompressHelper::uncompress(body + sizeof(size) + 1, len - sizeof(size) - 1, size, raw);
+        }
+        /// @brief 读取解压数据中的一条记录
+        /// @param raw 解压后的数据
+        /// @param inner 记录在块内的偏移
+        /// @param data 输出参数 记录数据
+        /// @param len 输出参数 记录长度
+        /// @return 成功返回true 偏移超出范围返回false
+        static bool entry(const std::string &raw, uint32_t inner, const char *&data, size_t &len)
+        {
+            uint32_t size;
+            if (inner < sizeof(uint32_t) || inner > raw.size() || raw.size() - inner < sizeof(size))
+                return false;
+            memcpy(&size, raw.data() + inner, sizeof(size));
+            if (size > raw.size() - inner - sizeof(size))
+                return false;
+            data = raw.data() + inner + sizeof(size);
+            len = size;
+            return true;
+        }
+        /// @brief 遍历解压数据中的所有记录
+        /// @param raw 解压后的数据
+        /// @param cb 回调 参数为记录在块内的偏移、记录数据和长度
+        /// @return 所有记录完整返回true 否则返回false
+        static bool each(const std::string &raw, const std::function<void(uint32_t, const char *, size_t)> &cb)
+        {
+            uint32_t count;
+            if (raw.size() < sizeof(count))
+                return false;
+            memcpy(&count, raw.data(), sizeof(count));
+            uint32_t inner = sizeof(count);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                const char *data;
+                size_t len;
+                if (entry(raw, inner, data, len) == false)
+                    return false;
+                cb(inner, data, len);
+                inner += sizeof(uint32_t) + len;
+            }
+            return true;
+        }
+
+    private:
+        std::string _raw; ///< 解压后的数据 开头预留条目数
+        uint32_t _count;  ///< 条目数
+    };
+
+    /// @class Segment
+    /// @brief 单个段文件 持有常驻打开的文件描述符并在内存中维护尾部偏移
+    class Segment
+    {
+    public:
+        using ptr = std::shared_ptr<Segment>;
+        /// @brief 构造函数
+        /// @param filename 段文件名
+        /// @param id 段号
+        /// @param options 写入方式
+        Segment(const std::string &filename, uint32_t id, const SegmentOptions &options = SegmentOptions())
+            : _filename(filename), _id(id), _fd(-1), _dfd(-1), _tail(0), _version(FORMAT_V2), _options(options),
+              _buffer(nullptr), _buffer_size(0), _staged(STAGE_NONE), _flushed(0)
+        {
+        }
+        /// @brief 析构函数 写出暂存的数据并关闭文件描述符
+        ~Segment()
+        {
+            close();
+            free(_buffer);
+        }
+        /// @brief 打开段文件 不存在则创建并写入段头
+        /// @return 成功返回true 失败返回false
+        /// @note 非空且没有段头的文件是 v1 格式的段
+        bool open()
+        {
+            _fd = ::open(_filename.c_str(), O_RDWR | O_CREAT, 0644);
+            if (_fd < 0)
+            {
+                error(logger, "%s:段文件打开失败! %s", _filename.c_str(), strerror(errno));
+                return false;
+            }
+            struct stat st;
+            if (fstat(_fd, &st) < 0)
+            {
+                error(logger, "%s:获取段文件大小失败! %s", _filename.c_str(), strerror(errno));
+                return false;
+            }
+            _tail = st.st_size;
+            if (_tail == 0)
+            {
+                preallocate();
+                SegmentHeader header = {SEGMENT_MAGIC, FORMAT_V2, RecordHeader::now()};
+                if (write((const char *)&header, 0, SEGMENT_HEADER_SIZE) == false)
+                    return false;
+                _tail = SEGMENT_HEADER_SIZE;
+                _version = FORMAT_V2;
+                return openDirect();
+            }
+            SegmentHeader header;
+            if (_tail >= SEGMENT_HEADER_SIZE && read((char *)&header, 0, SEGMENT_HEADER_SIZE) &&
+                header.magic == SEGMENT_MAGIC)
+                _version = header.version;
+            else
+                _version = FORMAT_V1;
+            // 预分配或对齐留下的全零尾部 逐条跳过记录头找到真正的尾部
+            if (_version >= FORMAT_V2 && zeroTail() && scanTail() == false)
+                return false;
+            return openDirect();
+        }
+        /// @brief 关闭段文件 先写出暂存的数据
+        void close()
+        {
+            flush();
+            std::unique_lock<std::mutex> lock(_stage_mutex);
+            if (_fd >= 0)
+                ::close(_fd);
+            if (_dfd >= 0)
+                ::close(_dfd);
+            _fd = -1;
+            _dfd = -1;
+        }
+        /// @brief 封存段 不再追加写入 写出暂存的数据 释放预分配但未使用的空间和 O_DIRECT 写缓冲区
+        void seal()
+        {
+            flush();
+            std::unique_lock<std::mutex> lock(_stage_mutex);
+            if (_dfd >= 0)
+                ::close(_dfd);
+            _dfd = -1;
+            free(_buffer);
+            _buffer = nullptr;
+            _buffer_size = 0;
+            _staged = STAGE_NONE;
+            if (_options.preallocate > 0 && _fd >= 0 && ::ftruncate(_fd, _tail) < 0)
+                warn(logger, "%s:释放段文件预分配的空间失败! %s", _filename.c_str(), strerror(errno));
+        }
+        /// @brief 在段尾追加一条记录 记录头和数据通过一次 pwritev 写入
+        /// @param body 记录数据
+        /// @param seq 消息序号
+        /// @param offset 输出参数 数据(不含记录头)在段内的偏移
+        /// @return 成功返回true 失败返回false
+        bool append(const std::string &body, uint64_t seq, size_t &offset)
+        {
+            return append(RecordHeader(seq, body.size(), RecordHeader::now()), body.data(), offset);
+        }
+        /// @brief 在段尾追加一条记录 校验和在这里计算
+        /// @param header 记录头 需要设置好长度、序号、入队时间和标志位
+        /// @param body 记录数据
+        /// @param offset 输出参数 数据(不含记录头)在段内的偏移
+        /// @return 成功返回true 失败返回false
+        bool append(RecordHeader header, const char *body, size_t &offset)
+        {
+            if (_version < FORMAT_V2)
+            {
+                error(logger, "%s:旧版本格式的段不能追加写入!", _filename.c_str());
+                return false;
+            }
+            header.crc = header.checksum(body);
+            if (_dfd >= 0)
+                return appendDirect(header, body, offset);
+            struct iovec iov[2];
+            iov[0].iov_base = &header;
+            iov[0].iov_len = RECORD_HEADER_SIZE;
+            iov[1].iov_base = const_cast<char *>(body);
+            iov[1].iov_len = header.length;
+            if (writev(_fd, iov, 2, _tail) == false)
+                return false;
+            // 写入失败时尾部偏移不变 残留的数据会被下一次追加覆盖
+            offset = _tail + RECORD_HEADER_SIZE;
+            _tail += RECORD_HEADER_SIZE + header.length;
+            return true;
+        }
+        /// @brief 从指定位置读取数据 O_DIRECT 暂存的部分从缓冲区中复制
+        /// @param body 存储读取内容的字符指针
+        /// @param offset 段内偏移
+        /// @param len 要读取的字节数
+        /// @return 成功返回true 失败返回false
+        bool read(char *body, size_t offset, size_t len)
+        {
+            {
+                std::unique_lock<std::mutex> lock(_stage_mutex);
+                if (_staged != STAGE_NONE && offset + len > _staged)
+                {
+                    size_t begin = std::max(offset, _staged);
+                    if (offset + len > _tail)
+                    {
+                        error(logger, "%s:段文件读取数据失败!", _filename.c_str());
+                        return false;
+                    }
+                    memcpy(body + (begin - offset), _buffer + (begin - _staged), offset + len - begin);
+                    len = begin - offset;
+                }
+            }
+            return readFile(body, offset, len);
+        }
+        /// @brief 覆盖写入指定位置的数据
+        /// @param body 要写入的字符指针
+        /// @param offset 段内偏移
+        /// @param len 要写入的字节数
+        /// @return 成功返回true 失败返回false
+        bool write(const char *body, size_t offset, size_t len)
+        {
+            struct iovec iov;
+            iov.iov_base = const_cast<char *>(body);
+            iov.iov_len = len;
+            return writev(_fd, &iov, 1, offset);
+        }
+        /// @brief 将段文件数据刷入磁盘 先写出 O_DIRECT 暂存的数据
+        /// @return 成功返回true 失败返回false
+        bool sync()
+        {
+            if (_fd < 0) // 段已经被删除
+                return true;
+            if (flush() == false)
+                return false;
+            if (::fdatasync(_fd) < 0)
+            {
+                error(logger, "%s:段文件刷盘失败! %s", _filename.c_str(), strerror(errno));
+                return false;
+            }
+            return true;
+        }
+        /// @brief 截断段文件 丢弃写入中途崩溃残留的不完整记录
+        /// @param size 保留的字节数
+        /// @return 成功返回true 失败返回false
+        /// @note 预分配的段截断后重新预分配 截掉的部分读出来是全零
+        bool truncate(size_t size)
+        {
+            std::unique_lock<std::mutex> lock(_stage_mutex);
+            if (::ftruncate(_fd, size) < 0)
+            {
+                error(logger, "%s:段文件截断失败! %s", _filename.c_str(), strerror(errno));
+                return false;
+            }
+            _tail = size;
+            _staged = STAGE_NONE;
+            if (_options.preallocate > size)
+                preallocate();
+            return true;
+        }
+        /// @brief 删除段文件 文件描述符在析构时关闭
+        /// @return 成功返回true 失败返回false
+        bool remove()
+        {
+            return FileHelper::removeFile(_filename);
+        }
+        /// @brief 重命名段文件 文件描述符保持打开
+        /// @param nname 新文件名 已存在时被原子地覆盖
+        /// @return 成功返回true 失败返回false
+        bool rename(const std::string &nname)
+        {
+            if (FileHelper(_filename).rename(nname) == false)
+            {
+                error(logger, "%s:段文件重命名失败! %s", _filename.c_str(), strerror(errno));
+                return false;
+            }
+            _filename = nname;
+            return true;
+        }
+        /// @brief 获取段号
+        uint32_t id() const { return _id; }
+        /// @brief 获取段的尾部偏移 即已写入的字节数
+        size_t size() const { return _tail; }
+        /// @brief 获取段文件名
+        const std::string &filename() const { return _filename; }
+        /// @brief 获取文件描述符
+        int fd() const { return _fd; }
+        /// @brief 获取段的格式版本
+        uint32_t version() const { return _version; }
+        /// @brief 获取第一条记录的偏移 即段头的长度
+        size_t begin() const { return _version >= FORMAT_V2 ? SEGMENT_HEADER_SIZE : 0; }
+        /// @brief 是否绕过页缓存追加写入 文件系统不支持 O_DIRECT 时为false
+        bool direct() const { return _dfd >= 0; }
+        /// @brief 获取追加一条记录之后段文件在磁盘上占用的字节数
+        /// @param len 记录数据的长度
+        /// @return O_DIRECT 写入时按对齐边界向上取整 否则为尾部偏移加上记录的长度
+        size_t footprint(size_t len) const
+        {
+            size_t end = _tail + RECORD_HEADER_SIZE + len;
+            return _dfd >= 0 ? alignUp(end) : end;
+        }
+        /// @brief 写出 O_DIRECT 暂存的数据 未写满的最后一块补零后整块写入并继续保留在缓冲区中
+        /// @return 成功返回true 失败返回false 失败时数据仍在缓冲区中 下次重试
+        bool flush()
+        {
+            std::unique_lock<std::mutex> lock(_stage_mutex);
+            return flushStaged();
+        }
+        /// @brief 获取段文件的inode编号 压缩替换后的段文件编号不同
+        /// @return inode编号 失败返回0
+        uint64_t inode() const
+        {
+            struct stat st;
+            if (_fd < 0 || fstat(_fd, &st) < 0)
+                return 0;
+            return st.st_ino;
+        }
+
+    private:
+        /// @brief 写出暂存的数据 调用者持有暂存缓冲区的锁 @see flush
+        bool flushStaged()
+        {
+            if (_dfd < 0 || _staged == STAGE_NONE || _flushed == _tail)
+                return true;
+            // 从已写出数据所在的块开始 之前的块不再改写
+            size_t from = _flushed / DIRECT_IO_ALIGN * DIRECT_IO_ALIGN;
+            size_t to = alignUp(_tail);
+            struct iovec iov;
+            iov.iov_base = _buffer + (from - _staged);
+            iov.iov_len = to - from;
+            if (writev(_dfd, &iov, 1, from) == false)
+                return false;
+            _flushed = _tail;
+            // 只保留未写满的最后一块
+            size_t keep = _tail / DIRECT_IO_ALIGN * DIRECT_IO_ALIGN;
+            if (keep > _staged)
+            {
+                size_t rest = _tail - keep;
+                memmove(_buffer, _buffer + (keep - _staged), rest);
+                memset(_buffer + rest, 0, to - _staged - rest);
+                _staged = keep;
+            }
+            return true;
+        }
+        /// @brief 按预分配大小为段文件分配空间 文件大小随之扩展 不支持时只打印警告
+        void preallocate()
+        {
+            if (_options.preallocate == 0)
+                return;
+            if (::fallocate(_fd, 0, 0, _options.preallocate) < 0)
+                warn(logger, "%s:段文件预分配失败! %s", _filename.c_str(), strerror(errno));
+        }
+        /// @brief 打开绕过页缓存的写入描述符 文件系统不支持时退回普通写入
+        /// @return 始终返回true
+        /// @note 读取、映射和刷盘仍然使用普通的文件描述符 旧版本格式的段只读 不需要打开
+        bool openDirect()
+        {
+            if (_options.direct == false || _version < FORMAT_V2)
+                return true;
+            _dfd = ::open(_filename.c_str(), O_WRONLY | O_DIRECT);
+            if (_dfd < 0)
+                warn(logger, "%s:文件系统不支持 O_DIRECT, 使用普通写入 %s", _filename.c_str(), strerror(errno));
+            return true;
+        }
+        /// @brief 判断段文件末尾是否为预分配或对齐留下的全零数据
+        /// @return 末尾一个记录头大小的数据全为零 或段文件按块对齐且最后一个字节为零时返回true
+        /// @note O_DIRECT 写出的最后一块补零 零的个数可能少于一个记录头
+        bool zeroTail()
+        {
+            char tail[RECORD_HEADER_SIZE];
+            if (_tail < SEGMENT_HEADER_SIZE + RECORD_HEADER_SIZE ||
+                read(tail, _tail - RECORD_HEADER_SIZE, RECORD_HEADER_SIZE) == false)
+                return false;
+            if (_tail % DIRECT_IO_ALIGN == 0 && tail[RECORD_HEADER_SIZE - 1] == 0)
+                return true;
+            return std::all_of(tail, tail + RECORD_HEADER_SIZE, [](char c)
+                               { return c == 0; });
+        }
+        /// @brief 从第一条记录开始逐条跳过记录头 将尾部偏移设为第一个无效记录头的位置
+        /// @return 成功返回true 映射失败返回false
+        /// @note 只检查魔数和长度 校验和由恢复时的读取检查
+        bool scanTail()
+        {
+            void *map = ::mmap(nullptr, _tail, PROT_READ, MAP_SHARED, _fd, 0);
+            if (map == MAP_FAILED)
+            {
+                error(logger, "%s:段文件映射失败! %s", _filename.c_str(), strerror(errno));
+                return false;
+            }
+            const char *p = (const char *)map;
+            size_t pos = SEGMENT_HEADER_SIZE;
+            RecordHeader header;
+            while (_tail - pos >= RECORD_HEADER_SIZE)
+            {
+                memcpy(&header, p + pos, RECORD_HEADER_SIZE);
+                if (header.magic != RECORD_MAGIC || header.length > _tail - pos - RECORD_HEADER_SIZE)
+                    break;
+                pos += RECORD_HEADER_SIZE + header.length;
+            }
+            ::munmap(map, _tail);
+            _tail = pos;
+            return true;
+        }
+        /// @brief 将一条记录暂存到对齐的缓冲区中 暂存过多时先写出
+        /// @param header 已计算校验和的记录头
+        /// @param body 记录数据
+        /// @param offset 输出参数 数据(不含记录头)在段内的偏移
+        /// @return 成功返回true 失败返回false
+        bool appendDirect(const RecordHeader &header, const char *body, size_t &offset)
+        {
+            std::unique_lock<std::mutex> lock(_stage_mutex);
+            if (_staged == STAGE_NONE && stage() == false)
+                return false;
+            if (_tail - _staged >= DIRECT_IO_STAGE_SIZE && flushStaged() == false)
+                return false;
+            size_t used = RECORD_HEADER_SIZE + header.length;
+            if (reserve(alignUp(_tail + used) - _staged) == false)
+                return false;
+            memcpy(_buffer + (_tail - _staged), &header, RECORD_HEADER_SIZE);
+            memcpy(_buffer + (_tail - _staged) + RECORD_HEADER_SIZE, body, header.length);
+            offset = _tail + RECORD_HEADER_SIZE;
+            _tail += used;
+            return true;
+        }
+        /// @brief 开始暂存 将尾部偏移所在的块读入缓冲区 之后的追加从这一块开始写出
+        /// @return 成功返回true 失败返回false
+        bool stage()
+        {
+            size_t begin = _tail / DIRECT_IO_ALIGN * DIRECT_IO_ALIGN;
+            if (reserve(DIRECT_IO_ALIGN) == false)
+                return false;
+            if (_tail > begin && readFile(_buffer, begin, _tail - begin) == false)
+                return false;
+            _staged = begin;
+            _flushed = _tail;
+            return true;
+        }
+        /// @brief 确保对齐缓冲区至少有指定的字节数 扩容时保留已暂存的数据 多出的部分为零
+        /// @param size 需要的字节数 按对齐边界取整
+        /// @return 成功返回true 失败返回false
+        bool reserve(size_t size)
+        {
+            if (size <= _buffer_size)
+                return true;
+            size = std::max(size, _buffer_size * 2);
+            char *buffer;
+            if (posix_memalign((void **)&buffer, DIRECT_IO_ALIGN, size) != 0)
+            {
+                error(logger, "%s:分配对齐的写缓冲区失败!", _filename.c_str());
+                return false;
+            }
+            if (_buffer != nullptr)
+                memcpy(buffer, _buffer, _buffer_size);
+            memset(buffer + _buffer_size, 0, size - _buffer_size);
+            free(_buffer);
+            _buffer = buffer;
+            _buffer_size = size;
+            return true;
+        }
+        /// @brief 从段文件的指定位置读取数据 不经过暂存缓冲区
+        /// @param body 存储读取内容的字符指针
+        /// @param offset 段内偏移
+        /// @param len 要读取的字节数
+        /// @return 成功返回true 失败返回false
+        bool readFile(char *body, size_t offset, size_t len)
+        {
+            size_t done = 0;
+            while (done < len)
+            {
+                ssize_t ret = ::pread(_fd, body + done, len - done, offset + done);
+                if (ret < 0 && errno == EINTR)
+                    continue;
+                if (ret <= 0)
+                {
+                    error(logger, "%s:段文件读取数据失败!", _filename.c_str());
+                    return false;
+                }
+                done += ret;
+            }
+            return true;
+        }
+        /// @brief 按对齐边界向上取整
+        static size_t alignUp(size_t len)
+        {
+            return (len + DIRECT_IO_ALIGN - 1) / DIRECT_IO_ALIGN * DIRECT_IO_ALIGN;
+        }
+        /// @brief 从指定位置写入一组缓冲区 处理短写和信号中断
+        /// @param fd 文件描述符
+        /// @param iov 缓冲区数组 写入过程中会被修改
+        /// @param count 缓冲区个数
+        /// @param offset 文件偏移
+        /// @return 成功返回true 失败返回false
+        bool writev(int fd, struct iovec *iov, int count, size_t offset)
+        {
+            while (count > 0)
+            {
+                ssize_t ret = ::pwritev(fd, iov, count, offset);
+                if (ret < 0 && errno == EINTR)
+                    continue;
+                if (ret < 0)
+                {
+                    error(logger, "%s:段文件写入数据失败! %s", _filename.c_str(), strerror(errno));
+                    return false;
+                }
+                offset += ret;
+                // 跳过已经写完的缓冲区
+                while (count > 0 && (size_t)ret >= iov->iov_len)
+                {
+                    ret -= iov->iov_len;
+                    iov++;
+                    count--;
+                }
+                if (count > 0)
+                {
+                    iov->iov_base = (char *)iov->iov_base + ret;
+                    iov->iov_len -= ret;
+                }
+            }
+            return true;
+        }
+
+    private:
+        std::string _filename;   ///< 段文件名
+        uint32_t _id;            ///< 段号
+        int _fd;                 ///< 常驻打开的文件描述符
+        int _dfd;                ///< 绕过页缓存的写入描述符 没有时为-1
+        size_t _tail;            ///< 尾部偏移
+        uint32_t _version;       ///< 格式版本
+        SegmentOptions _options; ///< 写入方式
+        char *_buffer;           ///< O_DIRECT 暂存数据的对齐缓冲区 缓冲区开头对应段内偏移 _staged
+        size_t _buffer_size;     ///< 对齐缓冲区的字节数
+        size_t _staged;          ///< 缓冲区开头对应的段内偏移 按块对齐 没有开始暂存时为 STAGE_NONE
+        size_t _flushed;         ///< 已经写出到段文件的尾部偏移
+        std::mutex _stage_mutex; ///< 保护暂存缓冲区 刷盘与追加、读取并发进行
+
+        static const size_t STAGE_NONE = (size_t)-1; ///< 没有开始暂存
+    };
+
+    /// @class SegmentReader
+    /// @brief 段文件的顺序读取器 将段文件映射到内存中 原地遍历记录 兼容 v1 格式
+    /// @note 读取到的数据指针在读取器析构之前有效
+    class SegmentReader
+    {
+    public:
+        /// @brief 构造函数 映射段文件中[offset, 段尾)的数据
+        /// @param segment 段
+        /// @param offset 开始读取的偏移 默认从第一条记录开始
+        SegmentReader(const Segment::ptr &segment, size_t offset = 0)
+            : _segment(segment), _map(nullptr), _base(0), _end(segment->size()),
+              _pos(std::max(offset, segment->begin())), _truncated(false)
+        {
+        }
+        /// @brief 析构函数 解除映射
+        ~SegmentReader()
+        {
+            if (_map != nullptr)
+                ::munmap(_map, _end - _base);
+        }
+        /// @brief 映射段文件 并提示内核按顺序预读
+        /// @return 成功返回true 失败返回false
+        bool open()
+        {
+            if (_pos >= _end)
+                return true;
+            size_t page = ::sysconf(_SC_PAGESIZE);
+            _base = _pos / page * page; // 映射的起点必须按页对齐
+            void *map = ::mmap(nullptr, _end - _base, PROT_READ, MAP_SHARED, _segment->fd(), _base);
+            if (map == MAP_FAILED)
+            {
+                error(logger, "%s:段文件映射失败! %s", _segment->filename().c_str(), strerror(errno));
+                return false;
+            }
+            _map = (char *)map;
+            ::madvise(_map, _end - _base, MADV_SEQUENTIAL);
+            return true;
+        }
+        /// @brief 读取下一条记录
+        /// @param header 输出参数 记录头 v1 记录只有长度有效
+        /// @param data 输出参数 记录数据在映射区域中的地址
+        /// @param offset 输出参数 记录数据(不含记录头)在段内的偏移
+        /// @return 读取到记录返回true 到达段尾或遇到不完整、校验失败的记录返回false
+        bool next(RecordHeader &header, const char *&data, size_t &offset)
+        {
+            while (true)
+            {
+                if (_pos >= _end || _truncated)
+                    return false;
+                size_t header_size = _segment->version() >= FORMAT_V2 ? RECORD_HEADER_SIZE : RECORD_HEADER_V1_SIZE;
+                if (_end - _pos < header_size)
+                    return stop("段尾存在不完整的记录头");
+                const char *p = _map + (_pos - _base);
+                size_t len;
+                if (_segment->version() >= FORMAT_V2)
+                {
+                    // 预分配或对齐留下的全零数据 之后没有记录
+                    if (std::all_of(p, p + RECORD_HEADER_SIZE, [](char c)
+                                    { return c == 0; }))
+                        return false;
+                    memcpy(&header, p, RECORD_HEADER_SIZE);
+                    if (header.magic != RECORD_MAGIC || header.version != FORMAT_V2)
+                        return stop("记录头损坏");
+                    len = header.length;
+                }
+                else
+                {
+                    memcpy(&len, p, RECORD_HEADER_V1_SIZE);
+                    header = RecordHeader();
+                    header.version = FORMAT_V1;
+                }
+                if (len > _end - _pos - header_size)
+                    return stop("段尾存在不完整的消息");
+                offset = _pos + header_size;
+                data = p + header_size;
+                header.length = len;
+                if (_segment->version() >= FORMAT_V2 && header.checksum(data) != header.crc)
+                    return stop("记录校验失败");
+                _pos = offset + len;
+                if ((header.flags & RECORD_FLAG_PADDING) == 0) // 跳过填充记录
+                    return true;
+            }
+        }
+        /// @brief 读取映射范围内指定位置的数据
+        /// @param offset 段内偏移
+        /// @param len 数据长度
+        /// @param data 输出参数 数据在映射区域中的地址
+        /// @return 成功返回true 超出映射范围返回false
+        bool at(size_t offset, size_t len, const char *&data)
+        {
+            if (_map == nullptr || offset < _base || offset > _end || len > _end - offset)
+                return false;
+            data = _map + (offset - _base);
+            return true;
+        }
+        /// @brief 是否遇到了不完整的记录
+        bool truncated() const { return _truncated; }
+        /// @brief 获取下一条记录的偏移 遇到不完整的记录时即为有效数据的结尾
+        size_t position() const { return _pos; }
+
+    private:
+        /// @brief 遇到不完整或损坏的记录 停止读取
+        /// @param reason 原因
+        /// @return 始终返回false
+        bool stop(const char *reason)
+        {
+            warn(logger, " %s :偏移 %zu 处%s, 之后的数据已忽略", _segment->filename().c_str(), _pos, reason);
+            _truncated = true;
+            return false;
+        }
+
+    private:
+        Segment::ptr _segment; ///< 段 读取期间保持文件描述符有效
+        char *_map;            ///< 映射区域起始地址
+        size_t _base;          ///< 映射区域对应的段内偏移
+        size_t _end;           ///< 映射区域结束的段内偏移
+        size_t _pos;           ///< 下一条记录的段内偏移
+        bool _truncated;       ///< 是否遇到了不完整的记录
+    };
+
+    /// @class SegmentLog
+    /// @brief 分段追加日志 管理一个目录下的所有段文件
+    class SegmentLog
+    {
+    public:
+        /// @brief 构造函数
+        /// @param dirname 段文件所在目录
+        /// @param max_size 段文件滚动大小
+        /// @param options 段文件的写入方式
+        SegmentLog(const std::string &dirname, size_t max_size = SEGMENT_MAX_SIZE, const SegmentOptions &options = SegmentOptions())
+            : _dirname(dirname), _max_size(max_size), _options(options)
+        {
+            if (_dirname.back() != '/' && _dirname.back() != '\\')
+                _dirname.push_back('/');
+        }
+        /// @brief 打开日志 扫描目录中已有的段文件 没有则创建第一个段
+        /// @return 成功返回true 失败返回false
+        bool open()
+        {
+            if (FileHelper(_dirname).exists() == false && FileHelper::createDirectory(_dirname) == false)
+            {
+                error(logger, "%s:创建段目录失败!", _dirname.c_str());
+                return false;
+            }
+            std::vector<std::string> files;
+            FileHelper::listDirectory(_dirname, files);
+            for (auto &file : files)
+            {
+                uint32_t id;
+                if (isTempName(file))
+                {
+                    // 压缩中途退出残留的临时段 原段仍然完整
+                    FileHelper::removeFile(_dirname + file);
+                    continue;
+                }
+                if (parseSegmentName(file, id) == false)
+                    continue;
+                auto segment = std::make_shared<Segment>(_dirname + file, id, _options);
+                if (segment->open() == false)
+                    return false;
+                _segments.insert(std::make_pair(id, segment));
+            }
+            if (_segments.empty())
+                return roll();
+            _active = _segments.rbegin()->second;
+            if (_active->version() < FORMAT_V2)
+            {
+                // 旧版本的段只读 新的记录写入 v2 段
+                info(logger, "%s:活跃段为旧版本格式, 滚动到新的段", _active->filename().c_str());
+                return roll();
+            }
+            return true;
+        }
+        /// @brief 关闭所有段文件
+        void close()
+        {
+            _segments.clear();
+            _active.reset();
+        }
+        /// @brief 追加一条记录 活跃段写满时先滚动到新的段
+        /// @param body 记录数据
+        /// @param seq 消息序号
+        /// @param segment 输出参数 记录所在段号
+        /// @param offset 输出参数 数据在段内的偏移
+        /// @return 成功返回true 失败返回false
+        bool append(const std::string &body, uint64_t seq, uint32_t &segment, size_t &offset)
+        {
+            return append(body, seq, Codec::NONE, segment, offset);
+        }
+        /// @brief 追加一条记录 活跃段写满时先滚动到新的段
+        /// @param body 记录数据 压缩块为 RecordBlock::encode 的结果
+        /// @param seq 消息序号 压缩块为块中第一条记录的序号
+        /// @param codec 压缩方式 写入记录头的标志位
+        /// @param segment 输出参数 记录所在段号
+        /// @param offset 输出参数 数据在段内的偏移
+        /// @return 成功返回true 失败返回false
+        bool append(const std::string &body, uint64_t seq, Codec codec, uint32_t &segment, size_t &offset)
+        {
+            if (_active.get() == nullptr)
+            {
+                error(logger, "%s:段日志尚未打开!", _dirname.c_str());
+                return false;
+            }
+            // O_DIRECT 写入的段按整块占用磁盘 按对齐后的长度判断
+            if (_active->size() > _active->begin() && _active->footprint(body.size()) > _max_size)
+            {
+                if (roll() == false)
+                    return false;
+            }
+            segment = _active->id();
+            RecordHeader header(seq, body.size(), RecordHeader::now(), (uint8_t)codec);
+            return _active->append(header, body.data(), offset);
+        }
+        /// @brief 读取指定段中的数据
+        /// @param segment 段号
+        /// @param offset 段内偏移
+        /// @param len 读取长度
+        /// @param body 存储读取内容的字符串
+        /// @return 成功返回true 失败返回false
+        bool read(uint32_t segment, size_t offset, size_t len, std::string &body)
+        {
+            Segment::ptr sp = select(segment);
+            if (sp.get() == nullptr)
+                return false;
+            body.resize(len);
+            return sp->read(&body[0], offset, len);
+        }
+        /// @brief 覆盖写入指定段中的数据
+        /// @param segment 段号
+        /// @param offset 段内偏移
+        /// @param body 要写入的字符指针
+        /// @param len 写入长度
+        /// @return 成功返回true 失败返回false
+        bool write(uint32_t segment, size_t offset, const char *body, size_t len)
+        {
+            Segment::ptr sp = select(segment);
+            if (sp.get() == nullptr)
+                return false;
+            return sp->write(body, offset, len);
+        }
+        /// @brief 封存当前活跃段 创建新的段接收后续写入
+        /// @return 成功返回true 失败返回false
+        bool roll()
+        {
+            uint32_t id = _segments.empty() ? 0 : _segments.rbegin()->first + 1;
+            auto segment = std::make_shared<Segment>(segmentName(id), id, _options);
+            if (segment->open() == false)
+                return false;
+            if (_active.get() != nullptr)
+                _active->seal();
+            _segments.insert(std::make_pair(id, segment));
+            _active = segment;
+            return true;
+        }
+        /// @brief 删除指定段 活跃段不可删除
+        /// @param segment 段号
+        /// @return 成功返回true 失败返回false
+        bool removeSegment(uint32_t segment)
+        {
+            auto it = _segments.find(segment);
+            if (it == _segments.end() || it->second == _active)
+                return false;
+            bool ret = it->second->remove();
+            _segments.erase(it);
+            return ret;
+        }
+        /// @brief 为压缩指定的段创建临时段 临时段不加入段映射表
+        /// @param segment 段号
+        /// @note 临时段大小确定且只写一次 不预分配 经过页缓存写入
+        /// @return 临时段指针 失败返回空指针
+        Segment::ptr createTemp(uint32_t segment)
+        {
+            std::string filename = segmentName(segment) + SEGMENT_TMP_SUBFIX;
+            FileHelper::removeFile(filename);
+            auto temp = std::make_shared<Segment>(filename, segment);
+            if (temp->open() == false)
+                return Segment::ptr();
+            return temp;
+        }
+        /// @brief 用压缩完成的临时段替换原段 重命名是原子的 段号不变
+        /// @param temp 临时段 @see createTemp
+        /// @return 成功返回true 失败返回false
+        bool replace(const Segment::ptr &temp)
+        {
+            auto it = _segments.find(temp->id());
+            if (it == _segments.end() || it->second == _active)
+                return false;
+            if (temp->rename(segmentName(temp->id())) == false)
+                return false;
+            // 原段文件已被覆盖 旧段的最后一个引用释放后空间即被回收
+            it->second = temp;
+            return true;
+        }
+        /// @brief 判断段是否存在
+        /// @param segment 段号
+        /// @return 存在返回true 不存在返回false
+        bool contains(uint32_t segment)
+        {
+            return _segments.find(segment) != _segments.end();
+        }
+        /// @brief 删除所有段文件和目录
+        void removeAll()
+        {
+            for (auto &segment : _segments)
+                segment.second->remove();
+            _segments.clear();
+            _active.reset();
+            ::rmdir(_dirname.c_str());
+        }
+        /// @brief 获取指定段
+        /// @param segment 段号
+        /// @return 段指针 不存在返回空指针
+        Segment::ptr select(uint32_t segment)
+        {
+            auto it = _segments.find(segment);
+            if (it == _segments.end())
+            {
+                error(logger, "%s:没有找到段 %u", _dirname.c_str(), segment);
+                return Segment::ptr();
+            }
+            return it->second;
+        }
+        /// @brief 获取按段号升序排列的所有段
+        /// @return 段指针数组
+        std::vector<Segment::ptr> segments()
+        {
+            std::vector<Segment::ptr> result;
+            for (auto &segment : _segments)
+                result.push_back(segment.second);
+            return result;
+        }
+        /// @brief 获取活跃段
+        Segment::ptr active() { return _active; }
+        /// @brief 获取段目录
+        const std::string &dirname() const { return _dirname; }
+        /// @brief 根据段号生成段文件名
+        /// @param id 段号
+        /// @return 段文件路径
+        std::string segmentName(uint32_t id) const
+        {
+            char name[32] = {0};
+            snprintf(name, sizeof(name), "%010u", id);
+            return _dirname + name + SEGMENT_SUBFIX;
+        }
+
+    private:
+        /// @brief 判断是否为压缩残留的临时段文件名
+        /// @param file 文件名
+        static bool isTempName(const std::string &file)
+        {
+            size_t len = strlen(SEGMENT_TMP_SUBFIX);
+            uint32_t id;
+            return file.size() > len && file.compare(file.size() - len, len, SEGMENT_TMP_SUBFIX) == 0 &&
+                   parseSegmentName(file.substr(0, file.size() - len), id);
+        }
+        /// @brief 解析段文件名
+        /// @param file 文件名
+        /// @param id 输出参数 段号
+        /// @return 是段文件返回true 否则返回false
+        static bool parseSegmentName(const std::string &file, uint32_t &id)
+        {
+            size_t len = strlen(SEGMENT_SUBFIX);
+            if (file.size() != 10 + len || file.compare(10, len, SEGMENT_SUBFIX) != 0)
+                return false;
+            for (size_t i = 0; i < 10; i++)
+                if (isdigit(file[i]) == false)
+                    return false;
+            id = std::stoul(file.substr(0, 10));
+            return true;
+        }
+
+    private:
+        std::string _dirname;                        ///< 段文件所在目录
+        size_t _max_size;                            ///< 段文件滚动大小
+        SegmentOptions _options;                     ///< 段文件的写入方式
+        std::map<uint32_t, Segment::ptr> _segments;  ///< 段号到段的映射表 按段号有序
+        Segment::ptr _active;                        ///< 活跃段
+    };
+}
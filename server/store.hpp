@@ -0,0 +1,271 @@
+/**
+ * @file store.hpp
+ * @brief 消息存储引擎接口的定义
+ *
+ * 该文件定义了 XuMQ 命名空间中的 MessageStore 接口、所有存储引擎共用的持久化策略 DurabilityPolicy
+ * 以及 MemoryStore 类。
+ *
+ * 推送消息队列(QueueMessage)只通过 MessageStore 接口访问持久化存储，
+ * 每个队列在声明时通过参数 x-store 选择存储引擎:
+ * - file: 分段日志 默认引擎 @see MessageMapper
+ * - memory: 纯内存 不写磁盘 重启后消息丢失 适合测试和临时的代理 @see MemoryStore
+ * - ring: 固定大小的内存映射环形文件 确认的消息从尾部依次回收 @see RingStore
+ * - btree: 虚拟机共用的B+树数据库 确认即删除 适合乱序确认 @see BTreeStore
+ *
+ * 虚拟机的默认持久化策略中可以指定默认的存储引擎。
+ *
+ * 除特别说明的方法外，接口方法都在持有队列锁时调用。
+ */
+
+#pragma once
+#include "../common/logger.hpp"
+#include "../common/helper.hpp"
+#include "../common/msg.pb.h"
+#include "segment.hpp"
+#include "body.hpp"
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <google/protobuf/map.h>
+
+namespace XuMQ
+{
+    using QueueArgs = google::protobuf::Map<std::string, std::string>; ///< 队列声明参数
+
+    const char *ARG_STORE = "x-store";                         ///< 队列参数: 存储引擎 file|memory|ring|btree
+    const char *ARG_DURABILITY = "x-durability";               ///< 队列参数: 持久化策略 none|interval|batch|confirm
+    const char *ARG_FSYNC_INTERVAL = "x-fsync-interval-ms";    ///< 队列参数: 定时刷盘间隔(毫秒)
+    const char *ARG_FSYNC_BATCH = "x-fsync-batch";             ///< 队列参数: 定量刷盘的消息条数
+    const size_t FSYNC_INTERVAL_DEFAULT = 100;                 ///< 默认定时刷盘间隔(毫秒)
+    const size_t FSYNC_BATCH_DEFAULT = 64;                     ///< 默认定量刷盘的消息条数
+    const char *ARG_COMPRESSION = "x-compression";            ///< 队列参数: 压缩方式 none|zlib
+    const char *ARG_COMPRESSION_LEVEL = "x-compression-level"; ///< 队列参数: 压缩级别 1(最快)~9(最小)
+    const char *ARG_PREALLOCATE = "x-preallocate";             ///< 队列参数: 是否预分配数据文件 true|false
+    const char *ARG_DIRECT_IO = "x-direct-io";                 ///< 队列参数: 是否绕过页缓存写入数据文件 true|false
+
+    /// @brief 持久化消息的刷盘方式
+    enum class SyncMode
+    {
+        NONE,     ///< 从不主动刷盘 由操作系统决定写回时机
+        INTERVAL, ///< 后台线程每隔固定时间刷盘一次
+        BATCH,    ///< 每累计固定条数的消息刷盘一次
+        CONFIRM   ///< 发布返回(向生产者确认)之前必须刷盘
+    };
+
+    /// @struct DurabilityPolicy
+    /// @brief 持久化策略 可以在虚拟机级别设置默认值 再由队列的声明参数覆盖
+    struct DurabilityPolicy
+    {
+        SyncMode mode;      ///< 刷盘方式
+        size_t interval_ms; ///< 定时刷盘间隔(毫秒) INTERVAL模式使用 BATCH模式下非0时作为兜底
+        size_t batch;       ///< 定量刷盘的消息条数 BATCH模式使用
+        Codec codec;        ///< 压缩方式 共享日志模式下不压缩
+        int level;          ///< 压缩级别
+        bool preallocate;   ///< 是否将数据文件预分配到滚动大小
+        bool direct;        ///< 是否绕过页缓存(O_DIRECT)写入数据文件
+        std::string store;  ///< 存储引擎 @see ARG_STORE
+
+        /// @brief 构造函数 默认不主动刷盘 不压缩 不预分配 写入经过页缓存 使用文件存储引擎
+        DurabilityPolicy(SyncMode smode = SyncMode::NONE,
+                         size_t sinterval_ms = FSYNC_INTERVAL_DEFAULT,
+                         size_t sbatch = FSYNC_BATCH_DEFAULT,
+                         Codec scodec = Codec::NONE, int slevel = Z_DEFAULT_COMPRESSION,
+                         bool spreallocate = false, bool sdirect = false, const std::string &sstore = "file")
+            : mode(smode), interval_ms(sinterval_ms), batch(sbatch), codec(scodec), level(slevel),
+              preallocate(spreallocate), direct(sdirect), store(sstore)
+        {
+        }
+        /// @brief 获取数据文件的写入方式
+        SegmentOptions segmentOptions() const
+        {
+            return SegmentOptions(preallocate ? SEGMENT_MAX_SIZE : 0, direct);
+        }
+        /// @brief 根据队列参数覆盖策略
+        /// @param args 队列声明参数 @see ARG_DURABILITY ARG_FSYNC_INTERVAL ARG_FSYNC_BATCH ARG_COMPRESSION ARG_COMPRESSION_LEVEL
+        ///             ARG_PREALLOCATE ARG_DIRECT_IO ARG_STORE
+        /// @return 覆盖后的策略 参数不合法时保留原值
+        DurabilityPolicy override(const QueueArgs &args) const
+        {
+            DurabilityPolicy result = *this;
+            auto it = args.find(ARG_DURABILITY);
+            if (it != args.end())
+            {
+                if (it->second == "none")
+                    result.mode = SyncMode::NONE;
+                else if (it->second == "interval")
+                    result.mode = SyncMode::INTERVAL;
+                else if (it->second == "batch")
+                    result.mode = SyncMode::BATCH;
+                else if (it->second == "confirm")
+                    result.mode = SyncMode::CONFIRM;
+                else
+                    warn(logger, "未知的持久化策略: %s", it->second.c_str());
+            }
+            it = args.find(ARG_FSYNC_INTERVAL);
+            if (it != args.end())
+                result.interval_ms = strtoul(it->second.c_str(), nullptr, 10);
+            it = args.find(ARG_FSYNC_BATCH);
+            if (it != args.end() && strtoul(it->second.c_str(), nullptr, 10) > 0)
+                result.batch = strtoul(it->second.c_str(), nullptr, 10);
+            it = args.find(ARG_COMPRESSION);
+            if (it != args.end())
+            {
+                if (it->second == "none")
+                    result.codec = Codec::NONE;
+                else if (it->second == "zlib")
+                    result.codec = Codec::ZLIB;
+                else
+                    warn(logger, "未知的压缩方式: %s", it->second.c_str());
+            }
+            it = args.find(ARG_COMPRESSION_LEVEL);
+            if (it != args.end())
+                result.level = strtol(it->second.c_str(), nullptr, 10);
+            it = args.find(ARG_PREALLOCATE);
+            if (it != args.end())
+                result.preallocate = it->second == "true";
+            it = args.find(ARG_DIRECT_IO);
+            if (it != args.end())
+                result.direct = it->second == "true";
+            it = args.find(ARG_STORE);
+            if (it != args.end())
+                result.store = it->second;
+            return result;
+        }
+    };
+
+    /// @class MessageStore
+    /// @brief 消息存储引擎接口
+    class MessageStore
+    {
+    public:
+        using ptr = std::shared_ptr<MessageStore>;
+        virtual ~MessageStore() {}
+        /// @brief 追加一条持久化消息
+        /// @param ref 队列中的消息 写入后更新其存储位置 长度为0表示没有磁盘上的副本
+        /// @param record 序列化后的共享消息
+        /// @return 成功返回true 失败返回false
+        virtual bool insert(const MessageRef::ptr &ref, const std::string &record) = 0;
+        /// @brief 将消息标记为已确认
+        /// @param ref 队列中的消息
+        /// @return 成功返回true 失败返回false
+        virtual bool remove(const MessageRef::ptr &ref) = 0;
+        /// @brief 遍历存活的持久化消息 队列创建时调用一次
+        /// @param seq 输出参数 已分配过的最大消息序号
+        /// @return 按序号排列的存活消息
+        virtual std::list<MessageRef::ptr> recovery(uint64_t &seq) = 0;
+        /// @brief 从存储中读回消息
+        /// @param refs 需要读回的消息 读取后设置其中共享的消息
+        /// @return 全部读取成功返回true 失败返回false
+        virtual bool read(const std::vector<MessageRef::ptr> &refs) = 0;
+        /// @brief 按持久化策略提交已写入的消息 调用时不持有队列锁
+        /// @return 成功返回true 刷盘失败返回false
+        virtual bool commit() = 0;
+        /// @brief 立即将所有已写入的消息刷盘 调用时不持有队列锁
+        /// @return 成功返回true 失败返回false
+        virtual bool sync() = 0;
+        /// @brief 删除存储的所有数据
+        virtual void clear() = 0;
+        /// @brief 丢弃所有数据 存储保持可用 之后可以继续写入
+        /// @return 成功返回true 失败返回false
+        /// @note 代价与存储中的消息数无关(B+树存储除外)
+        virtual bool purge() = 0;
+        /// @brief 获取存储中的记录总数 包括已确认但尚未回收的记录
+        virtual size_t totalCount() = 0;
+
+        /// @brief 定时刷盘 由后台线程周期性调用 调用时不持有队列锁
+        /// @return 成功返回true 失败返回false
+        virtual bool flush() { return true; }
+        /// @brief 是否需要后台线程定时刷盘
+        virtual bool needFlusher() const { return false; }
+        /// @brief 获取实际执行的刷盘次数 不刷盘的存储引擎返回0
+        virtual size_t syncCount() { return 0; }
+        /// @brief 回收已确认消息占用的空间 由后台线程调用 调用时不持有队列锁
+        /// @param mutex 队列锁 只在检查和更新消息位置时短暂持有
+        /// @param msgs 存活的持久化消息 以消息序号为键 只能在持有队列锁时访问
+        /// @param rate 速率上限(字节/秒) 0表示不限速
+        /// @return 改变了消息的存储位置返回true 否则返回false
+        virtual bool compact(std::mutex & /*mutex*/, const std::unordered_map<uint64_t, MessageRef::ptr> & /*msgs*/, size_t /*rate*/)
+        {
+            return false;
+        }
+        /// @brief 生成检查点数据
+        /// @param msgs 存活的持久化消息 以消息序号为键
+        /// @param seq 最近分配的消息序号
+        /// @param checkpoint 存储检查点数据
+        virtual void snapshot(const std::unordered_map<uint64_t, MessageRef::ptr> & /*msgs*/, uint64_t /*seq*/, QueueCheckpoint & /*checkpoint*/) {}
+        /// @brief 写入检查点 调用时不持有队列锁
+        /// @param checkpoint 检查点数据 @see snapshot
+        /// @return 成功返回true 失败返回false
+        virtual bool writeCheckpoint(const QueueCheckpoint & /*checkpoint*/) { return sync(); }
+        /// @brief 将非持久化消息换出内存
+        /// @param ref 非持久化消息 写入后更新其存储位置并清空消息
+        /// @return 成功返回true 不支持或失败返回false
+        virtual bool spill(const MessageRef::ptr & /*ref*/) { return false; }
+        /// @brief 写出攒在内存中的记录
+        /// @param flushed 输出参数 写出的消息
+        /// @return 成功返回true 失败返回false
+        virtual bool flushBlock(std::vector<MessageRef::ptr> & /*flushed*/) { return true; }
+        /// @brief 攒在内存中的记录是否需要立即写出
+        virtual bool blockDue() { return false; }
+        /// @brief 攒在内存中的记录是否停留过久
+        virtual bool blockExpired() const { return false; }
+        /// @brief 发布确认前是否需要先写出攒在内存中的记录
+        virtual bool flushOnCommit() const { return false; }
+        /// @brief 是否将消息写入虚拟机的共享日志 扇出发布时所有这样的队列只写一条记录
+        virtual bool journaled() const { return false; }
+        /// @brief 获取共享日志中的队列标识
+        virtual std::string tag() const { return std::string(); }
+        /// @brief 登记已经写入共享日志的消息
+        /// @param ref 队列中的消息 存储位置已设置
+        /// @param ticket 共享日志的写入序号
+        virtual void attach(const MessageRef::ptr & /*ref*/, uint64_t /*ticket*/) {}
+    };
+
+    /// @class MemoryStore
+    /// @brief 纯内存的存储引擎 消息只保存在队列中 不写磁盘
+    /// @note 消息没有磁盘上的副本 内存水位和惰性队列不会换出它们
+    class MemoryStore : public MessageStore
+    {
+    public:
+        using ptr = std::shared_ptr<MemoryStore>;
+        /// @brief 构造函数
+        MemoryStore() : _count(0) {}
+        bool insert(const MessageRef::ptr & /*ref*/, const std::string & /*record*/) override
+        {
+            _count++;
+            return true;
+        }
+        bool remove(const MessageRef::ptr & /*ref*/) override
+        {
+            if (_count > 0)
+                _count--;
+            return true;
+        }
+        std::list<MessageRef::ptr> recovery(uint64_t &seq) override
+        {
+            seq = 0;
+            return std::list<MessageRef::ptr>();
+        }
+        bool read(const std::vector<MessageRef::ptr> &refs) override
+        {
+            if (refs.empty())
+                return true;
+            error(logger, "内存存储中的消息不能读回!");
+            return false;
+        }
+        bool commit() override { return true; }
+        bool sync() override { return true; }
+        void clear() override { _count = 0; }
+        bool purge() override
+        {
+            _count = 0;
+            return true;
+        }
+        size_t totalCount() override { return _count; }
+
+    private:
+        size_t _count; ///< 存活消息数
+    };
+}
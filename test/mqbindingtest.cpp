@@ -1,5 +1,7 @@
 #include "../server/binding.hpp"
 #include <gtest/gtest.h>
+#include <thread>
+#include <atomic>
 
 XuMQ::BindingManager::ptr bmp;
 
@@ -22,6 +24,74 @@ TEST(bind_test, recovery_test)
     ASSERT_TRUE(bmp->exists("exchange2", "queue3"));
 }
 
+TEST(bind_test, snapshot_test)
+{
+    // 已经取得的快照不受之后的绑定和解绑影响
+    bmp->bind("exchange9", "queue1", "news.#", false);
+    XuMQ::BindingSnapshot before = bmp->getExchangeBindings("exchange9");
+    bmp->bind("exchange9", "queue2", "news.#", false);
+    bmp->unbind("exchange9", "queue1");
+    ASSERT_EQ(before->size(), 1);
+    ASSERT_NE(before->find("queue1"), before->end());
+    XuMQ::BindingSnapshot after = bmp->getExchangeBindings("exchange9");
+    ASSERT_EQ(after->size(), 1);
+    ASSERT_NE(after->find("queue2"), after->end());
+    bmp->removeMsgQueueBindings("queue2");
+    ASSERT_TRUE(bmp->getExchangeBindings("exchange9")->empty());
+    ASSERT_FALSE(bmp->exists("exchange9", "queue2"));
+}
+
+TEST(bind_test, cache_test)
+{
+    // 其他线程缓存的快照在绑定、解绑和删除交换机之后失效
+    std::atomic<bool> stop(false);
+    std::atomic<size_t> reads(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++)
+        readers.emplace_back([&]()
+                             {
+                                 while (stop == false)
+                                 {
+                                     size_t n = bmp->getExchangeBindings("exchange8")->size();
+                                     ASSERT_LE(n, 1000);
+                                     reads++;
+                                 } });
+    for (int i = 0; i < 1000; i++)
+        bmp->bind("exchange8", "queue" + std::to_string(i), "news.#", false);
+    ASSERT_EQ(bmp->getExchangeBindings("exchange8")->size(), 1000);
+    bmp->removeExchangeBindings("exchange8");
+    ASSERT_TRUE(bmp->getExchangeBindings("exchange8")->empty());
+    bmp->bind("exchange8", "queue1", "news.#", false);
+    while (reads == 0)
+        std::this_thread::yield();
+    stop = true;
+    for (auto &reader : readers)
+        reader.join();
+    ASSERT_GT(reads, 0);
+    std::thread checker([]()
+                        { ASSERT_EQ(bmp->getExchangeBindings("exchange8")->size(), 1); });
+    checker.join();
+    bmp->removeExchangeBindings("exchange8");
+}
+
+TEST(bind_test, cache_limit_test)
+{
+    // 已移除的交换机不会留在线程缓存中 缓存项数量有上限
+    size_t cached = bmp->cachedCount();
+    for (int i = 0; i < 100; i++)
+    {
+        std::string ename = "temp_exchange" + std::to_string(i);
+        bmp->bind(ename, "queue1", "news.#", false);
+        ASSERT_EQ(bmp->getExchangeBindings(ename)->size(), 1);
+        bmp->removeExchangeBindings(ename);
+        ASSERT_TRUE(bmp->getExchangeBindings(ename)->empty());
+    }
+    ASSERT_EQ(bmp->cachedCount(), cached);
+    for (size_t i = 0; i < XuMQ::BINDING_CACHE_LIMIT * 2; i++)
+        bmp->getExchangeBindings("missing_exchange" + std::to_string(i));
+    ASSERT_LE(bmp->cachedCount(), XuMQ::BINDING_CACHE_LIMIT);
+}
+
 // TEST(bind_test, insert_test)
 // {
 //     bmp->bind("exchange1", "queue1", "news.music.#", true);
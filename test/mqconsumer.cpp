@@ -17,7 +17,7 @@ public:
     }
 };
 
-void CallBack(const std::string &tag, const XuMQ::BasicProperties *bp, const std::string &body)
+void CallBack(const std::string &tag, const std::string &qname, uint64_t delivery_tag, const XuMQ::BasicProperties *bp, const std::string &body)
 {
     DEBUG("tag %s 消费了消息: %s", tag.c_str(), body.c_str());
 }
@@ -1,7 +1,7 @@
 #include "../server/host.hpp"
 #include <gtest/gtest.h>
 
-using none_map = std::unordered_map<std::string, std::string>;
+using none_map = google::protobuf::Map<std::string, std::string>;
 
 class HostTest : public testing::Test
 {
@@ -10,29 +10,29 @@ public:
     {
         none_map map = none_map();
         _host = std::make_shared<XuMQ::VirtualHost>("host1", "./data/host1/message", "./data/host1/host1.db");
-        _host->declareExchange("exchange1", XuMQ::ExchangeType::DIRECT, true, false, map);
-        _host->declareExchange("exchange2", XuMQ::ExchangeType::DIRECT, true, false, map);
-        _host->declareExchange("exchange3", XuMQ::ExchangeType::DIRECT, true, false, map);
+        ASSERT_TRUE(_host->declareExchange("exchange1", XuMQ::ExchangeType::DIRECT, true, false, map));
+        ASSERT_TRUE(_host->declareExchange("exchange2", XuMQ::ExchangeType::DIRECT, true, false, map));
+        ASSERT_TRUE(_host->declareExchange("exchange3", XuMQ::ExchangeType::DIRECT, true, false, map));
 
-        _host->declareQueue("queue1", true, false, false, map);
-        _host->declareQueue("queue2", true, false, false, map);
-        _host->declareQueue("queue3", true, false, false, map);
+        ASSERT_TRUE(_host->declareQueue("queue1", true, false, false, map));
+        ASSERT_TRUE(_host->declareQueue("queue2", true, false, false, map));
+        ASSERT_TRUE(_host->declareQueue("queue3", true, false, false, map));
 
-        _host->bind("exchange1", "queue1", "news.music.#");
-        _host->bind("exchange1", "queue2", "news.music.#");
-        _host->bind("exchange1", "queue3", "news.music.#");
+        ASSERT_TRUE(_host->bind("exchange1", "queue1", "news.music.#"));
+        ASSERT_TRUE(_host->bind("exchange1", "queue2", "news.music.#"));
+        ASSERT_TRUE(_host->bind("exchange1", "queue3", "news.music.#"));
 
-        _host->bind("exchange2", "queue2", "news.music.#");
-        _host->bind("exchange2", "queue3", "news.music.#");
+        ASSERT_TRUE(_host->bind("exchange2", "queue2", "news.music.#"));
+        ASSERT_TRUE(_host->bind("exchange2", "queue3", "news.music.#"));
 
-        _host->bind("exchange3", "queue3", "news.music.#");
+        ASSERT_TRUE(_host->bind("exchange3", "queue3", "news.music.#"));
 
-        _host->basicPublish("queue1", nullptr, "hello world 1");
-        _host->basicPublish("queue1", nullptr, "hello world 2");
-        _host->basicPublish("queue1", nullptr, "hello world 3");
-        _host->basicPublish("queue2", nullptr, "hello world 1");
-        _host->basicPublish("queue2", nullptr, "hello world 2");
-        _host->basicPublish("queue3", nullptr, "hello world 1");
+        ASSERT_TRUE(_host->basicPublish("queue1", nullptr, "hello world 1"));
+        ASSERT_TRUE(_host->basicPublish("queue1", nullptr, "hello world 2"));
+        ASSERT_TRUE(_host->basicPublish("queue1", nullptr, "hello world 3"));
+        ASSERT_TRUE(_host->basicPublish("queue2", nullptr, "hello world 1"));
+        ASSERT_TRUE(_host->basicPublish("queue2", nullptr, "hello world 2"));
+        ASSERT_TRUE(_host->basicPublish("queue3", nullptr, "hello world 1"));
     }
     virtual void TearDown() override
     {
@@ -45,6 +45,7 @@ public:
 
 TEST_F(HostTest, init_test)
 {
+    uint64_t tag;
     ASSERT_TRUE(_host->existsExchange("exchange1"));
     ASSERT_TRUE(_host->existsExchange("exchange2"));
     ASSERT_TRUE(_host->existsExchange("exchange3"));
@@ -59,13 +60,13 @@ TEST_F(HostTest, init_test)
     ASSERT_TRUE(_host->existsBinding("exchange2", "queue3"));
     ASSERT_TRUE(_host->existsBinding("exchange3", "queue3"));
 
-    XuMQ::MessagePtr msg1 = _host->basicConsume("queue1");
-    ASSERT_EQ(msg1->payload().body(), std::string("hello world 1"));
-    XuMQ::MessagePtr msg2 = _host->basicConsume("queue1");
-    ASSERT_EQ(msg2->payload().body(), std::string("hello world 2"));
-    XuMQ::MessagePtr msg3 = _host->basicConsume("queue1");
-    ASSERT_EQ(msg3->payload().body(), std::string("hello world 3"));
-    XuMQ::MessagePtr msg4 = _host->basicConsume("queue1");
+    XuMQ::MessagePtr msg1 = _host->basicConsume("queue1", tag);
+    ASSERT_EQ(msg1->body(), std::string("hello world 1"));
+    XuMQ::MessagePtr msg2 = _host->basicConsume("queue1", tag);
+    ASSERT_EQ(msg2->body(), std::string("hello world 2"));
+    XuMQ::MessagePtr msg3 = _host->basicConsume("queue1", tag);
+    ASSERT_EQ(msg3->body(), std::string("hello world 3"));
+    XuMQ::MessagePtr msg4 = _host->basicConsume("queue1", tag);
     ASSERT_EQ(msg4.get(), nullptr);
 }
 
@@ -79,26 +80,32 @@ TEST_F(HostTest, delete_exchange)
 
 TEST_F(HostTest, delete_queue)
 {
+    uint64_t tag;
     _host->deleteQueue("queue3");
     ASSERT_FALSE(_host->existsBinding("exchange1", "queue3"));
     ASSERT_FALSE(_host->existsBinding("exchange2", "queue3"));
     ASSERT_FALSE(_host->existsBinding("exchange3", "queue3"));
-    XuMQ::MessagePtr msg1 = _host->basicConsume("queue3");
+    XuMQ::MessagePtr msg1 = _host->basicConsume("queue3", tag);
     ASSERT_EQ(msg1.get(), nullptr);
 }
 
 TEST_F(HostTest, ack_msg)
 {
-    XuMQ::MessagePtr msg1 = _host->basicConsume("queue2");
+    uint64_t tag1, tag2, tag3;
+    XuMQ::MessagePtr msg1 = _host->basicConsume("queue2", tag1);
     ASSERT_NE(msg1.get(), nullptr);
-    ASSERT_EQ(msg1->payload().body(), std::string("hello world 1"));
-    _host->basicAck("queue2", msg1->payload().properties().id());
-    XuMQ::MessagePtr msg2 = _host->basicConsume("queue2");
+    ASSERT_EQ(msg1->body(), std::string("hello world 1"));
+    ASSERT_TRUE(_host->basicAck("queue2", tag1));
+    XuMQ::MessagePtr msg2 = _host->basicConsume("queue2", tag2);
     ASSERT_NE(msg2.get(), nullptr);
-    _host->basicAck("queue2", msg2->payload().properties().id());
-    ASSERT_EQ(msg2->payload().body(), std::string("hello world 2"));
-    XuMQ::MessagePtr msg3 = _host->basicConsume("queue2");
+    ASSERT_NE(tag2, tag1);
+    ASSERT_EQ(msg2->body(), std::string("hello world 2"));
+    ASSERT_TRUE(_host->basicAck("queue2", tag2));
+    // 已确认的投递标识不能重复确认
+    ASSERT_FALSE(_host->basicAck("queue2", tag1));
+    XuMQ::MessagePtr msg3 = _host->basicConsume("queue2", tag3);
     ASSERT_EQ(msg3.get(), nullptr);
+    ASSERT_EQ(_host->availableCount("queue2"), 0);
 }
 
 int main(int argc, char *argv[])
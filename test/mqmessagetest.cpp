@@ -97,6 +97,749 @@ public:
     
 // }
 
+/// @brief 取出队头消息并立即确认
+static void ackFront(XuMQ::MessageManager &mmp, const std::string &qname)
+{
+    uint64_t tag;
+    mmp.front(qname, tag);
+    mmp.ack(qname, tag);
+}
+
+TEST(message_test, durability_test)
+{
+    // 一条消息一次刷盘时 8个线程并发发布也只需要远少于1600次刷盘
+    XuMQ::MessageManager dmp("./data/durable/");
+    google::protobuf::Map<std::string, std::string> args;
+    args["x-durability"] = "confirm";
+    dmp.initQueueMessage("queue1", args);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; i++)
+        threads.emplace_back([&dmp]()
+                             { for (int j = 0; j < 200; j++) dmp.insert("queue1", nullptr, "hello durable", true); });
+    for (auto &thread : threads)
+        thread.join();
+    ASSERT_EQ(dmp.durableCount("queue1"), 1600);
+    ASSERT_GT(dmp.syncCount("queue1"), 0);
+    ASSERT_LT(dmp.syncCount("queue1"), 800);
+    dmp.destroyQueueMessage("queue1");
+}
+
+TEST(message_test, batch_sync_test)
+{
+    // 每100条消息刷盘一次 关闭定时兜底后1600条消息恰好刷盘16次
+    XuMQ::MessageManager dmp("./data/batch/");
+    google::protobuf::Map<std::string, std::string> args;
+    args["x-durability"] = "batch";
+    args["x-fsync-batch"] = "100";
+    args["x-fsync-interval-ms"] = "0";
+    dmp.initQueueMessage("queue1", args);
+    for (int i = 0; i < 1600; i++)
+        dmp.insert("queue1", nullptr, "hello batch", true);
+    ASSERT_EQ(dmp.durableCount("queue1"), 1600);
+    ASSERT_EQ(dmp.syncCount("queue1"), 16);
+    dmp.destroyQueueMessage("queue1");
+}
+
+TEST(message_test, interval_sync_test)
+{
+    // 发布时不刷盘 后台线程每50毫秒最多刷盘一次
+    XuMQ::MessageManager dmp("./data/interval/");
+    google::protobuf::Map<std::string, std::string> args;
+    args["x-durability"] = "interval";
+    args["x-fsync-interval-ms"] = "50";
+    dmp.initQueueMessage("queue1", args);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 1600; i++)
+        dmp.insert("queue1", nullptr, "hello interval", true);
+    for (int i = 0; i < 50 && dmp.syncCount("queue1") == 0; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    ASSERT_EQ(dmp.durableCount("queue1"), 1600);
+    ASSERT_GT(dmp.syncCount("queue1"), 0);
+    ASSERT_LE(dmp.syncCount("queue1"), (size_t)elapsed / 50 + 1);
+    dmp.destroyQueueMessage("queue1");
+}
+
+TEST(message_test, compaction_test)
+{
+    // 确认大部分消息后 后台线程压缩数据段 剩余消息仍可按顺序获取
+    XuMQ::MessageManager cmp("./data/compact/");
+    cmp.setCompactionRate(0);
+    cmp.initQueueMessage("queue1");
+    for (int i = 0; i < 3000; i++)
+        cmp.insert("queue1", nullptr, "hello compact " + std::to_string(i), true);
+    for (int i = 0; i < 2000; i++)
+        ackFront(cmp, "queue1");
+    ASSERT_EQ(cmp.totalCount("queue1"), 3000);
+    for (int i = 0; i < 50 && cmp.totalCount("queue1") != 1000; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_EQ(cmp.totalCount("queue1"), 1000);
+    ASSERT_EQ(cmp.front("queue1")->body(), std::string("hello compact 2000"));
+    cmp.destroyQueueMessage("queue1");
+}
+
+TEST(message_test, checkpoint_test)
+{
+    // 退出时写入检查点 重启后按检查点恢复 数据段不会被重写
+    {
+        XuMQ::MessageManager cmp("./data/checkpoint/");
+        cmp.initQueueMessage("queue1");
+        for (int i = 0; i < 100; i++)
+            cmp.insert("queue1", nullptr, "hello checkpoint " + std::to_string(i), true);
+        for (int i = 0; i < 10; i++)
+            ackFront(cmp, "queue1");
+    }
+    ASSERT_TRUE(XuMQ::FileHelper("./data/checkpoint/queue1/checkpoint").exists());
+    XuMQ::MessageManager cmp("./data/checkpoint/");
+    cmp.initQueueMessage("queue1");
+    ASSERT_EQ(cmp.availableCount("queue1"), 90);
+    ASSERT_EQ(cmp.totalCount("queue1"), 100);
+    ASSERT_EQ(cmp.front("queue1")->body(), std::string("hello checkpoint 10"));
+    cmp.destroyQueueMessage("queue1");
+}
+
+static size_t segmentCount(const std::string &dirname)
+{
+    std::vector<std::string> files;
+    XuMQ::FileHelper::listDirectory(dirname, files);
+    size_t count = 0;
+    for (auto &file : files)
+        count += file.size() > 4 && file.compare(file.size() - 4, 4, ".mqd") == 0;
+    return count;
+}
+
+TEST(message_test, acklog_test)
+{
+    // 没有检查点时完整加载数据段 按确认日志中的墓碑跳过已确认的消息
+    {
+        XuMQ::MessageManager amp("./data/acklog/");
+        amp.initQueueMessage("queue1");
+        for (int i = 0; i < 100; i++)
+            amp.insert("queue1", nullptr, "hello acklog " + std::to_string(i), true);
+        for (int i = 0; i < 30; i++)
+            ackFront(amp, "queue1");
+    }
+    ASSERT_TRUE(XuMQ::FileHelper("./data/acklog/queue1/ack.log").exists());
+    ASSERT_TRUE(XuMQ::FileHelper::removeFile("./data/acklog/queue1/checkpoint"));
+    XuMQ::MessageManager amp("./data/acklog/");
+    amp.initQueueMessage("queue1");
+    ASSERT_EQ(amp.availableCount("queue1"), 70);
+    ASSERT_EQ(amp.front("queue1")->body(), std::string("hello acklog 30"));
+    amp.destroyQueueMessage("queue1");
+}
+
+TEST(message_test, retire_test)
+{
+    // 已封存的段中的消息全部确认后 段文件立即删除 不等待后台压缩
+    XuMQ::MessageManager rmp("./data/retire/");
+    rmp.initQueueMessage("queue1");
+    std::string body(4 * 1024 * 1024, 'x');
+    // 写满第一个段 最后一条消息滚动到第二个段
+    size_t count = 0;
+    while (segmentCount("./data/retire/queue1/") < 2)
+    {
+        ASSERT_TRUE(rmp.insert("queue1", nullptr, body, true));
+        count++;
+    }
+    // 先取出再集中确认 后台压缩来不及处理存活率降低的段
+    std::vector<uint64_t> tags(count - 1);
+    for (auto &tag : tags)
+        rmp.front("queue1", tag);
+    for (size_t i = 0; i < tags.size() - 1; i++)
+        ASSERT_TRUE(rmp.ack("queue1", tags[i]));
+    ASSERT_EQ(segmentCount("./data/retire/queue1/"), 2);
+    ASSERT_TRUE(rmp.ack("queue1", tags.back()));
+    ASSERT_EQ(segmentCount("./data/retire/queue1/"), 1);
+    ASSERT_FALSE(XuMQ::FileHelper("./data/retire/queue1/0000000000.mqd").exists());
+    ASSERT_EQ(rmp.availableCount("queue1"), 1);
+    rmp.destroyQueueMessage("queue1");
+}
+
+TEST(message_test, parallel_recovery_test)
+{
+    // 多个线程并行恢复多个队列 每个队列恢复各自的消息
+    std::vector<std::pair<std::string, XuMQ::QueueArgs>> queues;
+    {
+        XuMQ::MessageManager pmp("./data/recovery/");
+        for (int q = 0; q < 8; q++)
+        {
+            std::string qname = "queue" + std::to_string(q);
+            queues.push_back(std::make_pair(qname, XuMQ::QueueArgs()));
+            pmp.initQueueMessage(qname);
+            for (int i = 0; i < 10 * (q + 1); i++)
+                pmp.insert(qname, nullptr, "hello recovery " + std::to_string(i), true);
+            for (int i = 0; i < q; i++)
+                ackFront(pmp, qname);
+        }
+    }
+    XuMQ::MessageManager pmp("./data/recovery/");
+    pmp.recoverQueueMessages(queues, 4);
+    for (int q = 0; q < 8; q++)
+    {
+        std::string qname = "queue" + std::to_string(q);
+        ASSERT_EQ(pmp.availableCount(qname), 10 * (q + 1) - q);
+        ASSERT_EQ(pmp.front(qname)->body(), "hello recovery " + std::to_string(q));
+        pmp.destroyQueueMessage(qname);
+    }
+}
+
+TEST(message_test, journal_test)
+{
+    // 共享日志模式下扇出的消息写入同一个日志 重启后各队列恢复自己的消息 删除的队列不会复活
+    {
+        XuMQ::MessageManager jmp("./data/journal/", XuMQ::DurabilityPolicy(), XuMQ::StorageMode::SHARED_JOURNAL);
+        for (int q = 0; q < 3; q++)
+            jmp.initQueueMessage("queue" + std::to_string(q));
+        for (int i = 0; i < 100; i++)
+            for (int q = 0; q < 3; q++)
+                jmp.insert("queue" + std::to_string(q), nullptr, "hello journal " + std::to_string(i), true);
+        for (int i = 0; i < 10; i++)
+            ackFront(jmp, "queue0");
+        jmp.destroyQueueMessage("queue2");
+        jmp.initQueueMessage("queue2");
+    }
+    ASSERT_FALSE(XuMQ::FileHelper("./data/journal/queue0/0000000000.mqd").exists());
+    XuMQ::MessageManager jmp("./data/journal/", XuMQ::DurabilityPolicy(), XuMQ::StorageMode::SHARED_JOURNAL);
+    std::vector<std::pair<std::string, XuMQ::QueueArgs>> queues;
+    for (int q = 0; q < 3; q++)
+        queues.push_back(std::make_pair("queue" + std::to_string(q), XuMQ::QueueArgs()));
+    jmp.recoverQueueMessages(queues);
+    ASSERT_EQ(jmp.availableCount("queue0"), 90);
+    ASSERT_EQ(jmp.availableCount("queue1"), 100);
+    ASSERT_EQ(jmp.availableCount("queue2"), 0);
+    ASSERT_EQ(jmp.front("queue0")->body(), std::string("hello journal 10"));
+    ASSERT_EQ(jmp.front("queue1")->body(), std::string("hello journal 0"));
+    for (int q = 0; q < 3; q++)
+        jmp.destroyQueueMessage("queue" + std::to_string(q));
+}
+
+TEST(message_test, duplicate_id_test)
+{
+    // 消息id由应用填写 相同id或没有id的持久化消息重启后都不能合并
+    XuMQ::BasicProperties same, empty;
+    same.set_id("same-id");
+    same.set_delivery_mode(XuMQ::DeliveryMode::DURABLE);
+    empty.set_delivery_mode(XuMQ::DeliveryMode::DURABLE);
+    for (auto mode : {XuMQ::StorageMode::PER_QUEUE, XuMQ::StorageMode::SHARED_JOURNAL})
+    {
+        std::string dir = mode == XuMQ::StorageMode::PER_QUEUE ? "./data/dupid/" : "./data/dupid_journal/";
+        {
+            XuMQ::MessageManager dmp(dir, XuMQ::DurabilityPolicy(), mode);
+            dmp.initQueueMessage("queue1");
+            for (int i = 0; i < 3; i++)
+                dmp.insert("queue1", &same, "hello same " + std::to_string(i), true);
+            for (int i = 0; i < 3; i++)
+                dmp.insert("queue1", &empty, "hello empty " + std::to_string(i), true);
+        }
+        XuMQ::FileHelper::removeFile(dir + "queue1/checkpoint"); // 走完整加载的路径
+        XuMQ::MessageManager dmp(dir, XuMQ::DurabilityPolicy(), mode);
+        std::vector<std::pair<std::string, XuMQ::QueueArgs>> queues;
+        queues.push_back(std::make_pair("queue1", XuMQ::QueueArgs()));
+        dmp.recoverQueueMessages(queues);
+        ASSERT_EQ(dmp.availableCount("queue1"), 6);
+        ASSERT_EQ(dmp.front("queue1")->body(), std::string("hello same 0"));
+        ASSERT_EQ(dmp.front("queue1")->body(), std::string("hello same 1"));
+        dmp.destroyQueueMessage("queue1");
+    }
+}
+
+TEST(message_test, fanout_test)
+{
+    // 扇出的消息在各队列间共享 共享日志中每条消息只写入一条记录 被所有队列确认后才回收
+    std::vector<std::pair<std::string, bool>> queues;
+    for (int q = 0; q < 3; q++)
+        queues.push_back(std::make_pair("queue" + std::to_string(q), true));
+    {
+        XuMQ::MessageManager fmp("./data/fanout/", XuMQ::DurabilityPolicy(), XuMQ::StorageMode::SHARED_JOURNAL);
+        for (auto &queue : queues)
+            fmp.initQueueMessage(queue.first);
+        for (int i = 0; i < 100; i++)
+            ASSERT_TRUE(fmp.insert(queues, nullptr, "hello fanout " + std::to_string(i)));
+        uint64_t tag0, tag1;
+        XuMQ::MessagePtr msg = fmp.front("queue0", tag0);
+        ASSERT_EQ(msg.get(), fmp.front("queue1", tag1).get());
+        ASSERT_EQ(msg.get(), fmp.front("queue2").get());
+        fmp.ack("queue0", tag0);
+        fmp.ack("queue1", tag1);
+    }
+    XuMQ::MessageManager fmp("./data/fanout/", XuMQ::DurabilityPolicy(), XuMQ::StorageMode::SHARED_JOURNAL);
+    for (auto &queue : queues)
+        fmp.initQueueMessage(queue.first);
+    ASSERT_EQ(fmp.availableCount("queue0"), 99);
+    ASSERT_EQ(fmp.availableCount("queue2"), 100);
+    ASSERT_EQ(fmp.front("queue2")->body(), std::string("hello fanout 0"));
+    XuMQ::MessagePtr msg = fmp.front("queue0");
+    ASSERT_EQ(msg->body(), std::string("hello fanout 1"));
+    ASSERT_EQ(msg.get(), fmp.front("queue1").get());
+    for (auto &queue : queues)
+        fmp.destroyQueueMessage(queue.first);
+}
+
+TEST(message_test, lazy_test)
+{
+    // 惰性队列只保留消息引用 投递前从磁盘读回 重启后同样按顺序读回
+    google::protobuf::Map<std::string, std::string> args;
+    args["x-queue-mode"] = "lazy";
+    {
+        XuMQ::MessageManager lmp("./data/lazy/");
+        lmp.initQueueMessage("queue1", args);
+        for (int i = 0; i < 100; i++)
+            lmp.insert("queue1", nullptr, "hello lazy " + std::to_string(i), true);
+        lmp.insert("queue1", nullptr, "hello lazy transient", false);
+        for (int i = 0; i < 10; i++)
+        {
+            uint64_t tag;
+            XuMQ::MessagePtr msg = lmp.front("queue1", tag);
+            ASSERT_EQ(msg->body(), "hello lazy " + std::to_string(i));
+            lmp.ack("queue1", tag);
+        }
+    }
+    XuMQ::MessageManager lmp("./data/lazy/");
+    lmp.initQueueMessage("queue1", args);
+    ASSERT_EQ(lmp.availableCount("queue1"), 90);
+    for (int i = 10; i < 100; i++)
+        ASSERT_EQ(lmp.front("queue1")->body(), "hello lazy " + std::to_string(i));
+    lmp.destroyQueueMessage("queue1");
+}
+
+TEST(message_test, lazy_requeue_test)
+{
+    // 惰性队列投递后只释放持久化消息的消息体 退回的持久化消息从磁盘读回 非持久化消息仍在内存中
+    google::protobuf::Map<std::string, std::string> args;
+    args["x-queue-mode"] = "lazy";
+    XuMQ::MessageManager lmp("./data/lazy_requeue/");
+    lmp.initQueueMessage("queue1", args);
+    lmp.insert("queue1", nullptr, "hello lazy durable", true);
+    lmp.insert("queue1", nullptr, "hello lazy transient", false);
+    uint64_t durable, transient, tag;
+    ASSERT_EQ(lmp.front("queue1", durable)->body(), "hello lazy durable");
+    ASSERT_EQ(lmp.front("queue1", transient)->body(), "hello lazy transient");
+    ASSERT_TRUE(lmp.requeue("queue1", transient));
+    ASSERT_TRUE(lmp.requeue("queue1", durable));
+    ASSERT_EQ(lmp.front("queue1", tag)->body(), "hello lazy durable");
+    ASSERT_EQ(lmp.front("queue1", tag)->body(), "hello lazy transient");
+    lmp.destroyQueueMessage("queue1");
+}
+
+TEST(message_test, compression_test)
+{
+    // 开启压缩的队列将记录攒成压缩块写出 重启后透明地解压
+    google::protobuf::Map<std::string, std::string> args;
+    args["x-compression"] = "zlib";
+    std::string body = "{\"user\":\"xu\",\"action\":\"publish\",\"data\":\"" + std::string(200, 'a') + "\"}";
+    {
+        XuMQ::MessageManager zmp("./data/compress/");
+        zmp.initQueueMessage("queue1", args);
+        for (int i = 0; i < 1000; i++)
+            zmp.insert("queue1", nullptr, body + std::to_string(i), true);
+        for (int i = 0; i < 10; i++)
+            ackFront(zmp, "queue1");
+    }
+    std::vector<std::string> files;
+    XuMQ::FileHelper::listDirectory("./data/compress/queue1/", files);
+    size_t disk = 0;
+    for (auto &file : files)
+        if (file.find(".mqd") != std::string::npos)
+            disk += XuMQ::FileHelper("./data/compress/queue1/" + file).size();
+    ASSERT_GT(disk, 0);
+    ASSERT_LT(disk, 1000 * body.size() / 4);
+    XuMQ::MessageManager zmp("./data/compress/");
+    zmp.initQueueMessage("queue1", args);
+    ASSERT_EQ(zmp.availableCount("queue1"), 990);
+    for (int i = 10; i < 1000; i++)
+        ASSERT_EQ(zmp.front("queue1")->body(), body + std::to_string(i));
+    zmp.destroyQueueMessage("queue1");
+}
+
+TEST(message_test, lazy_compression_test)
+{
+    // 惰性队列投递还在压缩块中的消息时先写出压缩块 退回后可以从磁盘读回
+    google::protobuf::Map<std::string, std::string> args;
+    args["x-queue-mode"] = "lazy";
+    args["x-compression"] = "zlib";
+    XuMQ::MessageManager lmp("./data/lazy_compress/");
+    lmp.initQueueMessage("queue1", args);
+    for (int i = 0; i < 3; i++)
+        lmp.insert("queue1", nullptr, "hello lazy block " + std::to_string(i), true);
+    uint64_t tag;
+    ASSERT_EQ(lmp.front("queue1", tag)->body(), "hello lazy block 0");
+    ASSERT_TRUE(lmp.requeue("queue1", tag));
+    for (int i = 0; i < 3; i++)
+        ASSERT_EQ(lmp.front("queue1", tag)->body(), "hello lazy block " + std::to_string(i));
+    lmp.destroyQueueMessage("queue1");
+}
+
+TEST(message_test, watermark_test)
+{
+    // 内存占用超过高水位后换出消息 非持久化消息写入换出日志 投递时按顺序读回
+    XuMQ::MessageManager wmp("./data/watermark/");
+    wmp.setMemoryWatermark(256 * 1024);
+    wmp.initQueueMessage("queue1");
+    std::string padding(1024, 'x');
+    for (int i = 0; i < 2000; i++)
+        wmp.insert("queue1", nullptr, "hello watermark " + std::to_string(i) + padding, i % 2 == 0);
+    // 换出由后台线程完成 等待内存占用回落
+    for (int i = 0; i < 100 && wmp.memoryUsage() > 256 * 1024; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_LE(wmp.memoryUsage(), 256 * 1024);
+    for (int i = 0; i < 2000; i++)
+    {
+        uint64_t tag;
+        XuMQ::MessagePtr msg = wmp.front("queue1", tag);
+        ASSERT_EQ(msg->body(), "hello watermark " + std::to_string(i) + padding);
+        wmp.ack("queue1", tag);
+    }
+    ASSERT_EQ(wmp.memoryUsage(), 0);
+    wmp.destroyQueueMessage("queue1");
+}
+
+TEST(message_test, fanout_watermark_test)
+{
+    // 多个队列共享的消息体只计入一次内存占用 所有队列释放后才扣除
+    XuMQ::MessageManager wmp("./data/watermark/");
+    std::vector<std::pair<std::string, bool>> queues;
+    for (int i = 0; i < 4; i++)
+    {
+        wmp.initQueueMessage("queue" + std::to_string(i));
+        queues.push_back(std::make_pair("queue" + std::to_string(i), false));
+    }
+    std::string padding(1024, 'x');
+    for (int i = 0; i < 100; i++)
+        ASSERT_TRUE(wmp.insert(queues, nullptr, "hello fanout " + std::to_string(i) + padding));
+    size_t usage = wmp.memoryUsage();
+    ASSERT_GT(usage, 100 * 1024);
+    ASSERT_LT(usage, 2 * 100 * 1024);
+    for (int i = 0; i < 3; i++)
+        wmp.destroyQueueMessage("queue" + std::to_string(i));
+    ASSERT_GT(wmp.memoryUsage(), 100 * 1024);
+    wmp.destroyQueueMessage("queue3");
+    ASSERT_EQ(wmp.memoryUsage(), 0);
+}
+
+TEST(message_test, store_test)
+{
+    // 各存储引擎行为一致 只有内存存储重启后不恢复消息
+    for (std::string store : {"file", "memory", "ring", "btree"})
+    {
+        google::protobuf::Map<std::string, std::string> args;
+        args["x-store"] = store;
+        {
+            XuMQ::MessageManager smp("./data/store/");
+            smp.initQueueMessage("queue1", args);
+            for (int i = 0; i < 100; i++)
+                smp.insert("queue1", nullptr, "hello " + store + " " + std::to_string(i), true);
+            for (int i = 0; i < 10; i++)
+            {
+                uint64_t tag;
+                XuMQ::MessagePtr msg = smp.front("queue1", tag);
+                ASSERT_EQ(msg->body(), "hello " + store + " " + std::to_string(i));
+                smp.ack("queue1", tag);
+            }
+            ASSERT_EQ(smp.durableCount("queue1"), 90);
+        }
+        XuMQ::MessageManager smp("./data/store/");
+        smp.initQueueMessage("queue1", args);
+        if (store == "memory")
+        {
+            ASSERT_EQ(smp.availableCount("queue1"), 0);
+        }
+        else
+        {
+            ASSERT_EQ(smp.availableCount("queue1"), 90);
+            for (int i = 10; i < 100; i++)
+                ASSERT_EQ(smp.front("queue1")->body(), "hello " + store + " " + std::to_string(i));
+        }
+        smp.destroyQueueMessage("queue1");
+    }
+    // 环形存储绕过数据区末尾多圈后 重启仍然按顺序恢复未确认的消息 环满时发布失败
+    google::protobuf::Map<std::string, std::string> args;
+    args["x-store"] = "ring";
+    args["x-ring-size"] = "8192";
+    std::string padding(300, 'r');
+    {
+        XuMQ::MessageManager rmp("./data/store/");
+        rmp.initQueueMessage("queue1", args);
+        for (int i = 0; i < 200; i++)
+        {
+            ASSERT_TRUE(rmp.insert("queue1", nullptr, std::to_string(i) + padding, true));
+            if (i >= 5)
+                ackFront(rmp, "queue1");
+        }
+        ASSERT_LT(rmp.totalCount("queue1"), 10);
+    }
+    XuMQ::MessageManager rmp("./data/store/");
+    rmp.initQueueMessage("queue1", args);
+    ASSERT_EQ(rmp.availableCount("queue1"), 5);
+    for (int i = 195; i < 200; i++)
+        ASSERT_EQ(rmp.front("queue1")->body(), std::to_string(i) + padding);
+    bool full = false;
+    for (int i = 0; i < 100 && full == false; i++)
+        full = rmp.insert("queue1", nullptr, padding, true) == false;
+    ASSERT_TRUE(full);
+    rmp.destroyQueueMessage("queue1");
+}
+
+TEST(message_test, btree_test)
+{
+    // 虚拟机默认使用B+树存储 乱序确认的消息重启后不再出现
+    XuMQ::DurabilityPolicy policy;
+    policy.store = "btree";
+    std::vector<uint64_t> tags(100);
+    {
+        XuMQ::MessageManager bmp("./data/btree/", policy);
+        bmp.initQueueMessage("queue1");
+        for (int i = 0; i < 100; i++)
+            bmp.insert("queue1", nullptr, "hello btree " + std::to_string(i), true);
+        for (int i = 0; i < 100; i++)
+            bmp.front("queue1", tags[i]);
+        for (int i = 0; i < 100; i += 3)
+            ASSERT_TRUE(bmp.ack("queue1", tags[i]));
+        ASSERT_EQ(bmp.totalCount("queue1"), 66);
+    }
+    XuMQ::MessageManager bmp("./data/btree/", policy);
+    bmp.initQueueMessage("queue1");
+    ASSERT_EQ(bmp.availableCount("queue1"), 66);
+    for (int i = 0; i < 100; i++)
+    {
+        if (i % 3 != 0)
+        {
+            ASSERT_EQ(bmp.front("queue1")->body(), "hello btree " + std::to_string(i));
+        }
+    }
+    // 删除队列时删除其所有消息 同名队列重新声明后为空
+    bmp.destroyQueueMessage("queue1");
+    bmp.initQueueMessage("queue1");
+    ASSERT_EQ(bmp.availableCount("queue1"), 0);
+    bmp.destroyQueueMessage("queue1");
+}
+
+TEST(message_test, purge_test)
+{
+    // 清空队列丢弃待推送的消息 已推送未确认的消息保留 确认和重启后的恢复不受影响
+    std::vector<std::pair<std::string, XuMQ::StorageMode>> cases = {
+        {"file", XuMQ::StorageMode::PER_QUEUE}, {"ring", XuMQ::StorageMode::PER_QUEUE},
+        {"btree", XuMQ::StorageMode::PER_QUEUE}, {"file", XuMQ::StorageMode::SHARED_JOURNAL}};
+    for (auto &c : cases)
+    {
+        google::protobuf::Map<std::string, std::string> args;
+        args["x-store"] = c.first;
+        {
+            XuMQ::MessageManager pmp("./data/purge/", XuMQ::DurabilityPolicy(), c.second);
+            pmp.initQueueMessage("queue1", args);
+            for (int i = 0; i < 100; i++)
+                pmp.insert("queue1", nullptr, "hello purge " + std::to_string(i), true);
+            std::vector<uint64_t> tags(3);
+            for (int i = 0; i < 3; i++)
+                pmp.front("queue1", tags[i]);
+            ASSERT_EQ(pmp.purgeQueueMessage("queue1"), 97);
+            ASSERT_EQ(pmp.availableCount("queue1"), 0);
+            ASSERT_EQ(pmp.waitAckCount("queue1"), 3);
+            ASSERT_EQ(pmp.durableCount("queue1"), 3);
+            pmp.ack("queue1", tags[0]);
+            pmp.insert("queue1", nullptr, "after purge", true);
+        }
+        XuMQ::MessageManager pmp("./data/purge/", XuMQ::DurabilityPolicy(), c.second);
+        pmp.initQueueMessage("queue1", args);
+        ASSERT_EQ(pmp.availableCount("queue1"), 3);
+        ASSERT_EQ(pmp.front("queue1")->body(), "hello purge 1");
+        ASSERT_EQ(pmp.front("queue1")->body(), "hello purge 2");
+        ASSERT_EQ(pmp.front("queue1")->body(), "after purge");
+        pmp.destroyQueueMessage("queue1");
+    }
+}
+
+TEST(message_test, datadir_test)
+{
+    // 队列按名称分布到多个数据目录 目录顺序改变后重启仍在原来的目录中找到每个队列
+    std::vector<std::string> dirs = {"./data/disk0/", "./data/disk1/"};
+    {
+        XuMQ::MessageManager dmp(dirs);
+        for (int q = 0; q < 8; q++)
+        {
+            dmp.initQueueMessage("queue" + std::to_string(q));
+            for (int i = 0; i < 10; i++)
+                dmp.insert("queue" + std::to_string(q), nullptr, "hello disk " + std::to_string(i), true);
+        }
+    }
+    size_t placed[2] = {0, 0};
+    for (int q = 0; q < 8; q++)
+    {
+        for (int d = 0; d < 2; d++)
+            placed[d] += XuMQ::FileHelper(dirs[d] + "queue" + std::to_string(q)).exists();
+    }
+    ASSERT_EQ(placed[0] + placed[1], 8);
+    ASSERT_GT(placed[0], 0);
+    ASSERT_GT(placed[1], 0);
+    XuMQ::MessageManager dmp(std::vector<std::string>{dirs[1], dirs[0]}, XuMQ::DurabilityPolicy(),
+                             XuMQ::StorageMode::PER_QUEUE, XuMQ::PlacementPolicy::LEAST_USED);
+    for (int q = 0; q < 8; q++)
+    {
+        dmp.initQueueMessage("queue" + std::to_string(q));
+        ASSERT_EQ(dmp.availableCount("queue" + std::to_string(q)), 10);
+        ASSERT_EQ(dmp.front("queue" + std::to_string(q))->body(), "hello disk 0");
+        dmp.destroyQueueMessage("queue" + std::to_string(q));
+    }
+}
+
+TEST(message_test, packed_test)
+{
+    // 标准格式的 UUID 以二进制保存 转换回字符串不变
+    std::string uuid = XuMQ::UUIDHelper::uuid();
+    XuMQ::MessageId key;
+    ASSERT_TRUE(XuMQ::MessageId::parse(uuid, key));
+    ASSERT_EQ(key.str(), uuid);
+    ASSERT_FALSE(XuMQ::MessageId::parse("ORDER-42", key));
+    ASSERT_NE(XuMQ::MessageId::of("order-41"), XuMQ::MessageId::of("order-42"));
+    // 同一路由键的消息共享驻留的字符串
+    size_t interned = XuMQ::InternTable::instance().size();
+    {
+        auto a = XuMQ::PackedMessage::create(uuid, XuMQ::DeliveryMode::DURABLE, "news.sport", "hello");
+        auto b = XuMQ::PackedMessage::create("order-42", XuMQ::DeliveryMode::UNDURABLE, "news.sport", "");
+        ASSERT_EQ(&a->routingKey(), &b->routingKey());
+        ASSERT_EQ(XuMQ::InternTable::instance().size(), interned + 1);
+        ASSERT_EQ(a->id(), uuid);
+        ASSERT_EQ(b->id(), "order-42");
+        ASSERT_EQ(a->body(), "hello");
+        ASSERT_EQ(b->body(), "");
+        ASSERT_EQ(b->deliveryMode(), XuMQ::DeliveryMode::UNDURABLE);
+    }
+    ASSERT_EQ(XuMQ::InternTable::instance().size(), interned);
+    // 任意格式的 id 和路由键在重启后保持不变 并能按原来的 id 确认
+    {
+        XuMQ::MessageManager pmp("./data/packed/");
+        pmp.initQueueMessage("queue1");
+        XuMQ::BasicProperties bp;
+        for (int i = 0; i < 3; i++)
+        {
+            bp.set_id("order-" + std::to_string(i));
+            bp.set_delivery_mode(XuMQ::DeliveryMode::DURABLE);
+            bp.set_routing_key("orders.created");
+            pmp.insert("queue1", &bp, "hello packed " + std::to_string(i), true);
+        }
+        ackFront(pmp, "queue1");
+    }
+    XuMQ::MessageManager pmp("./data/packed/");
+    pmp.initQueueMessage("queue1");
+    ASSERT_EQ(pmp.availableCount("queue1"), 2);
+    for (int i = 1; i < 3; i++)
+    {
+        uint64_t tag;
+        XuMQ::MessagePtr msg = pmp.front("queue1", tag);
+        ASSERT_EQ(msg->id(), "order-" + std::to_string(i));
+        ASSERT_EQ(msg->routingKey(), "orders.created");
+        ASSERT_EQ(msg->body(), "hello packed " + std::to_string(i));
+        pmp.ack("queue1", tag);
+    }
+    ASSERT_EQ(pmp.waitAckCount("queue1"), 0);
+    pmp.destroyQueueMessage("queue1");
+}
+
+TEST(message_test, pending_test)
+{
+    // 跨越多个块的先进先出 放回队头 批量出队和遍历
+    XuMQ::PendingList list;
+    std::vector<XuMQ::MessageRef::ptr> refs;
+    for (int i = 0; i < 1000; i++)
+        refs.push_back(XuMQ::MessageRef::create(XuMQ::MessagePtr(), i + 1));
+    for (int i = 10; i < 1000; i++)
+        list.push_back(refs[i]);
+    for (int i = 9; i >= 0; i--)
+        list.push_front(refs[i]);
+    ASSERT_EQ(list.size(), 1000);
+    uint64_t expect = 1;
+    for (auto &ref : list)
+        ASSERT_EQ(ref->seq, expect++);
+    std::vector<XuMQ::MessageRef::ptr> popped;
+    ASSERT_EQ(list.pop_front(600, popped), 600);
+    ASSERT_EQ(popped.back()->seq, 600);
+    ASSERT_EQ(list.front()->seq, 601);
+    XuMQ::PendingList other;
+    other.swap(list);
+    ASSERT_TRUE(list.empty());
+    ASSERT_EQ(other.pop_front(1000, popped), 400);
+    ASSERT_TRUE(other.empty());
+    ASSERT_EQ(popped.back()->seq, 1000);
+
+    // 乱序确认时窗口只在最早的消息确认后滑动
+    XuMQ::DeliveryWindow<XuMQ::MessageRef::ptr> window(100);
+    for (int i = 0; i < 10; i++)
+        ASSERT_EQ(window.push(refs[i]), 100 + i);
+    XuMQ::MessageRef::ptr taken;
+    ASSERT_TRUE(window.take(105, taken));
+    ASSERT_EQ(taken->seq, 6);
+    ASSERT_FALSE(window.take(105, taken));
+    ASSERT_EQ(window.find(105), nullptr);
+    ASSERT_TRUE(window.take(100, taken));
+    ASSERT_EQ(window.find(99), nullptr);
+    ASSERT_EQ(window.size(), 8);
+    window.clear();
+    ASSERT_EQ(window.push(refs[0]), 110);
+
+    // 一条始终不确认的消息不会让窗口随后续投递无限增长
+    for (int i = 0; i < 100000; i++)
+    {
+        uint64_t tag = window.push(refs[1]);
+        ASSERT_TRUE(window.take(tag, taken));
+    }
+    ASSERT_EQ(window.size(), 1);
+    ASSERT_LT(window.capacity(), 2 * XuMQ::DELIVERY_WINDOW_SPARSE_MIN);
+    ASSERT_NE(window.find(110), nullptr);
+    ASSERT_TRUE(window.take(110, taken));
+    ASSERT_EQ(taken->seq, 1);
+    ASSERT_EQ(window.size(), 0);
+
+    // 批量获取队头消息 退回的消息下次最先推送
+    XuMQ::MessageManager pmp("./data/pending/");
+    pmp.initQueueMessage("queue1");
+    for (int i = 0; i < 100; i++)
+        pmp.insert("queue1", nullptr, "hello pending " + std::to_string(i), true);
+    std::vector<XuMQ::Delivery> msgs;
+    ASSERT_EQ(pmp.front("queue1", 40, msgs), 40);
+    ASSERT_EQ(msgs[39].msg->body(), "hello pending 39");
+    ASSERT_EQ(msgs[39].tag, msgs[0].tag + 39);
+    ASSERT_EQ(pmp.waitAckCount("queue1"), 40);
+    ASSERT_TRUE(pmp.requeue("queue1", msgs[5].tag));
+    ASSERT_FALSE(pmp.requeue("queue1", msgs[5].tag));
+    ASSERT_FALSE(pmp.ack("queue1", msgs[5].tag));
+    ASSERT_EQ(pmp.availableCount("queue1"), 61);
+    ASSERT_EQ(pmp.front("queue1")->body(), "hello pending 5");
+    ASSERT_EQ(pmp.front("queue1")->body(), "hello pending 40");
+    pmp.destroyQueueMessage("queue1");
+}
+
+TEST(message_test, concurrent_test)
+{
+    // 发布端和消费端并行访问同一个队列 每个发布者的消息按发布顺序推送且只推送一次
+    XuMQ::MessageManager cmp("./data/concurrent/");
+    cmp.initQueueMessage("queue1");
+    std::vector<std::thread> publishers;
+    for (int p = 0; p < 4; p++)
+        publishers.emplace_back([&cmp, p]()
+                                { for (int i = 0; i < 2000; i++) cmp.insert("queue1", nullptr, std::to_string(p) + " " + std::to_string(i), false); });
+    std::vector<int> next(4, 0);
+    for (int n = 0; n < 8000;)
+    {
+        uint64_t tag;
+        XuMQ::MessagePtr msg = cmp.front("queue1", tag);
+        if (msg.get() == nullptr)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        std::string body(msg->body());
+        int p = std::stoi(body.substr(0, body.find(' ')));
+        ASSERT_EQ(body, std::to_string(p) + " " + std::to_string(next[p]++));
+        ASSERT_TRUE(cmp.ack("queue1", tag));
+        n++;
+    }
+    for (auto &thread : publishers)
+        thread.join();
+    ASSERT_EQ(cmp.availableCount("queue1"), 0);
+    ASSERT_EQ(cmp.waitAckCount("queue1"), 0);
+    ASSERT_EQ(cmp.memoryUsage(), 0);
+    cmp.destroyQueueMessage("queue1");
+}
+
 TEST(message_test, destroy_test)
 {
     mmp->destroyQueueMessage("queue1");
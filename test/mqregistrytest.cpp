@@ -0,0 +1,56 @@
+#include "../common/registry.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <atomic>
+
+TEST(registry_test, basic_test)
+{
+    XuMQ::Registry<std::string, std::shared_ptr<int>> registry;
+    ASSERT_TRUE(registry.insert("a", std::make_shared<int>(1)));
+    ASSERT_FALSE(registry.insert("a", std::make_shared<int>(2)));
+    ASSERT_EQ(*registry.find("a"), 1);
+    ASSERT_EQ(registry.find("b").get(), nullptr);
+    ASSERT_TRUE(registry.exists("a"));
+    for (int i = 0; i < 100; i++)
+        registry.insert(std::to_string(i), std::make_shared<int>(i));
+    ASSERT_EQ(registry.size(), 101);
+    ASSERT_EQ(registry.values().size(), 101);
+    ASSERT_EQ(*registry.erase("a"), 1);
+    ASSERT_EQ(registry.erase("a").get(), nullptr);
+    ASSERT_EQ(registry.snapshot().size(), 100);
+    registry.clear();
+    ASSERT_EQ(registry.size(), 0);
+}
+
+TEST(registry_test, concurrent_test)
+{
+    // 多个线程并发对同一批键 检查-创建-插入 每个键只创建一次
+    XuMQ::Registry<std::string, std::shared_ptr<int>> registry(8);
+    std::atomic<int> created(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++)
+        threads.emplace_back([&]()
+                             {
+                                 for (int i = 0; i < 1000; i++)
+                                 {
+                                     std::string key = "queue" + std::to_string(i);
+                                     registry.update(key, [&](std::unordered_map<std::string, std::shared_ptr<int>> &map)
+                                                     {
+                                                         if (map.find(key) != map.end())
+                                                             return;
+                                                         map.insert(std::make_pair(key, std::make_shared<int>(i)));
+                                                         created++; });
+                                     ASSERT_EQ(*registry.find(key), i);
+                                 } });
+    for (auto &thread : threads)
+        thread.join();
+    ASSERT_EQ(created, 1000);
+    ASSERT_EQ(registry.size(), 1000);
+}
+
+int main(int argc, char *argv[])
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,264 @@
+#include "../server/segment.hpp"
+#include <gtest/gtest.h>
+
+const std::string SEGDIR = "./data/segment/";
+
+class SegmentTest : public testing::Test
+{
+public:
+    virtual void SetUp() override
+    {
+        _log = std::make_shared<XuMQ::SegmentLog>(SEGDIR, 256);
+        ASSERT_TRUE(_log->open());
+    }
+    virtual void TearDown() override
+    {
+        _log->removeAll();
+    }
+
+public:
+    std::shared_ptr<XuMQ::SegmentLog> _log;
+};
+
+TEST_F(SegmentTest, append_read_test)
+{
+    uint32_t segment;
+    size_t offset;
+    ASSERT_TRUE(_log->append("hello segment", 1, segment, offset));
+    ASSERT_EQ(segment, 0);
+    ASSERT_EQ(offset, XuMQ::SEGMENT_HEADER_SIZE + XuMQ::RECORD_HEADER_SIZE);
+    std::string body;
+    ASSERT_TRUE(_log->read(segment, offset, 13, body));
+    ASSERT_EQ(body, std::string("hello segment"));
+}
+
+TEST_F(SegmentTest, roll_test)
+{
+    uint32_t segment;
+    size_t offset;
+    std::string body(50, 'x');
+    for (int i = 0; i < 6; i++)
+        ASSERT_TRUE(_log->append(body, i + 1, segment, offset));
+    // 每个段除段头外最多容纳两条 82 字节的记录
+    ASSERT_EQ(_log->segments().size(), 3);
+    ASSERT_EQ(segment, 2);
+    ASSERT_FALSE(_log->removeSegment(2)); // 活跃段不可删除
+    ASSERT_TRUE(_log->removeSegment(0));
+    ASSERT_EQ(_log->segments().size(), 2);
+}
+
+TEST_F(SegmentTest, reopen_test)
+{
+    uint32_t segment;
+    size_t offset;
+    std::string body(50, 'y');
+    for (int i = 0; i < 3; i++)
+        ASSERT_TRUE(_log->append(body, i + 1, segment, offset));
+    _log->close();
+    // 重新打开后继续向最后一个段追加
+    _log = std::make_shared<XuMQ::SegmentLog>(SEGDIR, 256);
+    ASSERT_TRUE(_log->open());
+    ASSERT_EQ(_log->segments().size(), 2);
+    ASSERT_TRUE(_log->append(body, 4, segment, offset));
+    ASSERT_EQ(segment, 1);
+    ASSERT_EQ(offset, XuMQ::SEGMENT_HEADER_SIZE + 82 + XuMQ::RECORD_HEADER_SIZE);
+}
+
+TEST_F(SegmentTest, reader_test)
+{
+    uint32_t segment;
+    size_t offset;
+    for (int i = 0; i < 2; i++)
+        ASSERT_TRUE(_log->append("record " + std::to_string(i), i + 1, segment, offset));
+    // 模拟写入中途崩溃 段尾只有记录头
+    XuMQ::RecordHeader torn(3, 100);
+    size_t end = _log->select(segment)->size();
+    ASSERT_TRUE(_log->select(segment)->write((const char *)&torn, end, sizeof(torn)));
+    _log->close();
+    _log = std::make_shared<XuMQ::SegmentLog>(SEGDIR, 256);
+    ASSERT_TRUE(_log->open());
+    XuMQ::SegmentReader reader(_log->select(segment));
+    ASSERT_TRUE(reader.open());
+    XuMQ::RecordHeader header;
+    const char *data;
+    for (int i = 0; i < 2; i++)
+    {
+        ASSERT_TRUE(reader.next(header, data, offset));
+        ASSERT_EQ(std::string(data, header.length), "record " + std::to_string(i));
+        ASSERT_EQ(header.seq, i + 1);
+    }
+    ASSERT_FALSE(reader.next(header, data, offset));
+    ASSERT_TRUE(reader.truncated());
+    ASSERT_EQ(reader.position(), end);
+}
+
+TEST_F(SegmentTest, checksum_test)
+{
+    uint32_t segment;
+    size_t offset;
+    ASSERT_TRUE(_log->append("checksum", 1, segment, offset));
+    // 篡改数据 校验失败的记录不会被读出
+    ASSERT_TRUE(_log->write(segment, offset, "X", 1));
+    XuMQ::SegmentReader reader(_log->select(segment));
+    ASSERT_TRUE(reader.open());
+    XuMQ::RecordHeader header;
+    const char *data;
+    ASSERT_FALSE(reader.next(header, data, offset));
+    ASSERT_TRUE(reader.truncated());
+}
+
+TEST_F(SegmentTest, legacy_test)
+{
+    // v1 段没有段头 记录只有长度前缀 打开后滚动到新的 v2 段
+    _log->removeAll();
+    XuMQ::FileHelper::createDirectory(SEGDIR);
+    std::string body = "legacy record";
+    size_t len = body.size();
+    std::string v1((const char *)&len, sizeof(len));
+    XuMQ::FileHelper::createFile(SEGDIR + "0000000000.mqd");
+    XuMQ::FileHelper(SEGDIR + "0000000000.mqd").write(v1 + body);
+    _log = std::make_shared<XuMQ::SegmentLog>(SEGDIR, 256);
+    ASSERT_TRUE(_log->open());
+    ASSERT_EQ(_log->select(0)->version(), XuMQ::FORMAT_V1);
+    ASSERT_EQ(_log->active()->id(), 1);
+    ASSERT_EQ(_log->active()->version(), XuMQ::FORMAT_V2);
+    XuMQ::SegmentReader reader(_log->select(0));
+    ASSERT_TRUE(reader.open());
+    XuMQ::RecordHeader header;
+    const char *data;
+    size_t offset;
+    ASSERT_TRUE(reader.next(header, data, offset));
+    ASSERT_EQ(std::string(data, header.length), body);
+    ASSERT_EQ(offset, XuMQ::RECORD_HEADER_V1_SIZE);
+}
+
+TEST_F(SegmentTest, preallocate_test)
+{
+    // 预分配的段文件大小等于滚动大小 重新打开后从真正的尾部继续追加
+    _log->removeAll();
+    XuMQ::SegmentOptions options(256);
+    _log = std::make_shared<XuMQ::SegmentLog>(SEGDIR, 256, options);
+    ASSERT_TRUE(_log->open());
+    uint32_t segment;
+    size_t offset;
+    std::string body(50, 'p');
+    for (int i = 0; i < 3; i++)
+        ASSERT_TRUE(_log->append(body, i + 1, segment, offset));
+    ASSERT_EQ(XuMQ::FileHelper(_log->segmentName(1)).size(), 256);
+    // 封存的段释放未用的空间
+    ASSERT_EQ(XuMQ::FileHelper(_log->segmentName(0)).size(), XuMQ::SEGMENT_HEADER_SIZE + 2 * 82);
+    _log->close();
+    _log = std::make_shared<XuMQ::SegmentLog>(SEGDIR, 256, options);
+    ASSERT_TRUE(_log->open());
+    ASSERT_EQ(_log->active()->size(), XuMQ::SEGMENT_HEADER_SIZE + 82);
+    ASSERT_TRUE(_log->append(body, 4, segment, offset));
+    ASSERT_EQ(segment, 1);
+    ASSERT_EQ(offset, XuMQ::SEGMENT_HEADER_SIZE + 82 + XuMQ::RECORD_HEADER_SIZE);
+    XuMQ::SegmentReader reader(_log->select(1));
+    ASSERT_TRUE(reader.open());
+    XuMQ::RecordHeader header;
+    const char *data;
+    for (int i = 0; i < 2; i++)
+    {
+        ASSERT_TRUE(reader.next(header, data, offset));
+        ASSERT_EQ(header.seq, i + 3);
+    }
+    ASSERT_FALSE(reader.next(header, data, offset));
+    ASSERT_FALSE(reader.truncated());
+}
+
+TEST_F(SegmentTest, zero_tail_test)
+{
+    // 段尾全零(例如崩溃前已扩展但未写入) 不算损坏 下次追加覆盖全零的部分
+    uint32_t segment;
+    size_t offset;
+    for (int i = 0; i < 2; i++)
+        ASSERT_TRUE(_log->append("record " + std::to_string(i), i + 1, segment, offset));
+    size_t end = _log->active()->size();
+    std::string zeros(100, '\0');
+    ASSERT_TRUE(_log->active()->write(zeros.data(), end, zeros.size()));
+    _log->close();
+    _log = std::make_shared<XuMQ::SegmentLog>(SEGDIR, 256);
+    ASSERT_TRUE(_log->open());
+    ASSERT_EQ(_log->active()->size(), end);
+    XuMQ::SegmentReader reader(_log->active());
+    ASSERT_TRUE(reader.open());
+    XuMQ::RecordHeader header;
+    const char *data;
+    for (int i = 0; i < 2; i++)
+        ASSERT_TRUE(reader.next(header, data, offset));
+    ASSERT_FALSE(reader.next(header, data, offset));
+    ASSERT_FALSE(reader.truncated());
+    ASSERT_TRUE(_log->append("record 2", 3, segment, offset));
+    ASSERT_EQ(offset, end + XuMQ::RECORD_HEADER_SIZE);
+}
+
+TEST_F(SegmentTest, direct_test)
+{
+    // O_DIRECT 写入时记录紧密排列 刷盘前从暂存缓冲区读取 段文件不超过滚动大小 文件系统不支持时退回普通写入
+    _log->removeAll();
+    XuMQ::SegmentOptions options(0, true);
+    _log = std::make_shared<XuMQ::SegmentLog>(SEGDIR, 64 * 1024, options);
+    ASSERT_TRUE(_log->open());
+    uint32_t segment;
+    size_t offset;
+    for (int i = 0; i < 5; i++)
+    {
+        size_t tail = _log->active()->size();
+        ASSERT_TRUE(_log->append("direct " + std::to_string(i), i + 1, segment, offset));
+        ASSERT_EQ(offset, tail + XuMQ::RECORD_HEADER_SIZE);
+        ASSERT_EQ(_log->active()->size(), offset + 8);
+        std::string body;
+        ASSERT_TRUE(_log->read(segment, offset, 8, body));
+        ASSERT_EQ(body, "direct " + std::to_string(i));
+    }
+    ASSERT_TRUE(_log->active()->sync());
+    ASSERT_TRUE(_log->append("direct 5", 6, segment, offset));
+    std::string body;
+    ASSERT_TRUE(_log->read(segment, offset - XuMQ::RECORD_HEADER_SIZE - 8, 8, body));
+    ASSERT_EQ(body, "direct 4");
+    // 写满多个段 每个段文件都不超过滚动大小
+    std::string big(1000, 'x');
+    for (int i = 6; i < 200; i++)
+        ASSERT_TRUE(_log->append(big, i + 1, segment, offset));
+    ASSERT_GT(_log->segments().size(), 1);
+    ASSERT_TRUE(_log->active()->sync());
+    for (auto &sp : _log->segments())
+    {
+        struct stat st;
+        ASSERT_EQ(fstat(sp->fd(), &st), 0);
+        ASSERT_LE(st.st_size, 64 * 1024);
+    }
+    _log->close();
+    _log = std::make_shared<XuMQ::SegmentLog>(SEGDIR, 64 * 1024, options);
+    ASSERT_TRUE(_log->open());
+    XuMQ::RecordHeader header;
+    const char *data;
+    int count = 0;
+    for (auto &sp : _log->segments())
+    {
+        XuMQ::SegmentReader reader(sp);
+        ASSERT_TRUE(reader.open());
+        while (reader.next(header, data, offset))
+        {
+            ASSERT_EQ(header.seq, ++count);
+            if (count <= 6)
+                ASSERT_EQ(std::string(data, header.length), "direct " + std::to_string(count - 1));
+            else
+                ASSERT_EQ(std::string(data, header.length), big);
+        }
+        ASSERT_FALSE(reader.truncated());
+    }
+    ASSERT_EQ(count, 200);
+    // 重新打开后接着最后一条记录追加
+    size_t tail = _log->active()->size();
+    ASSERT_TRUE(_log->append("direct", 201, segment, offset));
+    ASSERT_EQ(offset, tail + XuMQ::RECORD_HEADER_SIZE);
+}
+
+int main(int argc, char *argv[])
+{
+    testing::InitGoogleTest(&argc, argv);
+    int res = RUN_ALL_TESTS();
+    return 0;
+}
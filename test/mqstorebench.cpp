@@ -0,0 +1,83 @@
+#include "../server/message.hpp"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <algorithm>
+
+/// @brief 对比各存储引擎的发布、恢复和消费速度
+/// 用法: mqstorebench [消息数] [消息大小] [持久化策略 none|interval|batch|confirm] [确认顺序 fifo|random]
+int main(int argc, char *argv[])
+{
+    size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 100000;
+    size_t size = argc > 2 ? strtoul(argv[2], nullptr, 10) : 256;
+    std::string durability = argc > 3 ? argv[3] : "none";
+    bool random = argc > 4 && std::string(argv[4]) == "random";
+    std::string body(size, 'x');
+
+    std::vector<std::pair<std::string, XuMQ::QueueArgs>> engines;
+    XuMQ::QueueArgs args;
+    args["x-durability"] = durability;
+    args["x-store"] = "file";
+    engines.push_back(std::make_pair("file", args));
+    args["x-compression"] = "zlib";
+    engines.push_back(std::make_pair("file+zlib", args));
+    args.erase("x-compression");
+    args["x-store"] = "memory";
+    engines.push_back(std::make_pair("memory", args));
+    args["x-store"] = "ring";
+    args["x-ring-size"] = std::to_string((count * (size + 128) / 4096 + 1) * 4096);
+    engines.push_back(std::make_pair("ring", args));
+    args.erase("x-ring-size");
+    args["x-store"] = "btree";
+    engines.push_back(std::make_pair("btree", args));
+
+    printf("%zu 条消息, 每条 %zu 字节, 持久化策略 %s, %s确认\n", count, size, durability.c_str(), random ? "乱序" : "顺序");
+    printf("%-12s %16s %12s %16s\n", "engine", "publish(msg/s)", "recover(ms)", "consume(msg/s)");
+    for (auto &engine : engines)
+    {
+        using clock = std::chrono::steady_clock;
+        auto seconds = [](clock::time_point begin)
+        { return std::chrono::duration<double>(clock::now() - begin).count(); };
+        double publish, recover, consume;
+        {
+            XuMQ::MessageManager mmp("./data/bench/");
+            mmp.initQueueMessage("bench", engine.second);
+            auto begin = clock::now();
+            for (size_t i = 0; i < count; i++)
+                mmp.insert("bench", nullptr, body, true);
+            publish = seconds(begin);
+        }
+        XuMQ::MessageManager mmp("./data/bench/");
+        auto begin = clock::now();
+        mmp.initQueueMessage("bench", engine.second);
+        recover = seconds(begin);
+        // 内存存储重启后没有消息 重新发布后再消费
+        if (mmp.availableCount("bench") == 0)
+        {
+            for (size_t i = 0; i < count; i++)
+                mmp.insert("bench", nullptr, body, true);
+        }
+        begin = clock::now();
+        if (random)
+        {
+            // 先取出所有消息 再按随机顺序确认 模拟多个消费者乱序确认
+            std::vector<uint64_t> tags;
+            uint64_t tag;
+            while (mmp.front("bench", tag).get() != nullptr)
+                tags.push_back(tag);
+            std::shuffle(tags.begin(), tags.end(), std::mt19937(1));
+            for (auto t : tags)
+                mmp.ack("bench", t);
+        }
+        else
+        {
+            uint64_t tag;
+            while (mmp.front("bench", tag).get() != nullptr)
+                mmp.ack("bench", tag);
+        }
+        consume = seconds(begin);
+        mmp.destroyQueueMessage("bench");
+        printf("%-12s %16.0f %12.1f %16.0f\n", engine.first.c_str(), count / publish, recover * 1000, count / consume);
+    }
+    return 0;
+}
@@ -51,6 +51,7 @@ public:
 
 TEST_F(HostTest, init_test)
 {
+    uint64_t tag;
     ASSERT_TRUE(_host->existsExchange("exchange1"));
     ASSERT_TRUE(_host->existsExchange("exchange2"));
     ASSERT_TRUE(_host->existsExchange("exchange3"));
@@ -65,13 +66,13 @@ TEST_F(HostTest, init_test)
     ASSERT_TRUE(_host->existsBinding("exchange2", "queue3"));
     ASSERT_TRUE(_host->existsBinding("exchange3", "queue3"));
 
-    XuMQ::MessagePtr msg1 = _host->basicConsume("queue1");
-    ASSERT_EQ(msg1->payload().body(), std::string("hello world 1"));
-    XuMQ::MessagePtr msg2 = _host->basicConsume("queue1");
-    ASSERT_EQ(msg2->payload().body(), std::string("hello world 2"));
-    XuMQ::MessagePtr msg3 = _host->basicConsume("queue1");
-    ASSERT_EQ(msg3->payload().body(), std::string("hello world 3"));
-    XuMQ::MessagePtr msg4 = _host->basicConsume("queue1");
+    XuMQ::MessagePtr msg1 = _host->basicConsume("queue1", tag);
+    ASSERT_EQ(msg1->body(), std::string("hello world 1"));
+    XuMQ::MessagePtr msg2 = _host->basicConsume("queue1", tag);
+    ASSERT_EQ(msg2->body(), std::string("hello world 2"));
+    XuMQ::MessagePtr msg3 = _host->basicConsume("queue1", tag);
+    ASSERT_EQ(msg3->body(), std::string("hello world 3"));
+    XuMQ::MessagePtr msg4 = _host->basicConsume("queue1", tag);
     ASSERT_EQ(msg4.get(), nullptr);
 }
 
@@ -85,25 +86,27 @@ TEST_F(HostTest, delete_exchange)
 
 TEST_F(HostTest, delete_queue)
 {
+    uint64_t tag;
     _host->deleteQueue("queue3");
     ASSERT_FALSE(_host->existsBinding("exchange1", "queue3"));
     ASSERT_FALSE(_host->existsBinding("exchange2", "queue3"));
     ASSERT_FALSE(_host->existsBinding("exchange3", "queue3"));
-    XuMQ::MessagePtr msg1 = _host->basicConsume("queue3");
+    XuMQ::MessagePtr msg1 = _host->basicConsume("queue3", tag);
     ASSERT_EQ(msg1.get(), nullptr);
 }
 
 TEST_F(HostTest, ack_msg)
 {
-    XuMQ::MessagePtr msg1 = _host->basicConsume("queue2");
+    uint64_t tag;
+    XuMQ::MessagePtr msg1 = _host->basicConsume("queue2", tag);
     ASSERT_NE(msg1.get(), nullptr);
-    ASSERT_EQ(msg1->payload().body(), std::string("hello world 1"));
-    _host->basicAck("queue2", msg1->payload().properties().id());
-    XuMQ::MessagePtr msg2 = _host->basicConsume("queue2");
+    ASSERT_EQ(msg1->body(), std::string("hello world 1"));
+    _host->basicAck("queue2", tag);
+    XuMQ::MessagePtr msg2 = _host->basicConsume("queue2", tag);
     ASSERT_NE(msg2.get(), nullptr);
-    _host->basicAck("queue2", msg2->payload().properties().id());
-    ASSERT_EQ(msg2->payload().body(), std::string("hello world 2"));
-    XuMQ::MessagePtr msg3 = _host->basicConsume("queue2");
+    _host->basicAck("queue2", tag);
+    ASSERT_EQ(msg2->body(), std::string("hello world 2"));
+    XuMQ::MessagePtr msg3 = _host->basicConsume("queue2", tag);
     ASSERT_EQ(msg3.get(), nullptr);
 }
 